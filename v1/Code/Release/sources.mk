@@ -30,6 +30,10 @@ src/common/inet \
 src/common/exception \
 src/common/date \
 src/prober/structure \
+src/prober/fanout \
+src/prober/pool \
+src/prober/uring \
+src/prober/xdp \
 src/prober/icmp \
 src/prober/udp \
 src/prober/tcp \
@@ -42,6 +46,7 @@ src/tool/repair \
 src/tool/postprocessing \
 src/tool/fingerprinting \
 src/tool/rate-limit-analysis \
+src/tool/sharding \
 src/tool/utils \
 src/tool \
 src \
@@ -4,16 +4,19 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../src/common/random/CyclicPermutation.cpp \
 ../src/common/random/Distribution.cpp \
 ../src/common/random/PRNGenerator.cpp \
 ../src/common/random/Uniform.cpp 
 
 OBJS += \
+./src/common/random/CyclicPermutation.o \
 ./src/common/random/Distribution.o \
 ./src/common/random/PRNGenerator.o \
 ./src/common/random/Uniform.o 
 
 CPP_DEPS += \
+./src/common/random/CyclicPermutation.d \
 ./src/common/random/Distribution.d \
 ./src/common/random/PRNGenerator.d \
 ./src/common/random/Uniform.d 
@@ -0,0 +1,33 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../src/prober/fanout/FanoutReceiver.cpp \
+../src/prober/fanout/FanoutReceptionUnit.cpp \
+../src/prober/fanout/FanoutSubscription.cpp \
+../src/prober/fanout/ReplyDispatcher.cpp 
+
+OBJS += \
+./src/prober/fanout/FanoutReceiver.o \
+./src/prober/fanout/FanoutReceptionUnit.o \
+./src/prober/fanout/FanoutSubscription.o \
+./src/prober/fanout/ReplyDispatcher.o 
+
+CPP_DEPS += \
+./src/prober/fanout/FanoutReceiver.d \
+./src/prober/fanout/FanoutReceptionUnit.d \
+./src/prober/fanout/FanoutSubscription.d \
+./src/prober/fanout/ReplyDispatcher.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/prober/fanout/%.o: ../src/prober/fanout/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ -m32 -O3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
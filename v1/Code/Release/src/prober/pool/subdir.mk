@@ -0,0 +1,24 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../src/prober/pool/ProberPool.cpp 
+
+OBJS += \
+./src/prober/pool/ProberPool.o 
+
+CPP_DEPS += \
+./src/prober/pool/ProberPool.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/prober/pool/%.o: ../src/prober/pool/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ -m32 -O3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
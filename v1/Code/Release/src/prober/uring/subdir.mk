@@ -0,0 +1,27 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../src/prober/uring/IOUringCompletionUnit.cpp \
+../src/prober/uring/IOUringEngine.cpp 
+
+OBJS += \
+./src/prober/uring/IOUringCompletionUnit.o \
+./src/prober/uring/IOUringEngine.o 
+
+CPP_DEPS += \
+./src/prober/uring/IOUringCompletionUnit.d \
+./src/prober/uring/IOUringEngine.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/prober/uring/%.o: ../src/prober/uring/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ -m32 -O3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -0,0 +1,27 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../src/prober/xdp/XDPReceiver.cpp \
+../src/prober/xdp/XDPReceptionUnit.cpp 
+
+OBJS += \
+./src/prober/xdp/XDPReceiver.o \
+./src/prober/xdp/XDPReceptionUnit.o 
+
+CPP_DEPS += \
+./src/prober/xdp/XDPReceiver.d \
+./src/prober/xdp/XDPReceptionUnit.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/prober/xdp/%.o: ../src/prober/xdp/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ -m32 -O3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -5,15 +5,21 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../src/tool/prescanning/NetworkPrescanningUnit.cpp \
-../src/tool/prescanning/NetworkPrescanner.cpp
+../src/tool/prescanning/NetworkPrescanner.cpp \
+../src/tool/prescanning/PrefixSampler.cpp \
+../src/tool/prescanning/PrescanningPipeline.cpp
 
 OBJS += \
 ./src/tool/prescanning/NetworkPrescanningUnit.o \
-./src/tool/prescanning/NetworkPrescanner.o
+./src/tool/prescanning/NetworkPrescanner.o \
+./src/tool/prescanning/PrefixSampler.o \
+./src/tool/prescanning/PrescanningPipeline.o
 
 CPP_DEPS += \
 ./src/tool/prescanning/NetworkPrescanningUnit.d \
-./src/tool/prescanning/NetworkPrescanner.d
+./src/tool/prescanning/NetworkPrescanner.d \
+./src/tool/prescanning/PrefixSampler.d \
+./src/tool/prescanning/PrescanningPipeline.d
 
 
 # Each subdirectory must supply rules for building sources it contributes
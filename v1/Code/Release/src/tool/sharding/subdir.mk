@@ -0,0 +1,27 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../src/tool/sharding/ShardConnection.cpp \
+../src/tool/sharding/ShardCoordinator.cpp
+
+OBJS += \
+./src/tool/sharding/ShardConnection.o \
+./src/tool/sharding/ShardCoordinator.o
+
+CPP_DEPS += \
+./src/tool/sharding/ShardConnection.d \
+./src/tool/sharding/ShardCoordinator.d
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/tool/sharding/%.o: ../src/tool/sharding/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ -m32 -O3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -9,7 +9,16 @@ CPP_SRCS += \
 ../src/tool/structure/RoundRecord.cpp \
 ../src/tool/structure/IPTableEntry.cpp \
 ../src/tool/structure/IPLookUpTable.cpp \
-../src/tool/structure/RouteRepair.cpp
+../src/tool/structure/RouteRepair.cpp \
+../src/tool/structure/LocalStopSet.cpp \
+../src/tool/structure/GlobalStopSet.cpp \
+../src/tool/structure/Hitlist.cpp \
+../src/tool/structure/PreviousCampaign.cpp \
+../src/tool/structure/RateLimitMonitor.cpp \
+../src/tool/structure/UnreachablePrefixCache.cpp \
+../src/tool/structure/TargetQueue.cpp \
+../src/tool/structure/ConcurrencyController.cpp \
+../src/tool/structure/TargetDispenser.cpp
 
 OBJS += \
 ./src/tool/structure/RouteInterface.o \
@@ -17,7 +26,16 @@ OBJS += \
 ./src/tool/structure/RoundRecord.o \
 ./src/tool/structure/IPTableEntry.o \
 ./src/tool/structure/IPLookUpTable.o \
-./src/tool/structure/RouteRepair.o
+./src/tool/structure/RouteRepair.o \
+./src/tool/structure/LocalStopSet.o \
+./src/tool/structure/GlobalStopSet.o \
+./src/tool/structure/Hitlist.o \
+./src/tool/structure/PreviousCampaign.o \
+./src/tool/structure/RateLimitMonitor.o \
+./src/tool/structure/UnreachablePrefixCache.o \
+./src/tool/structure/TargetQueue.o \
+./src/tool/structure/ConcurrencyController.o \
+./src/tool/structure/TargetDispenser.o
 
 CPP_DEPS += \
 ./src/tool/structure/RouteInterface.d \
@@ -25,7 +43,16 @@ CPP_DEPS += \
 ./src/tool/structure/RoundRecord.d \
 ./src/tool/structure/IPTableEntry.d \
 ./src/tool/structure/IPLookUpTable.d \
-./src/tool/structure/RouteRepair.d
+./src/tool/structure/RouteRepair.d \
+./src/tool/structure/LocalStopSet.d \
+./src/tool/structure/GlobalStopSet.d \
+./src/tool/structure/Hitlist.d \
+./src/tool/structure/PreviousCampaign.d \
+./src/tool/structure/RateLimitMonitor.d \
+./src/tool/structure/UnreachablePrefixCache.d \
+./src/tool/structure/TargetQueue.d \
+./src/tool/structure/ConcurrencyController.d \
+./src/tool/structure/TargetDispenser.d
 
 # Each subdirectory must supply rules for building sources it contributes
 src/tool/structure/%.o: ../src/tool/structure/%.cpp
@@ -4,13 +4,25 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
-../src/tool/traceroute/ParisTracerouteTask.cpp
+../src/tool/traceroute/AsyncTracerouteEngine.cpp \
+../src/tool/traceroute/ParisTracerouteTask.cpp \
+../src/tool/traceroute/StatelessTracerouteEngine.cpp \
+../src/tool/traceroute/TracerouteWorker.cpp \
+../src/tool/traceroute/Tracerouter.cpp
 
 OBJS += \
-./src/tool/traceroute/ParisTracerouteTask.o
+./src/tool/traceroute/AsyncTracerouteEngine.o \
+./src/tool/traceroute/ParisTracerouteTask.o \
+./src/tool/traceroute/StatelessTracerouteEngine.o \
+./src/tool/traceroute/TracerouteWorker.o \
+./src/tool/traceroute/Tracerouter.o
 
 CPP_DEPS += \
-./src/tool/traceroute/ParisTracerouteTask.d
+./src/tool/traceroute/AsyncTracerouteEngine.d \
+./src/tool/traceroute/ParisTracerouteTask.d \
+./src/tool/traceroute/StatelessTracerouteEngine.d \
+./src/tool/traceroute/TracerouteWorker.d \
+./src/tool/traceroute/Tracerouter.d
 
 # Each subdirectory must supply rules for building sources it contributes
 src/tool/traceroute/%.o: ../src/tool/traceroute/%.cpp
@@ -4,15 +4,21 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../src/tool/utils/CheckpointJournal.cpp \
 ../src/tool/utils/StopException.cpp \
+../src/tool/utils/TargetGenerator.cpp \
 ../src/tool/utils/TargetParser.cpp
 
 OBJS += \
+./src/tool/utils/CheckpointJournal.o \
 ./src/tool/utils/StopException.o \
+./src/tool/utils/TargetGenerator.o \
 ./src/tool/utils/TargetParser.o
 
 CPP_DEPS += \
+./src/tool/utils/CheckpointJournal.d \
 ./src/tool/utils/StopException.d \
+./src/tool/utils/TargetGenerator.d \
 ./src/tool/utils/TargetParser.d
 
 
@@ -17,12 +17,15 @@ using std::auto_ptr;
 using std::string;
 #include <list>
 using std::list;
+#include <vector>
+using std::vector;
 #include <algorithm> // For transform() function
 #include <getopt.h> // For options parsing
 #include <netinet/ip_icmp.h>
 #include <unistd.h>
 #include <ctime> // To obtain current time (for output file)
 #include <unistd.h> // For usleep() function
+#include <signal.h> // To ignore SIGPIPE in a worker of a sharded campaign
 
 #include "common/inet/InetAddress.h"
 #include "common/inet/InetAddressException.h"
@@ -39,18 +42,25 @@ using std::list;
 #include "common/utils/StringUtils.h"
 #include "common/random/PRNGenerator.h"
 #include "common/random/Uniform.h"
+#include "common/random/CyclicPermutation.h"
 
 #include "prober/icmp/DirectICMPProber.h"
 #include "prober/DirectProber.h"
+#include "prober/fanout/FanoutReceiver.h"
+#include "prober/uring/IOUringEngine.h"
+#include "prober/xdp/XDPReceiver.h"
 
 #include "tool/ToolEnvironment.h"
 #include "tool/utils/TargetParser.h"
 #include "tool/prescanning/NetworkPrescanner.h"
-#include "tool/traceroute/ParisTracerouteTask.h"
+#include "tool/prescanning/PrescanningPipeline.h"
+#include "tool/prescanning/PrefixSampler.h"
+#include "tool/traceroute/Tracerouter.h"
 #include "tool/repair/RouteRepairer.h"
 #include "tool/postprocessing/RoutePostProcessor.h"
 #include "tool/fingerprinting/FingerprintMaker.h"
 #include "tool/rate-limit-analysis/RoundScheduler.h"
+#include "tool/sharding/ShardCoordinator.h"
 
 // Simple function to display usage.
 
@@ -145,13 +155,92 @@ void printUsage()
     cout << "probing for traceroute records. Pre-scanning consists in eliminating all\n";
     cout << "unresponsive IPs among the targets to only collect traces towards responsive\n";
     cout << "IPs. It has the advantage of reducing the probing work and ensuring a maximum\n";
-    cout << "of complete traces (i.e., traces that reach a destination).\n";
+    cout << "of complete traces (i.e., traces that reach a destination). The TTL of each\n";
+    cout << "echo reply also gives an estimation of the distance of the target, which is\n";
+    cout << "used to start Doubletree closer to it (see -w) or to probe all TTLs up to it\n";
+    cout << "at once with the asynchronous traceroute (see -g).\n";
+    cout << "\n";
+    cout << "-S      --target-order-seed                 Integer (in [0, 2^32[)\n";
+    cout << "\n";
+    cout << "Use this option to set the seed of the order in which the targets are probed.\n";
+    cout << "Targets are given one at a time by a pseudo-random permutation of all target\n";
+    cout << "IPs, such that consecutive targets are spread across prefixes, and the same\n";
+    cout << "seed and targets always give the same order. By default, the seed is drawn at\n";
+    cout << "launch and displayed, so a campaign can be run again in the same order.\n";
+    cout << "\n";
+    cout << "-K      --sampling-prefix-length            Integer (in [8, 30])\n";
+    cout << "\n";
+    cout << "Use this option to prescan large and sparse target blocks (e.g. whole ASes)\n";
+    cout << "by sampling. Targets are grouped by prefixes of this length (e.g. 24), and\n";
+    cout << "only 16 random targets of each prefix are prescanned first. The other targets\n";
+    cout << "of a prefix are prescanned only if enough targets of its sample are responsive\n";
+    cout << "(see -T); the other prefixes are skipped and listed in [label].skipped. The\n";
+    cout << "amount of responsive IPs likely missed this way is estimated and displayed.\n";
+    cout << "This option has no effect without -s. By default, all targets are prescanned.\n";
+    cout << "\n";
+    cout << "-T      --sampling-hit-threshold            Integer (in [0, 100])\n";
+    cout << "\n";
+    cout << "Use this option to edit the percentage of responsive targets a sample must\n";
+    cout << "exceed for its prefix to be fully prescanned (see -K). By default, it is 0,\n";
+    cout << "i.e., a single responsive target in the sample suffices.\n";
+    cout << "\n";
+    cout << "-H      --export-hitlist                    None (flag)\n";
+    cout << "\n";
+    cout << "Add this flag to your command line to save the responsive targets found by the\n";
+    cout << "pre-scanning, with their preferred timeout and their estimated distance, in\n";
+    cout << "[label].hitlist (text) and [label].hitlist.bin (compact binary format). The\n";
+    cout << "hitlist can then be imported by the next campaign towards the same targets\n";
+    cout << "(see -I). This option has no effect without -s.\n";
+    cout << "\n";
+    cout << "-I      --import-hitlist                    String\n";
+    cout << "\n";
+    cout << "Use this option to give the label of the hitlist of a previous campaign (see\n";
+    cout << "-H), i.e., [label].hitlist.bin or, if not available, [label].hitlist. Instead\n";
+    cout << "of prescanning all targets, the targets of the hitlist are only verified with\n";
+    cout << "a single pass (with the longest timeout of the hitlist) and a share of the\n";
+    cout << "other targets (see -E) is prescanned as usual, the others being considered as\n";
+    cout << "unresponsive. This option has no effect without -s, and cannot be combined\n";
+    cout << "with -K or -Q. By default, all targets are prescanned.\n";
+    cout << "\n";
+    cout << "-E      --hitlist-resampling-rate           Integer (in [0, 100])\n";
+    cout << "\n";
+    cout << "Use this option to edit the percentage of the targets missing from an imported\n";
+    cout << "hitlist (see -I) which are prescanned again, to find the targets which became\n";
+    cout << "responsive. They are drawn independently of the order of the targets (see\n";
+    cout << "-S), so that successive campaigns re-sample different targets, even with the\n";
+    cout << "same seed. By default, it is 10 (100 means all targets are prescanned again).\n";
+    cout << "\n";
+    cout << "-J      --hitlist-resampling-seed           Integer (in [0, 2^32[)\n";
+    cout << "\n";
+    cout << "Use this option to set the seed of the draw of the re-sampled targets (see -E),\n";
+    cout << "so that the re-sampled share of a campaign can be reproduced. By default, the\n";
+    cout << "seed is drawn at launch and displayed with the re-sampling statistics.\n";
+    cout << "\n";
+    cout << "-Q      --pipeline-queue-capacity           Integer (amount of targets)\n";
+    cout << "\n";
+    cout << "Use this option to overlap the pre-scanning (see -s) and the traceroute: each\n";
+    cout << "target found responsive is put in a queue of this capacity and traced as soon\n";
+    cout << "as a traceroute thread is free, while the pre-scanning (including its second\n";
+    cout << "opinion) goes on. The pre-scanning waits while the queue is full, so the\n";
+    cout << "memory used stays bounded. Both phases share half of the ICMP identifiers\n";
+    cout << "each. This option has no effect without -s, or with -g, -Y, -P or a sharded\n";
+    cout << "campaign. By default, the traceroute starts after the pre-scanning.\n";
     cout << "\n";
     cout << "-a      --concurrency-amount-threads        Integer (amount of threads)\n";
     cout << "\n";
     cout << "Use this option to edit the amount of concurrent threads performing traceroute\n";
     cout << "measurements at the same time. By default, this value is set to 256.\n";
     cout << "\n";
+    cout << "-A      --adaptive-concurrency              None (flag)\n";
+    cout << "\n";
+    cout << "Add this flag to your command line to make the amount of concurrent traces\n";
+    cout << "adaptive (up to -a), like a TCP congestion window: it is halved when a socket\n";
+    cout << "or a thread cannot be created, a probe cannot be sent or the ratio of\n";
+    cout << "unanswered probes suddenly rises, then grows again by one trace at a time.\n";
+    cout << "Targets which could not be traced are traced again later, so a lack of\n";
+    cout << "resources slows down the traceroute instead of stopping RTrack (which still\n";
+    cout << "stops if failures go on without any success). By default, RTrack stops.\n";
+    cout << "\n";
     cout << "-d      --concurrency-delay-threading       Integer (amount of milliseconds)\n";
     cout << "\n";
     cout << "Use this option to edit the minimum amount of milliseconds spent waiting\n";
@@ -161,6 +250,155 @@ void printUsage()
     cout << "large amount of threads could potentially cause congestion and make the whole\n";
     cout << "application ineffective.\n";
     cout << "\n";
+    cout << "-f      --concurrency-reception-workers     Integer (in [0, 64])\n";
+    cout << "\n";
+    cout << "Use this option to receive the replies with a small pool of reception workers\n";
+    cout << "sharing a packet fanout group (Linux 4.3 or later), rather than with one raw\n";
+    cout << "ICMP socket per probing thread. The kernel spreads the replies among the\n";
+    cout << "workers according to the identifier of the probe they reply to, so each reply\n";
+    cout << "is read once instead of being copied to every thread. This is advised with a\n";
+    cout << "large amount of threads; a good value is the amount of CPU cores. By default,\n";
+    cout << "this value is 0 (i.e., each thread listens on its own socket).\n";
+    cout << "\n";
+    cout << "-u      --concurrency-io-uring              Integer (0, 1 or 2)\n";
+    cout << "\n";
+    cout << "Use this option to send the probes and receive the replies through io_uring\n";
+    cout << "(Linux 5.19 or later) rather than with one socket per probing thread. Replies\n";
+    cout << "are received by a single engine thread with multishot receive requests (one\n";
+    cout << "buffer per reply, taken from a ring shared with the kernel), and probes queued\n";
+    cout << "by concurrent threads are submitted together. 1 enables io_uring, 2 also\n";
+    cout << "enables a kernel thread polling the submission queue (SQPOLL), so that sending\n";
+    cout << "a probe requires no system call at the cost of one busy CPU core. This option\n";
+    cout << "takes precedence over -f. By default, this value is 0 (i.e., disabled). If\n";
+    cout << "io_uring is not available, RTrack falls back to the usual sockets.\n";
+    cout << "\n";
+    cout << "-q      --concurrency-af-xdp                Integer (0, 1 or 2)\n";
+    cout << "\n";
+    cout << "Use this option to receive the replies through AF_XDP (Linux 5.9 or later),\n";
+    cout << "which is advised when prescanning very large target lists. A small XDP\n";
+    cout << "program attached to the egress interface redirects the replies to the probing\n";
+    cout << "address before the network stack handles them, and one worker per receive\n";
+    cout << "queue reads them in place. 1 attaches the program in native mode if the\n";
+    cout << "driver supports it (generic mode otherwise), 2 always uses generic mode (e.g.,\n";
+    cout << "on veth interfaces). This option takes precedence over -u and -f. By default,\n";
+    cout << "this value is 0 (i.e., disabled). If AF_XDP is not available, or if another\n";
+    cout << "XDP program is attached to the interface, RTrack falls back to the usual\n";
+    cout << "sockets.\n";
+    cout << "\n";
+    cout << "-g      --async-traceroute-targets          Integer (in [0, 65535])\n";
+    cout << "\n";
+    cout << "Use this option to compute the routes with a single asynchronous engine rather\n";
+    cout << "than with threads. The engine keeps up to this amount of targets being traced\n";
+    cout << "at the same time, sends the probes of several TTLs without waiting for the\n";
+    cout << "replies (see -j) and matches each reply with its probe, so a few thousands of\n";
+    cout << "targets can be in flight without as many threads. The obtained routes are the\n";
+    cout << "same as with threads, and probes are paced such that the overall probing rate\n";
+    cout << "does not exceed the one of the threads (see -a and -r). The individual probes\n";
+    cout << "are not detailed in debug mode. This option cannot be combined with -q (AF_XDP\n";
+    cout << "would take the replies from the engine). By default, this value is 0 (i.e.,\n";
+    cout << "disabled).\n";
+    cout << "\n";
+    cout << "-j      --async-traceroute-window           Integer (in [1, 64])\n";
+    cout << "\n";
+    cout << "Use this option to set the amount of consecutive TTLs the asynchronous engine\n";
+    cout << "probes at the same time for each target (see -g). A larger window gives the\n";
+    cout << "routes faster but wastes the probes sent beyond the end of the route (e.g.,\n";
+    cout << "after the target replied). 1 probes one TTL at a time, exactly as threads do.\n";
+    cout << "By default, this value is 4.\n";
+    cout << "\n";
+    cout << "-Y      --stateless-traceroute-max-ttl      Integer (in [0, 64])\n";
+    cout << "\n";
+    cout << "Use this option to compute the routes without keeping any state per target or\n";
+    cout << "per probe, as Yarrp does: every TTL up to this value is probed exactly once for\n";
+    cout << "every target, in a random order over all (target, TTL) pairs, at the overall\n";
+    cout << "probing rate of the threads (see -a and -r). The TTL and the send time are\n";
+    cout << "encoded in each probe, so replies are self-describing, and the routes are\n";
+    cout << "reassembled once all probes have been sent (see -Z). Probes are spread over\n";
+    cout << "many routers, which reduces the anomalies due to rate-limiting, but the TTLs\n";
+    cout << "beyond the end of the routes are probed as well. This option cannot be combined\n";
+    cout << "with -g, -w, -G, -P, -W or -q. By default, this value is 0 (i.e., disabled).\n";
+    cout << "\n";
+    cout << "-Z      --stateless-traceroute-gap-limit    Integer (in [1, 64])\n";
+    cout << "\n";
+    cout << "Use this option to set the amount of consecutive anonymous hops after which a\n";
+    cout << "route reassembled from the replies of the stateless traceroute (see -Y) ends.\n";
+    cout << "By default, this value is the maximum amount of consecutive anonymous hops (see\n";
+    cout << "-n).\n";
+    cout << "\n";
+    cout << "-w      --doubletree-start-ttl              Integer (in [0, 64])\n";
+    cout << "\n";
+    cout << "Use this option to compute the routes with Doubletree. Each trace starts at\n";
+    cout << "this TTL (or at the distance of the target if it is already known), probes\n";
+    cout << "forward until the target as usual, then probes backward and stops as soon as\n";
+    cout << "it gets an interface which another trace already got at the same TTL. The first\n";
+    cout << "hops are then copied from that other trace, so the hops close to the vantage\n";
+    cout << "point are not probed again for every target. A good value is a bit less than\n";
+    cout << "the usual distance of the targets (e.g., 8 to 10). Bis traces are always\n";
+    cout << "complete. This option cannot be combined with -g. By default, this value is 0\n";
+    cout << "(i.e., disabled; 1 is equivalent).\n";
+    cout << "\n";
+    cout << "-G      --global-stop-set                   None (flag)\n";
+    cout << "\n";
+    cout << "Use this flag to stop probing forward as soon as a trace gets an interface that\n";
+    cout << "was already seen on the route towards another target of the same /24. The rest\n";
+    cout << "of the route is copied from that other route and marked as inferred (i.e., not\n";
+    cout << "measured) in the output files. Bis traces are always complete.\n";
+    cout << "\n";
+    cout << "-V      --global-stop-set-verification      Integer (in [0, 100])\n";
+    cout << "\n";
+    cout << "Use this option to set the percentage of traces that ignore the global stop set\n";
+    cout << "(see -G) and are fully measured, so that route changes are still detected: if\n";
+    cout << "the end of such a route differs, the global stop set is updated. By default,\n";
+    cout << "this value is 5.\n";
+    cout << "\n";
+    cout << "-P      --sibling-prefix-length             Integer (0 or in [8, 31])\n";
+    cout << "\n";
+    cout << "Use this option to group the targets by prefix of this length (e.g., 24). The\n";
+    cout << "first target of each prefix is traced as usual, then the other targets of the\n";
+    cout << "prefix (its siblings) are traced starting two hops before the penultimate\n";
+    cout << "hop of the first one. The hops before are copied from the route of the first\n";
+    cout << "target and marked as inferred. If a sibling gets a different hop before the\n";
+    cout << "last hop of the first target, its route is fully computed. Bis traces are\n";
+    cout << "always complete. This option cannot be combined with -g. By default, this value\n";
+    cout << "is 0 (i.e., targets are not grouped).\n";
+    cout << "\n";
+    cout << "-W      --warm-start                        String\n";
+    cout << "\n";
+    cout << "Use this option to give the label of the output files of a previous run of\n";
+    cout << "RTrack (typically, towards the same targets), i.e., [label].traces and, if\n";
+    cout << "available, [label].ip and [label].hitlist(.bin) (see -H). Each trace first\n";
+    cout << "probes the last hop of the previous route of its target and, if the target\n";
+    cout << "was reached, its previous distance: if both match, the other hops are copied\n";
+    cout << "from the previous route. Otherwise, the route is probed as usual, except that\n";
+    cout << "a hop which was anonymous is probed once, without the usual second attempt\n";
+    cout << "with a longer timeout, until a hop differs from the previous route. The\n";
+    cout << "timeouts of the previous hitlist, if longer, are used as preferred timeouts\n";
+    cout << "and, with Doubletree (-w), the previous distance of a target is also used as\n";
+    cout << "start TTL. Bis traces are always complete. This option cannot be combined\n";
+    cout << "with -g. By default, no previous run is used.\n";
+    cout << "\n";
+    cout << "-L      --live-rate-limit-pacing            None (flag)\n";
+    cout << "\n";
+    cout << "Add this flag to your command line to follow, during the traceroute, the ratio\n";
+    cout << "of probes answered by each interface at each TTL (the interface a probe should\n";
+    cout << "hit being predicted from the previous hop). When this ratio collapses (i.e.,\n";
+    cout << "the interface likely rate-limits ICMP), the probes expected to hit it are\n";
+    cout << "spaced (from 0.1s up to 2s between two probes) until it replies again. This\n";
+    cout << "gives fewer anonymous hops to repair after the traceroute. This flag has no\n";
+    cout << "effect with -g or -Y.\n";
+    cout << "\n";
+    cout << "-U      --unreachable-prefix-budget         Integer (in [0, 254])\n";
+    cout << "\n";
+    cout << "Use this option to remember, for each /24 of the targets, the last hop which\n";
+    cout << "replied before the silence which ended the trace towards an unreachable target\n";
+    cout << "(see -n). A trace towards another target of the same /24 which gets the same\n";
+    cout << "last hop at the same TTL then stops after this amount of consecutive anonymous\n";
+    cout << "hops plus one (i.e., 0 means a single confirmation probe beyond the last hop),\n";
+    cout << "unless a hop replies in the meantime. The value should be smaller than the\n";
+    cout << "maximum amount of consecutive anonymous hops (see -n) to have any effect. Bis\n";
+    cout << "traces are always complete. This option has no effect with -g or -Y. By\n";
+    cout << "default, no cache is used.\n";
+    cout << "\n";
     cout << "-b      --amount-bis-traces                 Integer (in [0, 255])\n";
     cout << "\n";
     cout << "Use this option to edit the amount of \"bis\" traces RTrack will collect for\n";
@@ -172,6 +410,27 @@ void printUsage()
     cout << "the amount of bis traces to 0 in order to prevent the collection of bis traces\n";
     cout << "at all.\n";
     cout << "\n";
+    cout << "-D      --differential-bis-traces           None (flag)\n";
+    cout << "\n";
+    cout << "Add this flag to your command line to only re-probe, in each bis trace, the hops\n";
+    cout << "around the stretched IPs and cycles of the first trace (two hops before the\n";
+    cout << "first one and after the last one). The other hops are copied from the first\n";
+    cout << "trace and marked as inferred (i.e., not measured) in the output files. This flag\n";
+    cout << "has no effect with -g or -Y, which always compute complete bis traces.\n";
+    cout << "\n";
+    cout << "-F      --flow-varied-bis-traces            None (flag)\n";
+    cout << "\n";
+    cout << "Add this flag to your command line to collect the bis traces in a single pass,\n";
+    cout << "where the hops around the stretched IPs and cycles of the first trace (as with\n";
+    cout << "-D) are probed once with each of as many flows as the amount of bis traces (see\n";
+    cout << "-b), the flow identifier being the ICMP checksum or the destination port. Each\n";
+    cout << "TTL is probed a single time per flow (no retry). The hops probed with the i-th\n";
+    cout << "flow give the opinion n°i+1 (the first trace using the flow n°0), the other hops\n";
+    cout << "being copied from the first trace and marked as inferred. Targets which get\n";
+    cout << "distinct hops at a same TTL depending on the flow are reported as subject to\n";
+    cout << "load balancing, the others as having persistent anomalies. This flag has no\n";
+    cout << "effect with -g or -Y.\n";
+    cout << "\n";
     cout << "-x      --rate-limit-amount-experiments     Integer (in [0, max. #threads])\n";
     cout << "\n";
     cout << "Use this option to set the amount of experiments conducted during a round for\n";
@@ -200,6 +459,51 @@ void printUsage()
     cout << "RTrack uses the time at which it was started, in the format\n";
     cout << "dd-mm-yyyy hh:mm:ss.\n";
     cout << "\n";
+    cout << "-C      --checkpoint-journal                None (flag)\n";
+    cout << "\n";
+    cout << "Add this flag to your command line to record the results of the campaign in\n";
+    cout << "an append-only journal, [label].journal, as they are obtained: responsive\n";
+    cout << "targets of the pre-scanning, traces (including bis traces) and the end of\n";
+    cout << "each of these phases. The journal is synchronized to disk every few seconds,\n";
+    cout << "so that an interrupted campaign can be resumed with -R.\n";
+    cout << "\n";
+    cout << "-R      --resume                            None (flag)\n";
+    cout << "\n";
+    cout << "Add this flag to your command line to resume an interrupted campaign from its\n";
+    cout << "journal (see -C, which this flag implies), using the same targets, options and\n";
+    cout << "label (-l is required). The responsive targets and the traces are reloaded,\n";
+    cout << "the completed phases are skipped and the other probing phases only probe the\n";
+    cout << "targets which are missing from the journal. Route analysis, fingerprinting and\n";
+    cout << "rate-limit analysis are run again.\n";
+    cout << "\n";
+    cout << "-M      --shard-coordinator                 String\n";
+    cout << "\n";
+    cout << "Use this option to split the campaign between several RTrack instances\n";
+    cout << "(workers, see -O), on this host or on other hosts of the LAN. The value is the\n";
+    cout << "address on which this instance (the coordinator) waits for the workers:\n";
+    cout << "[port] or [host]:[port] for TCP, or the path of a Unix socket (any value\n";
+    cout << "containing a '/'). The targets are split in shards by hashing their prefix\n";
+    cout << "(the /24, or the prefix length given with -P), each worker gets one shard,\n";
+    cout << "probes it and sends back its responsive targets and traces. The coordinator\n";
+    cout << "then carries out the route analysis and the next phases on all traces. The\n";
+    cout << "probing options of the pre-scanning and the traceroute (e.g., -s, -p, -t, -g)\n";
+    cout << "are those of each worker. Targets of a worker which is lost before completing\n";
+    cout << "its shard, or which does not connect within 10 minutes, are traced by the\n";
+    cout << "coordinator. By default, there is no coordinator.\n";
+    cout << "\n";
+    cout << "-N      --shard-workers                     Integer (in [1, 1024])\n";
+    cout << "\n";
+    cout << "Use this option to set the amount of workers (i.e., of shards) the coordinator\n";
+    cout << "(see -M) waits for. By default, this value is 2.\n";
+    cout << "\n";
+    cout << "-O      --shard-worker                      String\n";
+    cout << "\n";
+    cout << "Use this option to run RTrack as a worker of a sharded campaign, giving the\n";
+    cout << "address of its coordinator (see -M; [port] alone means localhost). The\n";
+    cout << "targets are then received from the coordinator and do not have to be given.\n";
+    cout << "The worker stops after the traceroute, its results being sent to the\n";
+    cout << "coordinator as they are obtained.\n";
+    cout << "\n";
     cout << "-v      --verbosity                         0, 1 or 2\n";
     cout << "\n";
     cout << "Use this option to handle the verbosity of the console output produced by\n";
@@ -285,6 +589,17 @@ string getCurrentTimeStr()
     return timeStr;
 }
 
+// Saves the responsive targets (among the given ones) in [label].hitlist and [label].hitlist.bin
+
+void saveHitlist(ToolEnvironment *env, list<InetAddress> &targets, string label)
+{
+    Hitlist hitlist;
+    hitlist.addResponsiveTargets(env->getIPTable(), targets);
+    hitlist.save(label);
+    cout << "Hitlist of " << hitlist.getNbTargets() << " responsive targets has been saved in ";
+    cout << "output files " << label << ".hitlist and " << label << ".hitlist.bin.\n" << endl;
+}
+
 // Simple function to convert an elapsed time (in seconds) into days/hours/mins/secs format
 
 string elapsedTimeStr(unsigned long elapsedSeconds)
@@ -345,13 +660,44 @@ int main(int argc, char *argv[])
     unsigned short maxConsecutiveAnonHops = 3;
     unsigned short maxCycles = 4;
     bool usePrescanning = false;
+    unsigned int pipelineCapacity = 0; // 0 = traceroute starts after the pre-scanning
+    unsigned short samplingPrefixLength = 0; // 0 = all targets are prescanned
+    unsigned short samplingThreshold = 0;
+    bool exportHitlist = false;
+    string hitlistLabel = ""; // Empty = no hitlist is imported
+    unsigned short hitlistResamplingRate = 10; // Percentage
+    uint32_t hitlistResamplingSeed = (uint32_t) time(NULL) ^ (uint32_t) getpid(); // Unless set
     unsigned short bisTraces = 2; // Amount of opinions for stretched/with cycle(s) traces
+    bool differentialBisTraces = false;
+    bool flowVariedBisTraces = false;
     unsigned short RLNbExperiments = 15;
     TimeVal RLDelayExperiments(2, 0); // 2s
     double RLMinResponseRatio = 5.0;
     bool kickLogs = false;
     unsigned short displayMode = ToolEnvironment::DISPLAY_MODE_LACONIC;
     unsigned short nbThreads = 256;
+    unsigned short nbReceptionWorkers = 0; // 0 = no fanout reception
+    unsigned short IOUringMode = 0; // 0 = disabled, 1 = enabled, 2 = enabled with SQPOLL
+    unsigned short XDPMode = 0; // 0 = disabled, 1 = native mode if supported, 2 = generic mode
+    unsigned int asyncTargets = 0; // 0 = asynchronous traceroute disabled
+    unsigned short asyncWindow = 4;
+    unsigned short statelessMaxTTL = 0; // 0 = stateless traceroute disabled
+    unsigned short statelessGapLimit = 0; // 0 = same as maxConsecutiveAnonHops
+    unsigned short doubletreeStartTTL = 0; // 0 = Doubletree disabled
+    bool useGlobalStopSet = false;
+    unsigned short globalStopSetVerification = 5; // Percentage of verification traces
+    unsigned short siblingPrefixLength = 0; // 0 = targets are not grouped
+    string warmStartLabel = ""; // Empty = no warm start
+    bool liveRateLimitPacing = false;
+    bool adaptiveConcurrency = false;
+    int unreachablePrefixBudget = -1; // Negative = no cache of unreachable prefixes
+    bool useCheckpointJournal = false;
+    bool resume = false;
+    string shardCoordinatorAddress = ""; // Empty = not a coordinator
+    unsigned short nbShardWorkers = 2;
+    string shardWorkerAddress = ""; // Empty = not a worker
+    bool targetOrderSeedSet = false;
+    uint32_t targetOrderSeed = 0; // Drawn by TargetParser if not set by user
     string outputFileName = ""; // Gets a default value later if not set by user.
     
     // Values to check if info, usage, version... should be displayed.
@@ -380,6 +726,14 @@ int main(int argc, char *argv[])
                 case 'i':
                 case 'k':
                 case 's':
+                case 'A':
+                case 'C':
+                case 'D':
+                case 'F':
+                case 'G':
+                case 'H':
+                case 'L':
+                case 'R':
                     break;
                 default:
                     flagParam = true;
@@ -416,7 +770,7 @@ int main(int argc, char *argv[])
      
     int opt = 0;
     int longIndex = 0;
-    const char* const shortOpts = "a:b:cd:e:hikl:m:n:o:p:r:st:v:x:y:z:";
+    const char* const shortOpts = "a:b:cCd:De:Ff:g:hij:kl:m:n:o:p:q:r:Rst:u:v:w:x:y:z:AE:GHI:J:K:LM:N:O:P:Q:S:T:U:V:W:Y:Z:";
     const struct option longOpts[] = {
             {"probing-egress-interface", required_argument, NULL, 'e'}, 
             {"probing-payload-message", required_argument, NULL, 'm'}, 
@@ -426,13 +780,43 @@ int main(int argc, char *argv[])
             {"max-consecutive-anonymous-hops", required_argument, NULL, 'n'}, 
             {"max-cycles", required_argument, NULL, 'o'}, 
             {"use-pre-scanning", no_argument, NULL, 's'}, 
+            {"target-order-seed", required_argument, NULL, 'S'}, 
+            {"sampling-prefix-length", required_argument, NULL, 'K'}, 
+            {"export-hitlist", no_argument, NULL, 'H'}, 
+            {"import-hitlist", required_argument, NULL, 'I'}, 
+            {"hitlist-resampling-rate", required_argument, NULL, 'E'}, 
+            {"hitlist-resampling-seed", required_argument, NULL, 'J'}, 
+            {"sampling-hit-threshold", required_argument, NULL, 'T'}, 
+            {"pipeline-queue-capacity", required_argument, NULL, 'Q'}, 
             {"concurrency-amount-threads", required_argument, NULL, 'a'}, 
+            {"adaptive-concurrency", no_argument, NULL, 'A'}, 
             {"concurrency-delay-threading", required_argument, NULL, 'd'}, 
+            {"concurrency-reception-workers", required_argument, NULL, 'f'}, 
+            {"concurrency-io-uring", required_argument, NULL, 'u'}, 
+            {"concurrency-af-xdp", required_argument, NULL, 'q'}, 
+            {"async-traceroute-targets", required_argument, NULL, 'g'}, 
+            {"async-traceroute-window", required_argument, NULL, 'j'}, 
+            {"stateless-traceroute-max-ttl", required_argument, NULL, 'Y'}, 
+            {"stateless-traceroute-gap-limit", required_argument, NULL, 'Z'}, 
+            {"doubletree-start-ttl", required_argument, NULL, 'w'}, 
+            {"global-stop-set", no_argument, NULL, 'G'}, 
+            {"global-stop-set-verification", required_argument, NULL, 'V'}, 
+            {"sibling-prefix-length", required_argument, NULL, 'P'}, 
+            {"warm-start", required_argument, NULL, 'W'}, 
+            {"live-rate-limit-pacing", no_argument, NULL, 'L'}, 
+            {"unreachable-prefix-budget", required_argument, NULL, 'U'}, 
             {"amount-bis-traces", required_argument, NULL, 'b'}, 
+            {"differential-bis-traces", no_argument, NULL, 'D'}, 
+            {"flow-varied-bis-traces", no_argument, NULL, 'F'}, 
             {"rate-limit-amount-experiments", required_argument, NULL, 'x'}, 
             {"rate-limit-delay-experiments", required_argument, NULL, 'y'}, 
             {"rate-limit-min-response-rate", required_argument, NULL, 'z'}, 
             {"label-output", required_argument, NULL, 'l'}, 
+            {"checkpoint-journal", no_argument, NULL, 'C'}, 
+            {"resume", no_argument, NULL, 'R'}, 
+            {"shard-coordinator", required_argument, NULL, 'M'}, 
+            {"shard-workers", required_argument, NULL, 'N'}, 
+            {"shard-worker", required_argument, NULL, 'O'}, 
             {"verbosity", required_argument, NULL, 'v'}, 
             {"external-logs", no_argument, NULL, 'k'}, 
             {"credits", no_argument, NULL, 'c'}, 
@@ -466,6 +850,14 @@ int main(int argc, char *argv[])
                 case 'i':
                 case 'k':
                 case 's':
+                case 'A':
+                case 'C':
+                case 'D':
+                case 'F':
+                case 'G':
+                case 'H':
+                case 'L':
+                case 'R':
                     break;
                 default:
                     optargSTR = string(optarg);
@@ -531,6 +923,47 @@ int main(int argc, char *argv[])
                 case 's':
                     usePrescanning = true;
                     break;
+                case 'S':
+                    targetOrderSeed = (uint32_t) StringUtils::string2Ulong(optargSTR);
+                    targetOrderSeedSet = true;
+                    break;
+                case 'K':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 8 && gotNb <= 30)
+                    {
+                        samplingPrefixLength = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -K option: a value smaller than 8 or greater ";
+                        cout << "than 30 was parsed. RTrack will prescan all targets.\n" << endl;
+                    }
+                    break;
+                case 'T':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb <= 100)
+                    {
+                        samplingThreshold = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -T option: a value smaller than 0 or greater ";
+                        cout << "than 100 was parsed. RTrack will use the default threshold ";
+                        cout << "(= 0%).\n" << endl;
+                    }
+                    break;
+                case 'Q':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb > 0)
+                    {
+                        pipelineCapacity = (unsigned int) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -Q option: a value smaller than 1 was parsed. ";
+                        cout << "RTrack will start the traceroute after the pre-scanning.\n" << endl;
+                    }
+                    break;
                 case 't':
                     val = 1000 * StringUtils::string2Ulong(optargSTR);
                     if(val > 0)
@@ -602,6 +1035,185 @@ int main(int argc, char *argv[])
                         cout << "the launch of two consecutive threads (= 250ms).\n" << endl;
                     }
                     break;
+                case 'f':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb <= (int) FanoutReceiver::MAX_NB_WORKERS)
+                    {
+                        nbReceptionWorkers = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -f option: a value smaller than 0 or greater ";
+                        cout << "than " << FanoutReceiver::MAX_NB_WORKERS << " was parsed. ";
+                        cout << "RTrack will receive replies without reception workers.\n" << endl;
+                    }
+                    break;
+                case 'u':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb <= 2)
+                    {
+                        IOUringMode = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -u option: a value other than 0, 1 or 2 was parsed. ";
+                        cout << "RTrack will not use io_uring.\n" << endl;
+                    }
+                    break;
+                case 'q':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb <= 2)
+                    {
+                        XDPMode = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -q option: a value other than 0, 1 or 2 was parsed. ";
+                        cout << "RTrack will not use AF_XDP.\n" << endl;
+                    }
+                    break;
+                case 'g':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb < 65536)
+                    {
+                        asyncTargets = (unsigned int) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -g option: a value smaller than 0 or greater ";
+                        cout << "than 65535 was parsed. RTrack will compute the routes with ";
+                        cout << "threads.\n" << endl;
+                    }
+                    break;
+                case 'j':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 1 && gotNb <= 64)
+                    {
+                        asyncWindow = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -j option: a value smaller than 1 or greater ";
+                        cout << "than 64 was parsed. RTrack will use the default window of ";
+                        cout << "the asynchronous traceroute (= 4).\n" << endl;
+                    }
+                    break;
+                case 'Y':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb <= 64)
+                    {
+                        statelessMaxTTL = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -Y option: a value smaller than 0 or greater ";
+                        cout << "than 64 was parsed. RTrack will not use the stateless ";
+                        cout << "traceroute.\n" << endl;
+                    }
+                    break;
+                case 'Z':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 1 && gotNb <= 64)
+                    {
+                        statelessGapLimit = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -Z option: a value smaller than 1 or greater ";
+                        cout << "than 64 was parsed. RTrack will use the maximum amount of ";
+                        cout << "consecutive anonymous hops as gap limit.\n" << endl;
+                    }
+                    break;
+                case 'w':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb <= 64)
+                    {
+                        doubletreeStartTTL = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -w option: a value smaller than 0 or greater ";
+                        cout << "than 64 was parsed. RTrack will not use Doubletree.\n" << endl;
+                    }
+                    break;
+                case 'D':
+                    differentialBisTraces = true;
+                    break;
+                case 'F':
+                    flowVariedBisTraces = true;
+                    break;
+                case 'G':
+                    useGlobalStopSet = true;
+                    break;
+                case 'V':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb <= 100)
+                    {
+                        globalStopSetVerification = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -V option: a value smaller than 0 or greater ";
+                        cout << "than 100 was parsed. RTrack will use the default rate of ";
+                        cout << "verification traces (= 5%).\n" << endl;
+                    }
+                    break;
+                case 'P':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb == 0 || (gotNb >= 8 && gotNb <= 31))
+                    {
+                        siblingPrefixLength = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -P option: a value other than 0 or out of [8, 31] ";
+                        cout << "was parsed. RTrack will not group targets by prefix.\n" << endl;
+                    }
+                    break;
+                case 'W':
+                    warmStartLabel = optargSTR;
+                    break;
+                case 'H':
+                    exportHitlist = true;
+                    break;
+                case 'I':
+                    hitlistLabel = optargSTR;
+                    break;
+                case 'E':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb <= 100)
+                    {
+                        hitlistResamplingRate = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -E option: a value smaller than 0 or greater ";
+                        cout << "than 100 was parsed. RTrack will use the default rate ";
+                        cout << "(= 10%).\n" << endl;
+                    }
+                    break;
+                case 'J':
+                    hitlistResamplingSeed = (uint32_t) StringUtils::string2Ulong(optargSTR);
+                    break;
+                case 'L':
+                    liveRateLimitPacing = true;
+                    break;
+                case 'A':
+                    adaptiveConcurrency = true;
+                    break;
+                case 'U':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 0 && gotNb < 255)
+                    {
+                        unreachablePrefixBudget = gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -U option: a value smaller than 0 or greater ";
+                        cout << "than 254 was parsed. RTrack will not use a cache of ";
+                        cout << "unreachable prefixes.\n" << endl;
+                    }
+                    break;
                 case 'b':
                     gotNb = std::atoi(optargSTR.c_str());
                     if (gotNb >= 0 && gotNb < 256)
@@ -661,6 +1273,32 @@ int main(int argc, char *argv[])
                 case 'l':
                     outputFileName = optargSTR;
                     break;
+                case 'C':
+                    useCheckpointJournal = true;
+                    break;
+                case 'R':
+                    resume = true;
+                    useCheckpointJournal = true;
+                    break;
+                case 'M':
+                    shardCoordinatorAddress = optargSTR;
+                    break;
+                case 'N':
+                    gotNb = std::atoi(optargSTR.c_str());
+                    if(gotNb >= 1 && gotNb <= 1024)
+                    {
+                        nbShardWorkers = (unsigned short) gotNb;
+                    }
+                    else
+                    {
+                        cout << "Warning for -N option: a value smaller than 1 or greater ";
+                        cout << "than 1024 was parsed. RTrack will use the default amount of ";
+                        cout << "workers (= 2).\n" << endl;
+                    }
+                    break;
+                case 'O':
+                    shardWorkerAddress = optargSTR;
+                    break;
                 case 'v':
                     gotNb = std::atoi(optargSTR.c_str());
                     if(gotNb >= 0 && gotNb <= 2)
@@ -708,7 +1346,7 @@ int main(int argc, char *argv[])
         return 0;
     }
     
-    if(!found)
+    if(!found && shardWorkerAddress.length() == 0)
     {
         cout << "No target prefix or target file was provided. Use -h or --help to get more ";
         cout << "details on how to use RTrack." << endl;
@@ -809,78 +1447,511 @@ int main(int argc, char *argv[])
         return 1;
     }
     
-    // Initialization of the environment
-    ToolEnvironment *env = new ToolEnvironment(&cout, 
-                                               kickLogs, 
-                                               probingProtocol, 
-                                               localIPAddress, 
-                                               LAN, 
-                                               probeAttentionMessage, 
-                                               timeoutPeriod, 
-                                               probeRegulatingPeriod, 
-                                               probeThreadDelay, 
-                                               maxConsecutiveAnonHops, 
-                                               maxCycles, 
-                                               RLNbExperiments, 
-                                               RLDelayExperiments, 
-                                               RLMinResponseRatio, 
-                                               displayMode, 
-                                               nbThreads);
-
-    // Various variables/structures which should be considered when catching some exception
-    ostream *out = env->getOutputStream();
-    TargetParser *parser = NULL;
-    NetworkPrescanner *prescanner = NULL;
-    Thread **tracerouteTasks = NULL;
-    RouteRepairer *repairer = NULL;
-    RoutePostProcessor *postProcessor = NULL;
-    FingerprintMaker *fingerprintMaker = NULL;
-    RoundScheduler *RLScheduler = NULL;
-    unsigned short nbTasks = nbThreads; // By default, might be edited later
+    if(statelessMaxTTL > 0 && (asyncTargets > 0 || doubletreeStartTTL > 1 || useGlobalStopSet || 
+       siblingPrefixLength > 0 || warmStartLabel.length() > 0))
+    {
+        cout << "Warning: the stateless traceroute cannot be combined with the asynchronous ";
+        cout << "traceroute, Doubletree, the global stop set, sibling targets or the warm start. ";
+        cout << "RTrack will only use the stateless traceroute.\n" << endl;
+        asyncTargets = 0;
+        doubletreeStartTTL = 0;
+        useGlobalStopSet = false;
+        siblingPrefixLength = 0;
+        warmStartLabel = "";
+    }
+    if(statelessGapLimit == 0)
+        statelessGapLimit = maxConsecutiveAnonHops;
     
-    try
+    if(asyncTargets > 0 && doubletreeStartTTL > 1)
     {
-        // Parses inputs and gets target lists
-        parser = new TargetParser(env);
-        parser->parseCommandLine(targetsStr);
-        
-        cout << "RTrack v1.0 (time at start: " << getCurrentTimeStr() << ")\n" << endl;
-        
-        // Announces that it will ignore LAN.
-        if(parser->targetsEncompassLAN())
-        {
-            cout << "Target IPs encompass the LAN of the vantage point ("
-                 << LAN.getSubnetPrefix() << "/" << (unsigned short) LAN.getPrefixLength() 
-                 << "). IPs belonging to the LAN will be ignored.\n" << endl;
-        }
-
-        list<InetAddress> targets = parser->getInitialTargets();
-        
-        // Stops if no target at all
-        if(targets.size() == 0)
-        {
-            cout << "No target to probe." << endl;
-            delete parser;
-            parser = NULL;
-            
-            cout << "Use \"--help\" or \"-h\" parameter to reach help" << endl;
-            delete env;
-            return 1;
-        }
-        
-        if(usePrescanning)
-        {
-            /*
-             * NETWORK PRE-SCANNING
-             *
-             * If asked, each address from the set of (re-ordered) target addresses are probed to 
-             * check that they are responsive.
-             */
-            
-            prescanner = new NetworkPrescanner(env);
-            prescanner->setTimeoutPeriod(env->getTimeoutPeriod());
-            
-            cout << "--- Start of network pre-scanning ---" << endl;
+        cout << "Warning: Doubletree cannot be used along the asynchronous traceroute. RTrack ";
+        cout << "will not use Doubletree.\n" << endl;
+        doubletreeStartTTL = 0;
+    }
+    
+    if(asyncTargets > 0 && siblingPrefixLength > 0)
+    {
+        cout << "Warning: sibling targets cannot be used along the asynchronous traceroute. ";
+        cout << "RTrack will not group targets by prefix.\n" << endl;
+        siblingPrefixLength = 0;
+    }
+    
+    if(asyncTargets > 0 && warmStartLabel.length() > 0)
+    {
+        cout << "Warning: the warm start cannot be used along the asynchronous traceroute. ";
+        cout << "RTrack will not use the previous campaign.\n" << endl;
+        warmStartLabel = "";
+    }
+    
+    if((asyncTargets > 0 || statelessMaxTTL > 0) && XDPMode > 0)
+    {
+        cout << "Warning: AF_XDP cannot be used along the asynchronous or stateless traceroute ";
+        cout << "(the XDP program would redirect the replies it waits for). RTrack will not use ";
+        cout << "AF_XDP.\n";
+        cout << endl;
+        XDPMode = 0;
+    }
+    
+    if(resume && outputFileName.length() == 0)
+    {
+        cout << "Warning: resuming a campaign requires its label (-l). RTrack will start a new ";
+        cout << "campaign, with its own journal.\n" << endl;
+        resume = false;
+    }
+    
+    if(shardWorkerAddress.length() > 0 && shardCoordinatorAddress.length() > 0)
+    {
+        cout << "Warning: RTrack cannot be both a coordinator and a worker. It will only be ";
+        cout << "a worker.\n" << endl;
+        shardCoordinatorAddress = "";
+    }
+    
+    if(shardWorkerAddress.length() > 0 && useCheckpointJournal)
+    {
+        cout << "Warning: a worker sends its results to its coordinator, which keeps the ";
+        cout << "journal. RTrack will not record a checkpoint journal.\n" << endl;
+        useCheckpointJournal = false;
+        resume = false;
+    }
+    
+    if((exportHitlist || hitlistLabel.length() > 0) && 
+       (!usePrescanning || shardCoordinatorAddress.length() > 0 || shardWorkerAddress.length() > 0))
+    {
+        cout << "Warning: hitlists require the pre-scanning (-s) and cannot be used in a ";
+        cout << "sharded campaign. RTrack will neither import nor export a hitlist.\n" << endl;
+        exportHitlist = false;
+        hitlistLabel = "";
+    }
+    
+    if(hitlistLabel.length() > 0 && (samplingPrefixLength > 0 || pipelineCapacity > 0))
+    {
+        cout << "Warning: an imported hitlist cannot be combined with the sampled or the ";
+        cout << "pipelined pre-scanning. RTrack will neither sample nor pipeline.\n" << endl;
+        samplingPrefixLength = 0;
+        pipelineCapacity = 0;
+    }
+    
+    if(samplingPrefixLength > 0 && (!usePrescanning || shardCoordinatorAddress.length() > 0))
+    {
+        cout << "Warning: the sampled pre-scanning requires the pre-scanning (-s) and cannot be ";
+        cout << "used by a coordinator. RTrack will not sample the targets.\n" << endl;
+        samplingPrefixLength = 0;
+    }
+    
+    if(pipelineCapacity > 0 && (!usePrescanning || asyncTargets > 0 || statelessMaxTTL > 0 || 
+       siblingPrefixLength > 0 || shardCoordinatorAddress.length() > 0 || shardWorkerAddress.length() > 0))
+    {
+        cout << "Warning: pipelining requires the pre-scanning (-s) and cannot be combined with ";
+        cout << "the asynchronous or stateless traceroute, sibling targets or a sharded campaign. ";
+        cout << "RTrack will start the traceroute after the pre-scanning.\n" << endl;
+        pipelineCapacity = 0;
+    }
+    
+    /*
+     * If asked, the shared reception path (AF_XDP, io_uring or reception workers) is started before 
+     * any prober exists, so that every prober receives its replies through it. If the kernel does 
+     * not support it, RTrack falls back to the usual reception (one raw socket per prober).
+     */
+    
+    ReplyDispatcher *sharedReception = NULL;
+    bool acceptTCP = (probingProtocol == ToolEnvironment::PROBING_PROTOCOL_TCP);
+    if(XDPMode > 0)
+    {
+        XDPReceiver *XDPReception = NULL;
+        try
+        {
+            XDPReception = new XDPReceiver(localIPAddress, acceptTCP, XDPMode == 2);
+            XDPReception->start();
+            sharedReception = XDPReception;
+        }
+        catch(SocketException &e)
+        {
+            cout << "Unable to set up AF_XDP (" << e.what() << "). RTrack will use the usual ";
+            cout << "sockets.\n" << endl;
+        }
+        catch(ThreadException &te)
+        {
+            cout << "Unable to start the AF_XDP reception workers. RTrack will use the usual ";
+            cout << "sockets.\n" << endl;
+            delete XDPReception;
+        }
+    }
+    else if(IOUringMode > 0)
+    {
+        IOUringEngine *engine = NULL;
+        try
+        {
+            engine = new IOUringEngine(acceptTCP, IOUringMode == 2);
+            engine->start();
+            sharedReception = engine;
+        }
+        catch(SocketException &e)
+        {
+            cout << "Unable to set up io_uring (" << e.what() << "). RTrack will use the usual ";
+            cout << "sockets.\n" << endl;
+        }
+        catch(ThreadException &te)
+        {
+            cout << "Unable to start the io_uring engine. RTrack will use the usual sockets.\n";
+            cout << endl;
+            delete engine;
+        }
+    }
+    else if(nbReceptionWorkers > 0)
+    {
+        FanoutReceiver *fanoutReceiver = NULL;
+        try
+        {
+            fanoutReceiver = new FanoutReceiver(nbReceptionWorkers, acceptTCP);
+            fanoutReceiver->start();
+            sharedReception = fanoutReceiver;
+        }
+        catch(SocketException &e)
+        {
+            cout << "Unable to set up the reception workers (" << e.what() << "). RTrack will ";
+            cout << "receive replies with one socket per thread.\n" << endl;
+        }
+        catch(ThreadException &te)
+        {
+            cout << "Unable to start the reception workers. RTrack will receive replies with ";
+            cout << "one socket per thread.\n" << endl;
+            delete fanoutReceiver;
+        }
+    }
+    DirectProber::setReplyDispatcher(sharedReception);
+    
+    // Initialization of the environment
+    ToolEnvironment *env = new ToolEnvironment(&cout, 
+                                               kickLogs, 
+                                               probingProtocol, 
+                                               localIPAddress, 
+                                               LAN, 
+                                               probeAttentionMessage, 
+                                               timeoutPeriod, 
+                                               probeRegulatingPeriod, 
+                                               probeThreadDelay, 
+                                               maxConsecutiveAnonHops, 
+                                               maxCycles, 
+                                               RLNbExperiments, 
+                                               RLDelayExperiments, 
+                                               RLMinResponseRatio, 
+                                               displayMode, 
+                                               nbThreads);
+    env->setAsyncTraceroute(asyncTargets, asyncWindow);
+    env->setStatelessTraceroute((unsigned char) statelessMaxTTL, statelessGapLimit);
+    env->setDoubletree((unsigned char) doubletreeStartTTL);
+    if(useGlobalStopSet)
+        env->enableGlobalStopSet(globalStopSetVerification);
+    env->setSiblingPrefixLength(siblingPrefixLength);
+    env->setDifferentialBisTraces(differentialBisTraces);
+    if(flowVariedBisTraces && asyncTargets == 0 && statelessMaxTTL == 0)
+        env->setBisTraceFlows(bisTraces);
+    if(liveRateLimitPacing && asyncTargets == 0 && statelessMaxTTL == 0)
+        env->enableRateLimitMonitor();
+    if(adaptiveConcurrency)
+        env->enableConcurrencyController();
+    if(unreachablePrefixBudget >= 0 && asyncTargets == 0 && statelessMaxTTL == 0)
+    {
+        if(unreachablePrefixBudget < (int) maxConsecutiveAnonHops)
+        {
+            env->enableUnreachablePrefixCache((unsigned short) unreachablePrefixBudget);
+        }
+        else
+        {
+            cout << "Warning for -U option: the budget is not smaller than the maximum amount ";
+            cout << "of consecutive anonymous hops (see -n). RTrack will not use a cache of ";
+            cout << "unreachable prefixes.\n" << endl;
+        }
+    }
+    if(warmStartLabel.length() > 0)
+    {
+        PreviousCampaign *previous = new PreviousCampaign();
+        if(previous->load(warmStartLabel))
+        {
+            env->setPreviousCampaign(previous);
+        }
+        else
+        {
+            cout << "Warning: could not read " << warmStartLabel << ".traces. RTrack will not ";
+            cout << "use the previous campaign.\n" << endl;
+            delete previous;
+        }
+    }
+    if(hitlistLabel.length() > 0)
+    {
+        Hitlist *hitlist = new Hitlist();
+        if(hitlist->load(hitlistLabel))
+        {
+            env->setHitlist(hitlist);
+        }
+        else
+        {
+            cout << "Warning: could not read " << hitlistLabel << ".hitlist.bin nor ";
+            cout << hitlistLabel << ".hitlist. RTrack will prescan all targets.\n" << endl;
+            delete hitlist;
+        }
+    }
+    if(useCheckpointJournal)
+    {
+        CheckpointJournal *journal = new CheckpointJournal(newFileName + ".journal");
+        if(resume && !journal->load(env->getIPTable(), env->getTraces()))
+        {
+            cout << "Warning: could not read " << newFileName << ".journal. RTrack will start a ";
+            cout << "new campaign.\n" << endl;
+            resume = false;
+        }
+        
+        if(journal->open(!resume))
+        {
+            env->setCheckpointJournal(journal);
+        }
+        else
+        {
+            cout << "Warning: could not open " << newFileName << ".journal. RTrack will not ";
+            cout << "record a checkpoint journal.\n" << endl;
+            delete journal;
+        }
+    }
+    
+    /*
+     * A worker of a sharded campaign receives its targets from its coordinator, then streams its 
+     * results to it through the same connection (with the records of the checkpoint journal).
+     */
+    
+    string shard = "";
+    unsigned int shardSize = 0;
+    if(shardWorkerAddress.length() > 0)
+    {
+        ShardConnection *connection = NULL;
+        try
+        {
+            connection = ShardConnection::connectTo(shardWorkerAddress);
+        }
+        catch(SocketException &e)
+        {
+            cout << "Unable to connect to the coordinator (" << e.what() << ")." << endl;
+            DirectProber::setReplyDispatcher(NULL);
+            delete sharedReception;
+            delete env;
+            return 1;
+        }
+        
+        string line;
+        bool complete = false;
+        while(!complete && connection->receiveLine(&line))
+        {
+            if(line == "E shard")
+            {
+                complete = true;
+            }
+            else if(line.size() > 2 && line[0] == 'X')
+            {
+                shard += line.substr(2) + "\n";
+                shardSize++;
+            }
+        }
+        
+        if(!complete)
+        {
+            cout << "The coordinator closed the connection before sending the whole shard." << endl;
+            delete connection;
+            DirectProber::setReplyDispatcher(NULL);
+            delete sharedReception;
+            delete env;
+            return 1;
+        }
+        
+        signal(SIGPIPE, SIG_IGN); // A lost coordinator should not kill the worker
+        env->setCheckpointJournal(new CheckpointJournal(connection->detach()));
+        delete connection;
+    }
+
+    // Various variables/structures which should be considered when catching some exception
+    ostream *out = env->getOutputStream();
+    TargetParser *parser = NULL;
+    TargetGenerator *generator = NULL;
+    NetworkPrescanner *prescanner = NULL;
+    Tracerouter *tracerouter = NULL;
+    ShardCoordinator *coordinator = NULL;
+    RouteRepairer *repairer = NULL;
+    RoutePostProcessor *postProcessor = NULL;
+    FingerprintMaker *fingerprintMaker = NULL;
+    RoundScheduler *RLScheduler = NULL;
+    
+    try
+    {
+        // Parses inputs and gets target lists
+        parser = new TargetParser(env);
+        if(targetOrderSeedSet)
+            parser->setSeed(targetOrderSeed);
+        if(shardWorkerAddress.length() > 0)
+            parser->parseShard(shard);
+        else
+            parser->parseCommandLine(targetsStr);
+        
+        cout << "RTrack v1.0 (time at start: " << getCurrentTimeStr() << ")" << endl;
+        cout << "Targets are ordered with the seed " << parser->getSeed() << " (see -S).\n" << endl;
+        
+        PreviousCampaign *previous = env->getPreviousCampaign();
+        if(previous != NULL)
+        {
+            cout << "Warm start with the previous campaign " << warmStartLabel << " (";
+            cout << previous->getNbRoutes() << " routes, " << previous->getNbDistances();
+            cout << " known distances, " << previous->getNbTimeouts() << " known timeouts).\n" << endl;
+        }
+        
+        Hitlist *hitlist = env->getHitlist();
+        if(hitlist != NULL)
+        {
+            cout << "Hitlist " << hitlistLabel << " imported (" << hitlist->getNbTargets();
+            cout << " previously responsive targets).\n" << endl;
+        }
+        
+        if(shardWorkerAddress.length() > 0)
+        {
+            cout << "Worker of the sharded campaign coordinated at " << shardWorkerAddress;
+            cout << " (" << shardSize << " target" << (shardSize != 1 ? "s" : "") << " received).\n" << endl;
+        }
+        
+        CheckpointJournal *journal = env->getCheckpointJournal();
+        if(journal != NULL && resume)
+        {
+            cout << "Resuming the campaign recorded in " << journal->getFilename() << " (";
+            cout << journal->getNbLoadedTargets() << " responsive targets, ";
+            cout << journal->getNbLoadedTraces() << " traces).\n" << endl;
+        }
+        
+        // Announces that it will ignore LAN.
+        if(parser->targetsEncompassLAN())
+        {
+            cout << "Target IPs encompass the LAN of the vantage point ("
+                 << LAN.getSubnetPrefix() << "/" << (unsigned short) LAN.getPrefixLength() 
+                 << "). IPs belonging to the LAN will be ignored.\n" << endl;
+        }
+
+        // Stops if the targets cannot be covered by a single permutation (see TargetGenerator)
+        uint64_t spaceSize = parser->getSpaceSize();
+        if(spaceSize > (uint64_t) CyclicPermutation::MAX_SIZE)
+        {
+            cout << "Too many targets: the target IPs and IP blocks cover " << spaceSize << " IPs, ";
+            cout << "while RTrack can probe at most " << CyclicPermutation::MAX_SIZE << " IPs ";
+            cout << "in a campaign. Split the targets in several campaigns (or shards)." << endl;
+            delete parser;
+            parser = NULL;
+            
+            DirectProber::setReplyDispatcher(NULL);
+            delete sharedReception;
+            delete env;
+            return 1;
+        }
+        
+        bool prescanningDone = (journal != NULL && journal->hasEnded("pre-scanning"));
+        bool pipelined = (usePrescanning && !prescanningDone && pipelineCapacity > 0);
+        
+        /*
+         * Unless a step needs the complete list of targets (prefix sampling, hitlist, resumed or 
+         * sharded campaign, pipelining, asynchronous or stateless traceroute, sibling targets), 
+         * the pre-scanning and the traceroute take their targets directly from a generator, so 
+         * the targets are never listed.
+         */
+        
+        list<InetAddress> targets;
+        bool noTarget = false;
+        if(!resume && !pipelined && samplingPrefixLength == 0 && hitlist == NULL && 
+           shardCoordinatorAddress.length() == 0 && asyncTargets == 0 && statelessMaxTTL == 0 && 
+           siblingPrefixLength == 0)
+        {
+            generator = parser->createGenerator();
+            InetAddress firstTarget;
+            noTarget = !generator->next(&firstTarget);
+            generator->rewind();
+        }
+        else
+        {
+            targets = parser->getInitialTargets();
+            noTarget = (targets.size() == 0);
+        }
+        
+        // Stops if no target at all (a worker still reports to its coordinator)
+        if(noTarget && shardWorkerAddress.length() == 0)
+        {
+            cout << "No target to probe." << endl;
+            delete generator;
+            generator = NULL;
+            delete parser;
+            parser = NULL;
+            
+            cout << "Use \"--help\" or \"-h\" parameter to reach help" << endl;
+            DirectProber::setReplyDispatcher(NULL);
+            delete sharedReception;
+            delete env;
+            return 1;
+        }
+        
+        list<InetAddress> resumedTargets; // Pipelining: responsive before the interruption
+        
+        /*
+         * SAMPLED PRE-SCANNING
+         *
+         * If asked, a sample of each prefix is prescanned first, and only the targets of the 
+         * prefixes with enough responsive targets in their sample are prescanned afterwards.
+         */
+        
+        if(usePrescanning && !prescanningDone && samplingPrefixLength > 0 && shardCoordinatorAddress.length() == 0)
+        {
+            cout << "--- Start of prefix sampling ---" << endl;
+            timeval samplingStart, samplingEnd;
+            gettimeofday(&samplingStart, NULL);
+            
+            if(kickLogs)
+                env->openLogStream("Log_" + newFileName + "_sampling");
+            out = env->getOutputStream();
+            
+            PrefixSampler *sampler = new PrefixSampler(env, samplingPrefixLength, samplingThreshold);
+            try
+            {
+                targets = sampler->sample(targets);
+            }
+            catch(StopException &e)
+            {
+                delete sampler;
+                throw;
+            }
+            (*out) << endl;
+            
+            if(kickLogs)
+                env->closeLogStream();
+            
+            cout << "--- End of prefix sampling (" << getCurrentTimeStr() << ") ---" << endl;
+            gettimeofday(&samplingEnd, NULL);
+            unsigned long samplingElapsed = samplingEnd.tv_sec - samplingStart.tv_sec;
+            cout << "Elapsed time: " << elapsedTimeStr(samplingElapsed) << endl;
+            cout << "Total amount of probes: " << env->getTotalProbes() << endl;
+            cout << "Sampled prefixes: " << sampler->getNbPrefixes() << " (";
+            cout << sampler->getNbSampledTargets() << " sampled targets)" << endl;
+            cout << "Expanded prefixes: " << sampler->getNbExpandedPrefixes() << " (";
+            cout << targets.size() << " targets left to prescan)" << endl;
+            cout << "Skipped prefixes: " << sampler->getNbSkippedPrefixes() << " (";
+            cout << sampler->getNbSkippedTargets() << " targets not prescanned)" << endl;
+            cout << "Responsive targets likely missed: " << sampler->getEstimatedMissedTargets();
+            cout << " (at most " << sampler->getMissedTargetsBound() << " with 95% confidence for each prefix)\n" << endl;
+            env->resetProbeAmounts();
+            delete sampler;
+        }
+        
+        if(usePrescanning && !prescanningDone && shardCoordinatorAddress.length() == 0 && !pipelined)
+        {
+            /*
+             * NETWORK PRE-SCANNING
+             *
+             * If asked, each address from the set of (re-ordered) target addresses are probed to 
+             * check that they are responsive.
+             */
+            
+            prescanner = new NetworkPrescanner(env);
+            prescanner->setTimeoutPeriod(env->getTimeoutPeriod());
+            
+            cout << "--- Start of network pre-scanning ---" << endl;
             timeval prescanningStart, prescanningEnd;
             gettimeofday(&prescanningStart, NULL);
             
@@ -888,8 +1959,81 @@ int main(int argc, char *argv[])
                 env->openLogStream("Log_" + newFileName + "_pre-scanning");
             out = env->getOutputStream();
             
+            // Targets found responsive before the interruption are not probed again
+            if(env->getIPTable()->getTotalIPs() > 0)
+            {
+                list<InetAddress> toPrescan;
+                for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+                    if(env->getIPTable()->lookUp((*it)) == NULL)
+                        toPrescan.push_back((*it));
+                targets = toPrescan;
+            }
+            
+            /*
+             * With a hitlist, the previously responsive targets are verified with a single pass 
+             * and only a share of the other targets are prescanned as usual. This share is drawn 
+             * with its own seed (see -J; not the one of the order of the targets, which may be 
+             * fixed with -S), so successive campaigns re-sample different targets.
+             */
+            
+            size_t nbKnownTargets = 0, nbResampledTargets = 0, nbUnprobedTargets = 0;
+            list<InetAddress> knownTargets, resampledTargets;
+            if(hitlist != NULL)
+            {
+                list<InetAddress> otherTargets;
+                for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+                {
+                    if(hitlist->contains((*it)))
+                        knownTargets.push_back((*it));
+                    else
+                        otherTargets.push_back((*it));
+                }
+                
+                nbKnownTargets = knownTargets.size();
+                nbResampledTargets = (otherTargets.size() * hitlistResamplingRate + 99) / 100;
+                nbUnprobedTargets = otherTargets.size() - nbResampledTargets;
+                if(nbResampledTargets > 0)
+                {
+                    vector<bool> drawn(otherTargets.size(), false);
+                    CyclicPermutation draw((uint32_t) otherTargets.size(), hitlistResamplingSeed);
+                    uint32_t index = 0;
+                    for(size_t i = 0; i < nbResampledTargets && draw.next(&index); i++)
+                        drawn[index] = true;
+                    
+                    // Drawn targets keep their order (spread across prefixes)
+                    size_t i = 0;
+                    for(list<InetAddress>::iterator it = otherTargets.begin(); it != otherTargets.end(); ++it, ++i)
+                        if(drawn[i])
+                            resampledTargets.push_back((*it));
+                }
+                
+                TimeVal hitlistTimeout = hitlist->getLongestTimeout();
+                if(hitlistTimeout == TimeVal(0, 0))
+                    hitlistTimeout = env->getTimeoutPeriod();
+                
+                (*out) << "Verifying " << nbKnownTargets << " targets of the hitlist with a ";
+                (*out) << "single pass (timeout of " << hitlistTimeout << ")..." << endl;
+                prescanner->setTimeoutPeriod(hitlistTimeout);
+                prescanner->setTargets(knownTargets);
+                prescanner->probe();
+                (*out) << endl;
+                
+                // A fresh prescanner, so the lost targets of the hitlist get no second opinion
+                delete prescanner;
+                prescanner = new NetworkPrescanner(env);
+                prescanner->setTimeoutPeriod(env->getTimeoutPeriod());
+                
+                (*out) << "Re-sampling " << nbResampledTargets << " of the ";
+                (*out) << nbResampledTargets + nbUnprobedTargets << " other targets (";
+                (*out) << hitlistResamplingRate << "%)." << endl;
+                targets = resampledTargets;
+            }
+            
             (*out) << "Prescanning with initial timeout..." << endl;
-            prescanner->setTargets(targets);
+            if(generator != NULL)
+                prescanner->setTargetGenerator(generator);
+            else
+                prescanner->setTargets(targets);
             prescanner->probe();
             (*out) << endl;
             
@@ -911,6 +2055,7 @@ int main(int argc, char *argv[])
                 env->closeLogStream();
 
             cout << "--- End of network pre-scanning (" << getCurrentTimeStr() << ") ---" << endl;
+            env->getProberPool()->closeSurplus();
             gettimeofday(&prescanningEnd, NULL);
             unsigned long prescanningElapsed = prescanningEnd.tv_sec - prescanningStart.tv_sec;
             double successRate = ((double) env->getTotalSuccessfulProbes() / (double) env->getTotalProbes()) * 100;
@@ -921,12 +2066,82 @@ int main(int argc, char *argv[])
             cout << " (" << successRate << "%)" << endl;
             cout << "Total amount of discovered responsive IPs: " << nbResponsiveIPs << "\n" << endl;
             env->resetProbeAmounts();
+            
+            if(hitlist != NULL)
+            {
+                size_t nbVerified = 0, nbNew = 0;
+                IPLookUpTable *table = env->getIPTable();
+                for(list<InetAddress>::iterator it = knownTargets.begin(); it != knownTargets.end(); ++it)
+                {
+                    IPTableEntry *entry = table->lookUp((*it));
+                    if(entry == NULL)
+                        continue;
+                    
+                    // Distance of the previous campaign if the reply gave no estimation
+                    if(entry->getEstimatedTTL() == 0)
+                        entry->setEstimatedTTL(hitlist->getDistance((*it)));
+                    nbVerified++;
+                }
+                for(list<InetAddress>::iterator it = resampledTargets.begin(); it != resampledTargets.end(); ++it)
+                    if(table->lookUp((*it)) != NULL)
+                        nbNew++;
+                cout << "Hitlist targets still responsive: " << nbVerified << " of ";
+                cout << nbKnownTargets << endl;
+                cout << "Re-sampled targets found responsive: " << nbNew << " of ";
+                cout << nbResampledTargets << endl;
+                cout << "Targets not prescanned: " << nbUnprobedTargets << endl;
+                cout << "Re-sampling seed: " << hitlistResamplingSeed << " (see -J)\n" << endl;
+            }
 
             delete prescanner;
             prescanner = NULL;
             
+            if(env->isStopping())
+            {
+                throw StopException();
+            }
+            
+            if(journal != NULL)
+                journal->recordPhaseEnd("pre-scanning");
+            
             // Gets the responsive targets
+            if(generator != NULL)
+            {
+                generator->setFilter(TargetGenerator::FILTER_RESPONSIVE, env->getIPTable());
+                generator->rewind();
+                if(exportHitlist)
+                {
+                    list<InetAddress> responsiveTargets = parser->getResponsiveTargets();
+                    saveHitlist(env, responsiveTargets, newFileName);
+                }
+            }
+            else
+            {
+                targets = parser->getResponsiveTargets();
+                if(exportHitlist)
+                    saveHitlist(env, targets, newFileName);
+            }
+        }
+        else if(usePrescanning && prescanningDone)
+        {
+            cout << "Pre-scanning was completed before the interruption.\n" << endl;
             targets = parser->getResponsiveTargets();
+            
+            if(exportHitlist)
+                saveHitlist(env, targets, newFileName);
+        }
+        else if(pipelined && env->getIPTable()->getTotalIPs() > 0)
+        {
+            // Targets found responsive before the interruption are traced at once (if not yet)
+            resumedTargets = parser->getResponsiveTargets();
+            if(journal != NULL)
+                resumedTargets = journal->filterTraced(resumedTargets, 1);
+            
+            list<InetAddress> toPrescan;
+            for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+                if(env->getIPTable()->lookUp((*it)) == NULL)
+                    toPrescan.push_back((*it));
+            targets = toPrescan;
         }
         
         // Parser is no longer needed
@@ -936,13 +2151,17 @@ int main(int argc, char *argv[])
         /*
          * PARIS TRACEROUTE
          *
-         * Launches several threads to conduct Paris traceroute measurement towards each target IP.
+         * Launches a pool of threads (see Tracerouter) to conduct Paris traceroute measurement 
+         * towards each target IP.
          *
          * The methodology is identical to what can be found in the prepare() method of the 
          * ClassicGrower class in TreeNET "Arborist" v3.0.
          */
         
-        cout << "--- Start of traceroute ---" << endl;
+        if(pipelined)
+            cout << "--- Start of traceroute (pipelined with the pre-scanning) ---" << endl;
+        else
+            cout << "--- Start of traceroute ---" << endl;
         timeval tracerouteStart, tracerouteEnd;
         gettimeofday(&tracerouteStart, NULL);
         
@@ -950,88 +2169,133 @@ int main(int argc, char *argv[])
             env->openLogStream("Log_" + newFileName + "_traceroute");
         out = env->getOutputStream();
 
-        (*out) << "Computing route towards each target IP...\n" << endl;
-        
-        // Size of the thread array
-        if((unsigned long) targets.size() > (unsigned long) nbThreads)
-            nbTasks = nbThreads;
-        else
-            nbTasks = (unsigned short) targets.size();
-        
-        // Creates thread(s)
-        tracerouteTasks = new Thread*[nbTasks];
-        for(unsigned short i = 0; i < nbTasks; i++)
-            tracerouteTasks[i] = NULL;
-        
-        while(targets.size() > 0)
+        bool tracerouteDone = (journal != NULL && journal->hasEnded("traceroute"));
+        unsigned int nbPipelinedTargets = 0, nbFullQueueWaits = 0;
+        if(tracerouteDone)
+        {
+            (*out) << "Traceroute was completed before the interruption.\n" << endl;
+        }
+        else if(pipelined)
         {
-            unsigned short range = DirectProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID;
-            range -= DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID;
-            range /= nbTasks;
+            /*
+             * PIPELINED PRE-SCANNING
+             *
+             * The pre-scanning runs in its own thread and feeds a bounded queue with the 
+             * responsive targets, which the traceroute workers consume at the same time. Each 
+             * phase gets half of the ICMP identifiers so that their probes are never mixed up.
+             */
+            
+            (*out) << "Computing route towards each target IP as soon as it is found responsive ";
+            (*out) << "(queue of " << pipelineCapacity << " targets)...\n" << endl;
+            
+            unsigned short lowerID = DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID;
+            unsigned short upperID = DirectProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID;
+            unsigned short middleID = lowerID + (upperID - lowerID) / 2;
+            
+            TargetQueue *queue = new TargetQueue(pipelineCapacity);
+            prescanner = new NetworkPrescanner(env);
+            prescanner->setTimeoutPeriod(env->getTimeoutPeriod());
+            prescanner->setTargetQueue(queue);
+            prescanner->setICMPidRange(lowerID, middleID - 1);
+            
+            tracerouter = new Tracerouter(env);
+            tracerouter->setTargetQueue(queue);
+            tracerouter->setICMPidRange(middleID, upperID);
             
-            for(unsigned short i = 0; i < nbTasks && targets.size() > 0; i++)
+            Thread *prescanning = NULL;
+            try
             {
-                InetAddress curTarget = targets.front();
-                targets.pop_front();
-                
-                unsigned short lowBound = (i * range);
-                unsigned short upBound = lowBound + range - 1;
-                
-                Runnable *task = NULL;
+                prescanning = new Thread(new PrescanningPipeline(env, prescanner, queue, targets, resumedTargets));
+                prescanning->start();
+            }
+            catch(ThreadException &te)
+            {
+                (*out) << "Unable to start the pre-scanning thread." << endl;
+                delete prescanning;
+                prescanning = NULL;
+                queue->close();
+                env->triggerStop();
+            }
+            
+            if(prescanning != NULL)
+            {
+                // The tracerouter closes the queue upon stop, so the pre-scanning always ends
                 try
                 {
-                    task = new ParisTracerouteTask(env, 
-                                                   curTarget, 
-                                                   DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + lowBound, 
-                                                   DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + upBound, 
-                                                   DirectProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ, 
-                                                   DirectProber::DEFAULT_UPPER_DST_PORT_ICMP_SEQ);
-
-                    tracerouteTasks[i] = new Thread(task);
-                }
-                catch(StopException &se)
-                {
-                    throw StopException();
-                }
-                catch(SocketException &se)
-                {
-                    throw StopException();
+                    tracerouter->probe();
                 }
-                catch(ThreadException &te)
+                catch(StopException &e)
                 {
-                    (*out) << "Unable to create more threads." << endl;
-                
-                    delete task;
-                    
-                    throw StopException();
                 }
+                prescanning->join();
+                delete prescanning; // Also deletes the PrescanningPipeline object
             }
-
-            // Launches thread(s) then waits for completion
-            for(unsigned short i = 0; i < nbTasks; i++)
+            
+            delete tracerouter;
+            tracerouter = NULL;
+            delete prescanner;
+            prescanner = NULL;
+            nbPipelinedTargets = queue->getNbPushedTargets();
+            nbFullQueueWaits = queue->getNbFullQueueWaits();
+            delete queue;
+            
+            if(!env->isStopping() && journal != NULL)
+                journal->recordPhaseEnd("pre-scanning");
+            
+            // Targets are in the IP dictionnary only if responsive (the traceroute adds no target)
+            if(!env->isStopping() && exportHitlist)
             {
-                if(tracerouteTasks[i] != NULL)
-                {
-                    tracerouteTasks[i]->start();
-                    Thread::invokeSleep(env->getProbeThreadDelay());
-                }
+                targets.insert(targets.end(), resumedTargets.begin(), resumedTargets.end());
+                saveHitlist(env, targets, newFileName);
             }
+        }
+        else
+        {
+            (*out) << "Computing route towards each target IP...\n" << endl;
+            
+            // Targets traced before the interruption are not traced again
+            if(journal != NULL)
+                targets = journal->filterTraced(targets, 1);
             
-            for(unsigned short i = 0; i < nbTasks; i++)
+            // Sharded campaign: the workers trace the targets, the coordinator only the leftovers
+            if(shardCoordinatorAddress.length() > 0)
             {
-                if(tracerouteTasks[i] != NULL)
+                coordinator = new ShardCoordinator(env, 
+                                                   shardCoordinatorAddress, 
+                                                   nbShardWorkers, 
+                                                   siblingPrefixLength);
+                try
                 {
-                    tracerouteTasks[i]->join();
-                    delete tracerouteTasks[i];
-                    tracerouteTasks[i] = NULL;
+                    coordinator->run(targets);
+                    targets = coordinator->getLeftoverTargets();
                 }
+                catch(SocketException &e)
+                {
+                    cout << "Unable to coordinate the workers (" << e.what() << ")." << endl;
+                    targets.clear();
+                    env->triggerStop();
+                }
+                delete coordinator;
+                coordinator = NULL;
+                
+                if(env->isStopping())
+                    targets.clear();
+                else if(targets.size() > 0)
+                    (*out) << "\nTracing the targets left by lost workers...\n" << endl;
             }
             
-            if(env->isStopping())
-                break;
+            tracerouter = new Tracerouter(env);
+            if(generator != NULL)
+                tracerouter->setTargetGenerator(generator);
+            else
+                tracerouter->setTargets(targets);
+            tracerouter->probe();
+            delete tracerouter;
+            tracerouter = NULL;
         }
         
-        delete[] tracerouteTasks;
+        delete generator;
+        generator = NULL;
         
         /*
          * If we are in laconic display mode, we add a line break before the next message to keep 
@@ -1046,17 +2310,61 @@ int main(int argc, char *argv[])
             throw StopException();
         }
         
+        if(journal != NULL && !tracerouteDone)
+            journal->recordPhaseEnd("traceroute");
+        
         if(kickLogs)
             env->closeLogStream();
         
         cout << "--- End of traceroute (" << getCurrentTimeStr() << ") ---" << endl;
+        env->getProberPool()->closeSurplus();
         gettimeofday(&tracerouteEnd, NULL);
         unsigned long tracerouteElapsed = tracerouteEnd.tv_sec - tracerouteStart.tv_sec;
         double successRate = ((double) env->getTotalSuccessfulProbes() / (double) env->getTotalProbes()) * 100;
         cout << "Elapsed time: " << elapsedTimeStr(tracerouteElapsed) << endl;
         cout << "Total amount of probes: " << env->getTotalProbes() << endl;
         cout << "Total amount of successful probes: " << env->getTotalSuccessfulProbes();
-        cout << " (" << successRate << "%)\n" << endl;
+        cout << " (" << successRate << "%)" << endl;
+        if(pipelined)
+        {
+            cout << "Targets traced as soon as found responsive: " << nbPipelinedTargets;
+            cout << " (the pre-scanning waited " << nbFullQueueWaits << " time(s) for a full queue)" << endl;
+        }
+        RateLimitMonitor *monitor = env->getRateLimitMonitor();
+        if(monitor != NULL && monitor->getNbThrottlings() > 0)
+        {
+            cout << "Rate-limited hops (live pacing): " << monitor->getNbThrottlings();
+            cout << " throttling(s), " << monitor->getNbDeferredProbes() << " deferred probes" << endl;
+        }
+        ConcurrencyController *controller = env->getConcurrencyController();
+        if(controller != NULL && controller->getNbBackoffs() > 0)
+        {
+            cout << "Adaptive concurrency: " << controller->getNbBackoffs() << " back-off(s), ";
+            cout << controller->getNbRetries() << " retried target(s), down to ";
+            cout << controller->getLowestLimit() << " concurrent trace(s)" << endl;
+        }
+        UnreachablePrefixCache *unreachables = env->getUnreachablePrefixCache();
+        if(unreachables != NULL && unreachables->getNbPrefixes() > 0)
+        {
+            cout << "Unreachable prefixes: " << unreachables->getNbPrefixes() << " (";
+            cout << unreachables->getNbShortenedTraces() << " shortened traces)" << endl;
+        }
+        cout << endl;
+        
+        // A worker stops here, the coordinator carrying out the next phases on all traces
+        if(shardWorkerAddress.length() > 0)
+        {
+            stringstream amounts;
+            amounts << "A " << env->getTotalProbes() << " " << env->getTotalSuccessfulProbes();
+            journal->record(amounts.str());
+            cout << "Results have been sent to the coordinator." << endl;
+            
+            DirectProber::setReplyDispatcher(NULL);
+            delete sharedReception;
+            delete env; // Also sends the pending records and closes the connection
+            return 0;
+        }
+        
         env->resetProbeAmounts();
         env->recordRouteStepsInDictionnary();
         env->sortTraces();
@@ -1086,6 +2394,7 @@ int main(int argc, char *argv[])
             env->closeLogStream();
         
         cout << "--- End of route analysis (" << getCurrentTimeStr() << ") ---" << endl;
+        env->getProberPool()->closeSurplus();
         gettimeofday(&analysisEnd, NULL);
         unsigned long analysisElapsed = analysisEnd.tv_sec - analysisStart.tv_sec;
         cout << "Elapsed time: " << elapsedTimeStr(analysisElapsed) << endl;
@@ -1132,93 +2441,43 @@ int main(int argc, char *argv[])
 
             (*out) << "Re-computing route with stretched IPs and/or cycles..." << endl;
             
-            for(unsigned short i = 0; i < bisTraces; i++)
+            // Flow-varied bis traces: all opinions (one per flow) are collected in a single pass
+            unsigned short nbPasses = bisTraces, nbFlows = env->getBisTraceFlows();
+            if(nbFlows > 0)
+                nbPasses = 1;
+            
+            for(unsigned short i = 0; i < nbPasses; i++)
             {
                 env->incBisTracesCounter();
-                (*out) << "\nOpinion n°" << (i + 2) << "..." << endl;
-                
-                list<InetAddress> clonedTargets(targets);
-            
-                // Size of the thread array
-                if((unsigned long) clonedTargets.size() > (unsigned long) nbThreads)
-                    nbTasks = nbThreads;
+                if(nbFlows > 0)
+                    (*out) << "\nOpinions n°2 to n°" << (nbFlows + 1) << " (one per flow)..." << endl;
                 else
-                    nbTasks = (unsigned short) clonedTargets.size();
+                    (*out) << "\nOpinion n°" << (i + 2) << "..." << endl;
+                
+                stringstream phase;
+                phase << "opinion-" << (i + 2);
+                if(journal != NULL && journal->hasEnded(phase.str()))
+                {
+                    (*out) << "Completed before the interruption." << endl;
+                    continue;
+                }
                 
-                // Creates thread(s)
-                tracerouteTasks = new Thread*[nbTasks];
-                for(unsigned short i = 0; i < nbTasks; i++)
-                    tracerouteTasks[i] = NULL;
+                tracerouter = new Tracerouter(env);
+                if(journal != NULL)
+                    tracerouter->setTargets(journal->filterTraced(targets, nbFlows > 0 ? nbFlows + 1 : i + 2));
+                else
+                    tracerouter->setTargets(targets);
+                tracerouter->probe();
+                delete tracerouter;
+                tracerouter = NULL;
                 
-                while(clonedTargets.size() > 0)
+                if(env->isStopping())
                 {
-                    unsigned short range = DirectProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID;
-                    range -= DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID;
-                    range /= nbTasks;
-                    
-                    for(unsigned short i = 0; i < nbTasks && clonedTargets.size() > 0; i++)
-                    {
-                        InetAddress curTarget = clonedTargets.front();
-                        clonedTargets.pop_front();
-                        
-                        unsigned short lowBound = (i * range);
-                        unsigned short upBound = lowBound + range - 1;
-                        
-                        Runnable *task = NULL;
-                        try
-                        {
-                            task = new ParisTracerouteTask(env, 
-                                                           curTarget, 
-                                                           DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + lowBound, 
-                                                           DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + upBound, 
-                                                           DirectProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ, 
-                                                           DirectProber::DEFAULT_UPPER_DST_PORT_ICMP_SEQ);
-
-                            tracerouteTasks[i] = new Thread(task);
-                        }
-                        catch(StopException &se)
-                        {
-                            throw StopException();
-                        }
-                        catch(SocketException &se)
-                        {
-                            throw StopException();
-                        }
-                        catch(ThreadException &te)
-                        {
-                            (*out) << "Unable to create more threads." << endl;
-                        
-                            delete task;
-                            
-                            throw StopException();
-                        }
-                    }
-
-                    // Launches thread(s) then waits for completion
-                    for(unsigned short i = 0; i < nbTasks; i++)
-                    {
-                        if(tracerouteTasks[i] != NULL)
-                        {
-                            tracerouteTasks[i]->start();
-                            Thread::invokeSleep(env->getProbeThreadDelay());
-                        }
-                    }
-                    
-                    for(unsigned short i = 0; i < nbTasks; i++)
-                    {
-                        if(tracerouteTasks[i] != NULL)
-                        {
-                            tracerouteTasks[i]->join();
-                            delete tracerouteTasks[i];
-                            tracerouteTasks[i] = NULL;
-                        }
-                    }
-                    
-                    if(env->isStopping())
-                        break;
+                    throw StopException();
                 }
                 
-                delete[] tracerouteTasks;
+                if(journal != NULL)
+                    journal->recordPhaseEnd(phase.str());
             }
             
             if(kickLogs)
@@ -1227,13 +2486,20 @@ int main(int argc, char *argv[])
                 cout << "\n";
             
             cout << "--- End of second opinion traceroute (" << getCurrentTimeStr() << ") ---" << endl;
+            env->getProberPool()->closeSurplus();
             gettimeofday(&tracerouteBisEnd, NULL);
             unsigned long tracerouteBisElapsed = tracerouteBisEnd.tv_sec - tracerouteBisStart.tv_sec;
             double successRate = ((double) env->getTotalSuccessfulProbes() / (double) env->getTotalProbes()) * 100;
             cout << "Elapsed time: " << elapsedTimeStr(tracerouteBisElapsed) << endl;
             cout << "Total amount of probes: " << env->getTotalProbes() << endl;
             cout << "Total amount of successful probes: " << env->getTotalSuccessfulProbes();
-            cout << " (" << successRate << "%)\n" << endl;
+            cout << " (" << successRate << "%)" << endl;
+            if(nbFlows > 0)
+            {
+                cout << "Targets subject to load balancing: " << env->getNbLoadBalancedTargets() << endl;
+                cout << "Targets with persistent anomalies: " << env->getNbPersistentTargets() << endl;
+            }
+            cout << endl;
             env->resetProbeAmounts();
             env->sortTraces();
             
@@ -1261,6 +2527,7 @@ int main(int argc, char *argv[])
             cout << "\n";
         
         cout << "--- End of fingerprinting (" << getCurrentTimeStr() << ") ---" << endl;
+        env->getProberPool()->closeSurplus();
         gettimeofday(&fingerprintingEnd, NULL);
         unsigned long fingerprintingElapsed = fingerprintingEnd.tv_sec - fingerprintingStart.tv_sec;
         cout << "Elapsed time: " << elapsedTimeStr(fingerprintingElapsed) << endl;
@@ -1294,6 +2561,7 @@ int main(int argc, char *argv[])
                 env->closeLogStream();
             
             cout << "--- End of rate-limit evaluation (" << getCurrentTimeStr() << ") ---" << endl;
+            env->getProberPool()->closeSurplus();
             gettimeofday(&rateLimitEnd, NULL);
             unsigned long rateLimitElapsed = rateLimitEnd.tv_sec - rateLimitStart.tv_sec;
             cout << "Elapsed time: " << elapsedTimeStr(rateLimitElapsed) << endl;
@@ -1312,6 +2580,13 @@ int main(int argc, char *argv[])
         env->getIPTable()->outputDictionnary(newFileName + ".ip");
         cout << "IP dictionnary has been saved in an output file ";
         cout << newFileName << ".ip." << endl;
+        
+        if(env->getIPTable()->getNbSkippedPrefixes() > 0)
+        {
+            env->getIPTable()->outputSkippedPrefixes(newFileName + ".skipped");
+            cout << "Prefixes skipped by the sampled pre-scanning have been saved in an output ";
+            cout << "file " << newFileName << ".skipped." << endl;
+        }
     }
     catch(StopException e)
     {
@@ -1325,32 +2600,24 @@ int main(int argc, char *argv[])
             cout << "\nTraces have been saved in a file \"[Stopped] "+ newFileName + ".traces\"." << endl;
         }
         
-        // Deleting the threads used for traceroute
-        if(tracerouteTasks != NULL)
-        {
-            for(unsigned short i = 0; i < nbTasks; i++)
-            {
-                if(tracerouteTasks[i] != NULL)
-                {
-                    delete tracerouteTasks[i];
-                    tracerouteTasks[i] = NULL;
-                }
-            }
-            
-            delete[] tracerouteTasks;
-        }
-        
         // Because pointers are set to NULL after deletion, next lines should not cause any issue.
         delete parser;
+        delete generator;
         delete prescanner;
+        delete tracerouter;
+        delete coordinator;
         delete repairer;
         delete postProcessor;
         delete fingerprintMaker;
         delete RLScheduler;
+        DirectProber::setReplyDispatcher(NULL);
+        delete sharedReception;
         delete env;
         return 1;
     }
     
+    DirectProber::setReplyDispatcher(NULL);
+    delete sharedReception;
     delete env;
     return 0;
 }
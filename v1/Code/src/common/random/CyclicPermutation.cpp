@@ -0,0 +1,137 @@
+/*
+ * CyclicPermutation.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in CyclicPermutation.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <cstdlib>
+#include <vector>
+using std::vector;
+
+#include "CyclicPermutation.h"
+
+CyclicPermutation::CyclicPermutation(uint32_t size)
+{
+    this->init(size, NULL);
+}
+
+CyclicPermutation::CyclicPermutation(uint32_t size, uint32_t seed)
+{
+    if(seed == 0)
+        seed = 1; // xorshift never leaves 0
+    this->init(size, &seed);
+}
+
+CyclicPermutation::~CyclicPermutation()
+{
+}
+
+void CyclicPermutation::init(uint32_t size, uint32_t *seed)
+{
+    if(size > MAX_SIZE)
+        size = MAX_SIZE;
+    this->size = size;
+    this->given = 0;
+
+    // Smallest prime above size (at least 3, so that the group is not trivial)
+    prime = size + 1;
+    if(prime < 3)
+        prime = 3;
+    while(!isPrime(prime))
+        prime++;
+
+    // Prime factors of p - 1, to check whether a candidate generates the whole group
+    vector<uint32_t> factors;
+    uint32_t n = prime - 1;
+    for(uint32_t d = 2; (uint64_t) d * d <= n; d++)
+    {
+        if(n % d != 0)
+            continue;
+        factors.push_back(d);
+        while(n % d == 0)
+            n /= d;
+    }
+    if(n > 1)
+        factors.push_back(n);
+
+    // Random primitive root
+    while(true)
+    {
+        generator = 2 + random32(seed) % (prime - 2);
+        bool primitive = true;
+        for(size_t i = 0; i < factors.size() && primitive; i++)
+            if(power(generator, (prime - 1) / factors[i], prime) == 1)
+                primitive = false;
+        if(primitive)
+            break;
+    }
+
+    // Random start in [1, p - 1]
+    first = 1 + random32(seed) % (prime - 1);
+    current = first;
+}
+
+bool CyclicPermutation::next(uint32_t *value)
+{
+    while(given < size)
+    {
+        uint32_t candidate = current - 1; // Group is [1, p - 1]
+        current = (uint32_t) (((uint64_t) current * generator) % prime);
+        if(candidate < size)
+        {
+            *value = candidate;
+            given++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CyclicPermutation::rewind()
+{
+    current = first;
+    given = 0;
+}
+
+bool CyclicPermutation::isPrime(uint32_t n)
+{
+    if(n < 2)
+        return false;
+    if(n % 2 == 0)
+        return n == 2;
+    for(uint32_t d = 3; (uint64_t) d * d <= n; d += 2)
+        if(n % d == 0)
+            return false;
+    return true;
+}
+
+uint32_t CyclicPermutation::power(uint32_t base, uint32_t exponent, uint32_t modulus)
+{
+    uint64_t result = 1, b = base % modulus;
+    while(exponent > 0)
+    {
+        if(exponent & 1)
+            result = (result * b) % modulus;
+        b = (b * b) % modulus;
+        exponent >>= 1;
+    }
+    return (uint32_t) result;
+}
+
+uint32_t CyclicPermutation::random32(uint32_t *seed)
+{
+    if(seed == NULL)
+        return ((uint32_t) (rand() & 0xFFFF) << 16) | (uint32_t) (rand() & 0xFFFF);
+
+    // xorshift32
+    uint32_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
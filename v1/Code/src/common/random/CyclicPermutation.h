@@ -0,0 +1,53 @@
+/*
+ * CyclicPermutation.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * CyclicPermutation enumerates the integers of [0, size[ in a pseudo-random order without storing
+ * them, as ZMap and Yarrp do: it iterates over the multiplicative group of integers modulo a prime
+ * p greater than size (x -> x * g mod p, g being a random primitive root), starting from a random
+ * element, and skips the values which are not in the range. Each integer of the range is given
+ * exactly once, and the state is a handful of integers whatever the size. Given a seed, the
+ * generator and the start are drawn from it (rather than from rand()), so the same seed and size
+ * always give the same order.
+ */
+
+#ifndef CYCLICPERMUTATION_H_
+#define CYCLICPERMUTATION_H_
+
+#include <inttypes.h>
+
+class CyclicPermutation
+{
+public:
+
+    // Largest supported size (p must fit in 32 bits, so that products fit in 64 bits)
+    static const uint32_t MAX_SIZE = 4294967000U;
+
+    // Constructors (the order depends on rand(), hence on its seed, or on the given seed), destructor
+    CyclicPermutation(uint32_t size);
+    CyclicPermutation(uint32_t size, uint32_t seed);
+    ~CyclicPermutation();
+
+    // Writes the next integer and returns true, or returns false once all of them were given
+    bool next(uint32_t *value);
+
+    // Starts the same order again
+    void rewind();
+
+    inline uint32_t getSize() { return this->size; }
+    inline uint32_t getNbGiven() { return this->given; }
+
+private:
+
+    uint32_t size, prime, generator, first, current, given;
+
+    void init(uint32_t size, uint32_t *seed); // seed is NULL to use rand()
+
+    static bool isPrime(uint32_t n);
+    static uint32_t power(uint32_t base, uint32_t exponent, uint32_t modulus);
+    static uint32_t random32(uint32_t *seed);
+};
+
+#endif /* CYCLICPERMUTATION_H_ */
@@ -62,6 +62,10 @@ void ConditionVariable::wait(unsigned long int period)throw(ConditionVariableExc
 	gettimeofday(&now, NULL);
 	abstimeout.tv_sec = now.tv_sec + period/1000 ;
 	abstimeout.tv_nsec = now.tv_usec * 1000 + (period%1000)*1000000;//extra 200ms added
+	if(abstimeout.tv_nsec >= 1000000000){
+		abstimeout.tv_sec++;
+		abstimeout.tv_nsec -= 1000000000;
+	}
 
 	int result=pthread_cond_timedwait(&condVar, &(condMutex->mutex), &abstimeout);
 	/************END DONT ADD EXTRA CODE IN BETWEEN ***************/
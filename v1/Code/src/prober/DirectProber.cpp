@@ -25,6 +25,7 @@ using std::set;
 
 #include "DirectProber.h"
 #include "../common/thread/Thread.h"
+#include "fanout/ReplyDispatcher.h"
 
 const unsigned short DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID = 30000;
 const unsigned short DirectProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID = 64000;
@@ -75,6 +76,8 @@ const int DirectProber::UDP_PROTOCOL = IPPROTO_UDP;
 
 const int DirectProber::CONJECTURED_GLOBAL_INTERNET_DIAMETER = 48;
 
+ReplyDispatcher *DirectProber::replyDispatcher = NULL;
+
 DirectProber::DirectProber(string &attentionMessage, 
                            int proto, 
                            int tcpUdpRoundRobinSocketCount, 
@@ -100,6 +103,7 @@ upperBoundSrcPortICMPid(upBoundSrcPortICMPid),
 lowerBoundDstPortICMPseq(lowBoundDstPortICMPseq),
 upperBoundDstPortICMPseq(upBoundDstPortICMPseq),
 probeCountStatistic(0),
+flowID(0),
 verbose(v), 
 log(""),
 nbProbes(0),
@@ -193,7 +197,14 @@ nbSuccessfulProbes(0)
     }
 
     // Creates receiving socket for ICMP (the protocol is always IPPROTO_ICMP, because we are collecting ICMP messages)
-    if((icmpReceiveSocketRAW = socket(PF_INET, SOCK_RAW, IPPROTO_ICMP)) == -1)
+    if(replyDispatcher != NULL)
+    {
+        if(verbose)
+        {
+            this->log += "ICMP messages are received through the shared reception path.\n";
+        }
+    }
+    else if((icmpReceiveSocketRAW = socket(PF_INET, SOCK_RAW, IPPROTO_ICMP)) == -1)
     {
         if(errno == EACCES)
             throw SocketException("Can NOT create receiving ICMP raw socket. The process does not have appropriate privileges.");
@@ -218,7 +229,7 @@ nbSuccessfulProbes(0)
     }
 
     const int onRecv = 1;
-    if (setsockopt(icmpReceiveSocketRAW, IPPROTO_IP, IP_HDRINCL, &onRecv, sizeof(onRecv)) < 0)
+    if (icmpReceiveSocketRAW >= 0 && setsockopt(icmpReceiveSocketRAW, IPPROTO_IP, IP_HDRINCL, &onRecv, sizeof(onRecv)) < 0)
     {
         throw SocketException("Can NOT set receiving socket IP_HDRINCL");
     }
@@ -604,6 +615,65 @@ void DirectProber::regulateProbingFrequency()
     }
 }
 
+void DirectProber::reparameterize(const TimeVal &timeout, 
+                                  const TimeVal &prp, 
+                                  unsigned short lbii, 
+                                  unsigned short ubii, 
+                                  unsigned short lbis, 
+                                  unsigned short ubis, 
+                                  bool v)
+{
+    this->timeout = timeout;
+    this->setProbeRegulatingPausePeriod(prp);
+    this->lowerBoundSrcPortICMPid = lbii;
+    this->upperBoundSrcPortICMPid = ubii;
+    this->lowerBoundDstPortICMPseq = lbis;
+    this->upperBoundDstPortICMPseq = ubis;
+    this->verbose = v;
+    
+    this->activeTCPUDPReceiveSocketIndex = 0;
+    this->probeCountStatistic = 0;
+    this->flowID = 0;
+    this->nbProbes = 0;
+    this->nbSuccessfulProbes = 0;
+    this->log = "";
+    
+    unsigned int nbDrained = this->drainReceiveSockets();
+    if(verbose)
+    {
+        stringstream ss;
+        ss << "Re-using prober with sending raw socket " << sendSocketRAW << " (";
+        ss << nbDrained << " stale packet(s) discarded).\n";
+        this->log += ss.str();
+    }
+}
+
+unsigned int DirectProber::drainReceiveSockets()
+{
+    uint8_t buffer[1500]; // A datagram is discarded as a whole, even if truncated
+    unsigned int nbDrained = 0;
+    if(icmpReceiveSocketRAW >= 0)
+        while(recv(icmpReceiveSocketRAW, buffer, sizeof(buffer), MSG_DONTWAIT) > 0)
+            nbDrained++;
+    for(int i = 0; tcpudpReceiveSockets != 0 && i < tcpudpReceiveSocketCount; i++)
+        if(tcpudpReceiveSockets[i] >= 0)
+            while(recv(tcpudpReceiveSockets[i], buffer, sizeof(buffer), MSG_DONTWAIT) > 0)
+                nbDrained++;
+    return nbDrained;
+}
+
+bool DirectProber::usesSourcePortsWithin(unsigned short lowerBound, unsigned short upperBound)
+{
+    // ICMP identifiers are not tied to any socket
+    if(tcpudpReceiveSockets == 0)
+        return true;
+    
+    for(int i = 0; i < tcpudpReceiveSocketCount; i++)
+        if(tcpudpReceivePorts[i] <= lowerBound || tcpudpReceivePorts[i] >= upperBound)
+            return false;
+    return true;
+}
+
 unsigned short DirectProber::getAvailableSrcPortICMPid(bool useFixedFlowID)
 {
     if(probingProtocol == IPPROTO_TCP || probingProtocol == IPPROTO_UDP)
@@ -624,7 +694,7 @@ unsigned short DirectProber::getAvailableDstPortICMPseq(bool useFixedFlowID)
     if(probingProtocol == IPPROTO_TCP || probingProtocol == IPPROTO_UDP)
     {
         if(useFixedFlowID == true)
-            return lowerBoundDstPortICMPseq + ((upperBoundDstPortICMPseq - lowerBoundDstPortICMPseq) / 2); // Just use the middle destination port
+            return lowerBoundDstPortICMPseq + ((upperBoundDstPortICMPseq - lowerBoundDstPortICMPseq) / 2) + flowID; // Just use the middle destination port (shifted by the flow ID)
         else
             return lowerBoundDstPortICMPseq + (rand() % (upperBoundDstPortICMPseq - lowerBoundDstPortICMPseq));
     }
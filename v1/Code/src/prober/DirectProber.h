@@ -32,6 +32,8 @@ using std::endl;
 #include "exception/SocketReceiveException.h"
 #include "../common/date/TimeVal.h"
 
+class ReplyDispatcher;
+
 class DirectProber
 {
 public:
@@ -192,9 +194,48 @@ public:
     
     inline unsigned int getNbProbes() { return this->nbProbes; }
     inline unsigned int getNbSuccessfulProbes() { return this->nbSuccessfulProbes; }
+    
+    /*
+     * Shared reception path (see ReplyDispatcher, e.g. FanoutReceiver or IOUringEngine). When 
+     * set, probers created afterwards do not open their own raw ICMP socket and receive the 
+     * replies through the shared path (which may also send the probes). It must be set (or 
+     * reset to NULL) while no prober exists.
+     */
+    
+    static void setReplyDispatcher(ReplyDispatcher *dispatcher) { replyDispatcher = dispatcher; }
+    static ReplyDispatcher *getReplyDispatcher() { return replyDispatcher; }
+    
+    /*
+     * Methods used by ProberPool to re-use a prober for a new task, without re-opening its 
+     * sockets. reparameterize() also resets the probe amounts and the log, and drains the 
+     * replies which reached the receive sockets while the prober was idle.
+     */
+    
+    void reparameterize(const TimeVal &timeout, 
+                        const TimeVal &probeRegulatingPausePeriod, 
+                        unsigned short lowerBoundSrcPortICMPid, 
+                        unsigned short upperBoundSrcPortICMPid, 
+                        unsigned short lowerBoundDstPortICMPseq, 
+                        unsigned short upperBoundDstPortICMPseq, 
+                        bool verbose);
+    bool usesSourcePortsWithin(unsigned short lowerBound, unsigned short upperBound);
+    
+    /*
+     * Flow identifier of the fixed flow probes (0 by default, reset by reparameterize()). It is 
+     * added to the constant ICMP checksum or to the destination port (UDP, TCP), such that 
+     * distinct values give distinct flows through per-flow load balancers.
+     */
+    
+    inline void setFlowID(unsigned short flowID) { this->flowID = flowID; }
+    inline unsigned short getFlowID() { return this->flowID; }
 
 protected:
 
+    // The probe pipeline (see pipeline/ProbePipeline.h) builds, sends and receives on behalf of subclasses
+    template<class Policy> friend class ProbePipeline;
+
+    static ReplyDispatcher *replyDispatcher;
+
     // Prepares and sends a probe packet.
     ProbeRecord *singleProbe(const InetAddress &src, 
             const InetAddress &dst, 
@@ -311,6 +352,9 @@ protected:
     }
 
     int getNextActiveTCPUDPreceiveSocketIndex();
+    
+    // Reads (without waiting) and discards the packets waiting on the receive sockets
+    unsigned int drainReceiveSockets();
     int getPreviousActiveTCPUDPreceiveSocketIndex();
 
     string attentionMessage;
@@ -329,11 +373,12 @@ protected:
     
     // N.B.: "SrcPortICMPid" means "source port OR ICMP Id"
     
-    const unsigned short lowerBoundSrcPortICMPid;
-    const unsigned short upperBoundSrcPortICMPid;
-    const unsigned short lowerBoundDstPortICMPseq;
-    const unsigned short upperBoundDstPortICMPseq;
+    unsigned short lowerBoundSrcPortICMPid;
+    unsigned short upperBoundSrcPortICMPid;
+    unsigned short lowerBoundDstPortICMPseq;
+    unsigned short upperBoundDstPortICMPseq;
     unsigned long long probeCountStatistic;
+    unsigned short flowID;
     
     // Fields to handle verbose/debug mode, via small logs displayed from time to time.
     
@@ -0,0 +1,205 @@
+/*
+ * FanoutReceiver.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in FanoutReceiver.h (see this file to learn further about the goals
+ * of such class).
+ */
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <net/ethernet.h>
+#include <linux/if_packet.h>
+#include <linux/filter.h>
+#include <cerrno>
+#include <cstring>
+
+#include "FanoutReceiver.h"
+#include "FanoutReceptionUnit.h"
+
+/*
+ * Program run by the kernel to pick the worker receiving a packet. With X being the length of
+ * the outer IP header, it returns:
+ * -the identifier of an ICMP echo/timestamp reply (at X + 4),
+ * -for time exceeded and destination unreachable messages, the ICMP identifier (quoted ICMP
+ *  probe) or the source port (quoted UDP/TCP probe) found after the quoted IP header,
+ * -the destination port of a TCP segment (i.e., the source port of the probe),
+ * -0 otherwise.
+ * The kernel then delivers the packet to the socket (returned value % amount of sockets). This
+ * is the same computation as ReplyDispatcher::extractKey(), so that each worker dispatches
+ * packets to its own slice of subscriptions.
+ */
+
+static struct sock_filter FANOUT_PROGRAM[] = {
+    BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),                  // 0: X = outer IP header length
+    BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9),                   // 1: A = protocol
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_TCP, 21, 0), // 2: TCP -> 24
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_ICMP, 0, 22),// 3: not ICMP -> 26
+    BPF_STMT(BPF_LD | BPF_B | BPF_IND, 0),                   // 4: A = ICMP type
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 3, 0),            // 5: echo reply -> 9
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 14, 2, 0),           // 6: timestamp reply -> 9
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 11, 3, 0),           // 7: time exceeded -> 11
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 3, 2, 17),           // 8: unreachable -> 11, else -> 26
+    BPF_STMT(BPF_LD | BPF_H | BPF_IND, 4),                   // 9: A = ICMP identifier
+    BPF_STMT(BPF_RET | BPF_A, 0),                            // 10
+    BPF_STMT(BPF_LD | BPF_B | BPF_IND, 17),                  // 11: A = quoted protocol
+    BPF_STMT(BPF_ST, 0),                                     // 12: M[0] = A
+    BPF_STMT(BPF_LD | BPF_B | BPF_IND, 8),                   // 13: A = quoted version/IHL
+    BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0xf),                // 14
+    BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 2),                  // 15: A = quoted IP header length
+    BPF_STMT(BPF_ALU | BPF_ADD | BPF_X, 0),                  // 16
+    BPF_STMT(BPF_MISC | BPF_TAX, 0),                         // 17: X = both header lengths
+    BPF_STMT(BPF_LD | BPF_MEM, 0),                           // 18: A = quoted protocol
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_ICMP, 0, 2), // 19: not ICMP -> 22
+    BPF_STMT(BPF_LD | BPF_H | BPF_IND, 12),                  // 20: A = quoted ICMP identifier
+    BPF_STMT(BPF_RET | BPF_A, 0),                            // 21
+    BPF_STMT(BPF_LD | BPF_H | BPF_IND, 8),                   // 22: A = quoted source port
+    BPF_STMT(BPF_RET | BPF_A, 0),                            // 23
+    BPF_STMT(BPF_LD | BPF_H | BPF_IND, 2),                   // 24: A = TCP destination port
+    BPF_STMT(BPF_RET | BPF_A, 0),                            // 25
+    BPF_STMT(BPF_RET | BPF_K, 0)                             // 26
+};
+
+/*
+ * Socket filter: keeps ICMP packets and, if the instruction 2 is set to IPPROTO_TCP, TCP resets.
+ * Everything else is dropped before reaching the sockets.
+ */
+
+static const unsigned int SOCKET_FILTER_TCP_INSTRUCTION = 2;
+static const struct sock_filter SOCKET_FILTER[] = {
+    BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9),                   // 0: A = protocol
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_ICMP, 4, 0), // 1: ICMP -> 6
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 256, 0, 4),          // 2: no match -> 7 (see above)
+    BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),                  // 3: X = IP header length
+    BPF_STMT(BPF_LD | BPF_B | BPF_IND, 13),                  // 4: A = TCP flags
+    BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x04, 0, 1),        // 5: RST -> 6, else -> 7
+    BPF_STMT(BPF_RET | BPF_K, 0xffff),                       // 6
+    BPF_STMT(BPF_RET | BPF_K, 0)                             // 7
+};
+
+FanoutReceiver::FanoutReceiver(unsigned short nbWorkers, bool acceptTCP) throw(SocketException):
+ReplyDispatcher(nbWorkers > MAX_NB_WORKERS ? MAX_NB_WORKERS : nbWorkers),
+stopMutex(Mutex::ERROR_CHECKING_MUTEX),
+stopping(false)
+{
+    // One slice of subscriptions per worker (see ReplyDispatcher)
+    this->nbWorkers = this->nbSlices;
+
+    sockets = new int[nbWorkers];
+    workers = new Thread*[nbWorkers];
+    for(unsigned short i = 0; i < nbWorkers; i++)
+    {
+        sockets[i] = -1;
+        workers[i] = NULL;
+    }
+
+    // Socket filter, adapted to the probing protocol
+    struct sock_filter socketFilterCode[8];
+    memcpy(socketFilterCode, SOCKET_FILTER, sizeof(SOCKET_FILTER));
+    if(acceptTCP)
+        socketFilterCode[SOCKET_FILTER_TCP_INSTRUCTION].k = IPPROTO_TCP;
+
+    struct sock_fprog socketFilter;
+    socketFilter.len = sizeof(SOCKET_FILTER) / sizeof(SOCKET_FILTER[0]);
+    socketFilter.filter = socketFilterCode;
+
+    // The group identifier only needs to be unique among the groups of this host
+    int fanoutArgument = (getpid() & 0xffff) | (PACKET_FANOUT_CBPF << 16);
+
+    for(unsigned short i = 0; i < nbWorkers; i++)
+    {
+        if((sockets[i] = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_IP))) == -1)
+        {
+            closeSockets();
+            if(errno == EPERM || errno == EACCES)
+                throw SocketException("Can NOT create packet socket. The process does not have appropriate privileges.");
+            throw SocketException("Can NOT create packet socket.");
+        }
+
+        if(setsockopt(sockets[i], SOL_SOCKET, SO_ATTACH_FILTER, &socketFilter, sizeof(socketFilter)) < 0)
+        {
+            closeSockets();
+            throw SocketException("Can NOT attach the filter to the packet socket.");
+        }
+
+        // Only available since Linux 4.20; reception units also check the packet type
+        const int ignoreOutgoing = 1;
+        setsockopt(sockets[i], SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignoreOutgoing, sizeof(ignoreOutgoing));
+
+        if(setsockopt(sockets[i], SOL_PACKET, PACKET_FANOUT, &fanoutArgument, sizeof(fanoutArgument)) < 0)
+        {
+            closeSockets();
+            throw SocketException("Can NOT join the packet fanout group (PACKET_FANOUT_CBPF requires Linux 4.3).");
+        }
+    }
+
+    // The program is shared by the whole group, so setting it on the first socket is enough
+    struct sock_fprog fanoutProgram;
+    fanoutProgram.len = sizeof(FANOUT_PROGRAM) / sizeof(FANOUT_PROGRAM[0]);
+    fanoutProgram.filter = FANOUT_PROGRAM;
+    if(setsockopt(sockets[0], SOL_PACKET, PACKET_FANOUT_DATA, &fanoutProgram, sizeof(fanoutProgram)) < 0)
+    {
+        closeSockets();
+        throw SocketException("Can NOT set the program of the packet fanout group.");
+    }
+}
+
+FanoutReceiver::~FanoutReceiver()
+{
+    this->stop();
+    closeSockets();
+
+    delete[] workers;
+    delete[] sockets;
+}
+
+void FanoutReceiver::closeSockets()
+{
+    for(unsigned short i = 0; i < nbWorkers; i++)
+    {
+        if(sockets[i] >= 0)
+        {
+            close(sockets[i]);
+            sockets[i] = -1;
+        }
+    }
+}
+
+void FanoutReceiver::start() throw(ThreadException)
+{
+    for(unsigned short i = 0; i < nbWorkers; i++)
+    {
+        workers[i] = new Thread(new FanoutReceptionUnit(this, i));
+        workers[i]->start();
+    }
+}
+
+void FanoutReceiver::stop()
+{
+    stopMutex.lock();
+    stopping = true;
+    stopMutex.unlock();
+
+    for(unsigned short i = 0; i < nbWorkers; i++)
+    {
+        if(workers[i] != NULL)
+        {
+            workers[i]->join();
+            delete workers[i];
+            workers[i] = NULL;
+        }
+    }
+}
+
+bool FanoutReceiver::isStopping()
+{
+    bool result = false;
+    stopMutex.lock();
+    result = stopping;
+    stopMutex.unlock();
+    return result;
+}
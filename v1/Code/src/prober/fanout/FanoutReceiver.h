@@ -0,0 +1,75 @@
+/*
+ * FanoutReceiver.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * This class implements an alternative reception path for the replies to the probes. Normally,
+ * each DirectProber object opens its own raw ICMP socket, which means the kernel copies every
+ * single incoming ICMP packet to every prober; with a large amount of probing threads, most of
+ * the reception time is spent discarding packets which belong to other threads.
+ *
+ * With this class, a small amount of AF_PACKET sockets (one per reception worker) are joined in
+ * a PACKET_FANOUT group. A classic BPF program, run by the kernel for each incoming packet,
+ * extracts the ICMP identifier or the source port of the probe the packet replies to (from the
+ * echo reply itself, from the quoted header of a time exceeded/destination unreachable message
+ * or from the destination port of a TCP reset) and the kernel delivers the packet to the worker
+ * (identifier % amount of workers). Each worker then dispatches the packet to the prober which
+ * subscribed to this identifier (see FanoutSubscription), which will perform the usual checks
+ * on the reply. Probers therefore no longer need their own ICMP socket.
+ *
+ * The subscriptions are split in as many slices as there are workers (see ReplyDispatcher), so
+ * that workers never compete with each other for the same lock.
+ */
+
+#ifndef FANOUTRECEIVER_H_
+#define FANOUTRECEIVER_H_
+
+#include "ReplyDispatcher.h"
+#include "../exception/SocketException.h"
+#include "../../common/thread/Thread.h"
+#include "../../common/thread/Mutex.h"
+
+class FanoutReceiver : public ReplyDispatcher
+{
+public:
+
+    static const unsigned short MAX_NB_WORKERS = 64;
+    static const size_t RECEPTION_BUFFER_SIZE = 512;
+
+    // Time (in ms) after which a worker checks if it should stop when no packet arrives
+    static const int POLLING_PERIOD = 100;
+
+    /*
+     * Opens the sockets and joins them to the fanout group; throws a SocketException if the
+     * kernel does not support PACKET_FANOUT with a BPF program (Linux < 4.3) or if the process
+     * lacks privileges. "acceptTCP" must be true when probing with TCP (to capture resets).
+     */
+
+    FanoutReceiver(unsigned short nbWorkers, bool acceptTCP) throw(SocketException);
+    ~FanoutReceiver();
+
+    // Starts and stops the reception workers
+    void start() throw(ThreadException);
+    void stop();
+
+    // Methods used by the reception workers
+    int getSocket(unsigned short index) { return sockets[index]; }
+    bool isStopping();
+
+    inline unsigned short getNbWorkers() { return this->nbWorkers; }
+
+private:
+
+    unsigned short nbWorkers;
+    int *sockets;
+
+    Thread **workers;
+    Mutex stopMutex;
+    bool stopping;
+
+    void closeSockets();
+
+};
+
+#endif /* FANOUTRECEIVER_H_ */
@@ -0,0 +1,64 @@
+/*
+ * FanoutReceptionUnit.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in FanoutReceptionUnit.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <cerrno>
+
+#include "FanoutReceptionUnit.h"
+
+FanoutReceptionUnit::FanoutReceptionUnit(FanoutReceiver *parent, unsigned short index)
+{
+    this->parent = parent;
+    this->index = index;
+}
+
+FanoutReceptionUnit::~FanoutReceptionUnit()
+{
+}
+
+void FanoutReceptionUnit::run()
+{
+    uint8_t buffer[FanoutReceiver::RECEPTION_BUFFER_SIZE];
+    struct pollfd pfd;
+    pfd.fd = parent->getSocket(index);
+    pfd.events = POLLIN;
+
+    while(!parent->isStopping())
+    {
+        pfd.revents = 0;
+        int pollResult = poll(&pfd, 1, FanoutReceiver::POLLING_PERIOD);
+        if(pollResult <= 0)
+            continue;
+
+        // Empties the socket before polling again
+        while(true)
+        {
+            struct sockaddr_ll from;
+            socklen_t fromLength = sizeof(from);
+            ssize_t receivedBytes = recvfrom(pfd.fd,
+                                             buffer,
+                                             FanoutReceiver::RECEPTION_BUFFER_SIZE,
+                                             MSG_DONTWAIT,
+                                             (struct sockaddr*) &from,
+                                             &fromLength);
+
+            if(receivedBytes <= 0)
+                break;
+
+            // Packets sent by this host are of no interest (older kernels still deliver them)
+            if(from.sll_pkttype == PACKET_OUTGOING)
+                continue;
+
+            parent->dispatch(buffer, (size_t) receivedBytes);
+        }
+    }
+}
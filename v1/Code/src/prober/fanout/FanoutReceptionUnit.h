@@ -0,0 +1,34 @@
+/*
+ * FanoutReceptionUnit.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * This class, inheriting Runnable, is the body of one reception worker of FanoutReceiver. It
+ * reads the packets the kernel delivered to its AF_PACKET socket and hands them to the receiver,
+ * which dispatches them to the subscribed probers. It polls with a short period in order to
+ * notice when the receiver is being stopped.
+ */
+
+#ifndef FANOUTRECEPTIONUNIT_H_
+#define FANOUTRECEPTIONUNIT_H_
+
+#include "../../common/thread/Runnable.h"
+#include "FanoutReceiver.h"
+
+class FanoutReceptionUnit : public Runnable
+{
+public:
+
+    FanoutReceptionUnit(FanoutReceiver *parent, unsigned short index);
+    ~FanoutReceptionUnit();
+    void run();
+
+private:
+
+    FanoutReceiver *parent;
+    unsigned short index;
+
+};
+
+#endif /* FANOUTRECEPTIONUNIT_H_ */
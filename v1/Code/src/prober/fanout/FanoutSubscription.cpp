@@ -0,0 +1,99 @@
+/*
+ * FanoutSubscription.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in FanoutSubscription.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <cstring>
+#include <cerrno>
+
+#include "FanoutSubscription.h"
+
+FanoutSubscription::FanoutSubscription(ReplyDispatcher *receiver, unsigned short key)
+{
+    this->receiver = receiver;
+    this->key = key;
+    this->packetArrival = NULL;
+    this->sendError = 0;
+
+    if(this->receiver != NULL)
+    {
+        this->packetArrival = new ConditionVariable(this->receiver->getSliceMutex(key));
+        this->receiver->subscribe(this);
+    }
+}
+
+FanoutSubscription::~FanoutSubscription()
+{
+    if(this->receiver != NULL)
+    {
+        this->receiver->unsubscribe(this);
+        delete this->packetArrival;
+    }
+}
+
+ssize_t FanoutSubscription::nextPacket(uint8_t *buffer, size_t bufferSize, const TimeVal &wait)
+{
+    if(this->receiver == NULL)
+        return 0;
+
+    // Rounds up to the next millisecond (a remaining time of a few µs still deserves a wait)
+    unsigned long int waitMs = (unsigned long int) wait.getSecondsPart() * 1000;
+    waitMs += (unsigned long int) (wait.getMicroSecondsPart() + 999) / 1000;
+
+    packetArrival->lock();
+    if(pendingPackets.size() == 0 && sendError == 0 && waitMs > 0)
+    {
+        try
+        {
+            packetArrival->wait(waitMs);
+        }
+        catch(TimedOutException &e)
+        {
+        }
+        catch(ConditionVariableException &e)
+        {
+        }
+    }
+
+    if(pendingPackets.size() == 0)
+    {
+        int error = sendError;
+        packetArrival->unlock();
+        if(error != 0)
+        {
+            errno = error;
+            return -1;
+        }
+        return 0;
+    }
+
+    string packet = pendingPackets.front();
+    pendingPackets.pop_front();
+    packetArrival->unlock();
+
+    size_t length = packet.length();
+    if(length > bufferSize)
+        length = bufferSize;
+    memcpy(buffer, packet.data(), length);
+    return (ssize_t) length;
+}
+
+void FanoutSubscription::push(const uint8_t *packet, size_t length)
+{
+    if(pendingPackets.size() >= MAX_PENDING_PACKETS)
+        pendingPackets.pop_front();
+
+    pendingPackets.push_back(string((const char*) packet, length));
+    packetArrival->signal();
+}
+
+void FanoutSubscription::pushFailure(int error)
+{
+    sendError = error;
+    packetArrival->signal();
+}
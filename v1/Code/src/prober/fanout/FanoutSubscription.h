@@ -0,0 +1,66 @@
+/*
+ * FanoutSubscription.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Small object created on the stack by a prober before sending a probe, and through which the
+ * prober receives the packets a shared reception path (see ReplyDispatcher) dispatched to it,
+ * i.e., packets which reply to a probe with the same ICMP identifier/source port. The
+ * subscription ends with the object, so every return path of a probing method (including
+ * exceptions) unsubscribes automatically.
+ *
+ * If the receiver is NULL (no shared reception path), the object does nothing and isActive()
+ * returns false, in which case the prober should listen on its own sockets as usual.
+ */
+
+#ifndef FANOUTSUBSCRIPTION_H_
+#define FANOUTSUBSCRIPTION_H_
+
+#include <inttypes.h>
+#include <sys/types.h>
+#include <string>
+using std::string;
+#include <list>
+using std::list;
+
+#include "ReplyDispatcher.h"
+#include "../../common/thread/ConditionVariable.h"
+#include "../../common/date/TimeVal.h"
+
+class FanoutSubscription
+{
+public:
+
+    // Maximum amount of packets waiting to be read by the prober
+    static const unsigned short MAX_PENDING_PACKETS = 8;
+
+    FanoutSubscription(ReplyDispatcher *receiver, unsigned short key);
+    ~FanoutSubscription();
+
+    inline bool isActive() { return this->receiver != NULL; }
+    inline unsigned short getKey() { return this->key; }
+
+    /*
+     * Copies the next dispatched packet in the buffer, waiting at most "wait". Returns the
+     * amount of copied bytes, 0 if no packet arrived in time or -1 (errno being set) if the 
+     * shared path reported that the probe could not be sent.
+     */
+
+    ssize_t nextPacket(uint8_t *buffer, size_t bufferSize, const TimeVal &wait);
+
+    // Called by the receiver, while holding the mutex of the slice of this subscription
+    void push(const uint8_t *packet, size_t length);
+    void pushFailure(int error);
+
+private:
+
+    ReplyDispatcher *receiver;
+    unsigned short key;
+    ConditionVariable *packetArrival;
+    list<string> pendingPackets;
+    int sendError; // errno value of a failed send (0 if none)
+
+};
+
+#endif /* FANOUTSUBSCRIPTION_H_ */
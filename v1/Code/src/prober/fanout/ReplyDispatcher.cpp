@@ -0,0 +1,159 @@
+/*
+ * ReplyDispatcher.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in ReplyDispatcher.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <netinet/ip.h>
+#include <utility>
+using std::pair;
+
+#include "ReplyDispatcher.h"
+#include "FanoutSubscription.h"
+
+ReplyDispatcher::ReplyDispatcher(unsigned short nbSlices)
+{
+    if(nbSlices == 0)
+        nbSlices = 1;
+    this->nbSlices = nbSlices;
+
+    sliceMutexes = new Mutex*[nbSlices];
+    slices = new multimap<unsigned short, FanoutSubscription*>[nbSlices];
+    for(unsigned short i = 0; i < nbSlices; i++)
+        sliceMutexes[i] = new Mutex(Mutex::ERROR_CHECKING_MUTEX);
+}
+
+ReplyDispatcher::~ReplyDispatcher()
+{
+    for(unsigned short i = 0; i < nbSlices; i++)
+        delete sliceMutexes[i];
+    delete[] sliceMutexes;
+    delete[] slices;
+}
+
+bool ReplyDispatcher::queueSend(const uint8_t *packet, 
+                                size_t length, 
+                                const struct sockaddr_in &to, 
+                                unsigned short key)
+{
+    return false;
+}
+
+void ReplyDispatcher::subscribe(FanoutSubscription *sub)
+{
+    unsigned short key = sub->getKey();
+    unsigned short slice = key % nbSlices;
+
+    sliceMutexes[slice]->lock();
+    slices[slice].insert(pair<unsigned short, FanoutSubscription*>(key, sub));
+    sliceMutexes[slice]->unlock();
+}
+
+void ReplyDispatcher::unsubscribe(FanoutSubscription *sub)
+{
+    unsigned short key = sub->getKey();
+    unsigned short slice = key % nbSlices;
+
+    sliceMutexes[slice]->lock();
+    multimap<unsigned short, FanoutSubscription*>::iterator it = slices[slice].lower_bound(key);
+    while(it != slices[slice].end() && it->first == key)
+    {
+        if(it->second == sub)
+        {
+            slices[slice].erase(it);
+            break;
+        }
+        ++it;
+    }
+    sliceMutexes[slice]->unlock();
+}
+
+void ReplyDispatcher::dispatch(const uint8_t *packet, size_t length)
+{
+    unsigned short key = 0;
+    if(!extractKey(packet, length, &key))
+        return;
+
+    /*
+     * Several subscriptions may share a key (e.g., two probers with overlapping identifier
+     * ranges). Each of them gets the packet and checks by itself whether it is a reply.
+     */
+
+    unsigned short slice = key % nbSlices;
+    sliceMutexes[slice]->lock();
+    multimap<unsigned short, FanoutSubscription*>::iterator it = slices[slice].lower_bound(key);
+    while(it != slices[slice].end() && it->first == key)
+    {
+        it->second->push(packet, length);
+        ++it;
+    }
+    sliceMutexes[slice]->unlock();
+}
+
+void ReplyDispatcher::dispatchFailure(unsigned short key, int error)
+{
+    /*
+     * Subscriptions sharing the key all get the failure, as with replies. The failure of a probe 
+     * whose prober stopped listening (i.e., no subscription anymore) is simply lost.
+     */
+
+    unsigned short slice = key % nbSlices;
+    sliceMutexes[slice]->lock();
+    multimap<unsigned short, FanoutSubscription*>::iterator it = slices[slice].lower_bound(key);
+    while(it != slices[slice].end() && it->first == key)
+    {
+        it->second->pushFailure(error);
+        ++it;
+    }
+    sliceMutexes[slice]->unlock();
+}
+
+bool ReplyDispatcher::extractKey(const uint8_t *packet, size_t length, unsigned short *key)
+{
+    if(length < 20 || (packet[0] >> 4) != 4)
+        return false;
+
+    size_t outerLength = (size_t) (packet[0] & 0xf) * 4;
+    uint8_t protocol = packet[9];
+
+    if(protocol == IPPROTO_TCP)
+    {
+        if(length < outerLength + 4)
+            return false;
+        *key = (unsigned short) ((packet[outerLength + 2] << 8) | packet[outerLength + 3]);
+        return true;
+    }
+    else if(protocol != IPPROTO_ICMP || length < outerLength + 8)
+    {
+        return false;
+    }
+
+    uint8_t type = packet[outerLength];
+    if(type == 0 || type == 14)
+    {
+        *key = (unsigned short) ((packet[outerLength + 4] << 8) | packet[outerLength + 5]);
+        return true;
+    }
+    else if(type != 11 && type != 3)
+    {
+        return false;
+    }
+
+    // Quoted IP header starts at outerLength + 8
+    if(length < outerLength + 8 + 20)
+        return false;
+
+    uint8_t quotedProtocol = packet[outerLength + 8 + 9];
+    size_t offset = outerLength + 8 + (size_t) (packet[outerLength + 8] & 0xf) * 4;
+    if(quotedProtocol == IPPROTO_ICMP)
+        offset += 4;
+    if(length < offset + 2)
+        return false;
+
+    *key = (unsigned short) ((packet[offset] << 8) | packet[offset + 1]);
+    return true;
+}
@@ -0,0 +1,84 @@
+/*
+ * ReplyDispatcher.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Base class of the shared reception paths (FanoutReceiver, IOUringEngine). Such a path reads
+ * the replies on behalf of all probers and hands each of them to the prober(s) which subscribed
+ * (see FanoutSubscription) to the identifier the reply refers to, i.e., the ICMP identifier or
+ * the source port of the probe.
+ *
+ * Subscriptions are split in several slices (each with its own mutex) so that the threads which
+ * dispatch replies do not compete for a single lock. The slices are not single-writer: a prober
+ * thread locks the mutex of its slice to subscribe and unsubscribe (once per probe), and so does
+ * the thread which dispatches the replies of this slice. Handing subscriptions over through a
+ * queue would remove this lock, but an unsubscription must take effect before the subscription
+ * (an object on the stack of the prober) is destroyed, so the prober would have to wait for the
+ * dispatching thread anyway. The lock is held for a few map operations, and the same mutex is
+ * needed to wake the waiting prober up (see FanoutSubscription).
+ *
+ * A shared path may also take over the sending of the probes (see queueSend()); by default,
+ * probers send them by themselves. A path which sends the probes reports the failed sends to the
+ * subscription(s) of the probe (see dispatchFailure()), so that the prober gets a
+ * SocketSendException as if it had sent the probe by itself.
+ */
+
+#ifndef REPLYDISPATCHER_H_
+#define REPLYDISPATCHER_H_
+
+#include <inttypes.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <map>
+using std::multimap;
+
+#include "../../common/thread/Mutex.h"
+
+class FanoutSubscription;
+
+class ReplyDispatcher
+{
+public:
+
+    ReplyDispatcher(unsigned short nbSlices);
+    virtual ~ReplyDispatcher();
+
+    // Subscription handling (used by FanoutSubscription)
+    void subscribe(FanoutSubscription *sub);
+    void unsubscribe(FanoutSubscription *sub);
+    Mutex *getSliceMutex(unsigned short key) { return sliceMutexes[key % nbSlices]; }
+
+    // Hands a received packet to the subscription(s) matching its identifier
+    void dispatch(const uint8_t *packet, size_t length);
+    
+    // Reports a failed send (errno value) to the subscription(s) matching the probe identifier
+    void dispatchFailure(unsigned short key, int error);
+
+    /*
+     * Takes over the sending of a probe (the packet is copied); key is the identifier of the 
+     * probe (see extractKey()). Returns false if the probe was not queued, in which case the 
+     * prober must send it by itself (default behaviour).
+     */
+
+    virtual bool queueSend(const uint8_t *packet, 
+                           size_t length, 
+                           const struct sockaddr_in &to, 
+                           unsigned short key);
+
+    /*
+     * Extracts the identifier (ICMP identifier or source port of the probe) a packet replies
+     * to. Returns false if the packet cannot be a reply to a probe.
+     */
+
+    static bool extractKey(const uint8_t *packet, size_t length, unsigned short *key);
+
+protected:
+
+    unsigned short nbSlices;
+    Mutex **sliceMutexes;
+    multimap<unsigned short, FanoutSubscription*> *slices;
+
+};
+
+#endif /* REPLYDISPATCHER_H_ */
@@ -72,23 +72,6 @@ private:
 
 protected:
 
-    ProbeRecord *buildProbeRecord(const auto_ptr<TimeVal> &reqTime, 
-                                  const InetAddress &dstAddress, 
-                                  const InetAddress &rplyAddress, 
-                                  unsigned char reqTTL, 
-                                  unsigned char rplyTTL, 
-                                  unsigned char replyType, 
-                                  unsigned char rplyCode, 
-                                  unsigned short srcIPidentifier, 
-                                  unsigned short rplyIPidentifier, 
-                                  unsigned char payloadTTL, 
-                                  unsigned short payloadLength, 
-                                  unsigned long originateTs, 
-                                  unsigned long receiveTs, 
-                                  unsigned long transmitTs, 
-                                  int probingCost, 
-                                  bool usingFixedFlowID);
-    
     uint8_t buffer[DEFAULT_DIRECT_ICMP_PROBER_BUFFER_SIZE];
     
 };
@@ -0,0 +1,422 @@
+/*
+ * ProbePipeline.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Probe pipeline shared by all probers: builds the probe, sends it, then receives and classifies
+ * the replies until one matches the probe or the timeout expires. It is parameterized by a
+ * protocol policy (see ProbePolicies.h) which provides everything that depends on the protocol,
+ * so that each instantiation (ICMP, UDP, TCP) is compiled as a single routine where building,
+ * matching and classifying are fully inlined, without virtual calls per packet.
+ *
+ * The probers (DirectICMPProber, DirectUDPProber, etc.) are thin adapters which fill a
+ * ProbeContext and call probe() with the appropriate policy. ProbePipeline is a friend of
+ * DirectProber, as it uses its sockets, its logs and its probe counters.
+ */
+
+#ifndef PROBEPIPELINE_H_
+#define PROBEPIPELINE_H_
+
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+using std::auto_ptr;
+#include <sys/select.h>
+#include <sys/socket.h>
+
+#include "ProbePolicies.h"
+#include "../DirectProber.h"
+#include "../fanout/ReplyDispatcher.h"
+#include "../fanout/FanoutSubscription.h"
+
+template<class Policy> class ProbePipeline
+{
+public:
+
+    static ProbeRecord *probe(DirectProber &prober,
+                              uint8_t *buffer,
+                              size_t bufferSize,
+                              uint8_t *pseudoBuffer,
+                              ProbeContext &c) throw(SocketSendException, SocketReceiveException);
+
+    /*
+     * The two next methods are also public for components which send and receive on their own 
+     * sockets (e.g. the asynchronous traceroute engine, see AsyncTracerouteEngine).
+     */
+
+    // Builds the whole packet in the buffer and returns its length
+    static inline uint16_t build(uint8_t *buffer, uint8_t *pseudoBuffer, ProbeContext &c);
+
+    /*
+     * Checks the IP header and the ICMP checksum of a received packet, then lets the policy
+     * match it with the probe. Returns a description of the rejection reason (for the log) or
+     * NULL if the packet is a reply to the probe.
+     */
+
+    static inline const char *classify(uint8_t *packet,
+                                       ssize_t receivedBytes,
+                                       ProbeContext &c,
+                                       unsigned short *payloadLength,
+                                       uint8_t *replyTTL,
+                                       unsigned short *replyIPIdentifier,
+                                       InetAddress *replyAddress);
+
+private:
+
+    static inline ProbeRecord *buildProbeRecord(TimeVal &reqTime,
+                                                const ProbeContext &c,
+                                                const InetAddress &rplyAddress,
+                                                unsigned char rplyTTL,
+                                                unsigned short rplyIPidentifier,
+                                                unsigned short payloadLength);
+
+};
+
+template<class Policy>
+inline uint16_t ProbePipeline<Policy>::build(uint8_t *buffer, uint8_t *pseudoBuffer, ProbeContext &c)
+{
+    uint16_t IPHeaderLength = DirectProber::MINIMUM_IP_HEADER_LENGTH;
+    uint16_t totalPacketLength = IPHeaderLength + Policy::getTransportLength(c);
+
+    struct ip *ip = (struct ip*) buffer;
+    ip->ip_v = DirectProber::DEFAULT_IP_VERSION;
+    ip->ip_hl = IPHeaderLength / 4; // In terms of 4 byte units
+    ip->ip_tos = DirectProber::DEFAULT_IP_TOS;
+    ip->ip_len = htons(totalPacketLength);
+    ip->ip_id = htons((uint16_t) c.IPIdentifier);
+    ip->ip_off = htons(DirectProber::DEFAULT_IP_FRAGMENT_OFFSET);
+    ip->ip_ttl = (uint8_t) c.TTL;
+    ip->ip_p = Policy::PROTOCOL;
+    (ip->ip_src).s_addr = htonl((uint32_t) c.src->getULongAddress());
+    (ip->ip_dst).s_addr = htonl((uint32_t) c.dst->getULongAddress());
+
+    // Even though IP checksum is 2 bytes long we don't need to apply htons() or ntohs() on this field
+    ip->ip_sum = 0x0;
+    ip->ip_sum = DirectProber::calculateInternetChecksum((uint16_t*) buffer, IPHeaderLength);
+
+    Policy::buildTransport(buffer, IPHeaderLength, pseudoBuffer, c);
+    return totalPacketLength;
+}
+
+template<class Policy>
+inline const char *ProbePipeline<Policy>::classify(uint8_t *packet,
+                                                   ssize_t receivedBytes,
+                                                   ProbeContext &c,
+                                                   unsigned short *payloadLength,
+                                                   uint8_t *replyTTL,
+                                                   unsigned short *replyIPIdentifier,
+                                                   InetAddress *replyAddress)
+{
+    struct ip *ip = (struct ip*) packet;
+    if(ip->ip_v != DirectProber::DEFAULT_IP_VERSION)
+        return "Received packet is not IPv4. Continue receiving...\n";
+    if(receivedBytes < DirectProber::MINIMUM_IP_HEADER_LENGTH)
+        return "Received less bytes than minimum header length. Continue receiving...\n";
+
+    uint16_t receivedIPtotalLength = ntohs(ip->ip_len);
+    uint16_t receivedIPheaderLength = ((uint16_t) ip->ip_hl) * (uint16_t) 4;
+    if(receivedBytes < receivedIPtotalLength)
+        return "Received less bytes than announced in header. Continue receiving...\n";
+
+    // IP checksum is checked with the sum field set to zero, then restored
+    uint16_t tmpChecksum = ip->ip_sum;
+    ip->ip_sum = 0x0;
+    if(DirectProber::calculateInternetChecksum((uint16_t*) packet, receivedIPheaderLength) != tmpChecksum)
+        return "Error while re-computing IP header checksum. Continue receiving...\n";
+    ip->ip_sum = tmpChecksum;
+
+    typename Policy::ReplyMatch match = Policy::REPLY_UNKNOWN;
+    if(ip->ip_p == IPPROTO_ICMP)
+    {
+        struct icmphdr *icmp = (struct icmphdr*) (packet + receivedIPheaderLength);
+        tmpChecksum = icmp->checksum;
+        icmp->checksum = 0x0;
+        if(DirectProber::calculateInternetChecksum((uint16_t*) icmp, receivedIPtotalLength - receivedIPheaderLength) != tmpChecksum)
+            return "Error while re-computing ICMP header checksum. Continue receiving...\n";
+        icmp->checksum = tmpChecksum;
+
+        match = Policy::matchICMP(packet, receivedIPheaderLength, c);
+    }
+    else if(Policy::ACCEPTS_TCP && ip->ip_p == IPPROTO_TCP)
+    {
+        match = Policy::matchTCP(packet, receivedIPheaderLength, c);
+    }
+    else
+    {
+        if(Policy::PROTOCOL == IPPROTO_ICMP)
+            return "Received packet is not an ICMP one. Continue receiving...\n";
+        return "Received packet is neither ICMP neither TCP. Continue receiving...\n";
+    }
+
+    if(match == Policy::REPLY_UNKNOWN)
+        return "An unknown packet has been received. Continue receiving...\n";
+    else if(match == Policy::REPLY_NOT_FROM_TARGET)
+        return "Received a TCP reply... not coming from the target. Continue receiving...\n";
+    else if(match == Policy::REPLY_IGNORED)
+        return "";
+
+    Policy::reinterpret(c);
+    *payloadLength = (unsigned short) (receivedIPtotalLength - receivedIPheaderLength);
+    *replyTTL = ip->ip_ttl;
+    *replyIPIdentifier = ntohs(ip->ip_id);
+    *replyAddress = InetAddress((unsigned long int) ntohl((ip->ip_src).s_addr));
+    return NULL;
+}
+
+template<class Policy>
+inline ProbeRecord *ProbePipeline<Policy>::buildProbeRecord(TimeVal &reqTime,
+                                                            const ProbeContext &c,
+                                                            const InetAddress &rplyAddress,
+                                                            unsigned char rplyTTL,
+                                                            unsigned short rplyIPidentifier,
+                                                            unsigned short payloadLength)
+{
+    ProbeRecord *recordPtr = new ProbeRecord();
+    recordPtr->setReqTime(reqTime);
+    recordPtr->setRplyTime(*(TimeVal::getCurrentSystemTime()));
+    recordPtr->setDstAddress(*(c.dst));
+    recordPtr->setRplyAddress(rplyAddress);
+    recordPtr->setReqTTL(c.TTL);
+    recordPtr->setRplyTTL(rplyTTL);
+    recordPtr->setRplyICMPtype(c.replyType);
+    recordPtr->setRplyICMPcode(c.replyCode);
+    recordPtr->setSrcIPidentifier(c.IPIdentifier);
+    recordPtr->setRplyIPidentifier(rplyIPidentifier);
+    recordPtr->setPayloadTTL(c.payloadTTL);
+    recordPtr->setPayloadLength(payloadLength);
+    if(c.replyType == DirectProber::ICMP_TYPE_TS_REPLY)
+        recordPtr->setOriginateTs((unsigned long) c.originateTs);
+    else
+        recordPtr->setOriginateTs(0);
+    recordPtr->setReceiveTs(c.receiveTs);
+    recordPtr->setTransmitTs(c.transmitTs);
+    recordPtr->setProbingCost(1);
+    recordPtr->setUsingFixedFlowID(c.usingFixedFlowID);
+    return recordPtr;
+}
+
+template<class Policy>
+ProbeRecord *ProbePipeline<Policy>::probe(DirectProber &prober,
+                                          uint8_t *buffer,
+                                          size_t bufferSize,
+                                          uint8_t *pseudoBuffer,
+                                          ProbeContext &c) throw(SocketSendException, SocketReceiveException)
+{
+    prober.nbProbes++;
+
+    // 1) Prepares packet to send
+    c.replyType = 0;
+    c.replyCode = 0;
+    c.payloadTTL = 0;
+    c.receiveTs = 0;
+    c.transmitTs = 0;
+    uint16_t totalPacketLength = build(buffer, pseudoBuffer, c);
+
+    // 2) Sends the request packet
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = (((struct ip*) buffer)->ip_dst).s_addr;
+
+    // Subscribes to the shared receiver (if any) before sending, so no early reply is missed
+    ReplyDispatcher *dispatcher = DirectProber::replyDispatcher;
+    FanoutSubscription subscription(dispatcher, (uint16_t) c.srcPortICMPid);
+
+    prober.regulateProbingFrequency();
+    if(prober.verbose)
+    {
+        stringstream logStream;
+
+        // The socket identifiers are written before anything else
+        logStream << "\n[SSID = " << prober.sendSocketRAW;
+        if(prober.tcpudpReceiveSockets != NULL)
+        {
+            logStream << ", Port = " << prober.tcpudpReceivePorts[prober.activeTCPUDPReceiveSocketIndex];
+            logStream << ", RSID = " << prober.tcpudpReceiveSockets[prober.activeTCPUDPReceiveSocketIndex] << "]\n";
+        }
+        else
+        {
+            logStream << ", RSID = " << prober.icmpReceiveSocketRAW << "]\n";
+        }
+
+        // Actual details on the probe.
+        logStream << Policy::getName() << " probing:\n";
+        logStream << "Source address: " << *(c.src) << "\n";
+        logStream << "Destination address: " << *(c.dst) << "\n";
+        logStream << "IP identifier (source): " << c.IPIdentifier << "\n";
+        logStream << "Initial TTL: " << (int) c.TTL << "\n";
+        Policy::logFields(logStream, buffer + DirectProber::MINIMUM_IP_HEADER_LENGTH, c);
+
+        prober.log += logStream.str();
+    }
+
+    // The shared reception path may take over the sending (e.g. io_uring); otherwise, sends it
+    if(dispatcher == NULL || !dispatcher->queueSend(buffer, totalPacketLength, to, (uint16_t) c.srcPortICMPid))
+    {
+        ssize_t bytesSent = 0;
+        ssize_t totalBytesSent = 0;
+        do
+        {
+            bytesSent = sendto(prober.sendSocketRAW,
+                               buffer + totalBytesSent,
+                               totalPacketLength - totalBytesSent,
+                               0,
+                               (struct sockaddr*) &to,
+                               sizeof(struct sockaddr));
+            if(bytesSent == -1)
+            {
+                perror("Socket Send Exception Error Message");
+                throw SocketSendException(string("Can NOT send the ") + Policy::getName() + " packet");
+            }
+
+            totalBytesSent += bytesSent;
+        }
+        while(totalBytesSent < totalPacketLength);
+    }
+    auto_ptr<TimeVal> REQTime = TimeVal::getCurrentSystemTime();
+    prober.updateLastProbingTime();
+
+    // 3) Receives the reply packet
+    struct sockaddr_in fromAddress;
+    socklen_t fromAddressLength = sizeof(fromAddress);
+    ssize_t receivedBytes = 0;
+
+    if(prober.verbose)
+    {
+        prober.log += "Started listening for a reply...\n";
+    }
+
+    TimeVal wait;
+    while(1)
+    {
+        wait = (*REQTime) + prober.timeout;
+        auto_ptr<TimeVal> now = TimeVal::getCurrentSystemTime();
+        wait -= (*now);
+        if(wait.isUndefined())
+        {
+            wait.resetToZero();
+        }
+
+        int selectResult = 0;
+        if(subscription.isActive())
+        {
+            selectResult = (int) subscription.nextPacket(buffer, bufferSize, wait);
+        }
+        else
+        {
+            prober.RESET_SELECT_SET();
+            selectResult = select(prober.getHighestSocketIdentifierForSelect() + 1, &(prober.receiveSet), NULL, NULL, wait.getStructure());
+        }
+
+        // Packet arrived
+        if(selectResult > 0)
+        {
+            if(subscription.isActive())
+            {
+                receivedBytes = (ssize_t) selectResult;
+            }
+            else
+            {
+                // First makes sure that the packet arrived to the socket we are interested in
+                int readySocketDescriptor = prober.GET_READY_SOCKET_DESCRIPTOR();
+                if(readySocketDescriptor < 0)
+                {
+                    continue;
+                }
+
+                // SOCK_RAW: the packet is always received as a whole
+                receivedBytes = recvfrom(readySocketDescriptor,
+                                         buffer,
+                                         bufferSize,
+                                         0,
+                                         (struct sockaddr*) &fromAddress,
+                                         &fromAddressLength);
+
+                if(receivedBytes == -1)
+                {
+                    perror("Socket Receive Exception Error Message");
+                    throw SocketReceiveException("Can NOT receive packets");
+                }
+            }
+
+            unsigned short payloadLength = 0, replyIPIdentifier = 0;
+            uint8_t replyTTL = 0;
+            InetAddress replyAddress;
+            const char *rejection = classify(buffer,
+                                             receivedBytes,
+                                             c,
+                                             &payloadLength,
+                                             &replyTTL,
+                                             &replyIPIdentifier,
+                                             &replyAddress);
+            if(rejection != NULL)
+            {
+                if(prober.verbose)
+                {
+                    prober.log += rejection;
+                }
+                continue;
+            }
+
+            ProbeRecord *newRecord = buildProbeRecord(*REQTime, c, replyAddress, replyTTL, replyIPIdentifier, payloadLength);
+            if(prober.verbose)
+            {
+                prober.log += newRecord->toString();
+            }
+
+            prober.nbSuccessfulProbes++;
+            return newRecord;
+        }
+        // Select timeout occured
+        else if(selectResult == 0)
+        {
+            if(prober.verbose)
+            {
+                prober.log += "\nThe select() function timed out. Stopped listening.\n";
+            }
+
+            c.replyType = 255;
+            c.replyCode = 255;
+            c.payloadTTL = 0;
+            c.receiveTs = 0;
+            c.transmitTs = 0;
+            return buildProbeRecord(*REQTime, c, InetAddress(0), 0, 0, 0);
+        }
+        // Send failure reported by the shared path
+        else if(subscription.isActive())
+        {
+            if(prober.verbose)
+            {
+                prober.log += "\nThe shared path could not send the probe: ";
+                prober.log += string(strerror(errno)) + ". Stopped listening.\n";
+            }
+            throw SocketSendException(string("Can NOT send the ") + Policy::getName() + " packet");
+        }
+        // Select error occured
+        else
+        {
+            if(prober.verbose)
+            {
+                string errorMsg = "\nThe select() function returned an error: ";
+                if(errno == EINVAL)
+                    errorMsg += "EINVAL.";
+                else if(errno == EINTR)
+                    errorMsg += "EINTR.";
+                else if(errno == EBADF)
+                    errorMsg += "EBADF.";
+                else
+                    errorMsg += string(strerror(errno)) + ".";
+                errorMsg += "Stopped listening.";
+
+                prober.log += errorMsg + "\n";
+            }
+            perror("select(...)");
+            throw SocketReceiveException("Can NOT select() on receiving socket");
+        }
+    }
+    return NULL; // Never reached
+}
+
+#endif /* PROBEPIPELINE_H_ */
@@ -0,0 +1,423 @@
+/*
+ * ProbePolicies.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Protocol policies of the probe pipeline (see ProbePipeline.h). A policy describes, with inline
+ * static methods only, what differs from one probing protocol to another: the layout of the
+ * transport part of the probe (built right after the IP header), the identifier the replies are
+ * dispatched on, and the way a reply is matched with the probe and classified. Since policies
+ * are template parameters, the compiler inlines all of this in the pipeline: no virtual call is
+ * made while building a probe or handling a reply.
+ *
+ * The "wrapped" policies (UDPWrappedICMPPolicy, TCPWrappedICMPPolicy) only differ from their base
+ * policy by their reinterpret() method, which translates replies into ICMP echo replies such that
+ * the rest of the program can interpret them as with ICMP probing (this used to be done by
+ * DirectUDPWrappedICMPProber and DirectTCPWrappedICMPProber on the final probe record).
+ */
+
+#ifndef PROBEPOLICIES_H_
+#define PROBEPOLICIES_H_
+
+#include <inttypes.h>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+using std::stringstream;
+#include <string>
+using std::string;
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/udp.h>
+#include <netinet/tcp.h>
+
+#include "../DirectProber.h"
+
+/*
+ * Parameters of a single probe (filled by the prober) and details of its reply (filled by the
+ * policy upon matching a reply).
+ */
+
+struct ProbeContext
+{
+    // Probe
+    const InetAddress *src;
+    const InetAddress *dst;
+    unsigned short IPIdentifier;
+    unsigned char TTL;
+    bool usingFixedFlowID;
+    unsigned short srcPortICMPid; // Source port or ICMP identifier
+    unsigned short dstPortICMPseq; // Destination port or ICMP sequence
+    const string *attentionMessage;
+    const uint8_t *randomData;
+
+    // Protocol-specific parameters of the probe
+    bool timestampRequest; // ICMP
+    uint16_t fixedFlowChecksum; // ICMP, with a fixed flow ID
+    uint32_t originateTs; // ICMP timestamp request
+    uint32_t TCPSequence; // TCP
+
+    // Reply
+    unsigned char replyType;
+    unsigned char replyCode;
+    unsigned char payloadTTL;
+    unsigned long receiveTs;
+    unsigned long transmitTs;
+};
+
+/*
+ * Default behaviours, hidden by the policies when needed. Since the methods are static and
+ * resolved at compile time, "hiding" is enough (no virtual method).
+ */
+
+class ProbePolicyBase
+{
+public:
+
+    // Outcomes of matching a received packet with the probe
+    enum ReplyMatch
+    {
+        REPLY_MATCHED, // Reply to the probe; details are in the context
+        REPLY_IGNORED, // Reply to another probe
+        REPLY_UNKNOWN, // Unexpected kind of packet
+        REPLY_NOT_FROM_TARGET // TCP segment which does not reply to the probe
+    };
+
+    static const bool ACCEPTS_TCP = false;
+
+    static inline ReplyMatch matchTCP(const uint8_t *packet, uint16_t IPHeaderLength, ProbeContext &c)
+    {
+        return REPLY_UNKNOWN;
+    }
+
+    static inline void reinterpret(ProbeContext &c) { }
+};
+
+class ICMPProbePolicy : public ProbePolicyBase
+{
+public:
+
+    static const uint8_t PROTOCOL = IPPROTO_ICMP;
+
+    static inline const char *getName() { return "ICMP"; }
+
+    static inline uint16_t getTransportLength(const ProbeContext &c)
+    {
+        if(c.timestampRequest)
+            return DirectProber::DEFAULT_ICMP_HEADER_LENGTH + DirectProber::ICMP_TS_FIELDS_LENGTH;
+        return DirectProber::DEFAULT_ICMP_HEADER_LENGTH + DirectProber::DEFAULT_ICMP_RADOM_DATA_LENGTH
+        + (uint16_t) c.attentionMessage->length();
+    }
+
+    static inline void buildTransport(uint8_t *buffer, uint16_t IPHeaderLength, uint8_t *pseudoBuffer, ProbeContext &c)
+    {
+        struct icmphdr *icmp = (struct icmphdr*) (buffer + IPHeaderLength);
+        icmp->code = 0x0;
+        (icmp->un).echo.id = htons((uint16_t) c.srcPortICMPid);
+        (icmp->un).echo.sequence = htons((uint16_t) c.dstPortICMPseq);
+        icmp->checksum = 0x0; // Before computing checksum, the sum field must be zero
+
+        uint16_t ICMPLength = getTransportLength(c);
+        uint8_t *icmpdata = (((uint8_t*) icmp) + DirectProber::DEFAULT_ICMP_HEADER_LENGTH);
+        if(c.timestampRequest)
+        {
+            icmp->type = DirectProber::ICMP_TYPE_TS_REQUEST;
+
+            // Originate (= current UT time since midnight), Receive and Transmit (= 0) timestamps
+            c.originateTs = DirectProber::getUTTimeSinceMidnight();
+            memcpy(icmpdata, &c.originateTs, DirectProber::TIMESTAMP_LENGTH_BYTES);
+            memset(icmpdata + DirectProber::TIMESTAMP_LENGTH_BYTES, 0x0, 2 * DirectProber::TIMESTAMP_LENGTH_BYTES);
+
+            icmp->checksum = DirectProber::calculateInternetChecksum((uint16_t*) icmp, ICMPLength);
+            return;
+        }
+
+        icmp->type = DirectProber::ICMP_TYPE_ECHO_REQUEST;
+        if(c.usingFixedFlowID)
+        {
+            /*
+             * Only uses six random bytes, the other two bytes will be computed later to make ones
+             * complement sum all-ones.
+             */
+
+            memset(icmpdata, 0x0, DirectProber::DEFAULT_ICMP_RADOM_DATA_LENGTH);
+            memcpy(icmpdata, c.randomData, DirectProber::DEFAULT_ICMP_RADOM_DATA_LENGTH - 2);
+        }
+        else
+        {
+            memcpy(icmpdata, c.randomData, DirectProber::DEFAULT_ICMP_RADOM_DATA_LENGTH);
+        }
+        memcpy(icmpdata + DirectProber::DEFAULT_ICMP_RADOM_DATA_LENGTH,
+               c.attentionMessage->c_str(),
+               c.attentionMessage->length());
+
+        if(c.usingFixedFlowID)
+        {
+            // Constant checksum: the last two random bytes make the ones complement sum all-ones
+            icmp->checksum = c.fixedFlowChecksum;
+            uint16_t ocsum = DirectProber::onesComplementAddition((uint16_t*) icmp, ICMPLength);
+            uint16_t ocdiff = DirectProber::onesComplementSubtraction(DirectProber::MAX_UINT16_T_NUMBER, ocsum);
+            memcpy(icmpdata + DirectProber::DEFAULT_ICMP_RADOM_DATA_LENGTH - 2, (uint8_t*) (&ocdiff), 2);
+        }
+        else
+        {
+            icmp->checksum = DirectProber::calculateInternetChecksum((uint16_t*) icmp, ICMPLength);
+        }
+    }
+
+    static inline void logFields(stringstream &logStream, const uint8_t *transport, const ProbeContext &c)
+    {
+        logStream << "ICMP identifier: " << c.srcPortICMPid << "\n";
+        logStream << "ICMP sequence: " << c.dstPortICMPseq << "\n";
+    }
+
+    // "packet" starts with the IP header; the ICMP checksum has already been verified
+    static inline ReplyMatch matchICMP(const uint8_t *packet, uint16_t IPHeaderLength, ProbeContext &c)
+    {
+        const struct icmphdr *icmp = (const struct icmphdr*) (packet + IPHeaderLength);
+        c.replyType = icmp->type;
+        c.replyCode = icmp->code;
+        if(icmp->type == DirectProber::ICMP_TYPE_TIME_EXCEEDED || icmp->type == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
+        {
+            const struct ip *payloadip = (const struct ip*) (packet + IPHeaderLength + DirectProber::DEFAULT_ICMP_HEADER_LENGTH);
+            const struct icmphdr *payloadicmp = (const struct icmphdr*) (((const uint8_t*) payloadip) + (payloadip->ip_hl) * 4);
+            if(payloadicmp->type == DirectProber::ICMP_TYPE_ECHO_REQUEST &&
+               ntohs(payloadip->ip_id) == (uint16_t) c.IPIdentifier &&
+               ntohs((payloadicmp->un).echo.id) == (uint16_t) c.srcPortICMPid &&
+               ntohs((payloadicmp->un).echo.sequence) == (uint16_t) c.dstPortICMPseq)
+            {
+                c.payloadTTL = payloadip->ip_ttl;
+                return REPLY_MATCHED;
+            }
+            return REPLY_IGNORED;
+        }
+        else if(icmp->type == DirectProber::ICMP_TYPE_ECHO_REPLY)
+        {
+            if(ntohs((icmp->un).echo.id) == (uint16_t) c.srcPortICMPid &&
+               ntohs((icmp->un).echo.sequence) == (uint16_t) c.dstPortICMPseq)
+                return REPLY_MATCHED;
+            return REPLY_IGNORED;
+        }
+        else if(icmp->type == DirectProber::ICMP_TYPE_TS_REPLY)
+        {
+            // + 12 because 8 bytes for ICMP headers and 4 bytes for originate timestamp
+            const uint8_t *timestamps = packet + IPHeaderLength + 12;
+            c.receiveTs = ((unsigned long) timestamps[0] << 24) + ((unsigned long) timestamps[1] << 16);
+            c.receiveTs += ((unsigned long) timestamps[2] << 8) + (unsigned long) timestamps[3];
+            c.transmitTs = ((unsigned long) timestamps[4] << 24) + ((unsigned long) timestamps[5] << 16);
+            c.transmitTs += ((unsigned long) timestamps[6] << 8) + (unsigned long) timestamps[7];
+            return REPLY_MATCHED;
+        }
+        return REPLY_UNKNOWN;
+    }
+};
+
+class UDPProbePolicy : public ProbePolicyBase
+{
+public:
+
+    static const uint8_t PROTOCOL = IPPROTO_UDP;
+
+    static inline const char *getName() { return "UDP"; }
+
+    static inline uint16_t getTransportLength(const ProbeContext &c)
+    {
+        return DirectProber::MINIMUM_UDP_HEADER_LENGTH + DirectProber::DEFAULT_UDP_RANDOM_DATA_LENGTH
+        + (uint16_t) c.attentionMessage->length();
+    }
+
+    static inline void buildTransport(uint8_t *buffer, uint16_t IPHeaderLength, uint8_t *pseudoBuffer, ProbeContext &c)
+    {
+        const struct ip *ip = (const struct ip*) buffer;
+        struct udphdr *udp = (struct udphdr*) (buffer + IPHeaderLength);
+        uint16_t UDPLength = getTransportLength(c);
+        udp->source = htons((uint16_t) c.srcPortICMPid);
+        udp->dest = htons((uint16_t) c.dstPortICMPseq);
+        udp->len = htons(UDPLength);
+        udp->check = 0x0;
+
+        // Random data keeps a single flow and avoids routers applying path balancing
+        uint8_t *udpdata = ((uint8_t*) udp + DirectProber::MINIMUM_UDP_HEADER_LENGTH);
+        memcpy(udpdata, c.randomData, DirectProber::DEFAULT_UDP_RANDOM_DATA_LENGTH);
+        udpdata += DirectProber::DEFAULT_UDP_RANDOM_DATA_LENGTH;
+        memcpy(udpdata, c.attentionMessage->c_str(), c.attentionMessage->length());
+
+        // UDP checksum is calculated over pseudo header, then the UDP header and data
+        uint8_t *pseudo = pseudoBuffer;
+        memcpy(pseudo, &((ip->ip_src).s_addr), 4);
+        memcpy(pseudo + 4, &((ip->ip_dst).s_addr), 4);
+        pseudo[8] = 0; // 1 byte padding
+        pseudo[9] = IPPROTO_UDP;
+        memcpy(pseudo + 10, &(udp->len), 2);
+        memcpy(pseudo + 12, (uint8_t*) udp, UDPLength);
+        udp->check = DirectProber::calculateInternetChecksum((uint16_t*) pseudoBuffer, 12 + UDPLength);
+    }
+
+    static inline void logFields(stringstream &logStream, const uint8_t *transport, const ProbeContext &c)
+    {
+        logStream << "Source port: " << c.srcPortICMPid << "\n";
+        logStream << "Destination port: " << c.dstPortICMPseq << "\n";
+    }
+
+    static inline ReplyMatch matchICMP(const uint8_t *packet, uint16_t IPHeaderLength, ProbeContext &c)
+    {
+        const struct icmphdr *icmp = (const struct icmphdr*) (packet + IPHeaderLength);
+        if(icmp->type != DirectProber::ICMP_TYPE_TIME_EXCEEDED && icmp->type != DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
+            return REPLY_UNKNOWN;
+
+        // IP identifier of the quoted packet is checked especially for multiplexing usingFixedFlowID packets
+        const struct ip *payloadip = (const struct ip*) (packet + IPHeaderLength + DirectProber::DEFAULT_ICMP_HEADER_LENGTH);
+        const struct udphdr *payloadudp = (const struct udphdr*) (((const uint8_t*) payloadip) + (payloadip->ip_hl) * 4);
+        if(payloadip->ip_p == IPPROTO_UDP &&
+           ntohs(payloadip->ip_id) == (uint16_t) c.IPIdentifier &&
+           ntohs(payloadudp->source) == (uint16_t) c.srcPortICMPid &&
+           ntohs(payloadudp->dest) == (uint16_t) c.dstPortICMPseq)
+        {
+            c.replyType = icmp->type;
+            c.replyCode = icmp->code;
+            c.payloadTTL = payloadip->ip_ttl;
+            return REPLY_MATCHED;
+        }
+        return REPLY_IGNORED;
+    }
+};
+
+class TCPProbePolicy : public ProbePolicyBase
+{
+public:
+
+    static const uint8_t PROTOCOL = IPPROTO_TCP;
+    static const bool ACCEPTS_TCP = true;
+
+    static inline const char *getName() { return "TCP"; }
+
+    static inline uint16_t getTransportLength(const ProbeContext &c)
+    {
+        return DirectProber::MINIMUM_TCP_HEADER_LENGTH + DirectProber::DEFAULT_TCP_RANDOM_DATA_LENGTH
+        + (uint16_t) c.attentionMessage->length();
+    }
+
+    static inline void buildTransport(uint8_t *buffer, uint16_t IPHeaderLength, uint8_t *pseudoBuffer, ProbeContext &c)
+    {
+        const struct ip *ip = (const struct ip*) buffer;
+        struct tcphdr *tcp = (struct tcphdr*) (buffer + IPHeaderLength);
+        tcp->source = htons((uint16_t) c.srcPortICMPid);
+        tcp->dest = htons((uint16_t) c.dstPortICMPseq);
+        tcp->seq = htonl(c.TCPSequence);
+        tcp->ack_seq = htonl((unsigned long) rand());
+        tcp->doff = (DirectProber::MINIMUM_TCP_HEADER_LENGTH / 4);
+        tcp->res1 = 0;
+        tcp->res2 = 0;
+        tcp->syn = 1;
+        tcp->ack = 1;
+        tcp->fin = 0;
+        tcp->psh = 0;
+        tcp->urg = 0;
+        tcp->rst = 0;
+        tcp->window = htons(32767);
+        tcp->check = 0x0;
+        tcp->urg_ptr = 0x0;
+
+        // Random data keeps a single flow and avoids routers applying path balancing
+        uint8_t *tcpdata = ((uint8_t*) tcp + DirectProber::MINIMUM_TCP_HEADER_LENGTH);
+        memcpy(tcpdata, c.randomData, DirectProber::DEFAULT_TCP_RANDOM_DATA_LENGTH);
+        tcpdata += DirectProber::DEFAULT_TCP_RANDOM_DATA_LENGTH;
+        memcpy(tcpdata, c.attentionMessage->c_str(), c.attentionMessage->length());
+
+        // TCP checksum is calculated over pseudo header, then the whole original packet
+        uint16_t totalPacketLength = IPHeaderLength + getTransportLength(c);
+        uint16_t TCPPseudoLength = htons(getTransportLength(c));
+        uint8_t *pseudo = pseudoBuffer;
+        memcpy(pseudo, &((ip->ip_src).s_addr), 4);
+        memcpy(pseudo + 4, &((ip->ip_dst).s_addr), 4);
+        pseudo[8] = 0; // 1 byte padding
+        pseudo[9] = IPPROTO_TCP;
+        memcpy(pseudo + 10, &TCPPseudoLength, 2);
+        memcpy(pseudo + 12, buffer, totalPacketLength);
+        tcp->check = DirectProber::calculateInternetChecksum((uint16_t*) pseudoBuffer, 12 + totalPacketLength);
+    }
+
+    static inline void logFields(stringstream &logStream, const uint8_t *transport, const ProbeContext &c)
+    {
+        const struct tcphdr *tcp = (const struct tcphdr*) transport;
+        logStream << "Source port: " << c.srcPortICMPid << "\n";
+        logStream << "Destination port: " << c.dstPortICMPseq << "\n";
+        logStream << "Sequence number: " << ntohl(tcp->seq) << "\n";
+        logStream << "ACK sequence number: " << ntohl(tcp->ack_seq) << "\n";
+        logStream << "Window size: " << ntohs(tcp->window) << "\n";
+    }
+
+    static inline ReplyMatch matchICMP(const uint8_t *packet, uint16_t IPHeaderLength, ProbeContext &c)
+    {
+        const struct icmphdr *icmp = (const struct icmphdr*) (packet + IPHeaderLength);
+        if(icmp->type != DirectProber::ICMP_TYPE_TIME_EXCEEDED && icmp->type != DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
+            return REPLY_UNKNOWN;
+
+        const struct ip *payloadip = (const struct ip*) (packet + IPHeaderLength + DirectProber::DEFAULT_ICMP_HEADER_LENGTH);
+        const struct tcphdr *payloadtcp = (const struct tcphdr*) (((const uint8_t*) payloadip) + (payloadip->ip_hl) * 4);
+        if(payloadip->ip_p == IPPROTO_TCP &&
+           ntohs(payloadip->ip_id) == (uint16_t) c.IPIdentifier &&
+           ntohs(payloadtcp->source) == (uint16_t) c.srcPortICMPid &&
+           (ntohs(payloadtcp->dest) == (uint16_t) c.dstPortICMPseq || ntohl(payloadtcp->seq) == c.TCPSequence))
+        {
+            c.replyType = icmp->type;
+            c.replyCode = icmp->code;
+            c.payloadTTL = payloadip->ip_ttl;
+            return REPLY_MATCHED;
+        }
+        return REPLY_IGNORED;
+    }
+
+    static inline ReplyMatch matchTCP(const uint8_t *packet, uint16_t IPHeaderLength, ProbeContext &c)
+    {
+        const struct tcphdr *tcp = (const struct tcphdr*) (packet + IPHeaderLength);
+        uint32_t expectedAck = c.TCPSequence + 1 + DirectProber::DEFAULT_TCP_RANDOM_DATA_LENGTH
+        + (uint32_t) c.attentionMessage->length();
+        if(ntohs(tcp->dest) == (uint16_t) c.srcPortICMPid &&
+           (ntohs(tcp->source) == (uint16_t) c.dstPortICMPseq || ntohl(tcp->ack_seq) == expectedAck))
+        {
+            c.replyType = DirectProber::PSEUDO_TCP_RESET_ICMP_TYPE;
+            c.replyCode = DirectProber::PSEUDO_TCP_RESET_ICMP_CODE;
+            c.payloadTTL = 0;
+            return REPLY_MATCHED;
+        }
+        return REPLY_NOT_FROM_TARGET;
+    }
+};
+
+// Port unreachable means the target was reached: interpreted as an echo reply
+class UDPWrappedICMPPolicy : public UDPProbePolicy
+{
+public:
+
+    static inline void reinterpret(ProbeContext &c)
+    {
+        if(c.replyType == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE &&
+           c.replyCode == DirectProber::ICMP_CODE_PORT_UNREACHABLE)
+        {
+            c.replyType = DirectProber::ICMP_TYPE_ECHO_REPLY;
+            c.replyCode = 0;
+        }
+    }
+};
+
+// A reset or a port unreachable means the target was reached: interpreted as an echo reply
+class TCPWrappedICMPPolicy : public TCPProbePolicy
+{
+public:
+
+    static inline void reinterpret(ProbeContext &c)
+    {
+        if(c.replyType == DirectProber::PSEUDO_TCP_RESET_ICMP_TYPE ||
+           (c.replyType == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE &&
+           c.replyCode == DirectProber::ICMP_CODE_PORT_UNREACHABLE))
+        {
+            c.replyType = DirectProber::ICMP_TYPE_ECHO_REPLY;
+            c.replyCode = 0;
+        }
+    }
+};
+
+#endif /* PROBEPOLICIES_H_ */
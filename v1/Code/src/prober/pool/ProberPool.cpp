@@ -0,0 +1,167 @@
+/*
+ * ProberPool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in ProberPool.h (see this file to learn further about the goals of
+ * such class).
+ */
+
+#include <netinet/in.h>
+
+#include "ProberPool.h"
+#include "../icmp/DirectICMPProber.h"
+#include "../udp/DirectUDPWrappedICMPProber.h"
+#include "../tcp/DirectTCPWrappedICMPProber.h"
+
+ProberPool::ProberPool(string &msg, int proto, unsigned short maxThreads):
+attentionMessage(msg),
+probingProtocol(proto),
+poolMutex(Mutex::ERROR_CHECKING_MUTEX),
+maxIdleProbers(2 * (unsigned int) maxThreads),
+nbInUse(0),
+peakInUse(0),
+nbCreatedProbers(0),
+nbReusedProbers(0),
+nbClosedProbers(0)
+{
+}
+
+ProberPool::~ProberPool()
+{
+    for(list<DirectProber*>::iterator it = idleProbers.begin(); it != idleProbers.end(); ++it)
+        delete (*it);
+    idleProbers.clear();
+}
+
+DirectProber *ProberPool::acquire(const TimeVal &timeout,
+                                  const TimeVal &prp,
+                                  unsigned short lbii,
+                                  unsigned short ubii,
+                                  unsigned short lbis,
+                                  unsigned short ubis,
+                                  bool verbose) throw(SocketException)
+{
+    DirectProber *prober = NULL;
+
+    poolMutex.lock();
+    nbInUse++;
+    if(nbInUse > peakInUse)
+        peakInUse = nbInUse;
+    for(list<DirectProber*>::iterator it = idleProbers.begin(); it != idleProbers.end(); ++it)
+    {
+        if((*it)->usesSourcePortsWithin(lbii, ubii))
+        {
+            prober = (*it);
+            idleProbers.erase(it);
+            nbReusedProbers++;
+            break;
+        }
+    }
+    poolMutex.unlock();
+
+    if(prober != NULL)
+    {
+        prober->reparameterize(timeout, prp, lbii, ubii, lbis, ubis, verbose);
+        return prober;
+    }
+
+    // No suitable idle prober: creates a new one (sockets are opened here)
+    int roundRobinSocketCount = 1;
+    try
+    {
+        if(probingProtocol == IPPROTO_UDP)
+        {
+            prober = new DirectUDPWrappedICMPProber(attentionMessage,
+                                                    roundRobinSocketCount,
+                                                    timeout,
+                                                    prp,
+                                                    lbii,
+                                                    ubii,
+                                                    lbis,
+                                                    ubis,
+                                                    verbose);
+        }
+        else if(probingProtocol == IPPROTO_TCP)
+        {
+            prober = new DirectTCPWrappedICMPProber(attentionMessage,
+                                                    roundRobinSocketCount,
+                                                    timeout,
+                                                    prp,
+                                                    lbii,
+                                                    ubii,
+                                                    lbis,
+                                                    ubis,
+                                                    verbose);
+        }
+        else
+        {
+            prober = new DirectICMPProber(attentionMessage,
+                                          timeout,
+                                          prp,
+                                          lbii,
+                                          ubii,
+                                          lbis,
+                                          ubis,
+                                          verbose);
+        }
+    }
+    catch(SocketException &e)
+    {
+        poolMutex.lock();
+        nbInUse--;
+        poolMutex.unlock();
+        throw;
+    }
+
+    poolMutex.lock();
+    nbCreatedProbers++;
+    poolMutex.unlock();
+
+    return prober;
+}
+
+void ProberPool::release(DirectProber *prober)
+{
+    if(prober == NULL)
+        return;
+
+    bool kept = false;
+    poolMutex.lock();
+    if(nbInUse > 0)
+        nbInUse--;
+    if(idleProbers.size() < (size_t) maxIdleProbers)
+    {
+        idleProbers.push_back(prober);
+        kept = true;
+    }
+    else
+    {
+        nbClosedProbers++;
+    }
+    poolMutex.unlock();
+
+    // Sockets are closed outside of the critical section
+    if(!kept)
+        delete prober;
+}
+
+void ProberPool::closeSurplus()
+{
+    list<DirectProber*> surplus;
+    poolMutex.lock();
+    size_t nbNeeded = (size_t) (peakInUse - nbInUse);
+    while(idleProbers.size() > nbNeeded)
+    {
+        surplus.push_back(idleProbers.back());
+        idleProbers.pop_back();
+        nbClosedProbers++;
+    }
+    peakInUse = nbInUse;
+    poolMutex.unlock();
+
+    // Sockets are closed outside of the critical section
+    for(list<DirectProber*>::iterator it = surplus.begin(); it != surplus.end(); ++it)
+        delete (*it);
+}
@@ -0,0 +1,83 @@
+/*
+ * ProberPool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * This class keeps DirectProber objects alive between the tasks that use them. Before it was
+ * introduced, every traceroute task (i.e., every target) or every rate-limit probe created a new
+ * prober, and therefore created, configured and closed two or more raw sockets, only to send a
+ * handful of probes. With the pool, a task acquires an already initialized prober, which is
+ * re-parameterized (ID ranges, timeout, verbosity) without re-opening any socket, and releases it
+ * when it is done. A campaign therefore opens at most as many probers as there are concurrent
+ * tasks.
+ *
+ * The amount of idle probers is capped by the largest amount of tasks which can run at the same 
+ * time (twice the maximum amount of threads, as the pre-scanning and the traceroute overlap when 
+ * pipelined), so that no socket is closed and re-opened within a phase. However, each idle raw 
+ * ICMP socket still gets a copy of every incoming ICMP packet, so keeping all the probers of a 
+ * phase with many threads (e.g. the pre-scanning) for the rest of the campaign would only fill 
+ * kernel buffers with stale replies. At the end of each phase, the idle probers beyond the amount 
+ * of probers this phase used at the same time are therefore closed (see closeSurplus()). The 
+ * receive sockets of a re-used prober are also drained first (see DirectProber::reparameterize()).
+ *
+ * For UDP and TCP, a prober's receive sockets are bound to source ports taken in the source port
+ * range it was created with, so an idle prober is only re-used for a task whose range includes
+ * these ports (tasks with the same index in successive waves share their range, so this is the
+ * common case). ICMP probers can be re-used by any task.
+ */
+
+#ifndef PROBERPOOL_H_
+#define PROBERPOOL_H_
+
+#include <string>
+using std::string;
+#include <list>
+using std::list;
+
+#include "../DirectProber.h"
+#include "../exception/SocketException.h"
+#include "../../common/thread/Mutex.h"
+#include "../../common/date/TimeVal.h"
+
+class ProberPool
+{
+public:
+
+    // probingProtocol is IPPROTO_ICMP, IPPROTO_UDP or IPPROTO_TCP
+    ProberPool(string &attentionMessage, int probingProtocol, unsigned short maxThreads);
+    ~ProberPool();
+
+    // Hands out a prober (re-used if possible, new otherwise)
+    DirectProber *acquire(const TimeVal &timeout,
+                          const TimeVal &probeRegulatingPeriod,
+                          unsigned short lowerBoundSrcPortICMPid,
+                          unsigned short upperBoundSrcPortICMPid,
+                          unsigned short lowerBoundDstPortICMPseq,
+                          unsigned short upperBoundDstPortICMPseq,
+                          bool verbose) throw(SocketException);
+
+    // Gives a prober back to the pool, or deletes it if the pool is full (NULL is ignored)
+    void release(DirectProber *prober);
+
+    // To call at the end of a phase: closes the idle probers this phase did not need at once
+    void closeSurplus();
+
+    inline unsigned int getNbCreatedProbers() { return this->nbCreatedProbers; }
+    inline unsigned int getNbReusedProbers() { return this->nbReusedProbers; }
+    inline unsigned int getNbClosedProbers() { return this->nbClosedProbers; }
+
+private:
+
+    string attentionMessage;
+    int probingProtocol;
+
+    Mutex poolMutex;
+    list<DirectProber*> idleProbers;
+    unsigned int maxIdleProbers;
+    unsigned int nbInUse, peakInUse; // Peak since the end of the previous phase
+    unsigned int nbCreatedProbers, nbReusedProbers, nbClosedProbers;
+
+};
+
+#endif /* PROBERPOOL_H_ */
@@ -36,6 +36,7 @@ using std::auto_ptr;
 #include "../exception/SocketException.h"
 #include "../structure/ProbeRecord.h"
 #include "../../common/date/TimeVal.h"
+#include "../pipeline/ProbePipeline.h"
 
 class DirectTCPProber : public DirectProber
 {
@@ -72,20 +73,41 @@ public:
 
 protected:
 
-    ProbeRecord *buildProbeRecord(const auto_ptr<TimeVal> &reqTime, 
-                                  const InetAddress &dstAddress, 
-                                  const InetAddress &rplyAddress, 
-                                  unsigned char reqTTL, 
-                                  unsigned char rplyTTL, 
-                                  unsigned char replyType, 
-                                  unsigned char rplyCode, 
-                                  unsigned short srcIPidentifier, 
-                                  unsigned short rplyIPidentifier,  
-                                  unsigned char payloadTTL, 
-                                  unsigned short payloadLength, 
-                                  int probingCost, 
-                                  bool usingFixedFlowID);
+    /*
+     * Fills the probe context and runs the probe pipeline with the given protocol policy, such 
+     * that the wrapped subclasses can use the same pipeline while re-interpreting replies.
+     */
     
+    template<class Policy> ProbeRecord *probeThroughPipeline(const InetAddress &src, 
+                                                             const InetAddress &dst, 
+                                                             unsigned short IPIdentifier, 
+                                                             unsigned char TTL, 
+                                                             bool usingFixedFlowID, 
+                                                             unsigned short srcPort, 
+                                                             unsigned short dstPort) throw(SocketSendException, SocketReceiveException)
+    {
+        ProbeContext c;
+        c.src = &src;
+        c.dst = &dst;
+        c.IPIdentifier = IPIdentifier;
+        c.TTL = TTL;
+        c.usingFixedFlowID = usingFixedFlowID;
+        c.srcPortICMPid = srcPort;
+        c.dstPortICMPseq = dstPort;
+        c.attentionMessage = &(getAttentionMsg());
+        c.randomData = this->randomDataBuffer;
+        c.timestampRequest = false;
+        c.fixedFlowChecksum = 0;
+        c.originateTs = 0;
+        c.TCPSequence = (uint32_t) rand();
+        
+        return ProbePipeline<Policy>::probe(*this, 
+                                            this->buffer, 
+                                            DEFAULT_DIRECT_TCP_PROBER_BUFFER_SIZE, 
+                                            this->pseudoBuffer, 
+                                            c);
+    }
+
     uint8_t buffer[DEFAULT_DIRECT_TCP_PROBER_BUFFER_SIZE];
     uint8_t pseudoBuffer[DEFAULT_TCP_PSEUDO_HEADER_LENGTH];
 
@@ -43,20 +43,11 @@ ProbeRecord *DirectTCPWrappedICMPProber::basic_probe(const InetAddress &src,
                                                      unsigned short srcPort, 
                                                      unsigned short dstPort) throw(SocketSendException, SocketReceiveException)
 {
-    ProbeRecord *result = DirectTCPProber::basic_probe(src, 
-                                                       dst, 
-                                                       IPIdentifier, 
-                                                       TTL, 
-                                                       usingFixedFlowID, 
-                                                       srcPort, 
-                                                       dstPort);
-    
-    if(result->getRplyICMPtype() == DirectProber::PSEUDO_TCP_RESET_ICMP_TYPE 
-    || (result->getRplyICMPtype() == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE 
-    && result->getRplyICMPcode() == DirectProber::ICMP_CODE_PORT_UNREACHABLE))
-    {
-        result->setRplyICMPtype(DirectProber::ICMP_TYPE_ECHO_REPLY);
-        result->setRplyICMPcode(0);
-    }
-    return result;
+    return probeThroughPipeline<TCPWrappedICMPPolicy>(src, 
+                                                      dst, 
+                                                      IPIdentifier, 
+                                                      TTL, 
+                                                      usingFixedFlowID, 
+                                                      srcPort, 
+                                                      dstPort);
 }
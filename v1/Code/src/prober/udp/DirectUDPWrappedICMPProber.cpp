@@ -45,18 +45,6 @@ ProbeRecord *DirectUDPWrappedICMPProber::basic_probe(const InetAddress &src,
                                                      unsigned short srcPort, 
                                                      unsigned short dstPort) throw(SocketSendException, SocketReceiveException)
 {
-    unsigned short dstPortBis = dstPort;
-    if(this->usingHighPortNumber)
-        dstPortBis = 65535;
-
-    ProbeRecord *result = DirectUDPProber::basic_probe(src, 
-                                                       dst, 
-                                                       IPIdentifier, 
-                                                       TTL, 
-                                                       usingFixedFlowID, 
-                                                       srcPort, 
-                                                       dstPortBis);
-    
     /*
      * Addition by J.-F. Grailet: in order to use UDP as an alias resolution tool (i.e., an 
      * unlikely high port number is used to get a Port Unreachable message, which contains an IP 
@@ -64,16 +52,21 @@ ProbeRecord *DirectUDPWrappedICMPProber::basic_probe(const InetAddress &src,
      * edition, such that the original reply can be analyzed.
      */
     
-    if(!this->usingHighPortNumber)
+    if(this->usingHighPortNumber)
     {
-        if(result->getRplyICMPtype() == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
-        {
-            if(result->getRplyICMPcode() == DirectProber::ICMP_CODE_PORT_UNREACHABLE)
-            {
-                result->setRplyICMPtype(DirectProber::ICMP_TYPE_ECHO_REPLY);
-                result->setRplyICMPcode(0);
-            }
-        }
+        return probeThroughPipeline<UDPProbePolicy>(src, 
+                                                    dst, 
+                                                    IPIdentifier, 
+                                                    TTL, 
+                                                    usingFixedFlowID, 
+                                                    srcPort, 
+                                                    65535);
     }
-    return result;
+    return probeThroughPipeline<UDPWrappedICMPPolicy>(src, 
+                                                      dst, 
+                                                      IPIdentifier, 
+                                                      TTL, 
+                                                      usingFixedFlowID, 
+                                                      srcPort, 
+                                                      dstPort);
 }
@@ -0,0 +1,26 @@
+/*
+ * IOUringCompletionUnit.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in IOUringCompletionUnit.h (see this file to learn further about
+ * the goals of such class).
+ */
+
+#include "IOUringCompletionUnit.h"
+
+IOUringCompletionUnit::IOUringCompletionUnit(IOUringEngine *parent)
+{
+    this->parent = parent;
+}
+
+IOUringCompletionUnit::~IOUringCompletionUnit()
+{
+}
+
+void IOUringCompletionUnit::run()
+{
+    while(!parent->isStopping())
+        parent->processCompletions();
+}
@@ -0,0 +1,31 @@
+/*
+ * IOUringCompletionUnit.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * This class, inheriting Runnable, is the body of the engine thread of IOUringEngine: it reaps
+ * the completions (replies and sent probes) until the engine is stopped.
+ */
+
+#ifndef IOURINGCOMPLETIONUNIT_H_
+#define IOURINGCOMPLETIONUNIT_H_
+
+#include "../../common/thread/Runnable.h"
+#include "IOUringEngine.h"
+
+class IOUringCompletionUnit : public Runnable
+{
+public:
+
+    IOUringCompletionUnit(IOUringEngine *parent);
+    ~IOUringCompletionUnit();
+    void run();
+
+private:
+
+    IOUringEngine *parent;
+
+};
+
+#endif /* IOURINGCOMPLETIONUNIT_H_ */
@@ -0,0 +1,532 @@
+/*
+ * IOUringEngine.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in IOUringEngine.h (see this file to learn further about the goals
+ * of such class).
+ */
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <netinet/ip.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include "IOUringEngine.h"
+#include "IOUringCompletionUnit.h"
+
+// Tags stored in the user data of the requests (low 32 bits: send slot, if any)
+static const uint64_t TAG_RECEIVE_ICMP = ((uint64_t) 1) << 32;
+static const uint64_t TAG_RECEIVE_TCP = ((uint64_t) 2) << 32;
+static const uint64_t TAG_SEND = ((uint64_t) 3) << 32;
+
+// Thin wrappers for the system calls (no liburing)
+static int uringSetup(unsigned entries, struct io_uring_params *p)
+{
+    return (int) syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void *arg, size_t argSize)
+{
+    return (int) syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize);
+}
+
+static int uringRegister(int fd, unsigned opcode, void *arg, unsigned nbArgs)
+{
+    return (int) syscall(__NR_io_uring_register, fd, opcode, arg, nbArgs);
+}
+
+IOUringEngine::IOUringEngine(bool acceptTCP, bool useSQPoll) throw(SocketException):
+ReplyDispatcher(NB_SLICES),
+ringFD(-1),
+SQPoll(useSQPoll),
+SQRingPtr(MAP_FAILED),
+CQRingPtr(MAP_FAILED),
+SQRingSize(0),
+CQRingSize(0),
+SQEsSize(0),
+SQEs((struct io_uring_sqe*) MAP_FAILED),
+bufferRing((struct io_uring_buf*) MAP_FAILED),
+bufferRingSize(0),
+receptionBuffers(NULL),
+bufferRingTail(0),
+multishot(true),
+sendSocket(-1),
+ICMPSocket(-1),
+TCPSocket(-1),
+sendBuffers(NULL),
+sendHeaders(NULL),
+sendVectors(NULL),
+sendAddresses(NULL),
+sendKeys(NULL),
+freeSlots(NULL),
+nbFreeSlots(0),
+nbFailedSends(0),
+submissionMutex(Mutex::ERROR_CHECKING_MUTEX),
+pendingSubmissions(0),
+nbQueuedSends(0),
+engineIdle(true),
+nbSubmitCalls(0),
+engineThread(NULL),
+stopMutex(Mutex::ERROR_CHECKING_MUTEX),
+stopping(false)
+{
+    // 1) Sets up the ring
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    if(SQPoll)
+    {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = 1000; // ms
+    }
+
+    if((ringFD = uringSetup(RING_ENTRIES, &params)) < 0)
+    {
+        if(errno == ENOSYS)
+            throw SocketException("io_uring is not supported by this kernel.");
+        else if(errno == EPERM)
+            throw SocketException("io_uring is disabled or the process does not have appropriate privileges.");
+        throw SocketException("Can NOT set up the io_uring instance.");
+    }
+
+    if(!(params.features & IORING_FEAT_EXT_ARG))
+    {
+        release();
+        throw SocketException("io_uring lacks extended arguments (Linux 5.11 or later is required).");
+    }
+
+    SQRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    CQRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if(singleMmap)
+    {
+        if(CQRingSize > SQRingSize)
+            SQRingSize = CQRingSize;
+        CQRingSize = SQRingSize;
+    }
+
+    SQRingPtr = mmap(0, SQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQ_RING);
+    if(SQRingPtr == MAP_FAILED)
+    {
+        release();
+        throw SocketException("Can NOT map the io_uring submission queue.");
+    }
+
+    if(singleMmap)
+    {
+        CQRingPtr = SQRingPtr;
+    }
+    else
+    {
+        CQRingPtr = mmap(0, CQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_CQ_RING);
+        if(CQRingPtr == MAP_FAILED)
+        {
+            release();
+            throw SocketException("Can NOT map the io_uring completion queue.");
+        }
+    }
+
+    SQEsSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    SQEs = (struct io_uring_sqe*) mmap(0, SQEsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQES);
+    if(SQEs == MAP_FAILED)
+    {
+        release();
+        throw SocketException("Can NOT map the io_uring submission entries.");
+    }
+
+    uint8_t *SQBase = (uint8_t*) SQRingPtr;
+    SQHead = (unsigned*) (SQBase + params.sq_off.head);
+    SQTail = (unsigned*) (SQBase + params.sq_off.tail);
+    SQMask = (unsigned*) (SQBase + params.sq_off.ring_mask);
+    SQFlags = (unsigned*) (SQBase + params.sq_off.flags);
+    SQArray = (unsigned*) (SQBase + params.sq_off.array);
+    SQEntries = params.sq_entries;
+
+    uint8_t *CQBase = (uint8_t*) CQRingPtr;
+    CQHead = (unsigned*) (CQBase + params.cq_off.head);
+    CQTail = (unsigned*) (CQBase + params.cq_off.tail);
+    CQMask = (unsigned*) (CQBase + params.cq_off.ring_mask);
+    CQEs = (struct io_uring_cqe*) (CQBase + params.cq_off.cqes);
+
+    // 2) Registers the ring of provided buffers (its tail overlays the "resv" field of bufs[0])
+    bufferRingSize = NB_RECEPTION_BUFFERS * sizeof(struct io_uring_buf);
+    bufferRing = (struct io_uring_buf*) mmap(0, bufferRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(bufferRing == MAP_FAILED)
+    {
+        release();
+        throw SocketException("Can NOT allocate the ring of provided buffers.");
+    }
+
+    struct io_uring_buf_reg bufferRegistration;
+    memset(&bufferRegistration, 0, sizeof(bufferRegistration));
+    bufferRegistration.ring_addr = (uint64_t) (uintptr_t) bufferRing;
+    bufferRegistration.ring_entries = NB_RECEPTION_BUFFERS;
+    bufferRegistration.bgid = BUFFER_GROUP;
+    if(uringRegister(ringFD, IORING_REGISTER_PBUF_RING, &bufferRegistration, 1) < 0)
+    {
+        release();
+        throw SocketException("io_uring lacks rings of provided buffers (Linux 5.19 or later is required).");
+    }
+
+    receptionBuffers = new uint8_t[NB_RECEPTION_BUFFERS * BUFFER_SIZE];
+    for(unsigned short i = 0; i < NB_RECEPTION_BUFFERS; i++)
+        recycleBuffer(i);
+
+    // 3) Sockets
+    if((sendSocket = socket(PF_INET, SOCK_RAW, IPPROTO_RAW)) < 0 ||
+       (ICMPSocket = socket(PF_INET, SOCK_RAW, IPPROTO_ICMP)) < 0 ||
+       (acceptTCP && (TCPSocket = socket(PF_INET, SOCK_RAW, IPPROTO_TCP)) < 0))
+    {
+        release();
+        throw SocketException("Can NOT create the raw sockets of the io_uring engine.");
+    }
+
+    const int on = 1;
+    if(setsockopt(sendSocket, IPPROTO_IP, IP_HDRINCL, &on, sizeof(on)) < 0)
+    {
+        release();
+        throw SocketException("Can NOT set sending socket IP_HDRINCL");
+    }
+
+    // Larger reception buffers, since a single socket now receives the replies of all threads
+    const int receiveBufferSize = 4 * 1024 * 1024;
+    setsockopt(ICMPSocket, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+    if(TCPSocket >= 0)
+        setsockopt(TCPSocket, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+
+    // 4) Send slots
+    sendBuffers = new uint8_t[NB_SEND_SLOTS * BUFFER_SIZE];
+    sendHeaders = new struct msghdr[NB_SEND_SLOTS];
+    sendVectors = new struct iovec[NB_SEND_SLOTS];
+    sendAddresses = new struct sockaddr_in[NB_SEND_SLOTS];
+    sendKeys = new unsigned short[NB_SEND_SLOTS];
+    freeSlots = new unsigned short[NB_SEND_SLOTS];
+    for(unsigned short i = 0; i < NB_SEND_SLOTS; i++)
+    {
+        memset(&sendHeaders[i], 0, sizeof(struct msghdr));
+        sendVectors[i].iov_base = sendBuffers + i * BUFFER_SIZE;
+        sendHeaders[i].msg_name = &sendAddresses[i];
+        sendHeaders[i].msg_namelen = sizeof(struct sockaddr_in);
+        sendHeaders[i].msg_iov = &sendVectors[i];
+        sendHeaders[i].msg_iovlen = 1;
+        sendKeys[i] = 0;
+        freeSlots[i] = NB_SEND_SLOTS - 1 - i;
+    }
+    nbFreeSlots = NB_SEND_SLOTS;
+
+    // 5) Arms the receptions
+    submissionMutex.lock();
+    armReceive(ICMPSocket, TAG_RECEIVE_ICMP);
+    if(TCPSocket >= 0)
+        armReceive(TCPSocket, TAG_RECEIVE_TCP);
+    submissionMutex.unlock();
+}
+
+IOUringEngine::~IOUringEngine()
+{
+    this->stop();
+    release();
+}
+
+void IOUringEngine::release()
+{
+    // Closing the ring cancels every pending request
+    if(ringFD >= 0)
+    {
+        close(ringFD);
+        ringFD = -1;
+    }
+    if(SQEs != MAP_FAILED)
+        munmap(SQEs, SQEsSize);
+    if(CQRingPtr != MAP_FAILED && CQRingPtr != SQRingPtr)
+        munmap(CQRingPtr, CQRingSize);
+    if(SQRingPtr != MAP_FAILED)
+        munmap(SQRingPtr, SQRingSize);
+    if(bufferRing != MAP_FAILED)
+        munmap(bufferRing, bufferRingSize);
+    SQEs = (struct io_uring_sqe*) MAP_FAILED;
+    SQRingPtr = CQRingPtr = MAP_FAILED;
+    bufferRing = (struct io_uring_buf*) MAP_FAILED;
+
+    if(sendSocket >= 0)
+        close(sendSocket);
+    if(ICMPSocket >= 0)
+        close(ICMPSocket);
+    if(TCPSocket >= 0)
+        close(TCPSocket);
+    sendSocket = ICMPSocket = TCPSocket = -1;
+
+    delete[] receptionBuffers;
+    delete[] sendBuffers;
+    delete[] sendHeaders;
+    delete[] sendVectors;
+    delete[] sendAddresses;
+    delete[] sendKeys;
+    delete[] freeSlots;
+    receptionBuffers = sendBuffers = NULL;
+    sendHeaders = NULL;
+    sendVectors = NULL;
+    sendAddresses = NULL;
+    sendKeys = NULL;
+    freeSlots = NULL;
+}
+
+void IOUringEngine::start() throw(ThreadException)
+{
+    engineThread = new Thread(new IOUringCompletionUnit(this));
+    try
+    {
+        engineThread->start();
+    }
+    catch(ThreadException &te)
+    {
+        delete engineThread;
+        engineThread = NULL;
+        throw;
+    }
+}
+
+void IOUringEngine::stop()
+{
+    stopMutex.lock();
+    stopping = true;
+    stopMutex.unlock();
+
+    if(engineThread != NULL)
+    {
+        engineThread->join();
+        delete engineThread;
+        engineThread = NULL;
+    }
+}
+
+bool IOUringEngine::isStopping()
+{
+    bool result = false;
+    stopMutex.lock();
+    result = stopping;
+    stopMutex.unlock();
+    return result;
+}
+
+struct io_uring_sqe *IOUringEngine::getSQE()
+{
+    unsigned head = __atomic_load_n(SQHead, __ATOMIC_ACQUIRE);
+    unsigned tail = *SQTail;
+    if(tail - head >= SQEntries)
+        return NULL;
+
+    unsigned index = tail & (*SQMask);
+    struct io_uring_sqe *sqe = &SQEs[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    SQArray[index] = index;
+    return sqe;
+}
+
+void IOUringEngine::publishSQE()
+{
+    __atomic_store_n(SQTail, (*SQTail) + 1, __ATOMIC_RELEASE);
+    pendingSubmissions++;
+}
+
+void IOUringEngine::armReceive(int socketFD, uint64_t tag)
+{
+    struct io_uring_sqe *sqe = getSQE();
+    if(sqe == NULL)
+        return; // Should not happen: receptions are re-armed after reaping, when entries are free
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = socketFD;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = tag;
+    if(multishot)
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+    else
+        sqe->len = BUFFER_SIZE;
+    publishSQE();
+}
+
+void IOUringEngine::submitPending()
+{
+    if(pendingSubmissions == 0)
+        return;
+
+    // Entries which were not consumed (e.g. EAGAIN, EINTR) stay pending for the next submission
+    int nbSubmitted = uringEnter(ringFD, pendingSubmissions, 0, 0, NULL, 0);
+    nbSubmitCalls++;
+    if(nbSubmitted <= 0)
+        return;
+    if((unsigned) nbSubmitted >= pendingSubmissions)
+        pendingSubmissions = 0;
+    else
+        pendingSubmissions -= (unsigned) nbSubmitted;
+}
+
+void IOUringEngine::recycleBuffer(unsigned short bufferID)
+{
+    struct io_uring_buf *buf = &bufferRing[bufferRingTail & (NB_RECEPTION_BUFFERS - 1)];
+    buf->addr = (uint64_t) (uintptr_t) (receptionBuffers + bufferID * BUFFER_SIZE);
+    buf->len = BUFFER_SIZE;
+    buf->bid = bufferID;
+    bufferRingTail++;
+    __atomic_store_n(&(bufferRing[0].resv), bufferRingTail, __ATOMIC_RELEASE);
+}
+
+bool IOUringEngine::queueSend(const uint8_t *packet, 
+                              size_t length, 
+                              const struct sockaddr_in &to, 
+                              unsigned short key)
+{
+    if(length > BUFFER_SIZE)
+        return false;
+
+    submissionMutex.lock();
+    struct io_uring_sqe *sqe = NULL;
+    if(nbFreeSlots == 0 || (sqe = getSQE()) == NULL)
+    {
+        submissionMutex.unlock();
+        return false;
+    }
+
+    unsigned short slot = freeSlots[--nbFreeSlots];
+    memcpy(sendBuffers + slot * BUFFER_SIZE, packet, length);
+    sendVectors[slot].iov_len = length;
+    sendAddresses[slot] = to;
+    sendKeys[slot] = key;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = sendSocket;
+    sqe->addr = (uint64_t) (uintptr_t) &sendHeaders[slot];
+    sqe->len = 1;
+    sqe->user_data = TAG_SEND | slot;
+    publishSQE();
+
+    if(SQPoll)
+    {
+        // Full barrier: the kernel thread must see the new tail before we read its flags
+        __sync_synchronize();
+        if(__atomic_load_n(SQFlags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP)
+            uringEnter(ringFD, 0, 0, IORING_ENTER_SQ_WAKEUP, NULL, 0);
+        pendingSubmissions = 0;
+    }
+    else
+    {
+        /*
+         * The engine thread submits the pending entries in batches. If it is idle, the entry is 
+         * submitted at once, and its completion wakes up the engine thread for the next ones.
+         */
+        
+        nbQueuedSends++;
+        if(engineIdle || pendingSubmissions >= SEND_BATCH)
+        {
+            submitPending();
+            engineIdle = false;
+        }
+    }
+    submissionMutex.unlock();
+    return true;
+}
+
+void IOUringEngine::processCompletions()
+{
+    unsigned toSubmit = 0;
+    long period = WAIT_PERIOD;
+    submissionMutex.lock();
+    if(!SQPoll)
+    {
+        toSubmit = pendingSubmissions;
+        if(nbQueuedSends > 0)
+            period = SUBMIT_PERIOD;
+        engineIdle = (nbQueuedSends == 0);
+        nbQueuedSends = 0;
+    }
+    pendingSubmissions = 0;
+    submissionMutex.unlock();
+
+    struct __kernel_timespec waitPeriod;
+    waitPeriod.tv_sec = 0;
+    waitPeriod.tv_nsec = period * 1000000;
+
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.ts = (uint64_t) (uintptr_t) &waitPeriod;
+
+    unsigned flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    if(SQPoll)
+        flags |= IORING_ENTER_SQ_WAKEUP;
+    int nbSubmitted = uringEnter(ringFD, toSubmit, 1, flags, &arg, sizeof(arg));
+    if(toSubmit > 0)
+    {
+        // Entries which were not consumed are submitted again at the next call
+        unsigned nbConsumed = (nbSubmitted > 0) ? (unsigned) nbSubmitted : 0;
+        submissionMutex.lock();
+        nbSubmitCalls++;
+        if(nbConsumed < toSubmit)
+            pendingSubmissions += toSubmit - nbConsumed;
+        submissionMutex.unlock();
+    }
+
+    unsigned head = *CQHead;
+    unsigned tail = __atomic_load_n(CQTail, __ATOMIC_ACQUIRE);
+    bool rearmICMP = false, rearmTCP = false;
+    while(head != tail)
+    {
+        struct io_uring_cqe *cqe = &CQEs[head & (*CQMask)];
+        uint64_t tag = cqe->user_data & (((uint64_t) 0xffffffff) << 32);
+
+        if(tag == TAG_SEND)
+        {
+            unsigned short slot = (unsigned short) (cqe->user_data & 0xffff);
+            submissionMutex.lock();
+            unsigned short key = sendKeys[slot];
+            freeSlots[nbFreeSlots++] = slot;
+            if(cqe->res < 0)
+                nbFailedSends++;
+            submissionMutex.unlock();
+            
+            // The prober is told at once, instead of waiting for a reply until its timeout
+            if(cqe->res < 0)
+                dispatchFailure(key, -cqe->res);
+        }
+        else
+        {
+            if(cqe->flags & IORING_CQE_F_BUFFER)
+            {
+                unsigned short bufferID = (unsigned short) (cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+                if(cqe->res > 0)
+                    dispatch(receptionBuffers + bufferID * BUFFER_SIZE, (size_t) cqe->res);
+                recycleBuffer(bufferID);
+            }
+            else if(cqe->res == -EINVAL && multishot)
+            {
+                multishot = false; // Kernel older than 6.0: single-shot receives from now on
+            }
+
+            // Without IORING_CQE_F_MORE, the request is over and must be armed again
+            if(!(cqe->flags & IORING_CQE_F_MORE))
+            {
+                if(tag == TAG_RECEIVE_ICMP)
+                    rearmICMP = true;
+                else
+                    rearmTCP = true;
+            }
+        }
+        head++;
+    }
+    __atomic_store_n(CQHead, head, __ATOMIC_RELEASE);
+
+    if(rearmICMP || rearmTCP)
+    {
+        submissionMutex.lock();
+        if(rearmICMP)
+            armReceive(ICMPSocket, TAG_RECEIVE_ICMP);
+        if(rearmTCP && TCPSocket >= 0)
+            armReceive(TCPSocket, TAG_RECEIVE_TCP);
+        submissionMutex.unlock();
+    }
+}
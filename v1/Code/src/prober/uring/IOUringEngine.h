@@ -0,0 +1,141 @@
+/*
+ * IOUringEngine.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * This class implements a shared send/receive path for the probers built on io_uring (used via
+ * raw system calls, so no additional library is required). It owns a raw sending socket and the
+ * raw receiving sockets (ICMP, plus TCP when probing with TCP). On these receiving sockets, a
+ * multishot receive request stays armed: the kernel fills buffers taken from a ring of provided
+ * buffers and posts one completion per packet, without any system call from user space. A single
+ * engine thread (see IOUringCompletionUnit) reaps these completions and dispatches the replies to
+ * the subscribed probers (see ReplyDispatcher).
+ *
+ * Probes are copied in a send slot and queued as submission queue entries (SQEs). Without SQPOLL,
+ * the entries are submitted in batches: while probes are being sent, the engine thread wakes up
+ * every SUBMIT_PERIOD ms and submits all pending entries with the same system call it uses to reap
+ * the completions, and the thread queueing a probe only submits by itself once SEND_BATCH entries
+ * are pending. When the engine thread is idle (no probe during its last wait), the first probe is
+ * submitted at once; its completion wakes up the engine thread, which then submits the next ones.
+ * With SQPOLL, a kernel thread polls the submission queue and sending requires no system call at
+ * all (except for waking up this kernel thread after a long idle period).
+ *
+ * A send which fails (e.g. ENOBUFS) is reported to the subscription(s) of the probe (see
+ * ReplyDispatcher::dispatchFailure()), so that the prober gets a SocketSendException instead of
+ * waiting for a reply until its timeout.
+ *
+ * The constructor throws a SocketException if the kernel lacks any required feature (io_uring
+ * itself, extended arguments for io_uring_enter() i.e. Linux 5.11, rings of provided buffers i.e.
+ * Linux 5.19) or if io_uring is disabled, so the caller can fall back to the usual reception.
+ * If multishot receive is not supported (Linux < 6.0), single-shot receives are re-armed after
+ * each packet instead.
+ */
+
+#ifndef IOURINGENGINE_H_
+#define IOURINGENGINE_H_
+
+#include <inttypes.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <linux/io_uring.h>
+
+#include "../fanout/ReplyDispatcher.h"
+#include "../exception/SocketException.h"
+#include "../../common/thread/Thread.h"
+#include "../../common/thread/Mutex.h"
+
+class IOUringEngine : public ReplyDispatcher
+{
+public:
+
+    static const unsigned int RING_ENTRIES = 1024;
+    static const unsigned short NB_RECEPTION_BUFFERS = 1024; // Must be a power of 2
+    static const unsigned short NB_SEND_SLOTS = 512;
+    static const size_t BUFFER_SIZE = 512;
+    static const unsigned short NB_SLICES = 16;
+    static const unsigned short BUFFER_GROUP = 0;
+
+    // Maximum time (in ms) the engine thread waits for completions before checking if it should stop
+    static const long WAIT_PERIOD = 100;
+    
+    // Batched submission (without SQPOLL): period (in ms) of the engine thread while probes are sent
+    static const long SUBMIT_PERIOD = 1;
+    static const unsigned SEND_BATCH = 32;
+
+    IOUringEngine(bool acceptTCP, bool useSQPoll) throw(SocketException);
+    ~IOUringEngine();
+
+    // Starts and stops the engine thread
+    void start() throw(ThreadException);
+    void stop();
+    bool isStopping();
+
+    // Overriden to queue the probe as a SQE (returns false if no send slot is free)
+    bool queueSend(const uint8_t *packet, size_t length, const struct sockaddr_in &to, unsigned short key);
+
+    // Called in a loop by the engine thread: submits pending entries and reaps completions
+    void processCompletions();
+
+    inline bool usingSQPoll() { return this->SQPoll; }
+    inline bool usingMultishot() { return this->multishot; }
+    inline unsigned long getNbFailedSends() { return this->nbFailedSends; }
+    inline unsigned long getNbSubmitCalls() { return this->nbSubmitCalls; }
+
+private:
+
+    // Ring and its mapped memory
+    int ringFD;
+    bool SQPoll;
+    void *SQRingPtr, *CQRingPtr;
+    size_t SQRingSize, CQRingSize, SQEsSize;
+    unsigned *SQHead, *SQTail, *SQMask, *SQFlags, *SQArray;
+    unsigned SQEntries;
+    struct io_uring_sqe *SQEs;
+    unsigned *CQHead, *CQTail, *CQMask;
+    struct io_uring_cqe *CQEs;
+
+    // Provided buffers (reception)
+    struct io_uring_buf *bufferRing;
+    size_t bufferRingSize;
+    uint8_t *receptionBuffers;
+    uint16_t bufferRingTail;
+    bool multishot;
+
+    // Sockets
+    int sendSocket, ICMPSocket, TCPSocket;
+
+    // Send slots (probe copy, message header, I/O vector, destination)
+    uint8_t *sendBuffers;
+    struct msghdr *sendHeaders;
+    struct iovec *sendVectors;
+    struct sockaddr_in *sendAddresses;
+    unsigned short *sendKeys; // Identifier of the probe (to report a failed send)
+    unsigned short *freeSlots;
+    unsigned short nbFreeSlots;
+    unsigned long nbFailedSends;
+
+    // Protects the submission queue, the send slots and the pending submissions counter
+    Mutex submissionMutex;
+    unsigned pendingSubmissions;
+    unsigned long nbQueuedSends; // Since the last wait of the engine thread
+    bool engineIdle; // True if the engine thread is in a long wait (i.e., no probe was sent)
+    unsigned long nbSubmitCalls;
+
+    Thread *engineThread;
+    Mutex stopMutex;
+    bool stopping;
+
+    // Private methods (the first four expect submissionMutex to be locked)
+    struct io_uring_sqe *getSQE();
+    void publishSQE();
+    void armReceive(int socketFD, uint64_t tag);
+    void submitPending();
+    void recycleBuffer(unsigned short bufferID);
+    void release();
+
+};
+
+#endif /* IOURINGENGINE_H_ */
@@ -0,0 +1,431 @@
+/*
+ * XDPReceiver.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in XDPReceiver.h (see this file to learn further about the goals
+ * of such class).
+ */
+
+#include <unistd.h>
+#include <dirent.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include "XDPReceiver.h"
+#include "XDPReceptionUnit.h"
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+static int bpfCall(int command, union bpf_attr *attr)
+{
+    return (int) syscall(__NR_bpf, command, attr, sizeof(union bpf_attr));
+}
+
+static struct bpf_insn instruction(uint8_t code, uint8_t dst, uint8_t src, int16_t offset, int32_t imm)
+{
+    struct bpf_insn insn;
+    memset(&insn, 0, sizeof(insn));
+    insn.code = code;
+    insn.dst_reg = dst;
+    insn.src_reg = src;
+    insn.off = offset;
+    insn.imm = imm;
+    return insn;
+}
+
+/*
+ * Positions (in the program) of the targets of the jumps. Jump offsets are relative to the next
+ * instruction, hence the "- 1" in the jumps below.
+ */
+
+static const int16_t PROGRAM_TCP = 21;
+static const int16_t PROGRAM_REDIRECT = 28;
+static const int16_t PROGRAM_PASS = 34;
+static const unsigned int PROGRAM_LENGTH = 36;
+
+XDPReceiver::XDPReceiver(const InetAddress &localIPAddress,
+                         bool acceptTCP,
+                         bool forceGeneric) throw(SocketException):
+ReplyDispatcher(countReceiveQueues(findInterfaceName(localIPAddress))),
+interfaceIndex(0),
+nativeMode(false),
+nbQueues(0),
+queues(NULL),
+mapFD(-1),
+programFD(-1),
+linkFD(-1),
+workers(NULL),
+stopMutex(Mutex::ERROR_CHECKING_MUTEX),
+stopping(false)
+{
+    interfaceName = findInterfaceName(localIPAddress);
+    if(interfaceName.empty() || (interfaceIndex = if_nametoindex(interfaceName.c_str())) == 0)
+        throw SocketException("Can NOT find the interface bearing the probing address.");
+
+    // Older kernels (< 5.11) account BPF maps and UMEMs as locked memory
+    struct rlimit unlimited;
+    unlimited.rlim_cur = RLIM_INFINITY;
+    unlimited.rlim_max = RLIM_INFINITY;
+    setrlimit(RLIMIT_MEMLOCK, &unlimited);
+
+    // One slice of subscriptions per receive queue, i.e., per reception worker
+    nbQueues = nbSlices;
+
+    queues = new Queue[nbQueues];
+    workers = new Thread*[nbQueues];
+    for(unsigned short i = 0; i < nbQueues; i++)
+    {
+        memset(&queues[i], 0, sizeof(Queue));
+        queues[i].socket = -1;
+        queues[i].RXRing = MAP_FAILED;
+        queues[i].fillRing = MAP_FAILED;
+        queues[i].UMEM = (uint8_t*) MAP_FAILED;
+        workers[i] = NULL;
+    }
+
+    try
+    {
+        // Map of the AF_XDP sockets, indexed by receive queue
+        union bpf_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.map_type = BPF_MAP_TYPE_XSKMAP;
+        attr.key_size = sizeof(uint32_t);
+        attr.value_size = sizeof(uint32_t);
+        attr.max_entries = nbQueues;
+        if((mapFD = bpfCall(BPF_MAP_CREATE, &attr)) < 0)
+        {
+            if(errno == EPERM)
+                throw SocketException("Can NOT create the eBPF map. The process does not have appropriate privileges.");
+            throw SocketException("Can NOT create the eBPF map (AF_XDP requires Linux 4.18).");
+        }
+
+        for(unsigned short i = 0; i < nbQueues; i++)
+            openQueue(i);
+
+        loadProgram(htonl((uint32_t) localIPAddress.getULongAddress()), acceptTCP);
+
+        // Native mode first (unless told otherwise), then generic mode
+        if(!forceGeneric && attachProgram(XDP_FLAGS_DRV_MODE))
+            nativeMode = true;
+        else if(!attachProgram(XDP_FLAGS_SKB_MODE))
+            throw SocketException("Can NOT attach the XDP program to " + interfaceName + " (BPF links for XDP require Linux 5.9; no other XDP program must be attached).");
+    }
+    catch(SocketException &e)
+    {
+        release();
+        throw;
+    }
+}
+
+XDPReceiver::~XDPReceiver()
+{
+    this->stop();
+    release();
+}
+
+void XDPReceiver::release()
+{
+    // Detaches the program first, so the kernel stops redirecting frames
+    if(linkFD >= 0)
+        close(linkFD);
+    if(programFD >= 0)
+        close(programFD);
+    if(mapFD >= 0)
+        close(mapFD);
+    linkFD = programFD = mapFD = -1;
+
+    if(queues != NULL)
+    {
+        for(unsigned short i = 0; i < nbQueues; i++)
+        {
+            if(queues[i].RXRing != MAP_FAILED)
+                munmap(queues[i].RXRing, queues[i].RXRingSize);
+            if(queues[i].fillRing != MAP_FAILED)
+                munmap(queues[i].fillRing, queues[i].fillRingSize);
+            if(queues[i].socket >= 0)
+                close(queues[i].socket);
+            if(queues[i].UMEM != MAP_FAILED)
+                munmap(queues[i].UMEM, NB_FRAMES * FRAME_SIZE);
+        }
+        delete[] queues;
+        queues = NULL;
+    }
+
+    delete[] workers;
+    workers = NULL;
+}
+
+void XDPReceiver::openQueue(unsigned short index) throw(SocketException)
+{
+    Queue *q = &queues[index];
+    if((q->socket = socket(AF_XDP, SOCK_RAW, 0)) < 0)
+        throw SocketException("Can NOT create AF_XDP socket.");
+
+    // UMEM: page-aligned area divided in frames
+    q->UMEM = (uint8_t*) mmap(NULL, NB_FRAMES * FRAME_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(q->UMEM == MAP_FAILED)
+        throw SocketException("Can NOT allocate the UMEM of an AF_XDP socket.");
+
+    struct xdp_umem_reg UMEMRegistration;
+    memset(&UMEMRegistration, 0, sizeof(UMEMRegistration));
+    UMEMRegistration.addr = (uint64_t) (uintptr_t) q->UMEM;
+    UMEMRegistration.len = NB_FRAMES * FRAME_SIZE;
+    UMEMRegistration.chunk_size = FRAME_SIZE;
+    UMEMRegistration.headroom = 0;
+    if(setsockopt(q->socket, SOL_XDP, XDP_UMEM_REG, &UMEMRegistration, sizeof(UMEMRegistration)) < 0)
+        throw SocketException("Can NOT register the UMEM of an AF_XDP socket.");
+
+    // The completion ring is never used (no sending) but binding requires it
+    const uint32_t ringSize = NB_FRAMES;
+    if(setsockopt(q->socket, SOL_XDP, XDP_UMEM_FILL_RING, &ringSize, sizeof(ringSize)) < 0 ||
+       setsockopt(q->socket, SOL_XDP, XDP_UMEM_COMPLETION_RING, &ringSize, sizeof(ringSize)) < 0 ||
+       setsockopt(q->socket, SOL_XDP, XDP_RX_RING, &ringSize, sizeof(ringSize)) < 0)
+        throw SocketException("Can NOT create the rings of an AF_XDP socket.");
+
+    struct xdp_mmap_offsets offsets;
+    socklen_t offsetsLength = sizeof(offsets);
+    if(getsockopt(q->socket, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &offsetsLength) < 0)
+        throw SocketException("Can NOT get the ring offsets of an AF_XDP socket.");
+
+    q->RXRingSize = offsets.rx.desc + NB_FRAMES * sizeof(struct xdp_desc);
+    q->RXRing = mmap(NULL, q->RXRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, q->socket, XDP_PGOFF_RX_RING);
+    // mmap64(): the offset of the fill ring does not fit in 32 bits
+    q->fillRingSize = offsets.fr.desc + NB_FRAMES * sizeof(uint64_t);
+    q->fillRing = mmap64(NULL, q->fillRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, q->socket, XDP_UMEM_PGOFF_FILL_RING);
+    if(q->RXRing == MAP_FAILED || q->fillRing == MAP_FAILED)
+        throw SocketException("Can NOT map the rings of an AF_XDP socket.");
+
+    uint8_t *RXBase = (uint8_t*) q->RXRing;
+    q->RXProducer = (uint32_t*) (RXBase + offsets.rx.producer);
+    q->RXConsumer = (uint32_t*) (RXBase + offsets.rx.consumer);
+    q->RXDescriptors = (struct xdp_desc*) (RXBase + offsets.rx.desc);
+
+    uint8_t *fillBase = (uint8_t*) q->fillRing;
+    q->fillProducer = (uint32_t*) (fillBase + offsets.fr.producer);
+    q->fillConsumer = (uint32_t*) (fillBase + offsets.fr.consumer);
+    q->fillAddresses = (uint64_t*) (fillBase + offsets.fr.desc);
+
+    // Hands all frames to the kernel
+    for(uint32_t i = 0; i < NB_FRAMES; i++)
+        q->fillAddresses[i] = (uint64_t) i * FRAME_SIZE;
+    __atomic_store_n(q->fillProducer, NB_FRAMES, __ATOMIC_RELEASE);
+
+    // No flag: the kernel uses zero-copy if the driver supports it, copy mode otherwise
+    struct sockaddr_xdp address;
+    memset(&address, 0, sizeof(address));
+    address.sxdp_family = AF_XDP;
+    address.sxdp_ifindex = interfaceIndex;
+    address.sxdp_queue_id = index;
+    if(bind(q->socket, (struct sockaddr*) &address, sizeof(address)) < 0)
+        throw SocketException("Can NOT bind an AF_XDP socket to " + interfaceName + ".");
+
+    union bpf_attr attr;
+    uint32_t key = index, value = (uint32_t) q->socket;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_fd = mapFD;
+    attr.key = (uint64_t) (uintptr_t) &key;
+    attr.value = (uint64_t) (uintptr_t) &value;
+    if(bpfCall(BPF_MAP_UPDATE_ELEM, &attr) < 0)
+        throw SocketException("Can NOT insert an AF_XDP socket in the eBPF map.");
+}
+
+void XDPReceiver::loadProgram(uint32_t localAddress, bool acceptTCP) throw(SocketException)
+{
+    /*
+     * Registers: r6 = context, r2 = start of the frame, r3 = end of the frame. The IP header is
+     * expected right after the Ethernet header, without options (i.e., first byte = 0x45).
+     */
+
+    const uint8_t LDX_W = BPF_LDX | BPF_MEM | BPF_W, LDX_H = BPF_LDX | BPF_MEM | BPF_H;
+    const uint8_t LDX_B = BPF_LDX | BPF_MEM | BPF_B;
+    const uint8_t IP = ETHERNET_HEADER_LENGTH;
+    struct bpf_insn p[PROGRAM_LENGTH] = {
+        instruction(BPF_ALU64 | BPF_MOV | BPF_X, 6, 1, 0, 0),                // 0: r6 = context
+        instruction(LDX_W, 2, 6, offsetof(struct xdp_md, data), 0),          // 1: r2 = data
+        instruction(LDX_W, 3, 6, offsetof(struct xdp_md, data_end), 0),      // 2: r3 = data_end
+        instruction(BPF_ALU64 | BPF_MOV | BPF_X, 4, 2, 0, 0),                // 3
+        instruction(BPF_ALU64 | BPF_ADD | BPF_K, 4, 0, 0, IP + 28),          // 4: r4 = end of ICMP header
+        instruction(BPF_JMP | BPF_JGT | BPF_X, 4, 3, PROGRAM_PASS - 6, 0),   // 5: too short -> pass
+        instruction(LDX_H, 5, 2, 12, 0),                                     // 6: r5 = EtherType
+        instruction(BPF_JMP | BPF_JNE | BPF_K, 5, 0, PROGRAM_PASS - 8, htons(0x0800)),
+        instruction(LDX_B, 5, 2, IP, 0),                                     // 8: r5 = version/IHL
+        instruction(BPF_JMP | BPF_JNE | BPF_K, 5, 0, PROGRAM_PASS - 10, 0x45),
+        instruction(LDX_W, 5, 2, IP + 16, 0),                                // 10: r5 = destination
+        instruction(BPF_ALU | BPF_MOV | BPF_K, 0, 0, 0, (int32_t) localAddress),
+        instruction(BPF_JMP | BPF_JNE | BPF_X, 5, 0, PROGRAM_PASS - 13, 0),  // 12: not for us -> pass
+        instruction(LDX_B, 5, 2, IP + 9, 0),                                 // 13: r5 = protocol
+        instruction(BPF_JMP | BPF_JNE | BPF_K, 5, 0, PROGRAM_TCP - 15, IPPROTO_ICMP),
+        instruction(LDX_B, 5, 2, IP + 20, 0),                                // 15: r5 = ICMP type
+        instruction(BPF_JMP | BPF_JEQ | BPF_K, 5, 0, PROGRAM_REDIRECT - 17, 0),
+        instruction(BPF_JMP | BPF_JEQ | BPF_K, 5, 0, PROGRAM_REDIRECT - 18, 3),
+        instruction(BPF_JMP | BPF_JEQ | BPF_K, 5, 0, PROGRAM_REDIRECT - 19, 11),
+        instruction(BPF_JMP | BPF_JEQ | BPF_K, 5, 0, PROGRAM_REDIRECT - 20, 14),
+        instruction(BPF_JMP | BPF_JA, 0, 0, PROGRAM_PASS - 21, 0),           // 20: other ICMP -> pass
+        instruction(BPF_JMP | BPF_JNE | BPF_K, 5, 0, PROGRAM_PASS - 22, acceptTCP ? IPPROTO_TCP : 256),
+        instruction(BPF_ALU64 | BPF_MOV | BPF_X, 4, 2, 0, 0),                // 22
+        instruction(BPF_ALU64 | BPF_ADD | BPF_K, 4, 0, 0, IP + 34),          // 23: r4 = after TCP flags
+        instruction(BPF_JMP | BPF_JGT | BPF_X, 4, 3, PROGRAM_PASS - 25, 0),
+        instruction(LDX_B, 5, 2, IP + 33, 0),                                // 25: r5 = TCP flags
+        instruction(BPF_ALU64 | BPF_AND | BPF_K, 5, 0, 0, 0x04),             // 26: RST
+        instruction(BPF_JMP | BPF_JEQ | BPF_K, 5, 0, PROGRAM_PASS - 28, 0),
+        instruction(LDX_W, 2, 6, offsetof(struct xdp_md, rx_queue_index), 0),// 28: r2 = queue
+        instruction(BPF_LD | BPF_DW | BPF_IMM, 1, BPF_PSEUDO_MAP_FD, 0, mapFD), // 29-30: r1 = map
+        instruction(0, 0, 0, 0, 0),
+        instruction(BPF_ALU64 | BPF_MOV | BPF_K, 3, 0, 0, XDP_PASS),         // 31: no socket -> pass
+        instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),     // 32
+        instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),                         // 33
+        instruction(BPF_ALU64 | BPF_MOV | BPF_K, 0, 0, 0, XDP_PASS),         // 34: pass
+        instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0)                          // 35
+    };
+
+    const char *license = "GPL";
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.expected_attach_type = BPF_XDP;
+    attr.insns = (uint64_t) (uintptr_t) p;
+    attr.insn_cnt = PROGRAM_LENGTH;
+    attr.license = (uint64_t) (uintptr_t) license;
+    if((programFD = bpfCall(BPF_PROG_LOAD, &attr)) < 0)
+        throw SocketException("Can NOT load the XDP program.");
+}
+
+bool XDPReceiver::attachProgram(uint32_t flags)
+{
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.link_create.prog_fd = programFD;
+    attr.link_create.target_ifindex = interfaceIndex;
+    attr.link_create.attach_type = BPF_XDP;
+    attr.link_create.flags = flags;
+    linkFD = bpfCall(BPF_LINK_CREATE, &attr);
+    return linkFD >= 0;
+}
+
+void XDPReceiver::start() throw(ThreadException)
+{
+    for(unsigned short i = 0; i < nbQueues; i++)
+    {
+        workers[i] = new Thread(new XDPReceptionUnit(this, i));
+        workers[i]->start();
+    }
+}
+
+void XDPReceiver::stop()
+{
+    stopMutex.lock();
+    stopping = true;
+    stopMutex.unlock();
+
+    if(workers == NULL)
+        return;
+
+    for(unsigned short i = 0; i < nbQueues; i++)
+    {
+        if(workers[i] != NULL)
+        {
+            workers[i]->join();
+            delete workers[i];
+            workers[i] = NULL;
+        }
+    }
+}
+
+bool XDPReceiver::isStopping()
+{
+    bool result = false;
+    stopMutex.lock();
+    result = stopping;
+    stopMutex.unlock();
+    return result;
+}
+
+void XDPReceiver::receive(unsigned short index)
+{
+    Queue *q = &queues[index];
+    uint32_t consumer = *(q->RXConsumer);
+    uint32_t producer = __atomic_load_n(q->RXProducer, __ATOMIC_ACQUIRE);
+    if(consumer == producer)
+        return;
+
+    // Every frame read here came from the fill ring, so there is always room to give it back
+    uint32_t fillProducer = *(q->fillProducer);
+    while(consumer != producer)
+    {
+        struct xdp_desc *desc = &(q->RXDescriptors[consumer & (NB_FRAMES - 1)]);
+        if(desc->len > ETHERNET_HEADER_LENGTH)
+        {
+            const uint8_t *frame = q->UMEM + desc->addr;
+            dispatch(frame + ETHERNET_HEADER_LENGTH, desc->len - ETHERNET_HEADER_LENGTH);
+        }
+
+        q->fillAddresses[fillProducer & (NB_FRAMES - 1)] = desc->addr & ~((uint64_t) FRAME_SIZE - 1);
+        fillProducer++;
+        consumer++;
+    }
+    __atomic_store_n(q->fillProducer, fillProducer, __ATOMIC_RELEASE);
+    __atomic_store_n(q->RXConsumer, consumer, __ATOMIC_RELEASE);
+}
+
+string XDPReceiver::findInterfaceName(const InetAddress &localIPAddress)
+{
+    string result = "";
+    struct ifaddrs *interfaceList = NULL;
+    if(getifaddrs(&interfaceList) < 0)
+        return result;
+
+    for(struct ifaddrs *it = interfaceList; it != NULL; it = it->ifa_next)
+    {
+        if(it->ifa_addr == NULL || it->ifa_addr->sa_family != AF_INET)
+            continue;
+
+        struct sockaddr_in *la = (struct sockaddr_in*) (it->ifa_addr);
+        if((unsigned long) ntohl(la->sin_addr.s_addr) == localIPAddress.getULongAddress())
+        {
+            result = string(it->ifa_name);
+            break;
+        }
+    }
+
+    freeifaddrs(interfaceList);
+    return result;
+}
+
+unsigned short XDPReceiver::countReceiveQueues(const string &interfaceName)
+{
+    unsigned short count = 0;
+    string path = "/sys/class/net/" + interfaceName + "/queues";
+    DIR *dir = opendir(path.c_str());
+    if(dir != NULL)
+    {
+        struct dirent *entry = NULL;
+        while((entry = readdir(dir)) != NULL)
+            if(strncmp(entry->d_name, "rx-", 3) == 0)
+                count++;
+        closedir(dir);
+    }
+
+    if(count == 0)
+        count = 1;
+    else if(count > MAX_NB_QUEUES)
+        count = MAX_NB_QUEUES;
+    return count;
+}
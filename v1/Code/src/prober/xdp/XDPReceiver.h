@@ -0,0 +1,121 @@
+/*
+ * XDPReceiver.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * This class implements a reception path for the replies based on AF_XDP, for probing at rates
+ * where even the packet fanout group (see FanoutReceiver) becomes the bottleneck, e.g. while
+ * prescanning very large target lists. A small eBPF program (assembled here, so neither clang
+ * nor libbpf is required) is attached to the egress interface and runs on each incoming frame
+ * before the kernel network stack handles it. Frames carrying an ICMP echo/timestamp reply, a
+ * time exceeded or destination unreachable message, or (when probing with TCP) a TCP reset
+ * destined to the probing address are redirected to an AF_XDP socket bound to the receive queue
+ * of the frame; everything else goes through the network stack as usual.
+ *
+ * Each AF_XDP socket owns a UMEM, i.e., a memory area shared with the kernel and divided in
+ * frames. The kernel writes the replies directly in these frames, and a reception worker (one
+ * per receive queue, see XDPReceptionUnit) reads them in place and dispatches them to the
+ * subscribed probers (see ReplyDispatcher) before handing the frames back to the kernel.
+ *
+ * The program is attached in native (driver) mode when the driver supports it, and in generic
+ * (SKB) mode otherwise, which works on any interface (including veth pairs) but is slower. The
+ * program is attached through a BPF link, so it is detached as soon as RTrack exits, even upon
+ * crashing. The constructor throws a SocketException if the kernel lacks any required feature
+ * (BPF links for XDP appeared in Linux 5.9), if the interface is not an Ethernet-like interface
+ * or if another XDP program is already attached to it, so the caller can fall back to the usual
+ * reception.
+ *
+ * N.B.: replies carrying IP options (rare) are not redirected and are therefore not seen by the
+ * probers.
+ */
+
+#ifndef XDPRECEIVER_H_
+#define XDPRECEIVER_H_
+
+#include <inttypes.h>
+#include <sys/types.h>
+#include <linux/if_xdp.h>
+#include <string>
+using std::string;
+
+#include "../fanout/ReplyDispatcher.h"
+#include "../exception/SocketException.h"
+#include "../../common/inet/InetAddress.h"
+#include "../../common/thread/Thread.h"
+#include "../../common/thread/Mutex.h"
+
+class XDPReceiver : public ReplyDispatcher
+{
+public:
+
+    static const unsigned short MAX_NB_QUEUES = 64;
+    static const uint32_t NB_FRAMES = 2048; // Per queue; also the size of the rings (power of 2)
+    static const uint32_t FRAME_SIZE = 2048;
+    static const size_t ETHERNET_HEADER_LENGTH = 14;
+
+    // Time (in ms) after which a worker checks if it should stop when no packet arrives
+    static const int POLLING_PERIOD = 100;
+
+    /*
+     * Attaches the program to the interface bearing the probing address and binds one AF_XDP
+     * socket per receive queue. "acceptTCP" must be true when probing with TCP (to capture
+     * resets); "forceGeneric" skips the attempt to attach the program in native mode.
+     */
+
+    XDPReceiver(const InetAddress &localIPAddress, bool acceptTCP, bool forceGeneric) throw(SocketException);
+    ~XDPReceiver();
+
+    // Starts and stops the reception workers
+    void start() throw(ThreadException);
+    void stop();
+
+    // Methods used by the reception workers
+    int getSocket(unsigned short index) { return queues[index].socket; }
+    void receive(unsigned short index);
+    bool isStopping();
+
+    inline string getInterfaceName() { return this->interfaceName; }
+    inline unsigned short getNbQueues() { return this->nbQueues; }
+    inline bool usingNativeMode() { return this->nativeMode; }
+
+private:
+
+    // AF_XDP socket bound to a receive queue, with its UMEM and its (mapped) rings
+    struct Queue
+    {
+        int socket;
+        uint8_t *UMEM;
+        void *RXRing, *fillRing;
+        size_t RXRingSize, fillRingSize;
+        uint32_t *RXProducer, *RXConsumer, *fillProducer, *fillConsumer;
+        struct xdp_desc *RXDescriptors;
+        uint64_t *fillAddresses;
+    };
+
+    string interfaceName;
+    unsigned int interfaceIndex;
+    bool nativeMode;
+
+    unsigned short nbQueues;
+    Queue *queues;
+
+    // File descriptors of the eBPF objects
+    int mapFD, programFD, linkFD;
+
+    Thread **workers;
+    Mutex stopMutex;
+    bool stopping;
+
+    // Private methods
+    void openQueue(unsigned short index) throw(SocketException);
+    void loadProgram(uint32_t localAddress, bool acceptTCP) throw(SocketException);
+    bool attachProgram(uint32_t flags);
+    void release();
+
+    static string findInterfaceName(const InetAddress &localIPAddress);
+    static unsigned short countReceiveQueues(const string &interfaceName);
+
+};
+
+#endif /* XDPRECEIVER_H_ */
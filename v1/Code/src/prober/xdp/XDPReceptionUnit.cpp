@@ -0,0 +1,40 @@
+/*
+ * XDPReceptionUnit.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in XDPReceptionUnit.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <poll.h>
+
+#include "XDPReceptionUnit.h"
+
+XDPReceptionUnit::XDPReceptionUnit(XDPReceiver *parent, unsigned short index)
+{
+    this->parent = parent;
+    this->index = index;
+}
+
+XDPReceptionUnit::~XDPReceptionUnit()
+{
+}
+
+void XDPReceptionUnit::run()
+{
+    struct pollfd pfd;
+    pfd.fd = parent->getSocket(index);
+    pfd.events = POLLIN;
+
+    while(!parent->isStopping())
+    {
+        pfd.revents = 0;
+        int pollResult = poll(&pfd, 1, XDPReceiver::POLLING_PERIOD);
+        if(pollResult <= 0)
+            continue;
+
+        parent->receive(index);
+    }
+}
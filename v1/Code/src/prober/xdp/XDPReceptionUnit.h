@@ -0,0 +1,34 @@
+/*
+ * XDPReceptionUnit.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * This class, inheriting Runnable, is the body of one reception worker of XDPReceiver. It waits
+ * for the kernel to fill the RX ring of the AF_XDP socket of its receive queue, then lets the
+ * receiver read the frames in place and dispatch them. It polls with a short period in order to
+ * notice when the receiver is being stopped.
+ */
+
+#ifndef XDPRECEPTIONUNIT_H_
+#define XDPRECEPTIONUNIT_H_
+
+#include "../../common/thread/Runnable.h"
+#include "XDPReceiver.h"
+
+class XDPReceptionUnit : public Runnable
+{
+public:
+
+    XDPReceptionUnit(XDPReceiver *parent, unsigned short index);
+    ~XDPReceptionUnit();
+    void run();
+
+private:
+
+    XDPReceiver *parent;
+    unsigned short index;
+
+};
+
+#endif /* XDPRECEPTIONUNIT_H_ */
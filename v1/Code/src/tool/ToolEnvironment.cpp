@@ -9,6 +9,7 @@
  */
 
 #include <sys/stat.h> // For CHMOD edition
+#include <netinet/in.h> // For IPPROTO_* constants
 
 #include "ToolEnvironment.h"
 
@@ -44,22 +45,64 @@ probeRegulatingPeriod(regulatingPeriod),
 probeThreadDelay(threadDelay), 
 maxConsecutiveAnonHops(mCAH), 
 maxCycles(mC), 
-bisTracesCounter(0), 
+bisTracesCounter(0),
+differentialBisTraces(false), 
+bisTraceFlows(0), 
+nbLoadBalancedTargets(0), 
+nbPersistentTargets(0), 
 RLNbExperiments(RLExps), 
 RLDelayExperiments(RLDelay), 
 RLMinResponseRatio(RLRatio), 
 displayMode(dMode), 
 maxThreads(mT), 
+asyncTracerouteTargets(0), 
+asyncTracerouteWindow(1), 
+statelessMaxTTL(0), 
+statelessGapLimit(0), 
+doubletreeStartTTL(0), 
+localStopSet(NULL), 
+globalStopSet(NULL), 
+rateLimitMonitor(NULL), 
+unreachablePrefixCache(NULL), 
+concurrencyController(NULL), 
+siblingPrefixLength(0), 
+previousCampaign(NULL), 
+hitlist(NULL), 
+checkpointJournal(NULL), 
 totalProbes(0), 
 totalSuccessfulProbes(0), 
 flagEmergencyStop(false)
 {
     this->IPTable = new IPLookUpTable();
+    
+    int proberProtocol = IPPROTO_ICMP;
+    if(probingProtocol == PROBING_PROTOCOL_UDP)
+        proberProtocol = IPPROTO_UDP;
+    else if(probingProtocol == PROBING_PROTOCOL_TCP)
+        proberProtocol = IPPROTO_TCP;
+    this->proberPool = new ProberPool(probeAttentionMessage, proberProtocol, maxThreads);
 }
 
 ToolEnvironment::~ToolEnvironment()
 {
     delete IPTable;
+    delete proberPool;
+    if(localStopSet != NULL)
+        delete localStopSet;
+    if(globalStopSet != NULL)
+        delete globalStopSet;
+    if(rateLimitMonitor != NULL)
+        delete rateLimitMonitor;
+    if(unreachablePrefixCache != NULL)
+        delete unreachablePrefixCache;
+    if(concurrencyController != NULL)
+        delete concurrencyController;
+    if(previousCampaign != NULL)
+        delete previousCampaign;
+    if(hitlist != NULL)
+        delete hitlist;
+    if(checkpointJournal != NULL)
+        delete checkpointJournal;
     
     for(list<Trace*>::iterator it = traces.begin(); it != traces.end(); it++)
     {
@@ -76,9 +119,18 @@ ToolEnvironment::~ToolEnvironment()
 
 void ToolEnvironment::addTrace(Trace *newTrace)
 {
-    if(bisTracesCounter >= 1)
+    if(bisTracesCounter >= 1 && newTrace->getOpinionNumber() == 1)
         newTrace->setOpinionNumber(bisTracesCounter + 1);
     traces.push_back(newTrace);
+    
+    if(checkpointJournal != NULL)
+    {
+        IPTableEntry *target = IPTable->lookUp(newTrace->getTargetIP());
+        unsigned char targetTTL = 0;
+        if(target != NULL && target->getTTL() != IPTableEntry::NO_KNOWN_TTL)
+            targetTTL = target->getTTL();
+        checkpointJournal->recordTrace(newTrace, targetTTL);
+    }
 }
 
 ostream* ToolEnvironment::getOutputStream()
@@ -143,12 +195,49 @@ void ToolEnvironment::outputRouteRepairs(string filename)
     chmod(path.c_str(), 0766);
 }
 
+void ToolEnvironment::setDoubletree(unsigned char startTTL)
+{
+    this->doubletreeStartTTL = startTTL;
+    if(startTTL > 1 && localStopSet == NULL)
+        localStopSet = new LocalStopSet();
+}
+
+void ToolEnvironment::enableGlobalStopSet(unsigned short verificationRate)
+{
+    if(globalStopSet == NULL)
+        globalStopSet = new GlobalStopSet(verificationRate);
+}
+
+void ToolEnvironment::enableRateLimitMonitor()
+{
+    if(rateLimitMonitor == NULL)
+        rateLimitMonitor = new RateLimitMonitor();
+}
+
+void ToolEnvironment::enableUnreachablePrefixCache(unsigned short budget)
+{
+    if(unreachablePrefixCache == NULL)
+        unreachablePrefixCache = new UnreachablePrefixCache(budget);
+}
+
+void ToolEnvironment::enableConcurrencyController()
+{
+    if(concurrencyController == NULL)
+        concurrencyController = new ConcurrencyController(maxThreads);
+}
+
 void ToolEnvironment::updateProbeAmounts(DirectProber *proberObject)
 {
     totalProbes += proberObject->getNbProbes();
     totalSuccessfulProbes += proberObject->getNbSuccessfulProbes();
 }
 
+void ToolEnvironment::updateProbeAmounts(unsigned int nbProbes, unsigned int nbSuccessfulProbes)
+{
+    totalProbes += nbProbes;
+    totalSuccessfulProbes += nbSuccessfulProbes;
+}
+
 void ToolEnvironment::resetProbeAmounts()
 {
     totalProbes = 0;
@@ -25,10 +25,19 @@ using std::ofstream;
 #include "../common/inet/InetAddress.h"
 #include "../common/inet/NetworkAddress.h"
 #include "../prober/DirectProber.h"
+#include "../prober/pool/ProberPool.h"
 #include "utils/StopException.h" // Not used directly here, but provided to all classes that need it this way
+#include "utils/CheckpointJournal.h"
 #include "structure/IPLookUpTable.h"
 #include "structure/Trace.h"
 #include "structure/RouteRepair.h"
+#include "structure/LocalStopSet.h"
+#include "structure/GlobalStopSet.h"
+#include "structure/PreviousCampaign.h"
+#include "structure/Hitlist.h"
+#include "structure/RateLimitMonitor.h"
+#include "structure/UnreachablePrefixCache.h"
+#include "structure/ConcurrencyController.h"
 
 class ToolEnvironment
 {
@@ -79,6 +88,7 @@ public:
     inline IPLookUpTable *getIPTable() { return this->IPTable; }
     inline list<Trace*> *getTraces() { return &this->traces; }
     inline list<RouteRepair*> *getRouteRepairs() { return &this->routeRepairs; }
+    inline ProberPool *getProberPool() { return this->proberPool; }
     
     // Accesser to the output stream is not inline, because it depends of the settings
     ostream *getOutputStream();
@@ -107,6 +117,24 @@ public:
     
     // Bis traces counter
     inline void incBisTracesCounter() { this->bisTracesCounter++; }
+    inline bool collectingBisTraces() { return this->bisTracesCounter > 0; }
+    
+    // Differential bis traces (only the hops around the anomalies are probed again)
+    inline void setDifferentialBisTraces(bool differential) { this->differentialBisTraces = differential; }
+    inline bool usingDifferentialBisTraces() { return this->differentialBisTraces; }
+    
+    /*
+     * Flow-varied bis traces: amount of flows (0 = not used) for which the hops around the 
+     * anomalies are probed again, in a single pass, and how many targets got different hops 
+     * depending on the flow (load balancing) or the same hops (persistent anomalies). The 
+     * counters must be updated while holding tracesListMutex.
+     */
+    
+    inline void setBisTraceFlows(unsigned short nbFlows) { this->bisTraceFlows = nbFlows; }
+    inline unsigned short getBisTraceFlows() { return this->bisTraceFlows; }
+    inline void countFlowVariedTarget(bool loadBalanced) { loadBalanced ? nbLoadBalancedTargets++ : nbPersistentTargets++; }
+    inline unsigned int getNbLoadBalancedTargets() { return this->nbLoadBalancedTargets; }
+    inline unsigned int getNbPersistentTargets() { return this->nbPersistentTargets; }
     
     // Rate-limit analysis
     inline unsigned short getRLNbExperiments() { return this->RLNbExperiments; }
@@ -120,8 +148,56 @@ public:
     
     inline void setTimeoutPeriod(TimeVal timeout) { this->timeoutPeriod = timeout; }
     
+    // Asynchronous traceroute (see AsyncTracerouteEngine); 0 targets means it is disabled
+    inline void setAsyncTraceroute(unsigned int targets, unsigned short window) { this->asyncTracerouteTargets = targets; this->asyncTracerouteWindow = window; }
+    inline unsigned int getAsyncTracerouteTargets() { return this->asyncTracerouteTargets; }
+    inline unsigned short getAsyncTracerouteWindow() { return this->asyncTracerouteWindow; }
+    
+    // Stateless traceroute (see StatelessTracerouteEngine); a maximum TTL of 0 means it is disabled
+    inline void setStatelessTraceroute(unsigned char maxTTL, unsigned short gapLimit) { this->statelessMaxTTL = maxTTL; this->statelessGapLimit = gapLimit; }
+    inline unsigned char getStatelessTracerouteMaxTTL() { return this->statelessMaxTTL; }
+    inline unsigned short getStatelessTracerouteGapLimit() { return this->statelessGapLimit; }
+    
+    // Doubletree (see LocalStopSet); a start TTL of 0 or 1 means it is disabled
+    void setDoubletree(unsigned char startTTL);
+    inline unsigned char getDoubletreeStartTTL() { return this->doubletreeStartTTL; }
+    inline LocalStopSet *getLocalStopSet() { return this->localStopSet; }
+    
+    // Global stop set (NULL if not used); the verification rate is a percentage of the traces
+    void enableGlobalStopSet(unsigned short verificationRate);
+    inline GlobalStopSet *getGlobalStopSet() { return this->globalStopSet; }
+    
+    // Live rate-limit pacing of the traceroute (NULL if not used)
+    void enableRateLimitMonitor();
+    inline RateLimitMonitor *getRateLimitMonitor() { return this->rateLimitMonitor; }
+    
+    // Cache of the prefixes of unreachable targets (NULL if not used)
+    void enableUnreachablePrefixCache(unsigned short budget);
+    inline UnreachablePrefixCache *getUnreachablePrefixCache() { return this->unreachablePrefixCache; }
+    
+    // Adaptive amount of concurrent tasks (NULL if not used, i.e. emergency stop upon failure)
+    void enableConcurrencyController();
+    inline ConcurrencyController *getConcurrencyController() { return this->concurrencyController; }
+    
+    // Prefix length used to group sibling targets (0 means targets are not grouped)
+    inline void setSiblingPrefixLength(unsigned short length) { this->siblingPrefixLength = length; }
+    inline unsigned short getSiblingPrefixLength() { return this->siblingPrefixLength; }
+    
+    // Previous campaign used for a warm start (NULL if none); it is deleted with the environment
+    inline void setPreviousCampaign(PreviousCampaign *previous) { this->previousCampaign = previous; }
+    inline PreviousCampaign *getPreviousCampaign() { return this->previousCampaign; }
+    
+    // Hitlist of a previous pre-scanning (NULL if none); it is deleted with the environment
+    inline void setHitlist(Hitlist *hitlist) { this->hitlist = hitlist; }
+    inline Hitlist *getHitlist() { return this->hitlist; }
+    
+    // Checkpoint journal (NULL if none); it is deleted (hence synchronized) with the environment
+    inline void setCheckpointJournal(CheckpointJournal *journal) { this->checkpointJournal = journal; }
+    inline CheckpointJournal *getCheckpointJournal() { return this->checkpointJournal; }
+    
     // Methods to handle total amounts of (successful) probes
     void updateProbeAmounts(DirectProber *proberObject);
+    void updateProbeAmounts(unsigned int nbProbes, unsigned int nbSuccessfulProbes);
     void resetProbeAmounts();
     inline unsigned int getTotalProbes() { return this->totalProbes; }
     inline unsigned int getTotalSuccessfulProbes() { return this->totalSuccessfulProbes; }
@@ -159,6 +235,9 @@ private:
     list<Trace*> traces;
     list<RouteRepair*> routeRepairs;
     
+    // Probers shared by successive probing tasks (so that sockets are opened only once)
+    ProberPool *proberPool;
+    
     /*
      * Output streams (main console output and file stream for the external logs). Having both is 
      * useful because the console output stream will still be used to advertise the creation of a 
@@ -181,6 +260,13 @@ private:
     // Single field to number the bis traces
     unsigned short bisTracesCounter;
     
+    // Whether bis traces only re-probe the hops around the anomalies
+    bool differentialBisTraces;
+    
+    // Flows of the flow-varied bis traces and outcomes
+    unsigned short bisTraceFlows;
+    unsigned int nbLoadBalancedTargets, nbPersistentTargets;
+    
     // Fields related to rate-limit analysis (all prefixed with "RL" to avoid confusion)
     unsigned short RLNbExperiments;
     TimeVal &RLDelayExperiments;
@@ -196,6 +282,34 @@ private:
     // Maximum amount of threads involved during the probing steps
     unsigned short maxThreads;
     
+    // Settings of the asynchronous traceroute (amount of targets and TTLs in flight)
+    unsigned int asyncTracerouteTargets;
+    unsigned short asyncTracerouteWindow;
+    
+    // Settings of the stateless traceroute (maximum TTL and gap limit)
+    unsigned char statelessMaxTTL;
+    unsigned short statelessGapLimit;
+    
+    // Doubletree settings and local stop set (NULL if Doubletree is not used)
+    unsigned char doubletreeStartTTL;
+    LocalStopSet *localStopSet;
+    GlobalStopSet *globalStopSet;
+    RateLimitMonitor *rateLimitMonitor;
+    UnreachablePrefixCache *unreachablePrefixCache;
+    ConcurrencyController *concurrencyController;
+    
+    // Prefix length of sibling targets
+    unsigned short siblingPrefixLength;
+    
+    // Dataset of a previous campaign (warm start)
+    PreviousCampaign *previousCampaign;
+    
+    // Responsive targets of a previous pre-scanning
+    Hitlist *hitlist;
+    
+    // Journal of the results, to resume an interrupted campaign
+    CheckpointJournal *checkpointJournal;
+    
     // Fields to record the amount of (successful) probes used during some stage (can be reset)
     unsigned int totalProbes;
     unsigned int totalSuccessfulProbes;
@@ -15,6 +15,7 @@ using std::ostream;
 
 #include "FingerprintMaker.h"
 #include "FingerprintingUnit.h"
+#include "../structure/TargetDispenser.h"
 #include "../../common/thread/Thread.h"
 
 FingerprintMaker::FingerprintMaker(ToolEnvironment *env)
@@ -53,54 +54,33 @@ void FingerprintMaker::probe()
     {
         return;
     }
-    unsigned short nbThreads = 1;
-    unsigned long targetsPerThread = (unsigned long) FingerprintMaker::MINIMUM_TARGETS_PER_THREAD;
-    unsigned long lastTargets = 0;
     
-    // Computes amount of threads and amount of targets being probed per thread
-    if(nbTargets > FingerprintMaker::MINIMUM_TARGETS_PER_THREAD)
-    {
-        if((nbTargets / targetsPerThread) > (unsigned long) maxThreads)
-        {
-            unsigned long factor = 2;
-            while((nbTargets / (targetsPerThread * factor)) > (unsigned long) maxThreads)
-                factor++;
-            
-            targetsPerThread *= factor;
-        }
-        
-        nbThreads = (unsigned short) (nbTargets / targetsPerThread);
-        lastTargets = nbTargets % targetsPerThread;
-        if(lastTargets > 0)
-            nbThreads++;
-    }
-    else
-        lastTargets = nbTargets;
+    // Amount of threads (at least MINIMUM_TARGETS_PER_THREAD targets for each of them)
+    unsigned long nbThreadsLong = nbTargets / (unsigned long) FingerprintMaker::MINIMUM_TARGETS_PER_THREAD;
+    if(nbTargets % (unsigned long) FingerprintMaker::MINIMUM_TARGETS_PER_THREAD > 0)
+        nbThreadsLong++;
+    if(nbThreadsLong > (unsigned long) maxThreads)
+        nbThreadsLong = (unsigned long) maxThreads;
+    unsigned short nbThreads = (unsigned short) nbThreadsLong;
+    
+    // Targets are taken in chunks by the threads (see TargetDispenser)
+    TargetDispenser dispenser(targets, nbThreads);
+    targets.clear();
 
     // Prepares and launches threads
     unsigned short range = (DirectICMPProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID - DirectICMPProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID) / nbThreads;
     Thread **th = new Thread*[nbThreads];
+    for(unsigned short i = 0; i < nbThreads; i++)
+        th[i] = NULL;
     
     for(unsigned short i = 0; i < nbThreads; i++)
     {
-        std::list<InetAddress> targetsSubset;
-        unsigned long toRead = targetsPerThread;
-        if(lastTargets > 0 && i == (nbThreads - 1))
-            toRead = lastTargets;
-        
-        for(unsigned long j = 0; j < toRead; j++)
-        {
-            InetAddress addr(targets.front());
-            targetsSubset.push_back(addr);
-            targets.pop_front();
-        }
-
         Runnable *task = NULL;
         try
         {
             task = new FingerprintingUnit(env, 
                                           this, 
-                                          targetsSubset, 
+                                          &dispenser, 
                                           DirectICMPProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + (i * range), 
                                           DirectICMPProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + (i * range) + range - 1, 
                                           DirectICMPProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ, 
@@ -110,6 +90,13 @@ void FingerprintMaker::probe()
         }
         catch(SocketException &se)
         {
+            // Adaptive concurrency: the units already created take the remaining chunks
+            if(env->getConcurrencyController() != NULL && i > 0)
+            {
+                nbThreads = i;
+                break;
+            }
+            
             // Cleaning remaining threads (if any is set)
             for(unsigned short k = 0; k < nbThreads; k++)
             {
@@ -127,6 +114,12 @@ void FingerprintMaker::probe()
             (*out) << "Unable to create more threads." << endl;
                 
             delete task;
+            
+            if(env->getConcurrencyController() != NULL && i > 0)
+            {
+                nbThreads = i;
+                break;
+            }
         
             // Cleaning remaining threads (if any is set)
             for(unsigned short k = 0; k < nbThreads; k++)
@@ -8,6 +8,9 @@
  * to fingerprint them, using FingerprintingUnit to send the probes themselves. The class is very 
  * similar in construction to NetworkPrescanner, but has been made unique because it might be 
  * differentiated further in the future (extended fingerprinting).
+ *
+ * Oct 19, 2026: as in NetworkPrescanner, the threads take the IPs in small chunks from a shared 
+ * TargetDispenser instead of receiving an equal share of them.
  */
 
 #ifndef FINGERPRINTMAKER_H_
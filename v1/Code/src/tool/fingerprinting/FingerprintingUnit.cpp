@@ -14,58 +14,24 @@ Mutex FingerprintingUnit::makerMutex(Mutex::ERROR_CHECKING_MUTEX);
 
 FingerprintingUnit::FingerprintingUnit(ToolEnvironment *e, 
                                        FingerprintMaker *p, 
-                                       std::list<InetAddress> IPs, 
+                                       TargetDispenser *d, 
                                        unsigned short lbii, 
                                        unsigned short ubii, 
                                        unsigned short lbis, 
                                        unsigned short ubis) throw(SocketException):
 env(e), 
 parent(p), 
-IPsToProbe(IPs)
+dispenser(d)
 {
     try
     {
-        unsigned short protocol = env->getProbingProtocol();
-    
-        if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
-        {
-            int roundRobinSocketCount = 1;
-            
-            prober = new DirectUDPWrappedICMPProber(env->getAttentionMessage(), 
-                                                    roundRobinSocketCount, 
-                                                    env->getTimeoutPeriod(), 
-                                                    env->getProbeRegulatingPeriod(), 
-                                                    lbii, 
-                                                    ubii, 
-                                                    lbis, 
-                                                    ubis, 
-                                                    env->debugMode());
-        }
-        else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
-        {
-            int roundRobinSocketCount = 1;
-            
-            prober = new DirectTCPWrappedICMPProber(env->getAttentionMessage(), 
-                                                    roundRobinSocketCount, 
-                                                    env->getTimeoutPeriod(), 
-                                                    env->getProbeRegulatingPeriod(), 
-                                                    lbii, 
-                                                    ubii, 
-                                                    lbis, 
-                                                    ubis, 
-                                                    env->debugMode());
-        }
-        else
-        {
-            prober = new DirectICMPProber(env->getAttentionMessage(), 
-                                          env->getTimeoutPeriod(), 
-                                          env->getProbeRegulatingPeriod(), 
-                                          lbii, 
-                                          ubii, 
-                                          lbis, 
-                                          ubis, 
-                                          env->debugMode());
-        }
+        prober = env->getProberPool()->acquire(env->getTimeoutPeriod(), 
+                                               env->getProbeRegulatingPeriod(), 
+                                               lbii, 
+                                               ubii, 
+                                               lbis, 
+                                               ubis, 
+                                               env->debugMode());
     }
     catch(SocketException &se)
     {
@@ -73,7 +39,8 @@ IPsToProbe(IPs)
         ToolEnvironment::consoleMessagesMutex.lock();
         (*out) << "Caught an exception because no new socket could be opened." << endl;
         ToolEnvironment::consoleMessagesMutex.unlock();
-        this->stop();
+        if(env->getConcurrencyController() == NULL)
+            this->stop();
         throw;
     }
     
@@ -91,7 +58,7 @@ FingerprintingUnit::~FingerprintingUnit()
     if(prober != NULL)
     {
         env->updateProbeAmounts(prober);
-        delete prober;
+        env->getProberPool()->release(prober);
     }
 }
 
@@ -131,51 +98,61 @@ void FingerprintingUnit::stop()
 
 void FingerprintingUnit::run()
 {
-    for(std::list<InetAddress>::iterator it = IPsToProbe.begin(); it != IPsToProbe.end(); ++it)
+    list<InetAddress> chunk;
+    while(dispenser->nextChunk(chunk))
     {
-        InetAddress curIP = *it;
-        
-        ProbeRecord *probeRecord = NULL;
-        
-        try
-        {
-            probeRecord = probe(curIP);
-        }
-        catch(SocketException &se)
+        unsigned int nbTimeouts = 0;
+        for(list<InetAddress>::iterator it = chunk.begin(); it != chunk.end(); ++it)
         {
-            this->stop();
-            return;
-        }
-        
-        if(probeRecord == NULL)
-            continue;
-        
-        InetAddress replyingIP = probeRecord->getRplyAddress();
-        unsigned char replyType = probeRecord->getRplyICMPtype();
-        if(!probeRecord->isAnonymousRecord() && replyType == DirectProber::ICMP_TYPE_ECHO_REPLY && replyingIP == curIP)
-        {
-            unsigned short replyTTLAsShort = (unsigned short) probeRecord->getRplyTTL();
-            unsigned char iTTL = 0;
-        
-            if(replyTTLAsShort > 128)
-                iTTL = (unsigned char) 255;
-            else if(replyTTLAsShort > 64)
-                iTTL = (unsigned char) 128;
-            else if(replyTTLAsShort > 32)
-                iTTL = (unsigned char) 64;
-            else if(replyTTLAsShort > 0)
-                iTTL = (unsigned char) 32;
-            else
-                iTTL = (unsigned char) 0;
-        
-            makerMutex.lock();
-            parent->callback(curIP, iTTL);
-            makerMutex.unlock();
+            InetAddress curIP = (*it);
+            
+            ProbeRecord *probeRecord = NULL;
+            
+            try
+            {
+                probeRecord = probe(curIP);
+            }
+            catch(SocketException &se)
+            {
+                this->stop();
+                return;
+            }
+            
+            if(probeRecord == NULL)
+                continue;
+            
+            InetAddress replyingIP = probeRecord->getRplyAddress();
+            unsigned char replyType = probeRecord->getRplyICMPtype();
+            if(!probeRecord->isAnonymousRecord() && replyType == DirectProber::ICMP_TYPE_ECHO_REPLY && replyingIP == curIP)
+            {
+                unsigned short replyTTLAsShort = (unsigned short) probeRecord->getRplyTTL();
+                unsigned char iTTL = 0;
+            
+                if(replyTTLAsShort > 128)
+                    iTTL = (unsigned char) 255;
+                else if(replyTTLAsShort > 64)
+                    iTTL = (unsigned char) 128;
+                else if(replyTTLAsShort > 32)
+                    iTTL = (unsigned char) 64;
+                else if(replyTTLAsShort > 0)
+                    iTTL = (unsigned char) 32;
+                else
+                    iTTL = (unsigned char) 0;
+            
+                makerMutex.lock();
+                parent->callback(curIP, iTTL);
+                makerMutex.unlock();
+            }
+            else if(probeRecord->isAnonymousRecord())
+            {
+                nbTimeouts++;
+            }
+            
+            delete probeRecord;
+            
+            if(env->isStopping())
+                return;
         }
-        
-        delete probeRecord;
-        
-        if(env->isStopping())
-            return;
+        dispenser->recordOutcomes((unsigned int) chunk.size(), nbTimeouts);
     }
 }
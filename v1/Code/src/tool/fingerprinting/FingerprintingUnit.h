@@ -12,6 +12,9 @@
  * The class is very similar to NetworkPrescanningUnit, but has been made unique in case it had to 
  * be extended with other probing methods or more generally data collection mechanisms (e.g., 
  * reverse DNS, much like in TreeNET).
+ *
+ * Oct 19, 2026: like NetworkPrescanningUnit, the IPs are now taken in chunks from a shared 
+ * TargetDispenser rather than given as a fixed list.
  */
 
 #ifndef FINGERPRINTINGUNIT_H_
@@ -28,6 +31,7 @@ using std::list;
 #include "../../prober/tcp/DirectTCPWrappedICMPProber.h"
 #include "../../prober/exception/SocketException.h"
 #include "../../prober/structure/ProbeRecord.h"
+#include "../structure/TargetDispenser.h"
 #include "FingerprintMaker.h"
 
 class FingerprintingUnit : public Runnable
@@ -42,7 +46,7 @@ public:
     // Constructor
     FingerprintingUnit(ToolEnvironment *env, 
                        FingerprintMaker *parent, 
-                       std::list<InetAddress> IPsToProbe, 
+                       TargetDispenser *dispenser, 
                        unsigned short lowerBoundICMPid = DirectICMPProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID, 
                        unsigned short upperBoundICMPid = DirectICMPProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID, 
                        unsigned short lowerBoundICMPseq = DirectICMPProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ, 
@@ -59,7 +63,7 @@ private:
     
     // Private fields
     FingerprintMaker *parent;
-    std::list<InetAddress> IPsToProbe;
+    TargetDispenser *dispenser;
 
     // Prober object and probing methods (no TTL asked, since it is here virtually infinite)
     DirectProber *prober;
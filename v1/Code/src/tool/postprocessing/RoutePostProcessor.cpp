@@ -85,8 +85,10 @@ void RoutePostProcessor::detect()
             RouteInterface *route = curTrace->getRoute();
             for(unsigned short i = 0; i < routeSize; i++)
             {
+                // Inferred hops were not measured in this trace (they keep their state)
                 InetAddress hop = route[i].ip;
-                if(hop == InetAddress(0) || route[i].state == RouteInterface::CYCLE)
+                if(hop == InetAddress(0) || route[i].state == RouteInterface::CYCLE || 
+                   route[i].state == RouteInterface::INFERRED)
                     continue;
                 
                 IPTableEntry *IPEntry = dict->lookUp(hop);
@@ -420,7 +422,7 @@ void RoutePostProcessor::checkForCycles(Trace *t)
         for(unsigned short j = i + 1; j < routeSize; ++j)
         {
             InetAddress nextStep = route[j].ip;
-            if(curStep == nextStep)
+            if(curStep == nextStep && route[j].state != RouteInterface::INFERRED)
             {
                 route[j].state = RouteInterface::CYCLE;
                 
@@ -15,26 +15,55 @@ using std::ostream;
 
 #include "NetworkPrescanner.h"
 #include "NetworkPrescanningUnit.h"
+#include "../structure/TargetDispenser.h"
 #include "../../common/thread/Thread.h"
 
 NetworkPrescanner::NetworkPrescanner(ToolEnvironment *env)
 {
     this->env = env;
+    this->queue = NULL;
+    this->generator = NULL;
+    this->nbUnresponsiveTargets = 0;
+    this->lowerBoundICMPid = DirectICMPProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID;
+    this->upperBoundICMPid = DirectICMPProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID;
 }
 
 NetworkPrescanner::~NetworkPrescanner()
 {
 }
 
+void NetworkPrescanner::setICMPidRange(unsigned short lowerBound, unsigned short upperBound)
+{
+    this->lowerBoundICMPid = lowerBound;
+    this->upperBoundICMPid = upperBound;
+}
+
+void NetworkPrescanner::setTargetGenerator(TargetGenerator *generator)
+{
+    this->generator = generator;
+    this->targets.clear();
+    
+    // Responsive targets are in the IP dictionnary, so they are not probed again
+    generator->setFilter(TargetGenerator::FILTER_UNRESPONSIVE, env->getIPTable());
+    generator->rewind();
+}
+
 bool NetworkPrescanner::hasUnresponsiveTargets()
 {
-    if(unresponsiveTargets.size() > 0)
+    if(unresponsiveTargets.size() > 0 || nbUnresponsiveTargets > 0)
         return true;
     return false;
 }
 
 void NetworkPrescanner::reloadUnresponsiveTargets()
 {
+    if(generator != NULL)
+    {
+        nbUnresponsiveTargets = 0;
+        generator->rewind();
+        return;
+    }
+    
     this->targets.clear();
     while(unresponsiveTargets.size() > 0)
     {
@@ -44,7 +73,33 @@ void NetworkPrescanner::reloadUnresponsiveTargets()
     }
 }
 
-void NetworkPrescanner::callback(InetAddress target, bool responsive)
+unsigned char NetworkPrescanner::estimateDistance(unsigned char replyTTL)
+{
+    /*
+     * The initial TTL of the reply is guessed as in ParisTracerouteTask::saveRoute(); assuming the 
+     * return path is as long as the forward path, the target replies to probes with a TTL of at 
+     * least (hops on the return path) + 1.
+     */
+    
+    unsigned short iTTL = 0, rTTL = (unsigned short) replyTTL;
+    if(rTTL > 128)
+        iTTL = 255;
+    else if(rTTL > 64)
+        iTTL = 128;
+    else if(rTTL > 32)
+        iTTL = 64;
+    else if(rTTL > 0)
+        iTTL = 32;
+    else
+        return 0;
+    
+    unsigned short distance = iTTL - rTTL + 1;
+    if(distance > 64)
+        return 0; // Unlikely, and beyond what traceroute probes anyway
+    return (unsigned char) distance;
+}
+
+void NetworkPrescanner::callback(InetAddress target, bool responsive, unsigned char replyTTL)
 {
     /*
      * N.B.: since callback() is called once at a time, it is also used to print out prescanning 
@@ -53,7 +108,10 @@ void NetworkPrescanner::callback(InetAddress target, bool responsive)
 
     if(!responsive)
     {
-        unresponsiveTargets.push_back(target);
+        if(generator != NULL)
+            nbUnresponsiveTargets++;
+        else
+            unresponsiveTargets.push_back(target);
         return;
     }
     
@@ -62,6 +120,11 @@ void NetworkPrescanner::callback(InetAddress target, bool responsive)
     if(newEntry != NULL)
     {
         newEntry->setPreferredTimeout(this->timeout);
+        newEntry->setEstimatedTTL(estimateDistance(replyTTL));
+        
+        CheckpointJournal *journal = env->getCheckpointJournal();
+        if(journal != NULL)
+            journal->recordResponsiveTarget(newEntry);
         
         ostream *out = env->getOutputStream();
         
@@ -70,10 +133,17 @@ void NetworkPrescanner::callback(InetAddress target, bool responsive)
          * log (which is quite long) does not highlight well the result.
          */
         
+        // Console mutex is needed when the traceroute workers run at the same time (pipelining)
+        ToolEnvironment::consoleMessagesMutex.lock();
         if(env->debugMode())
             (*out) << "\n";
         
         (*out) << target << " is responsive." << endl;
+        ToolEnvironment::consoleMessagesMutex.unlock();
+        
+        // Pipelined pre-scanning: waits here while the queue is full (back-pressure)
+        if(queue != NULL)
+            queue->push(target);
     }
     else
     {
@@ -86,60 +156,45 @@ void NetworkPrescanner::probe()
 {
     unsigned short maxThreads = env->getMaxThreads();
     unsigned long nbTargets = (unsigned long) targets.size();
+    if(generator != NULL)
+        nbTargets = (unsigned long) generator->getNbRemaining(); // Upper bound
     if(nbTargets == 0)
     {
         return;
     }
-    unsigned short nbThreads = 1;
-    unsigned long targetsPerThread = (unsigned long) NetworkPrescanner::MINIMUM_TARGETS_PER_THREAD;
-    unsigned long lastTargets = 0;
     
-    // Computes amount of threads and amount of targets being probed per thread
-    if(nbTargets > NetworkPrescanner::MINIMUM_TARGETS_PER_THREAD)
-    {
-        if((nbTargets / targetsPerThread) > (unsigned long) maxThreads)
-        {
-            unsigned long factor = 2;
-            while((nbTargets / (targetsPerThread * factor)) > (unsigned long) maxThreads)
-                factor++;
-            
-            targetsPerThread *= factor;
-        }
-        
-        nbThreads = (unsigned short) (nbTargets / targetsPerThread);
-        lastTargets = nbTargets % targetsPerThread;
-        if(lastTargets > 0)
-            nbThreads++;
-    }
+    // Amount of threads (at least MINIMUM_TARGETS_PER_THREAD targets for each of them)
+    unsigned long nbThreadsLong = nbTargets / (unsigned long) NetworkPrescanner::MINIMUM_TARGETS_PER_THREAD;
+    if(nbTargets % (unsigned long) NetworkPrescanner::MINIMUM_TARGETS_PER_THREAD > 0)
+        nbThreadsLong++;
+    if(nbThreadsLong > (unsigned long) maxThreads)
+        nbThreadsLong = (unsigned long) maxThreads;
+    unsigned short nbThreads = (unsigned short) nbThreadsLong;
+    
+    // Targets are taken in chunks by the threads (see TargetDispenser)
+    TargetDispenser *dispenser = NULL;
+    if(generator != NULL)
+        dispenser = new TargetDispenser(generator, nbThreads);
     else
-        lastTargets = nbTargets;
+        dispenser = new TargetDispenser(targets, nbThreads);
+    targets.clear();
 
     // Prepares and launches threads
-    unsigned short range = (DirectICMPProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID - DirectICMPProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID) / nbThreads;
+    unsigned short range = (upperBoundICMPid - lowerBoundICMPid) / nbThreads;
     Thread **th = new Thread*[nbThreads];
+    for(unsigned short i = 0; i < nbThreads; i++)
+        th[i] = NULL;
     
     for(unsigned short i = 0; i < nbThreads; i++)
     {
-        std::list<InetAddress> targetsSubset;
-        unsigned long toRead = targetsPerThread;
-        if(lastTargets > 0 && i == (nbThreads - 1))
-            toRead = lastTargets;
-        
-        for(unsigned long j = 0; j < toRead; j++)
-        {
-            InetAddress addr(targets.front());
-            targetsSubset.push_back(addr);
-            targets.pop_front();
-        }
-
         Runnable *task = NULL;
         try
         {
             task = new NetworkPrescanningUnit(env, 
                                               this, 
-                                              targetsSubset, 
-                                              DirectICMPProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + (i * range), 
-                                              DirectICMPProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + (i * range) + range - 1, 
+                                              dispenser, 
+                                              lowerBoundICMPid + (i * range), 
+                                              lowerBoundICMPid + (i * range) + range - 1, 
                                               DirectICMPProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ, 
                                               DirectICMPProber::DEFAULT_UPPER_DST_PORT_ICMP_SEQ);
 
@@ -147,6 +202,13 @@ void NetworkPrescanner::probe()
         }
         catch(SocketException &se)
         {
+            // Adaptive concurrency: the units already created take the remaining chunks
+            if(env->getConcurrencyController() != NULL && i > 0)
+            {
+                nbThreads = i;
+                break;
+            }
+            
             // Cleaning remaining threads (if any is set)
             for(unsigned short k = 0; k < nbThreads; k++)
             {
@@ -155,6 +217,7 @@ void NetworkPrescanner::probe()
             }
             
             delete[] th;
+            delete dispenser;
             
             throw StopException();
         }
@@ -164,6 +227,12 @@ void NetworkPrescanner::probe()
             (*out) << "Unable to create more threads." << endl;
                 
             delete task;
+            
+            if(env->getConcurrencyController() != NULL && i > 0)
+            {
+                nbThreads = i;
+                break;
+            }
         
             // Cleaning remaining threads (if any is set)
             for(unsigned short k = 0; k < nbThreads; k++)
@@ -173,6 +242,7 @@ void NetworkPrescanner::probe()
             }
             
             delete[] th;
+            delete dispenser;
             
             throw StopException();
         }
@@ -192,6 +262,7 @@ void NetworkPrescanner::probe()
     }
     
     delete[] th;
+    delete dispenser;
     
     // Might happen because of SocketSendException thrown within a unit
     if(env->isStopping())
@@ -12,6 +12,24 @@
  * TreeNET involving probes.
  *
  * January 19, 2017: Re-used "as is" in WIP Traceroute.
+ *
+ * Oct 19, 2026: the TTL of the echo reply is now used to estimate the distance of each responsive 
+ * target (against the usual initial TTLs), which the traceroute phase uses to start closer to the 
+ * target (see ParisTracerouteTask and AsyncTracerouteEngine).
+ *
+ * Oct 19, 2026: responsive targets can also be pushed in a TargetQueue as soon as they are found, 
+ * so that the traceroute workers trace them while the pre-scanning goes on (see 
+ * PrescanningPipeline). The prescanner then uses its own range of ICMP identifiers.
+ *
+ * Oct 19, 2026: the targets are no longer split in equal shares, one per thread, but taken in 
+ * small chunks by the threads as they go (see TargetDispenser), so that a thread which gets many 
+ * unresponsive targets does not delay the end of the pre-scanning. With the adaptive concurrency, 
+ * the threads which could be created carry out the pre-scanning if the others could not be.
+ *
+ * Oct 19, 2026: the targets can also be drawn from a TargetGenerator rather than given as a list. 
+ * The unresponsive targets are then only counted, and the next opinion draws the targets of the 
+ * same generator again, skipping the ones found responsive in the meantime (so no list of 
+ * targets, responsive or not, is kept).
  */
 
 #ifndef NETWORKPRESCANNER_H_
@@ -21,6 +39,8 @@
 using std::list;
 
 #include "../ToolEnvironment.h"
+#include "../structure/TargetQueue.h"
+#include "../utils/TargetGenerator.h"
 
 class NetworkPrescanner
 {
@@ -35,14 +55,20 @@ public:
     // Methods to configure the prescanner
     inline void setTimeoutPeriod(TimeVal timeout) { this->timeout = timeout; }
     inline void setTargets(list<InetAddress> targets) { this->targets = targets; }
+    inline void setTargetQueue(TargetQueue *queue) { this->queue = queue; }
+    void setTargetGenerator(TargetGenerator *generator); // Replaces the list of targets
+    void setICMPidRange(unsigned short lowerBound, unsigned short upperBound);
     bool hasUnresponsiveTargets();
     void reloadUnresponsiveTargets();
     
     // Accesser to timeout field (for children threads)
     inline TimeVal getTimeoutPeriod() { return this->timeout; }
     
-    // Callback method (for children threads)
-    void callback(InetAddress target, bool responsive);
+    // Callback method (for children threads); replyTTL is the TTL of the echo reply, if any
+    void callback(InetAddress target, bool responsive, unsigned char replyTTL = 0);
+    
+    // Estimates the distance of a target from the TTL of its echo reply (0 if not possible)
+    static unsigned char estimateDistance(unsigned char replyTTL);
     
     // Launches a pre-scanning (i.e. probing once all IPs from targets)
     void probe();
@@ -59,6 +85,16 @@ private:
     list<InetAddress> targets;
     list<InetAddress> unresponsiveTargets; // From a previous probing, thus empty at first
     
+    // Generator giving the targets (NULL if they were given as a list; not owned)
+    TargetGenerator *generator;
+    unsigned long nbUnresponsiveTargets; // Listed in unresponsiveTargets if generator is NULL
+    
+    // Queue fed with the responsive targets (pipelined pre-scanning only, NULL otherwise)
+    TargetQueue *queue;
+    
+    // Range of ICMP identifiers shared by the prescanning units
+    unsigned short lowerBoundICMPid, upperBoundICMPid;
+    
     /*
      * N.B.: responsive targets are not stored in a third list, and directly saved in the IP 
      * look-up table (which is accessible through env).
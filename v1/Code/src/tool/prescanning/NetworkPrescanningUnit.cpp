@@ -14,58 +14,24 @@ Mutex NetworkPrescanningUnit::prescannerMutex(Mutex::ERROR_CHECKING_MUTEX);
 
 NetworkPrescanningUnit::NetworkPrescanningUnit(ToolEnvironment *e, 
                                                NetworkPrescanner *p, 
-                                               std::list<InetAddress> IPs, 
+                                               TargetDispenser *d, 
                                                unsigned short lbii, 
                                                unsigned short ubii, 
                                                unsigned short lbis, 
                                                unsigned short ubis) throw(SocketException):
 env(e), 
 parent(p), 
-IPsToProbe(IPs)
+dispenser(d)
 {
     try
     {
-        unsigned short protocol = env->getProbingProtocol();
-    
-        if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
-        {
-            int roundRobinSocketCount = 1;
-            
-            prober = new DirectUDPWrappedICMPProber(env->getAttentionMessage(), 
-                                                    roundRobinSocketCount, 
-                                                    p->getTimeoutPeriod(), 
-                                                    env->getProbeRegulatingPeriod(), 
-                                                    lbii, 
-                                                    ubii, 
-                                                    lbis, 
-                                                    ubis, 
-                                                    env->debugMode());
-        }
-        else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
-        {
-            int roundRobinSocketCount = 1;
-            
-            prober = new DirectTCPWrappedICMPProber(env->getAttentionMessage(), 
-                                                    roundRobinSocketCount, 
-                                                    p->getTimeoutPeriod(), 
-                                                    env->getProbeRegulatingPeriod(), 
-                                                    lbii, 
-                                                    ubii, 
-                                                    lbis, 
-                                                    ubis, 
-                                                    env->debugMode());
-        }
-        else
-        {
-            prober = new DirectICMPProber(env->getAttentionMessage(), 
-                                          p->getTimeoutPeriod(), 
-                                          env->getProbeRegulatingPeriod(), 
-                                          lbii, 
-                                          ubii, 
-                                          lbis, 
-                                          ubis, 
-                                          env->debugMode());
-        }
+        prober = env->getProberPool()->acquire(p->getTimeoutPeriod(), 
+                                               env->getProbeRegulatingPeriod(), 
+                                               lbii, 
+                                               ubii, 
+                                               lbis, 
+                                               ubis, 
+                                               env->debugMode());
     }
     catch(SocketException &se)
     {
@@ -73,7 +39,8 @@ IPsToProbe(IPs)
         ToolEnvironment::consoleMessagesMutex.lock();
         (*out) << "Caught an exception because no new socket could be opened." << endl;
         ToolEnvironment::consoleMessagesMutex.unlock();
-        this->stop();
+        if(env->getConcurrencyController() == NULL)
+            this->stop();
         throw;
     }
     
@@ -91,7 +58,7 @@ NetworkPrescanningUnit::~NetworkPrescanningUnit()
     if(prober != NULL)
     {
         env->updateProbeAmounts(prober);
-        delete prober;
+        env->getProberPool()->release(prober);
     }
 }
 
@@ -131,40 +98,51 @@ void NetworkPrescanningUnit::stop()
 
 void NetworkPrescanningUnit::run()
 {
-    for(std::list<InetAddress>::iterator it = IPsToProbe.begin(); it != IPsToProbe.end(); ++it)
+    list<InetAddress> chunk;
+    while(dispenser->nextChunk(chunk))
     {
-        InetAddress curIP = *it;
-        
-        ProbeRecord *probeRecord = NULL;
-        
-        try
-        {
-            probeRecord = probe(curIP);
-        }
-        catch(SocketException &se)
-        {
-            this->stop();
-            return;
-        }
-        
-        if(probeRecord == NULL)
-            continue;
-        
-        bool responsive = false;
-        InetAddress replyingIP = probeRecord->getRplyAddress();
-        unsigned char replyType = probeRecord->getRplyICMPtype();
-        if(!probeRecord->isAnonymousRecord() && replyType == DirectProber::ICMP_TYPE_ECHO_REPLY && replyingIP == curIP)
+        unsigned int nbTimeouts = 0;
+        for(list<InetAddress>::iterator it = chunk.begin(); it != chunk.end(); ++it)
         {
-            responsive = true;
+            InetAddress curIP = (*it);
+            
+            ProbeRecord *probeRecord = NULL;
+            
+            try
+            {
+                probeRecord = probe(curIP);
+            }
+            catch(SocketException &se)
+            {
+                this->stop();
+                return;
+            }
+            
+            if(probeRecord == NULL)
+                continue;
+            
+            bool responsive = false;
+            InetAddress replyingIP = probeRecord->getRplyAddress();
+            unsigned char replyType = probeRecord->getRplyICMPtype(), replyTTL = 0;
+            if(!probeRecord->isAnonymousRecord() && replyType == DirectProber::ICMP_TYPE_ECHO_REPLY && replyingIP == curIP)
+            {
+                responsive = true;
+                replyTTL = probeRecord->getRplyTTL();
+            }
+            else if(probeRecord->isAnonymousRecord())
+            {
+                nbTimeouts++;
+            }
+            
+            prescannerMutex.lock();
+            parent->callback(curIP, responsive, replyTTL);
+            prescannerMutex.unlock();
+            
+            delete probeRecord;
+            
+            if(env->isStopping())
+                return;
         }
-        
-        prescannerMutex.lock();
-        parent->callback(curIP, responsive);
-        prescannerMutex.unlock();
-        
-        delete probeRecord;
-        
-        if(env->isStopping())
-            return;
+        dispenser->recordOutcomes((unsigned int) chunk.size(), nbTimeouts);
     }
 }
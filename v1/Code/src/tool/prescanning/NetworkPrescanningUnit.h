@@ -14,6 +14,10 @@
  * the program because it might mitigate failures over a short period of time.
  *
  * January 19, 2017: Re-used "as is" in WIP Traceroute.
+ *
+ * Oct 19, 2026: the IPs are no longer given as a fixed list, but taken in chunks from a 
+ * TargetDispenser shared by all units, until there is none left. The amount of timeouts of each 
+ * chunk is reported to the dispenser, which adapts the size of the next chunks.
  */
 
 #ifndef NETWORKPRESCANNINGUNIT_H_
@@ -30,6 +34,7 @@ using std::list;
 #include "../../prober/tcp/DirectTCPWrappedICMPProber.h"
 #include "../../prober/exception/SocketException.h"
 #include "../../prober/structure/ProbeRecord.h"
+#include "../structure/TargetDispenser.h"
 #include "NetworkPrescanner.h"
 
 class NetworkPrescanningUnit : public Runnable
@@ -44,7 +49,7 @@ public:
     // Constructor
     NetworkPrescanningUnit(ToolEnvironment *env, 
                            NetworkPrescanner *parent, 
-                           std::list<InetAddress> IPsToProbe, 
+                           TargetDispenser *dispenser, 
                            unsigned short lowerBoundICMPid = DirectICMPProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID, 
                            unsigned short upperBoundICMPid = DirectICMPProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID, 
                            unsigned short lowerBoundICMPseq = DirectICMPProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ, 
@@ -61,7 +66,7 @@ private:
     
     // Private fields
     NetworkPrescanner *parent;
-    std::list<InetAddress> IPsToProbe;
+    TargetDispenser *dispenser;
 
     // Prober object and probing methods (no TTL asked, since it is here virtually infinite)
     DirectProber *prober;
@@ -0,0 +1,170 @@
+/*
+ * PrefixSampler.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in PrefixSampler.h (see this file to learn further about the 
+ * goals of such class).
+ */
+
+#include <cmath>
+#include <map>
+using std::map;
+#include <ostream>
+using std::ostream;
+
+#include "PrefixSampler.h"
+#include "NetworkPrescanner.h"
+
+PrefixSampler::PrefixSampler(ToolEnvironment *env, unsigned short prefixLength, unsigned short threshold)
+{
+    this->env = env;
+    this->prefixLength = prefixLength;
+    this->threshold = threshold;
+    nbPrefixes = 0;
+    nbExpanded = 0;
+    nbSkipped = 0;
+    nbSampledTargets = 0;
+    nbSkippedTargets = 0;
+    estimatedMissed = 0.0;
+    missedBound = 0.0;
+}
+
+PrefixSampler::~PrefixSampler()
+{
+}
+
+double PrefixSampler::upperRatio(unsigned short nbHits, unsigned short nbSampled)
+{
+    if(nbHits >= nbSampled)
+        return 1.0;
+    
+    /*
+     * Largest ratio p such that P(X <= nbHits) >= 5% for X ~ B(nbSampled, p), found by bisection 
+     * (this probability decreases as p grows).
+     */
+    
+    double low = 0.0, high = 1.0;
+    for(unsigned short step = 0; step < 50; step++)
+    {
+        double p = (low + high) / 2.0;
+        double cumulated = 0.0, coefficient = 1.0;
+        for(unsigned short i = 0; i <= nbHits; i++)
+        {
+            if(i > 0)
+                coefficient = coefficient * (double) (nbSampled - i + 1) / (double) i;
+            cumulated += coefficient * pow(p, (double) i) * pow(1.0 - p, (double) (nbSampled - i));
+        }
+        if(cumulated >= 0.05)
+            low = p;
+        else
+            high = p;
+    }
+    return low;
+}
+
+list<InetAddress> PrefixSampler::sample(list<InetAddress> &targets)
+{
+    IPLookUpTable *table = env->getIPTable();
+    
+    // Samples: the first SAMPLE_SIZE targets of each prefix (already responsive ones excepted)
+    map<uint32_t, unsigned long> sizes;
+    list<InetAddress> samples;
+    for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+    {
+        unsigned long &size = sizes[prefixOf((*it))];
+        size++;
+        if(size <= (unsigned long) SAMPLE_SIZE)
+        {
+            nbSampledTargets++;
+            if(table->lookUp((*it)) == NULL)
+                samples.push_back((*it));
+        }
+    }
+    nbPrefixes = (unsigned int) sizes.size();
+    
+    ostream *out = env->getOutputStream();
+    (*out) << "Prescanning a sample of " << SAMPLE_SIZE << " targets in each of the " << nbPrefixes;
+    (*out) << " /" << prefixLength << " prefixes..." << endl;
+    
+    NetworkPrescanner *prescanner = new NetworkPrescanner(env);
+    prescanner->setTimeoutPeriod(env->getTimeoutPeriod());
+    try
+    {
+        prescanner->setTargets(samples);
+        prescanner->probe();
+        if(prescanner->hasUnresponsiveTargets())
+        {
+            prescanner->setTimeoutPeriod(env->getTimeoutPeriod() * 2);
+            prescanner->reloadUnresponsiveTargets();
+            prescanner->probe();
+        }
+    }
+    catch(StopException &e)
+    {
+        delete prescanner;
+        throw;
+    }
+    delete prescanner;
+    samples.clear();
+    
+    // Responsive targets of each sample
+    map<uint32_t, unsigned short> hits, sampled;
+    for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+    {
+        uint32_t prefix = prefixOf((*it));
+        unsigned short &nbSampled = sampled[prefix];
+        if(nbSampled >= SAMPLE_SIZE)
+            continue;
+        nbSampled++;
+        if(table->lookUp((*it)) != NULL)
+            hits[prefix]++;
+    }
+    
+    // Decision for each prefix (prefixes not larger than a sample were already fully probed)
+    map<uint32_t, bool> expanded;
+    for(map<uint32_t, unsigned long>::iterator it = sizes.begin(); it != sizes.end(); ++it)
+    {
+        unsigned long size = it->second;
+        if(size <= (unsigned long) SAMPLE_SIZE)
+            continue;
+        
+        unsigned short nbHits = hits[it->first];
+        bool expand = (nbHits > 0 && (unsigned long) nbHits * 100 > (unsigned long) threshold * SAMPLE_SIZE);
+        expanded[it->first] = expand;
+        if(expand)
+        {
+            nbExpanded++;
+            continue;
+        }
+        
+        nbSkipped++;
+        unsigned long rest = size - (unsigned long) SAMPLE_SIZE;
+        nbSkippedTargets += rest;
+        estimatedMissed += ((double) nbHits / (double) SAMPLE_SIZE) * (double) rest;
+        missedBound += upperRatio(nbHits, SAMPLE_SIZE) * (double) rest;
+        
+        table->addSkippedPrefix(InetAddress((unsigned long int) (it->first << (32 - prefixLength))), 
+                                (unsigned char) prefixLength);
+    }
+    
+    // Targets left, i.e. the targets beyond the sample in the expanded prefixes
+    list<InetAddress> remaining;
+    sampled.clear();
+    for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+    {
+        uint32_t prefix = prefixOf((*it));
+        unsigned short &nbSampled = sampled[prefix];
+        if(nbSampled < SAMPLE_SIZE)
+        {
+            nbSampled++;
+            continue;
+        }
+        
+        map<uint32_t, bool>::iterator decision = expanded.find(prefix);
+        if(decision != expanded.end() && decision->second)
+            remaining.push_back((*it));
+    }
+    return remaining;
+}
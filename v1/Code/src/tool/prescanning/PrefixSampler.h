@@ -0,0 +1,77 @@
+/*
+ * PrefixSampler.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * PrefixSampler carries out the first step of the sampled pre-scanning, which is meant for large 
+ * and sparsely populated target blocks (e.g. whole ASes, where most /24 prefixes have no 
+ * responsive IP at all). The targets are grouped by prefix (/24 by default), and only a sample 
+ * of SAMPLE_SIZE targets of each prefix is prescanned (with the usual second opinion). A prefix 
+ * is expanded, i.e. its other targets are prescanned as well, only if the ratio of responsive 
+ * targets in its sample exceeds a threshold (by default, a single responsive target suffices). 
+ * The other prefixes are skipped and listed as such in the IP dictionnary.
+ *
+ * Since the targets are given in a pseudo-random order (see TargetGenerator), the first targets 
+ * of each prefix in this order are a random sample of the prefix. The sampler reports how many 
+ * responsive targets were likely missed in the skipped prefixes: the estimation extrapolates the 
+ * ratio of each sample, while the bound uses the exact (Clopper-Pearson) one-sided upper bound of 
+ * this ratio at 95% confidence, given the amount of responsive targets in the sample (with no 
+ * responsive target in 16, the ratio is below 17%). The bound is the sum of these per-prefix 
+ * bounds.
+ */
+
+#ifndef PREFIXSAMPLER_H_
+#define PREFIXSAMPLER_H_
+
+#include <inttypes.h>
+#include <list>
+using std::list;
+
+#include "../ToolEnvironment.h"
+
+class PrefixSampler
+{
+public:
+
+    static const unsigned short SAMPLE_SIZE = 16;
+
+    // Constructor (threshold is a percentage of the sample), destructor
+    PrefixSampler(ToolEnvironment *env, unsigned short prefixLength, unsigned short threshold);
+    ~PrefixSampler();
+
+    /*
+     * Prescans the samples and returns the targets which remain to be prescanned (the other 
+     * targets of the expanded prefixes, in the same order). Throws StopException upon emergency 
+     * stop.
+     */
+
+    list<InetAddress> sample(list<InetAddress> &targets);
+
+    inline unsigned int getNbPrefixes() { return this->nbPrefixes; }
+    inline unsigned int getNbExpandedPrefixes() { return this->nbExpanded; }
+    inline unsigned int getNbSkippedPrefixes() { return this->nbSkipped; }
+    inline unsigned long getNbSampledTargets() { return this->nbSampledTargets; }
+    inline unsigned long getNbSkippedTargets() { return this->nbSkippedTargets; }
+    inline unsigned long getEstimatedMissedTargets() { return (unsigned long) this->estimatedMissed; }
+    inline unsigned long getMissedTargetsBound() { return (unsigned long) this->missedBound; }
+
+private:
+
+    ToolEnvironment *env;
+    unsigned short prefixLength, threshold;
+
+    unsigned int nbPrefixes, nbExpanded, nbSkipped;
+    unsigned long nbSampledTargets, nbSkippedTargets;
+    double estimatedMissed, missedBound;
+
+    // Upper bound (95% confidence) of the ratio of responsive targets given a sample
+    static double upperRatio(unsigned short nbHits, unsigned short nbSampled);
+
+    inline uint32_t prefixOf(InetAddress &target)
+    {
+        return (uint32_t) (target.getULongAddress() >> (32 - prefixLength));
+    }
+};
+
+#endif /* PREFIXSAMPLER_H_ */
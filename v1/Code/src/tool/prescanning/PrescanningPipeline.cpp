@@ -0,0 +1,78 @@
+/*
+ * PrescanningPipeline.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in PrescanningPipeline.h (see this file to learn further about the 
+ * goals of such class).
+ */
+
+#include <ostream>
+using std::ostream;
+#include <sstream>
+using std::stringstream;
+
+#include "PrescanningPipeline.h"
+
+PrescanningPipeline::PrescanningPipeline(ToolEnvironment *env, 
+                                         NetworkPrescanner *prescanner, 
+                                         TargetQueue *queue, 
+                                         list<InetAddress> targets, 
+                                         list<InetAddress> resumedTargets)
+{
+    this->env = env;
+    this->prescanner = prescanner;
+    this->queue = queue;
+    this->targets = targets;
+    this->resumedTargets = resumedTargets;
+}
+
+PrescanningPipeline::~PrescanningPipeline()
+{
+}
+
+void PrescanningPipeline::printMessage(string message)
+{
+    ostream *out = env->getOutputStream();
+    ToolEnvironment::consoleMessagesMutex.lock();
+    (*out) << message << endl;
+    ToolEnvironment::consoleMessagesMutex.unlock();
+}
+
+void PrescanningPipeline::run()
+{
+    for(list<InetAddress>::iterator it = resumedTargets.begin(); it != resumedTargets.end(); ++it)
+        if(!queue->push((*it)))
+            break;
+    resumedTargets.clear();
+    
+    try
+    {
+        this->printMessage("Prescanning with initial timeout...");
+        prescanner->setTargets(targets);
+        prescanner->probe();
+        
+        if(prescanner->hasUnresponsiveTargets() && !queue->isClosed())
+        {
+            TimeVal timeout2 = env->getTimeoutPeriod() * 2;
+            stringstream message;
+            message << "Second opinion with twice the timeout (" << timeout2 << ")...";
+            this->printMessage(message.str());
+            prescanner->setTimeoutPeriod(timeout2);
+            prescanner->reloadUnresponsiveTargets();
+            prescanner->probe();
+        }
+        this->printMessage("Pre-scanning is over, tracing the last responsive targets...");
+    }
+    catch(StopException &e)
+    {
+        // The traceroute workers must stop as well (e.g. no thread could be created)
+        ToolEnvironment::emergencyStopMutex.lock();
+        if(!env->isStopping())
+            env->triggerStop();
+        ToolEnvironment::emergencyStopMutex.unlock();
+    }
+    
+    queue->close();
+}
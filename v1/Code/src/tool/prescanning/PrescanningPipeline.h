@@ -0,0 +1,54 @@
+/*
+ * PrescanningPipeline.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * PrescanningPipeline runs the whole pre-scanning (the first pass, then the second opinion with 
+ * twice the timeout on the unresponsive targets) in its own thread, the responsive targets being 
+ * pushed in a bounded TargetQueue which the traceroute workers consume at the same time (see 
+ * Tracerouter). Instead of waiting for the last late responder of the second opinion before the 
+ * first trace, the traceroute therefore starts with the first responsive target, and the total 
+ * duration gets close to the duration of the longest of both phases.
+ *
+ * The targets found responsive before an interruption (checkpoint journal) are pushed first, as 
+ * they are not prescanned again. The queue is closed once the pre-scanning is over, which tells 
+ * the workers that no more target will come.
+ */
+
+#ifndef PRESCANNINGPIPELINE_H_
+#define PRESCANNINGPIPELINE_H_
+
+#include <list>
+using std::list;
+
+#include "../ToolEnvironment.h"
+#include "../structure/TargetQueue.h"
+#include "../../common/thread/Runnable.h"
+#include "NetworkPrescanner.h"
+
+class PrescanningPipeline : public Runnable
+{
+public:
+
+    // Constructor, destructor and run method
+    PrescanningPipeline(ToolEnvironment *env, 
+                        NetworkPrescanner *prescanner, 
+                        TargetQueue *queue, 
+                        list<InetAddress> targets, 
+                        list<InetAddress> resumedTargets);
+    ~PrescanningPipeline();
+    void run();
+
+private:
+
+    ToolEnvironment *env;
+    NetworkPrescanner *prescanner;
+    TargetQueue *queue;
+    list<InetAddress> targets, resumedTargets;
+    
+    // Prints a message about the progress of the pre-scanning
+    void printMessage(string message);
+};
+
+#endif /* PRESCANNINGPIPELINE_H_ */
@@ -26,47 +26,13 @@ toReprobe(tR)
 {
     try
     {
-        unsigned short protocol = env->getProbingProtocol();
-    
-        if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
-        {
-            int roundRobinSocketCount = 1;
-            
-            prober = new DirectUDPWrappedICMPProber(env->getAttentionMessage(), 
-                                                    roundRobinSocketCount, 
-                                                    env->getTimeoutPeriod(), 
-                                                    env->getProbeRegulatingPeriod(), 
-                                                    lbii, 
-                                                    ubii, 
-                                                    lbis, 
-                                                    ubis, 
-                                                    env->debugMode());
-        }
-        else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
-        {
-            int roundRobinSocketCount = 1;
-            
-            prober = new DirectTCPWrappedICMPProber(env->getAttentionMessage(), 
-                                                    roundRobinSocketCount, 
-                                                    env->getTimeoutPeriod(), 
-                                                    env->getProbeRegulatingPeriod(), 
-                                                    lbii, 
-                                                    ubii, 
-                                                    lbis, 
-                                                    ubis, 
-                                                    env->debugMode());
-        }
-        else
-        {
-            prober = new DirectICMPProber(env->getAttentionMessage(), 
-                                          env->getTimeoutPeriod(), 
-                                          env->getProbeRegulatingPeriod(), 
-                                          lbii, 
-                                          ubii, 
-                                          lbis, 
-                                          ubis, 
-                                          env->debugMode());
-        }
+        prober = env->getProberPool()->acquire(env->getTimeoutPeriod(), 
+                                               env->getProbeRegulatingPeriod(), 
+                                               lbii, 
+                                               ubii, 
+                                               lbis, 
+                                               ubis, 
+                                               env->debugMode());
     }
     catch(SocketException &se)
     {
@@ -92,7 +58,7 @@ AnonymousCheckUnit::~AnonymousCheckUnit()
     if(prober != NULL)
     {
         env->updateProbeAmounts(prober);
-        delete prober;
+        env->getProberPool()->release(prober);
     }
 }
 
@@ -0,0 +1,267 @@
+/*
+ * ShardConnection.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in ShardConnection.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "ShardConnection.h"
+#include "../../common/inet/InetAddress.h"
+#include "../../common/inet/InetAddressException.h"
+
+int ShardConnection::listenOn(string address) throw(SocketException)
+{
+    int listeningSocket = -1;
+    if(isUnixAddress(address))
+    {
+        struct sockaddr_un local;
+        if(address.size() >= sizeof(local.sun_path))
+            throw SocketException("Unix socket path is too long.");
+
+        memset(&local, 0, sizeof(local));
+        local.sun_family = AF_UNIX;
+        strncpy(local.sun_path, address.c_str(), sizeof(local.sun_path) - 1);
+        unlink(address.c_str()); // Left by a previous coordinator
+
+        listeningSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(listeningSocket < 0)
+            throw SocketException("Can NOT create Unix listening socket.");
+        if(bind(listeningSocket, (struct sockaddr *) &local, sizeof(local)) < 0)
+        {
+            close(listeningSocket);
+            throw SocketException("Can NOT bind Unix listening socket.");
+        }
+    }
+    else
+    {
+        string host = "";
+        unsigned short port = 0;
+        parseTCPAddress(address, &host, &port);
+
+        struct sockaddr_in local;
+        memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        local.sin_port = htons(port);
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        if(host.length() > 0)
+        {
+            try
+            {
+                InetAddress hostAddress(host);
+                local.sin_addr.s_addr = htonl((uint32_t) hostAddress.getULongAddress());
+            }
+            catch(InetAddressException &e)
+            {
+                throw SocketException("Unknown host for the coordinator.");
+            }
+        }
+
+        listeningSocket = socket(AF_INET, SOCK_STREAM, 0);
+        if(listeningSocket < 0)
+            throw SocketException("Can NOT create TCP listening socket.");
+        int reuse = 1;
+        setsockopt(listeningSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if(bind(listeningSocket, (struct sockaddr *) &local, sizeof(local)) < 0)
+        {
+            close(listeningSocket);
+            throw SocketException("Can NOT bind TCP listening socket.");
+        }
+    }
+
+    if(listen(listeningSocket, LISTEN_BACKLOG) < 0)
+    {
+        close(listeningSocket);
+        throw SocketException("Can NOT listen for workers.");
+    }
+    return listeningSocket;
+}
+
+ShardConnection *ShardConnection::acceptFrom(int listeningSocket) throw(SocketException)
+{
+    int descriptor = accept(listeningSocket, NULL, NULL);
+    if(descriptor < 0)
+        throw SocketException("Can NOT accept a worker.");
+
+    int noDelay = 1;
+    setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)); // Fails on Unix sockets
+    return new ShardConnection(descriptor);
+}
+
+ShardConnection *ShardConnection::connectTo(string address) throw(SocketException)
+{
+    int descriptor = -1;
+    if(isUnixAddress(address))
+    {
+        struct sockaddr_un remote;
+        if(address.size() >= sizeof(remote.sun_path))
+            throw SocketException("Unix socket path is too long.");
+
+        memset(&remote, 0, sizeof(remote));
+        remote.sun_family = AF_UNIX;
+        strncpy(remote.sun_path, address.c_str(), sizeof(remote.sun_path) - 1);
+
+        descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(descriptor < 0)
+            throw SocketException("Can NOT create Unix socket.");
+        if(connect(descriptor, (struct sockaddr *) &remote, sizeof(remote)) < 0)
+        {
+            close(descriptor);
+            throw SocketException("Can NOT connect to the coordinator.");
+        }
+    }
+    else
+    {
+        string host = "";
+        unsigned short port = 0;
+        parseTCPAddress(address, &host, &port);
+
+        struct sockaddr_in remote;
+        memset(&remote, 0, sizeof(remote));
+        remote.sin_family = AF_INET;
+        remote.sin_port = htons(port);
+        remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if(host.length() > 0)
+        {
+            try
+            {
+                InetAddress hostAddress(host);
+                remote.sin_addr.s_addr = htonl((uint32_t) hostAddress.getULongAddress());
+            }
+            catch(InetAddressException &e)
+            {
+                throw SocketException("Unknown host for the coordinator.");
+            }
+        }
+
+        descriptor = socket(AF_INET, SOCK_STREAM, 0);
+        if(descriptor < 0)
+            throw SocketException("Can NOT create TCP socket.");
+        if(connect(descriptor, (struct sockaddr *) &remote, sizeof(remote)) < 0)
+        {
+            close(descriptor);
+            throw SocketException("Can NOT connect to the coordinator.");
+        }
+        int noDelay = 1;
+        setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return new ShardConnection(descriptor);
+}
+
+void ShardConnection::closeListening(int listeningSocket, string address)
+{
+    if(listeningSocket < 0)
+        return;
+    close(listeningSocket);
+    if(isUnixAddress(address))
+        unlink(address.c_str());
+}
+
+ShardConnection::ShardConnection(int descriptor)
+{
+    this->descriptor = descriptor;
+    this->incomplete = "";
+}
+
+ShardConnection::~ShardConnection()
+{
+    if(descriptor >= 0)
+        close(descriptor);
+}
+
+bool ShardConnection::send(string data)
+{
+    const char *toSend = data.c_str();
+    size_t remaining = data.size();
+    while(remaining > 0)
+    {
+        ssize_t sent = write(descriptor, toSend, remaining);
+        if(sent < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+        toSend += sent;
+        remaining -= (size_t) sent;
+    }
+    return true;
+}
+
+bool ShardConnection::receive(list<string> *lines)
+{
+    char buffer[BUFFER_SIZE];
+    ssize_t length = read(descriptor, buffer, BUFFER_SIZE);
+    if(length < 0 && errno == EINTR)
+        return true;
+    if(length <= 0)
+        return false;
+
+    incomplete.append(buffer, (size_t) length);
+    size_t start = 0, lineBreak = incomplete.find('\n');
+    while(lineBreak != string::npos)
+    {
+        lines->push_back(incomplete.substr(start, lineBreak - start));
+        start = lineBreak + 1;
+        lineBreak = incomplete.find('\n', start);
+    }
+    incomplete.erase(0, start);
+    return true;
+}
+
+bool ShardConnection::receiveLine(string *line)
+{
+    size_t lineBreak = incomplete.find('\n');
+    while(lineBreak == string::npos)
+    {
+        char buffer[BUFFER_SIZE];
+        ssize_t length = read(descriptor, buffer, BUFFER_SIZE);
+        if(length < 0 && errno == EINTR)
+            continue;
+        if(length <= 0)
+            return false;
+        size_t searchFrom = incomplete.size();
+        incomplete.append(buffer, (size_t) length);
+        lineBreak = incomplete.find('\n', searchFrom);
+    }
+
+    (*line) = incomplete.substr(0, lineBreak);
+    incomplete.erase(0, lineBreak + 1);
+    return true;
+}
+
+int ShardConnection::detach()
+{
+    int detached = descriptor;
+    descriptor = -1;
+    return detached;
+}
+
+void ShardConnection::parseTCPAddress(string address, string *host, unsigned short *port) throw(SocketException)
+{
+    size_t colon = address.rfind(':');
+    string portStr = address;
+    if(colon != string::npos)
+    {
+        (*host) = address.substr(0, colon);
+        portStr = address.substr(colon + 1);
+    }
+
+    int gotPort = std::atoi(portStr.c_str());
+    if(gotPort <= 0 || gotPort > 65535)
+        throw SocketException("Invalid port in the address of the coordinator.");
+    (*port) = (unsigned short) gotPort;
+}
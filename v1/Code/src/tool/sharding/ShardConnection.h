@@ -0,0 +1,73 @@
+/*
+ * ShardConnection.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * ShardConnection is one end of the connection between the coordinator of a sharded campaign
+ * (see ShardCoordinator) and one of its workers, i.e., RTrack instances which only probe the
+ * share of the targets (shard) they are given. The connection is either a TCP connection or a
+ * Unix domain socket, depending on the address: any address containing a '/' is the path of a Unix
+ * socket, otherwise it is "[host]:[port]" or only "[port]" (all interfaces for the coordinator,
+ * localhost for a worker).
+ *
+ * The protocol is line-based and re-uses the records of the checkpoint journal (see
+ * CheckpointJournal):
+ * -the coordinator sends the shard, one "X [IP]" record per target, followed by "E shard",
+ * -the worker streams back the records of its journal ("P" and "T" records, "E" at the end of
+ *  each phase), plus "A [probes] [successful probes]" after the traceroute, then closes.
+ */
+
+#ifndef SHARDCONNECTION_H_
+#define SHARDCONNECTION_H_
+
+#include <string>
+using std::string;
+#include <list>
+using std::list;
+
+#include "../../prober/exception/SocketException.h"
+
+class ShardConnection
+{
+public:
+
+    static const size_t BUFFER_SIZE = 65536;
+    static const int LISTEN_BACKLOG = 64;
+
+    // Methods to open a connection (listening socket, accepted connection, worker connection)
+    static int listenOn(string address) throw(SocketException);
+    static ShardConnection *acceptFrom(int listeningSocket) throw(SocketException);
+    static ShardConnection *connectTo(string address) throw(SocketException);
+    static void closeListening(int listeningSocket, string address);
+
+    // Constructor (takes ownership of the descriptor), destructor (closes it unless detached)
+    ShardConnection(int descriptor);
+    ~ShardConnection();
+
+    // Writes the whole string; returns false if the connection was lost
+    bool send(string data);
+
+    /*
+     * Reads what is available (a single read()) and appends the complete lines to the list;
+     * returns false once the other end closed the connection (or upon error).
+     */
+
+    bool receive(list<string> *lines);
+
+    // Blocks until a complete line is available; returns false if the connection was lost
+    bool receiveLine(string *line);
+
+    inline int getDescriptor() { return this->descriptor; }
+    int detach(); // The descriptor is no longer closed by this object
+
+private:
+
+    int descriptor;
+    string incomplete; // Received data after the last line break
+
+    static bool isUnixAddress(string address) { return address.find('/') != string::npos; }
+    static void parseTCPAddress(string address, string *host, unsigned short *port) throw(SocketException);
+};
+
+#endif /* SHARDCONNECTION_H_ */
@@ -0,0 +1,229 @@
+/*
+ * ShardCoordinator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in ShardCoordinator.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <cstdlib>
+#include <cerrno>
+#include <sstream>
+using std::stringstream;
+#include <poll.h>
+
+#include "ShardCoordinator.h"
+
+ShardCoordinator::ShardCoordinator(ToolEnvironment *env,
+                                   string address,
+                                   unsigned short nbWorkers,
+                                   unsigned short prefixLength)
+{
+    this->env = env;
+    this->address = address;
+    this->nbWorkers = nbWorkers;
+    if(this->nbWorkers == 0)
+        this->nbWorkers = 1;
+    this->prefixLength = prefixLength;
+    if(this->prefixLength == 0 || this->prefixLength > 32)
+        this->prefixLength = DEFAULT_PREFIX_LENGTH;
+}
+
+ShardCoordinator::~ShardCoordinator()
+{
+    for(vector<Worker>::iterator it = workers.begin(); it != workers.end(); ++it)
+    {
+        delete it->connection;
+        delete it->records;
+    }
+    workers.clear();
+}
+
+unsigned short ShardCoordinator::shardOf(InetAddress target, unsigned short prefixLength, unsigned short nbShards)
+{
+    uint32_t prefix = (uint32_t) target.getULongAddress();
+    if(prefixLength < 32)
+        prefix >>= (32 - prefixLength);
+    uint32_t hash = prefix * 2654435761U; // Knuth's multiplicative hashing
+    return (unsigned short) ((hash >> 16) % nbShards);
+}
+
+void ShardCoordinator::run(list<InetAddress> targets) throw(SocketException)
+{
+    ostream *out = env->getOutputStream();
+
+    shards.assign(nbWorkers, list<InetAddress>());
+    for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+        shards[shardOf((*it), prefixLength, nbWorkers)].push_back((*it));
+
+    int listeningSocket = ShardConnection::listenOn(address);
+    (*out) << "Waiting for " << nbWorkers << " worker" << (nbWorkers > 1 ? "s" : "") << " on ";
+    (*out) << address << "..." << endl;
+
+    TimeVal deadline = *(TimeVal::getCurrentSystemTime()) + TimeVal(CONNECTION_DEADLINE, 0);
+    unsigned short nbConnected = 0;
+    bool listening = true;
+    while((listening && nbConnected < nbWorkers) || workers.size() > 0)
+    {
+        if(env->isStopping())
+        {
+            if(listening)
+                this->leaveUnclaimedShards(nbConnected);
+            break;
+        }
+        
+        // Missing workers: their shards are left to the coordinator
+        if(listening && nbConnected < nbWorkers && *(TimeVal::getCurrentSystemTime()) >= deadline)
+        {
+            this->leaveUnclaimedShards(nbConnected);
+            listening = false;
+            continue;
+        }
+
+        // Listening socket (until all workers are connected), then workers
+        vector<struct pollfd> fds;
+        size_t first = 0;
+        if(listening && nbConnected < nbWorkers)
+        {
+            struct pollfd listeningFD;
+            listeningFD.fd = listeningSocket;
+            listeningFD.events = POLLIN;
+            listeningFD.revents = 0;
+            fds.push_back(listeningFD);
+            first = 1;
+        }
+        size_t nbPolled = workers.size();
+        for(size_t i = 0; i < nbPolled; i++)
+        {
+            struct pollfd worker;
+            worker.fd = workers[i].connection->getDescriptor();
+            worker.events = POLLIN;
+            worker.revents = 0;
+            fds.push_back(worker);
+        }
+
+        int ready = poll(&fds[0], fds.size(), POLLING_PERIOD);
+        if(ready < 0 && errno == EINTR)
+            continue;
+        if(ready < 0)
+        {
+            ShardConnection::closeListening(listeningSocket, address);
+            throw SocketException("Can NOT wait for the workers.");
+        }
+        if(ready == 0)
+            continue;
+
+        // Workers are handled backwards, so that lost or completed ones can be erased on the way
+        for(size_t i = nbPolled; i > 0; i--)
+        {
+            Worker &worker = workers[i - 1];
+            if(fds[first + i - 1].revents == 0)
+                continue;
+
+            list<string> lines;
+            bool open = worker.connection->receive(&lines);
+            for(list<string>::iterator it = lines.begin(); it != lines.end(); ++it)
+                this->handle(worker, (*it));
+            if(!open)
+            {
+                this->finish(worker);
+                workers.erase(workers.begin() + (i - 1));
+            }
+        }
+
+        if(first == 1 && (fds[0].revents & POLLIN))
+        {
+            Worker newWorker;
+            try
+            {
+                newWorker.connection = ShardConnection::acceptFrom(listeningSocket);
+            }
+            catch(SocketException &e)
+            {
+                ShardConnection::closeListening(listeningSocket, address);
+                throw;
+            }
+            newWorker.records = new CheckpointJournal("");
+            newWorker.shard = nbConnected++;
+            workers.push_back(newWorker);
+            this->dispatch(workers.back());
+        }
+    }
+
+    ShardConnection::closeListening(listeningSocket, address);
+}
+
+void ShardCoordinator::leaveUnclaimedShards(unsigned short nbConnected)
+{
+    ostream *out = env->getOutputStream();
+    for(unsigned short i = nbConnected; i < nbWorkers; i++)
+    {
+        (*out) << "Worker " << (i + 1) << " did not connect; " << shards[i].size() << " target";
+        (*out) << (shards[i].size() != 1 ? "s are" : " is") << " left to the coordinator." << endl;
+        leftoverTargets.splice(leftoverTargets.end(), shards[i]);
+    }
+}
+
+void ShardCoordinator::dispatch(Worker &worker)
+{
+    list<InetAddress> &shard = shards[worker.shard];
+    stringstream records;
+    for(list<InetAddress>::iterator it = shard.begin(); it != shard.end(); ++it)
+        records << "X " << (*it) << "\n";
+    records << "E shard\n";
+
+    ostream *out = env->getOutputStream();
+    (*out) << "Worker " << (worker.shard + 1) << " connected; " << shard.size() << " target";
+    (*out) << (shard.size() != 1 ? "s" : "") << " dispatched." << endl;
+
+    // A failure shows up as a lost connection when polling
+    worker.connection->send(records.str());
+}
+
+void ShardCoordinator::handle(Worker &worker, string &line)
+{
+    if(line.size() > 2 && line[0] == 'A')
+    {
+        stringstream amounts(line.substr(2));
+        unsigned int nbProbes = 0, nbSuccessfulProbes = 0;
+        if(amounts >> nbProbes >> nbSuccessfulProbes)
+            env->updateProbeAmounts(nbProbes, nbSuccessfulProbes);
+        return;
+    }
+
+    // Targets and traces are merged (and journaled by the coordinator, if it has a journal)
+    if(worker.records->parseRecord(line, env->getIPTable(), env->getTraces()))
+    {
+        CheckpointJournal *journal = env->getCheckpointJournal();
+        if(journal != NULL)
+            journal->record(line);
+    }
+}
+
+void ShardCoordinator::finish(Worker &worker)
+{
+    ostream *out = env->getOutputStream();
+    list<InetAddress> &shard = shards[worker.shard];
+    if(worker.records->hasEnded("traceroute"))
+    {
+        (*out) << "Worker " << (worker.shard + 1) << " completed its shard (";
+        if(worker.records->hasEnded("pre-scanning"))
+            (*out) << worker.records->getNbLoadedTargets() << " responsive targets, ";
+        (*out) << worker.records->getNbLoadedTraces() << " traces)." << endl;
+    }
+    else
+    {
+        list<InetAddress> left = worker.records->filterTraced(shard, 1);
+        (*out) << "Worker " << (worker.shard + 1) << " was lost before completing its shard; ";
+        (*out) << left.size() << " target" << (left.size() != 1 ? "s are" : " is") << " left ";
+        (*out) << "to the coordinator." << endl;
+        leftoverTargets.splice(leftoverTargets.end(), left);
+    }
+
+    delete worker.connection;
+    delete worker.records;
+    worker.connection = NULL;
+    worker.records = NULL;
+}
@@ -0,0 +1,82 @@
+/*
+ * ShardCoordinator.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * ShardCoordinator splits a campaign between several RTrack instances (workers), either on the
+ * same host (e.g., one per network interface) or on several hosts of the same LAN, so that the
+ * probing throughput scales with the amount of workers while the route analysis still reasons
+ * over all the traces at once. The targets are split in shards by hashing their prefix (by
+ * default, their /24), so that all targets of a prefix are traced by the same worker, which keeps
+ * Doubletree and sibling targets as efficient as with a single instance.
+ *
+ * Each worker connects to the coordinator (see ShardConnection), receives its shard, probes it
+ * (pre-scanning if it uses -s, then traceroute) and streams back its responsive targets and its
+ * traces, which are merged in the IP dictionnary and the trace list of the coordinator as they
+ * arrive. The coordinator then carries out the subsequent phases (route analysis, bis traces,
+ * fingerprinting, etc.) by itself. The targets of a worker which is lost before completing its
+ * traceroute and which were not traced yet are given back to the coordinator (leftover targets).
+ * Likewise, the shards of the workers which did not connect within CONNECTION_DEADLINE seconds
+ * (or before an emergency stop) are entirely left to the coordinator, so that a missing worker
+ * cannot block the campaign.
+ */
+
+#ifndef SHARDCOORDINATOR_H_
+#define SHARDCOORDINATOR_H_
+
+#include <vector>
+using std::vector;
+
+#include "../ToolEnvironment.h"
+#include "ShardConnection.h"
+
+class ShardCoordinator
+{
+public:
+
+    static const unsigned short DEFAULT_PREFIX_LENGTH = 24;
+    static const int POLLING_PERIOD = 1000; // In ms (to check the emergency stop)
+    static const long CONNECTION_DEADLINE = 600; // In seconds, since the coordinator listens
+
+    // Constructor, destructor
+    ShardCoordinator(ToolEnvironment *env,
+                     string address,
+                     unsigned short nbWorkers,
+                     unsigned short prefixLength);
+    ~ShardCoordinator();
+
+    // Dispatches the shards then merges the results until all workers completed (or were lost)
+    void run(list<InetAddress> targets) throw(SocketException);
+
+    inline list<InetAddress> getLeftoverTargets() { return this->leftoverTargets; }
+
+    // Index of the shard of a target
+    static unsigned short shardOf(InetAddress target, unsigned short prefixLength, unsigned short nbShards);
+
+private:
+
+    // Worker (the records object is only used to parse and count the received records)
+    struct Worker
+    {
+        ShardConnection *connection;
+        CheckpointJournal *records;
+        unsigned int shard; // Index in shards
+    };
+
+    ToolEnvironment *env;
+    string address;
+    unsigned short nbWorkers, prefixLength;
+
+    vector<list<InetAddress> > shards;
+    vector<Worker> workers;
+    list<InetAddress> leftoverTargets;
+
+    // Private methods
+    void dispatch(Worker &worker);
+    void handle(Worker &worker, string &line);
+    void finish(Worker &worker);
+    void leaveUnclaimedShards(unsigned short nbConnected);
+};
+
+#endif /* SHARDCOORDINATOR_H_ */
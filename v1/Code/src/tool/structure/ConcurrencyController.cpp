@@ -0,0 +1,162 @@
+/*
+ * ConcurrencyController.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in ConcurrencyController.h (see this file to learn further about 
+ * the goals of such class).
+ */
+
+#include "ConcurrencyController.h"
+
+ConcurrencyController::ConcurrencyController(unsigned short maxConcurrency):
+controllerMutex(Mutex::ERROR_CHECKING_MUTEX),
+freeSlot(&controllerMutex)
+{
+    if(maxConcurrency == 0)
+        maxConcurrency = 1;
+    maxLimit = maxConcurrency;
+    limit = maxConcurrency;
+    lowestLimit = maxConcurrency;
+    nbRunning = 0;
+    tasksSinceChange = 0;
+    consecutiveFailures = 0;
+    epochEnd = TimeVal(0, 0);
+    nbBackoffs = 0;
+    nbRetries = 0;
+    lastBackoff = TimeVal(0, 0);
+    windowProbes = 0;
+    windowSuccessfulProbes = 0;
+    baselineLossRatio = 0;
+    hasLossRatio = false;
+}
+
+ConcurrencyController::~ConcurrencyController()
+{
+}
+
+void ConcurrencyController::backOff()
+{
+    TimeVal now = *(TimeVal::getCurrentSystemTime());
+    if(nbBackoffs > 0 && now - lastBackoff < TimeVal(HOLD_PERIOD, 0))
+        return;
+    
+    lastBackoff = now;
+    nbBackoffs++;
+    tasksSinceChange = 0;
+    limit /= 2;
+    if(limit == 0)
+        limit = 1;
+    if(limit < lowestLimit)
+        lowestLimit = limit;
+}
+
+void ConcurrencyController::acquire()
+{
+    controllerMutex.lock();
+    while(nbRunning >= limit)
+        freeSlot.wait();
+    nbRunning++;
+    controllerMutex.unlock();
+}
+
+void ConcurrencyController::release(bool failed)
+{
+    controllerMutex.lock();
+    if(nbRunning > 0)
+        nbRunning--;
+    
+    if(failed)
+    {
+        // Failures of the tasks running along the first one of an epoch count as one
+        TimeVal now = *(TimeVal::getCurrentSystemTime());
+        if(now >= epochEnd)
+        {
+            consecutiveFailures++;
+            epochEnd = now + TimeVal(0, BASE_RETRY_DELAY) * (float) consecutiveFailures;
+        }
+        nbRetries++;
+    }
+    else
+    {
+        consecutiveFailures = 0;
+        tasksSinceChange++;
+        
+        // Additive increase: one more task once a whole "round" of tasks went fine
+        if(tasksSinceChange >= (unsigned int) limit && limit < maxLimit)
+        {
+            limit++;
+            tasksSinceChange = 0;
+        }
+    }
+    freeSlot.broadcast();
+    controllerMutex.unlock();
+}
+
+void ConcurrencyController::signalFailure()
+{
+    controllerMutex.lock();
+    this->backOff();
+    controllerMutex.unlock();
+}
+
+void ConcurrencyController::recordProbes(unsigned int nbProbes, unsigned int nbSuccessfulProbes)
+{
+    controllerMutex.lock();
+    windowProbes += nbProbes;
+    windowSuccessfulProbes += nbSuccessfulProbes;
+    if(windowProbes >= LOSS_WINDOW)
+    {
+        unsigned int lost = windowProbes - windowSuccessfulProbes;
+        unsigned short lossRatio = (unsigned short) ((lost * 100) / windowProbes);
+        if(!hasLossRatio)
+        {
+            baselineLossRatio = lossRatio;
+            hasLossRatio = true;
+        }
+        else
+        {
+            if(lossRatio > baselineLossRatio + LOSS_MARGIN)
+                this->backOff();
+            baselineLossRatio = (3 * baselineLossRatio + lossRatio) / 4;
+        }
+        windowProbes = 0;
+        windowSuccessfulProbes = 0;
+    }
+    controllerMutex.unlock();
+}
+
+void ConcurrencyController::capConcurrency(unsigned short maxConcurrency)
+{
+    if(maxConcurrency == 0)
+        maxConcurrency = 1;
+    
+    controllerMutex.lock();
+    if(maxConcurrency < maxLimit)
+        maxLimit = maxConcurrency;
+    if(limit > maxLimit)
+        limit = maxLimit;
+    if(limit < lowestLimit)
+        lowestLimit = limit;
+    controllerMutex.unlock();
+}
+
+bool ConcurrencyController::givesUp()
+{
+    bool res = false;
+    controllerMutex.lock();
+    res = (consecutiveFailures >= MAX_CONSECUTIVE_FAILURES);
+    controllerMutex.unlock();
+    return res;
+}
+
+TimeVal ConcurrencyController::getRetryDelay()
+{
+    unsigned short factor = 1;
+    controllerMutex.lock();
+    if(consecutiveFailures > 1)
+        factor = consecutiveFailures;
+    controllerMutex.unlock();
+    return TimeVal(0, BASE_RETRY_DELAY) * (float) factor;
+}
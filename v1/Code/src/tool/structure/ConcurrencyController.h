@@ -0,0 +1,95 @@
+/*
+ * ConcurrencyController.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * ConcurrencyController bounds the amount of tasks running at the same time in a pool of workers 
+ * (see TracerouteWorker) and adapts this bound like TCP adapts its congestion window (AIMD), so 
+ * that a lack of resources slows down a campaign instead of stopping it. Congestion is signaled 
+ * by the workers when a socket cannot be opened or a probe cannot be sent (e.g. the kernel lacks 
+ * buffers), and detected when the ratio of unanswered probes, computed over windows of 
+ * LOSS_WINDOW probes, exceeds its smoothed value (over the previous windows) by more than 
+ * LOSS_MARGIN percents. A lasting change of the ratio (e.g. less responsive targets) therefore 
+ * only slows down the campaign once.
+ *
+ * Upon congestion, the bound is halved (at most once every HOLD_PERIOD seconds, as a burst of 
+ * failures is a single congestion event) and the failed work is retried by the worker after a 
+ * delay which grows with the amount of consecutive failures. Every time as many tasks as the 
+ * bound complete without congestion, the bound grows by one, up to its initial value.
+ *
+ * Failures are counted per congestion epoch: the failures which occur before the retry delay of 
+ * the first failure of the epoch has passed are a single failure (all running tasks typically 
+ * fail at once when the kernel lacks buffers or descriptors). After MAX_CONSECUTIVE_FAILURES 
+ * epochs of failures without any task succeeding in between, the controller gives up, and the 
+ * usual emergency stop takes place (the resources are most likely not coming back).
+ */
+
+#ifndef CONCURRENCYCONTROLLER_H_
+#define CONCURRENCYCONTROLLER_H_
+
+#include "../../common/date/TimeVal.h"
+#include "../../common/thread/Mutex.h"
+#include "../../common/thread/ConditionVariable.h"
+
+class ConcurrencyController
+{
+public:
+
+    static const unsigned int LOSS_WINDOW = 500; // Probes per evaluation of the loss ratio
+    static const unsigned short LOSS_MARGIN = 15; // In percents
+    static const unsigned short HOLD_PERIOD = 1; // In seconds
+    static const unsigned short MAX_CONSECUTIVE_FAILURES = 8; // Epochs of failures
+    static const long BASE_RETRY_DELAY = 500000; // In microseconds (multiplied by the failures)
+
+    // Constructor (the bound starts at the maximum amount of concurrent tasks), destructor
+    ConcurrencyController(unsigned short maxConcurrency);
+    ~ConcurrencyController();
+
+    // Waits until a new task can run, then counts it as running
+    void acquire();
+
+    // Counts a task as over (failed if it could not be carried out and will be retried)
+    void release(bool failed);
+
+    // Congestion signaled by a worker (socket or thread creation, sending failure)
+    void signalFailure();
+
+    // Records the probes of a task (loss ratio)
+    void recordProbes(unsigned int nbProbes, unsigned int nbSuccessfulProbes);
+
+    // Caps the bound to the amount of workers which could actually be created
+    void capConcurrency(unsigned short maxConcurrency);
+
+    // True if the failures go on without any success (emergency stop advised)
+    bool givesUp();
+
+    // Delay to wait before retrying a failed task
+    TimeVal getRetryDelay();
+
+    inline unsigned short getLimit() { return this->limit; }
+    inline unsigned short getLowestLimit() { return this->lowestLimit; }
+    inline unsigned int getNbBackoffs() { return this->nbBackoffs; }
+    inline unsigned int getNbRetries() { return this->nbRetries; }
+
+private:
+
+    unsigned short maxLimit, limit, lowestLimit, nbRunning;
+    unsigned int tasksSinceChange; // Completed tasks since the last change of the bound
+    unsigned short consecutiveFailures;
+    TimeVal epochEnd; // End of the current congestion epoch (failures until then count as one)
+    unsigned int nbBackoffs, nbRetries;
+    TimeVal lastBackoff;
+
+    // Loss ratio (current window and smoothed ratio of the previous windows, in percents)
+    unsigned int windowProbes, windowSuccessfulProbes;
+    unsigned short baselineLossRatio;
+    bool hasLossRatio;
+
+    Mutex controllerMutex;
+    ConditionVariable freeSlot;
+
+    void backOff(); // Mutex must be locked
+};
+
+#endif /* CONCURRENCYCONTROLLER_H_ */
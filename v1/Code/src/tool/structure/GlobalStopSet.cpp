@@ -0,0 +1,129 @@
+/*
+ * GlobalStopSet.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in GlobalStopSet.h (see this file to learn further about the goals
+ * of such class).
+ */
+
+#include <cstdlib>
+
+#include "GlobalStopSet.h"
+
+GlobalStopSet::GlobalStopSet(unsigned short verificationRate):
+setMutex(Mutex::ERROR_CHECKING_MUTEX)
+{
+    this->verificationRate = verificationRate;
+    if(this->verificationRate > 100)
+        this->verificationRate = 100;
+}
+
+GlobalStopSet::~GlobalStopSet()
+{
+    for(vector<KnownRoute*>::iterator it = routes.begin(); it != routes.end(); ++it)
+        delete (*it);
+    routes.clear();
+    pairs.clear();
+}
+
+bool GlobalStopSet::drawVerification()
+{
+    if(verificationRate == 0)
+        return false;
+    return (unsigned short) (rand() % 100) < verificationRate;
+}
+
+bool GlobalStopSet::lookUp(InetAddress interface,
+                           InetAddress target,
+                           list<InetAddress> &suffixHops,
+                           list<unsigned char> &suffixReplyTTLs,
+                           bool &reachable)
+{
+    if(interface == InetAddress(0))
+        return false;
+
+    bool found = false;
+    setMutex.lock();
+    map<uint64_t, PairLocation>::iterator it = pairs.find(pairKey(interface, target));
+    if(it != pairs.end())
+    {
+        KnownRoute *route = routes[it->second.route];
+        for(size_t i = (size_t) it->second.hop + 1; i < route->hops.size(); i++)
+        {
+            suffixHops.push_back(route->hops[i]);
+            if(i < route->replyTTLs.size())
+                suffixReplyTTLs.push_back(route->replyTTLs[i]);
+            else
+                suffixReplyTTLs.push_back(0);
+        }
+        reachable = route->reachable;
+        found = true;
+    }
+    setMutex.unlock();
+    return found;
+}
+
+bool GlobalStopSet::record(InetAddress target,
+                           list<InetAddress> &routeHops,
+                           list<unsigned char> &replyTTLs,
+                           bool reachable,
+                           bool verification)
+{
+    if(routeHops.size() == 0)
+        return false;
+
+    KnownRoute *route = new KnownRoute();
+    route->hops.assign(routeHops.begin(), routeHops.end());
+    route->replyTTLs.assign(replyTTLs.begin(), replyTTLs.end());
+    route->reachable = reachable;
+
+    setMutex.lock();
+    unsigned int routeIndex = (unsigned int) routes.size();
+    bool newPairs = false, routeChange = false;
+    for(unsigned short i = 0; i < (unsigned short) route->hops.size(); i++)
+    {
+        if(route->hops[i] == InetAddress(0))
+            continue;
+
+        uint64_t key = pairKey(route->hops[i], target);
+        map<uint64_t, PairLocation>::iterator it = pairs.find(key);
+        if(it == pairs.end())
+        {
+            PairLocation location;
+            location.route = routeIndex;
+            location.hop = i;
+            pairs.insert(std::pair<uint64_t, PairLocation>(key, location));
+            newPairs = true;
+            continue;
+        }
+
+        if(!verification)
+            continue;
+
+        // Compares the rest of both routes
+        KnownRoute *known = routes[it->second.route];
+        size_t knownHop = (size_t) it->second.hop + 1, newHop = (size_t) i + 1;
+        bool sameSuffix = (known->hops.size() - knownHop) == (route->hops.size() - newHop);
+        sameSuffix = sameSuffix && known->reachable == route->reachable;
+        for(; sameSuffix && newHop < route->hops.size(); knownHop++, newHop++)
+            if(known->hops[knownHop] != route->hops[newHop])
+                sameSuffix = false;
+
+        if(!sameSuffix)
+        {
+            it->second.route = routeIndex;
+            it->second.hop = i;
+            newPairs = true;
+            routeChange = true;
+        }
+    }
+
+    if(newPairs)
+        routes.push_back(route);
+    else
+        delete route;
+    setMutex.unlock();
+    return routeChange;
+}
@@ -0,0 +1,106 @@
+/*
+ * GlobalStopSet.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * GlobalStopSet is the "global stop set" of Doubletree (Donnet et al., "Efficient Algorithms for
+ * Large-Scale Topology Discovery", SIGMETRICS 2005), i.e., the set of (interface, destination
+ * prefix) pairs observed by the traces collected so far, the prefix being the /24 of the target.
+ * Targets of a same /24 are usually reached through the same routers once their routes converge,
+ * so a trace which gets an interface already seen on the route towards another target of the
+ * same /24 can stop probing forward: the rest of the route is copied from the other trace and
+ * marked as inferred (see RouteInterface), rather than measured. Whether the other target was
+ * reached is kept with its route: if it was, the trace which copies it probes its own target right
+ * after the copied hops, and is only considered as reachable if the target replies there (it goes
+ * on probing as usual otherwise). The reachability and the distance of a target are therefore
+ * never taken from another target.
+ *
+ * As for LocalStopSet, the routes which brought new pairs are kept to fill the other traces, and
+ * each pair points to the hop of the route where it was first seen. To still detect route
+ * changes, a given share of the traces (the verification rate) ignore the set and are fully
+ * measured; if the rest of such a route differs from the one in the set, the pairs are updated
+ * to point to the new route.
+ */
+
+#ifndef GLOBALSTOPSET_H_
+#define GLOBALSTOPSET_H_
+
+#include <inttypes.h>
+#include <list>
+using std::list;
+#include <vector>
+using std::vector;
+#include <map>
+using std::map;
+
+#include "../../common/inet/InetAddress.h"
+#include "../../common/thread/Mutex.h"
+
+class GlobalStopSet
+{
+public:
+
+    // Constructor (verification rate is a percentage), destructor
+    GlobalStopSet(unsigned short verificationRate);
+    ~GlobalStopSet();
+
+    inline unsigned short getVerificationRate() { return this->verificationRate; }
+
+    // Draws whether a new trace should be fully measured to verify the set
+    bool drawVerification();
+
+    /*
+     * Returns true if the pair (interface, /24 of the target) is in the set. In that case, the
+     * hops which follow this interface in the route where it was seen (and their reply TTLs) are
+     * appended to the given lists, and "reachable" tells whether this route reached its target.
+     */
+
+    bool lookUp(InetAddress interface,
+                InetAddress target,
+                list<InetAddress> &suffixHops,
+                list<unsigned char> &suffixReplyTTLs,
+                bool &reachable);
+
+    /*
+     * Records the pairs of a complete (i.e., measured) route. If "verification" is true, pairs
+     * already in the set are updated when the rest of the route differs. The return value tells
+     * whether such a difference (i.e., a route change) was found.
+     */
+
+    bool record(InetAddress target,
+                list<InetAddress> &routeHops,
+                list<unsigned char> &replyTTLs,
+                bool reachable,
+                bool verification);
+
+private:
+
+    // A route kept to fill the traces which stop on one of its pairs
+    struct KnownRoute
+    {
+        vector<InetAddress> hops;
+        vector<unsigned char> replyTTLs;
+        bool reachable; // The target replied right after the last hop
+    };
+
+    // Hop of a known route where a pair was seen
+    struct PairLocation
+    {
+        unsigned int route;
+        unsigned short hop;
+    };
+
+    // Key of a pair: interface (as an integer) and /24 of the target
+    static inline uint64_t pairKey(InetAddress &interface, InetAddress &target)
+    {
+        return ((uint64_t) interface.getULongAddress() << 24) | (uint64_t) (target.getULongAddress() >> 8);
+    }
+
+    unsigned short verificationRate;
+    map<uint64_t, PairLocation> pairs;
+    vector<KnownRoute*> routes;
+    Mutex setMutex;
+};
+
+#endif /* GLOBALSTOPSET_H_ */
@@ -0,0 +1,195 @@
+/*
+ * Hitlist.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in Hitlist.h (see this file to learn further about the goals of
+ * such class).
+ */
+
+#include <sstream>
+using std::stringstream;
+#include <fstream>
+using std::ofstream;
+#include <sys/stat.h> // For CHMOD edition
+
+#include "Hitlist.h"
+#include "../../common/inet/InetAddressException.h"
+
+Hitlist::Hitlist()
+{
+}
+
+Hitlist::~Hitlist()
+{
+    targets.clear();
+}
+
+void Hitlist::addResponsiveTargets(IPLookUpTable *table, list<InetAddress> &targets)
+{
+    for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+    {
+        IPTableEntry *entry = table->lookUp((*it));
+        if(entry == NULL)
+            continue;
+
+        HitlistRecord record;
+        record.timeout = entry->getPreferredTimeout();
+        record.distance = entry->getEstimatedTTL();
+        this->targets[it->getULongAddress()] = record;
+    }
+}
+
+bool Hitlist::load(string label)
+{
+    if(this->loadBinary(label + ".hitlist.bin"))
+        return true;
+    return this->loadText(label + ".hitlist");
+}
+
+void Hitlist::save(string label)
+{
+    // Text file
+    string filename = label + ".hitlist";
+    ofstream textFile;
+    textFile.open(filename.c_str());
+    for(map<unsigned long, HitlistRecord>::iterator it = targets.begin(); it != targets.end(); ++it)
+    {
+        textFile << InetAddress(it->first) << " " << it->second.timeout.getSecondsPart() << " ";
+        textFile << it->second.timeout.getMicroSecondsPart() << " ";
+        textFile << (unsigned short) it->second.distance << "\n";
+    }
+    textFile.close();
+
+    string path = "./" + filename;
+    chmod(path.c_str(), 0766);
+
+    // Binary file (integers in network byte order, whatever the host)
+    string binary = "RTHL";
+    binary += (char) FORMAT_VERSION;
+    unsigned long nbRecords = (unsigned long) targets.size();
+    for(short shift = 24; shift >= 0; shift -= 8)
+        binary += (char) ((nbRecords >> shift) & 0xFF);
+
+    for(map<unsigned long, HitlistRecord>::iterator it = targets.begin(); it != targets.end(); ++it)
+    {
+        TimeVal timeout = it->second.timeout;
+        unsigned long microSeconds = (unsigned long) (timeout.getSecondsPart() * 1000000 + timeout.getMicroSecondsPart());
+        for(short shift = 24; shift >= 0; shift -= 8)
+            binary += (char) ((it->first >> shift) & 0xFF);
+        for(short shift = 24; shift >= 0; shift -= 8)
+            binary += (char) ((microSeconds >> shift) & 0xFF);
+        binary += (char) it->second.distance;
+    }
+
+    filename = label + ".hitlist.bin";
+    ofstream binaryFile;
+    binaryFile.open(filename.c_str(), std::ios::out | std::ios::binary);
+    binaryFile.write(binary.data(), binary.size());
+    binaryFile.close();
+
+    path = "./" + filename;
+    chmod(path.c_str(), 0766);
+}
+
+bool Hitlist::contains(InetAddress target)
+{
+    return targets.find(target.getULongAddress()) != targets.end();
+}
+
+TimeVal Hitlist::getLongestTimeout()
+{
+    TimeVal longest(0, 0);
+    for(map<unsigned long, HitlistRecord>::iterator it = targets.begin(); it != targets.end(); ++it)
+        if(it->second.timeout > longest)
+            longest = it->second.timeout;
+    return longest;
+}
+
+TimeVal Hitlist::getTimeout(InetAddress target)
+{
+    map<unsigned long, HitlistRecord>::iterator res = targets.find(target.getULongAddress());
+    if(res == targets.end())
+        return TimeVal(0, 0);
+    return res->second.timeout;
+}
+
+unsigned char Hitlist::getDistance(InetAddress target)
+{
+    map<unsigned long, HitlistRecord>::iterator res = targets.find(target.getULongAddress());
+    if(res == targets.end())
+        return 0;
+    return res->second.distance;
+}
+
+bool Hitlist::loadBinary(string filename)
+{
+    std::ifstream binaryFile;
+    binaryFile.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!binaryFile.is_open())
+        return false;
+
+    string content = "";
+    content.assign((std::istreambuf_iterator<char>(binaryFile)), (std::istreambuf_iterator<char>()));
+    binaryFile.close();
+
+    if(content.size() < 9 || content.substr(0, 4) != "RTHL" || (unsigned char) content[4] != FORMAT_VERSION)
+        return false;
+
+    const unsigned char *data = (const unsigned char*) content.data();
+    unsigned long nbRecords = 0;
+    for(unsigned short i = 5; i < 9; i++)
+        nbRecords = (nbRecords << 8) | data[i];
+
+    // A truncated file only gives its complete records
+    size_t offset = 9;
+    for(unsigned long i = 0; i < nbRecords && offset + RECORD_SIZE <= content.size(); i++)
+    {
+        unsigned long IP = 0, microSeconds = 0;
+        for(unsigned short j = 0; j < 4; j++)
+            IP = (IP << 8) | data[offset + j];
+        for(unsigned short j = 4; j < 8; j++)
+            microSeconds = (microSeconds << 8) | data[offset + j];
+
+        HitlistRecord record;
+        record.timeout = TimeVal((long) (microSeconds / 1000000), (long) (microSeconds % 1000000));
+        record.distance = data[offset + 8];
+        targets[IP] = record;
+        offset += RECORD_SIZE;
+    }
+    return true;
+}
+
+bool Hitlist::loadText(string filename)
+{
+    std::ifstream textFile;
+    textFile.open(filename.c_str());
+    if(!textFile.is_open())
+        return false;
+
+    string line;
+    while(std::getline(textFile, line))
+    {
+        stringstream ss(line);
+        string IPStr;
+        long seconds = 0, microSeconds = 0;
+        unsigned short distance = 0;
+        if(!(ss >> IPStr >> seconds >> microSeconds >> distance))
+            continue;
+
+        try
+        {
+            InetAddress IP(IPStr);
+            HitlistRecord record;
+            record.timeout = TimeVal(seconds, microSeconds);
+            record.distance = (unsigned char) distance;
+            targets[IP.getULongAddress()] = record;
+        }
+        catch(InetAddressException &e)
+        {
+        }
+    }
+    textFile.close();
+    return true;
+}
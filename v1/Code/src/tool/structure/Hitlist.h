@@ -0,0 +1,86 @@
+/*
+ * Hitlist.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Hitlist lists the responsive targets found by the pre-scanning of a campaign, with their
+ * preferred timeout and their distance (as estimated from the TTL of their echo reply), so that
+ * the next campaign towards the same targets (typically, the day after) does not prescan the
+ * whole target space again. It is saved in two files:
+ * -[label].hitlist, in text ("[IP] [timeout s] [timeout us] [distance]", one line per target),
+ * -[label].hitlist.bin, in a compact binary format: the magic "RTHL", a version byte, the amount
+ *  of records (4 bytes) then 9 bytes per record (IP, timeout in microseconds, distance), all
+ *  integers being written in network byte order.
+ *
+ * When a hitlist is imported, the targets it lists are only verified with a single pass (using
+ * the longest timeout of the hitlist), while a share of the other targets is prescanned as usual
+ * to find the targets which became responsive in the meantime (see -E). The distance saved for a
+ * verified target is used when its reply in the current campaign gives no estimation. The
+ * structure is read-only once loaded.
+ */
+
+#ifndef HITLIST_H_
+#define HITLIST_H_
+
+#include <string>
+using std::string;
+#include <list>
+using std::list;
+#include <map>
+using std::map;
+
+#include "../../common/date/TimeVal.h"
+#include "../../common/inet/InetAddress.h"
+#include "IPLookUpTable.h"
+
+class Hitlist
+{
+public:
+
+    const static unsigned char FORMAT_VERSION = 1;
+    const static unsigned short RECORD_SIZE = 9; // Bytes
+
+    // Constructor, destructor
+    Hitlist();
+    ~Hitlist();
+
+    // Adds the targets which are responsive according to the IP dictionnary
+    void addResponsiveTargets(IPLookUpTable *table, list<InetAddress> &targets);
+
+    /*
+     * Loads [label].hitlist.bin or, if it cannot be read, [label].hitlist. Returns false if none
+     * of both files could be read.
+     */
+
+    bool load(string label);
+
+    // Writes [label].hitlist and [label].hitlist.bin
+    void save(string label);
+
+    // Look-up methods
+    bool contains(InetAddress target);
+    TimeVal getLongestTimeout(); // Zero if the hitlist is empty
+    TimeVal getTimeout(InetAddress target); // Zero if unknown
+    unsigned char getDistance(InetAddress target); // Zero if unknown
+
+    inline unsigned int getNbTargets() { return (unsigned int) targets.size(); }
+
+private:
+
+    struct HitlistRecord
+    {
+        TimeVal timeout;
+        unsigned char distance;
+
+        HitlistRecord(): timeout(0, 0), distance(0) {}
+    };
+
+    map<unsigned long, HitlistRecord> targets;
+
+    // Private methods
+    bool loadBinary(string filename);
+    bool loadText(string filename);
+};
+
+#endif /* HITLIST_H_ */
@@ -19,6 +19,8 @@ using namespace std;
 IPLookUpTable::IPLookUpTable()
 {
     this->haystack = new list<IPTableEntry*>[SIZE_TABLE];
+    for(unsigned int i = 0; i < NB_LIST_MUTEXES; i++)
+        listMutexes[i] = new Mutex(Mutex::ERROR_CHECKING_MUTEX);
 }
 
 IPLookUpTable::~IPLookUpTable()
@@ -33,6 +35,8 @@ IPLookUpTable::~IPLookUpTable()
         haystack[i].clear();
     }
     delete[] haystack;
+    for(unsigned int i = 0; i < NB_LIST_MUTEXES; i++)
+        delete listMutexes[i];
 }
 
 bool IPLookUpTable::isEmpty()
@@ -61,11 +65,14 @@ IPTableEntry *IPLookUpTable::create(InetAddress needle)
 {
     unsigned long index = (needle.getULongAddress() >> 12);
     list<IPTableEntry*> *IPList = &(this->haystack[index]);
+    Mutex *listMutex = listMutexes[index % NB_LIST_MUTEXES];
     
+    listMutex->lock();
     for(list<IPTableEntry*>::iterator i = IPList->begin(); i != IPList->end(); ++i)
     {
         if((*i)->getULongAddress() == needle.getULongAddress())
         {
+            listMutex->unlock();
             return NULL;
         }
     }
@@ -73,6 +80,7 @@ IPTableEntry *IPLookUpTable::create(InetAddress needle)
     IPTableEntry *newEntry = new IPTableEntry(needle);
     IPList->push_back(newEntry);
     IPList->sort(IPTableEntry::compare);
+    listMutex->unlock();
     return newEntry;
 }
 
@@ -81,15 +89,39 @@ IPTableEntry *IPLookUpTable::lookUp(InetAddress needle)
     unsigned long index = (needle.getULongAddress() >> 12);
     list<IPTableEntry*> *IPList = &(this->haystack[index]);
     
+    Mutex *listMutex = listMutexes[index % NB_LIST_MUTEXES];
+    
+    IPTableEntry *found = NULL;
+    listMutex->lock();
     for(list<IPTableEntry*>::iterator i = IPList->begin(); i != IPList->end(); ++i)
     {
         if((*i)->getULongAddress() == needle.getULongAddress())
         {
-            return (*i);
+            found = (*i);
+            break;
         }
     }
+    listMutex->unlock();
+    
+    return found;
+}
+
+void IPLookUpTable::addSkippedPrefix(InetAddress prefix, unsigned char prefixLength)
+{
+    skippedPrefixes.push_back(NetworkAddress(prefix, prefixLength));
+}
+
+void IPLookUpTable::outputSkippedPrefixes(string filename)
+{
+    ofstream newFile;
+    newFile.open(filename.c_str());
+    for(list<NetworkAddress>::iterator it = skippedPrefixes.begin(); it != skippedPrefixes.end(); ++it)
+        newFile << (*it).getSubnetPrefix() << "/" << (unsigned short) (*it).getPrefixLength() << "\n";
+    newFile.close();
     
-    return NULL;
+    // File must be accessible to all
+    string path = "./" + filename;
+    chmod(path.c_str(), 0766);
 }
 
 list<InetAddress> IPLookUpTable::listIPs()
@@ -22,6 +22,13 @@
  *
  * January 18, 2017: this class is re-used with a few modifications (notably related to output and 
  *"amount of IP-IDs) in WIP Traceroute.
+ *
+ * Oct 19, 2026: creation and look-up of a same list are now mutually exclusive, because the 
+ * pre-scanning can create entries while the traceroute workers look up their targets (see 
+ * PrescanningPipeline). Lists share NB_LIST_MUTEXES mutexes (consecutive lists use different 
+ * mutexes), so threads looking up different prefixes rarely wait for each other.
+ * The table also lists the prefixes which were skipped by the sampled pre-scanning (see 
+ * PrefixSampler), i.e., prefixes whose IPs are neither responsive nor unresponsive but unknown.
  */
 
 #ifndef IPLOOKUPTABLE_H_
@@ -31,6 +38,8 @@
 using std::list;
 
 #include "IPTableEntry.h"
+#include "../../common/inet/NetworkAddress.h"
+#include "../../common/thread/Mutex.h"
 
 class IPLookUpTable
 {
@@ -38,6 +47,7 @@ public:
 
     // X = 20
     const static unsigned int SIZE_TABLE = 1048576;
+    const static unsigned int NB_LIST_MUTEXES = 256;
     
     // Constructor, destructor
     IPLookUpTable();
@@ -53,6 +63,11 @@ public:
     
     list<InetAddress> listIPs();
     
+    // Prefixes skipped by the sampled pre-scanning (their IPs were not all probed)
+    void addSkippedPrefix(InetAddress prefix, unsigned char prefixLength);
+    inline unsigned int getNbSkippedPrefixes() { return (unsigned int) this->skippedPrefixes.size(); }
+    void outputSkippedPrefixes(string filename);
+    
     void outputDictionnary(string filename);
     void outputRoundRecords(string filename);
     
@@ -63,6 +78,8 @@ public:
 private:
 
     list<IPTableEntry*> *haystack;
+    Mutex *listMutexes[NB_LIST_MUTEXES]; // For create() and lookUp()
+    list<NetworkAddress> skippedPrefixes;
     
 };
 
@@ -19,6 +19,7 @@ IPTableEntry::IPTableEntry(InetAddress ip) : InetAddress(ip)
 {
     TTL = NO_KNOWN_TTL;
     preferredTimeout = TimeVal(DEFAULT_TIMEOUT_SECONDS, TimeVal::HALF_A_SECOND);
+    estimatedTTL = 0;
     
     rateLimited = false;
     
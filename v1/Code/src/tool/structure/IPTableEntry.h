@@ -34,6 +34,10 @@ public:
     inline void setTTL(unsigned char TTL) { this->TTL = TTL; }
     inline void setPreferredTimeout(TimeVal timeout) { this->preferredTimeout = timeout; }
     
+    // Distance inferred from the echo reply obtained at pre-scanning (0 if unknown)
+    inline unsigned char getEstimatedTTL() { return this->estimatedTTL; }
+    inline void setEstimatedTTL(unsigned char TTL) { this->estimatedTTL = TTL; }
+    
     // TTL stuff (re-used from TreeNET's own IPTableEntry class)
     inline bool sameTTL(unsigned char TTL) { return (this->TTL != 0 && this->TTL == TTL); }
     bool hasHopCount(unsigned char hopCount);
@@ -78,6 +82,7 @@ private:
     
     unsigned char TTL; // Minimum TTL
     TimeVal preferredTimeout; // Set at pre-scanning
+    unsigned char estimatedTTL; // Set at pre-scanning
     list<unsigned char> hopCounts; // List of the TTLs at which this IP has been observed (no duplicates)
     
     /*
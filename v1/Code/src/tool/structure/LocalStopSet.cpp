@@ -0,0 +1,85 @@
+/*
+ * LocalStopSet.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in LocalStopSet.h (see this file to learn further about the goals
+ * of such class).
+ */
+
+#include "LocalStopSet.h"
+
+LocalStopSet::LocalStopSet():
+setMutex(Mutex::ERROR_CHECKING_MUTEX)
+{
+}
+
+LocalStopSet::~LocalStopSet()
+{
+    for(vector<KnownRoute*>::iterator it = routes.begin(); it != routes.end(); ++it)
+        delete (*it);
+    routes.clear();
+    pairs.clear();
+}
+
+void LocalStopSet::record(list<InetAddress> &routeHops, list<unsigned char> &replyTTLs)
+{
+    if(routeHops.size() == 0)
+        return;
+
+    setMutex.lock();
+    unsigned int routeIndex = (unsigned int) routes.size();
+    bool newPairs = false;
+    unsigned char TTL = 1;
+    for(list<InetAddress>::iterator it = routeHops.begin(); it != routeHops.end(); ++it)
+    {
+        if((*it) != InetAddress(0))
+        {
+            uint64_t key = pairKey((*it), TTL);
+            if(pairs.find(key) == pairs.end())
+            {
+                pairs.insert(std::pair<uint64_t, unsigned int>(key, routeIndex));
+                newPairs = true;
+            }
+        }
+        TTL++;
+    }
+
+    if(newPairs)
+    {
+        KnownRoute *route = new KnownRoute();
+        route->hops.assign(routeHops.begin(), routeHops.end());
+        route->replyTTLs.assign(replyTTLs.begin(), replyTTLs.end());
+        routes.push_back(route);
+    }
+    setMutex.unlock();
+}
+
+bool LocalStopSet::lookUp(InetAddress interface,
+                          unsigned char TTL,
+                          list<InetAddress> &prefixHops,
+                          list<unsigned char> &prefixReplyTTLs)
+{
+    if(interface == InetAddress(0))
+        return false;
+
+    bool found = false;
+    setMutex.lock();
+    map<uint64_t, unsigned int>::iterator it = pairs.find(pairKey(interface, TTL));
+    if(it != pairs.end())
+    {
+        KnownRoute *route = routes[it->second];
+        for(unsigned short i = 0; i < (unsigned short) TTL - 1 && i < route->hops.size(); i++)
+        {
+            prefixHops.push_back(route->hops[i]);
+            if(i < route->replyTTLs.size())
+                prefixReplyTTLs.push_back(route->replyTTLs[i]);
+            else
+                prefixReplyTTLs.push_back(0);
+        }
+        found = true;
+    }
+    setMutex.unlock();
+    return found;
+}
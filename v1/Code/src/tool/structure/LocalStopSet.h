@@ -0,0 +1,83 @@
+/*
+ * LocalStopSet.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * LocalStopSet is the "local stop set" of Doubletree (Donnet et al., "Efficient Algorithms for
+ * Large-Scale Topology Discovery", SIGMETRICS 2005), i.e., the set of (interface, TTL) pairs
+ * already observed by the traces collected from this vantage point. A trace which starts probing
+ * at some distance of the vantage point then probes backward (towards the vantage point) stops as
+ * soon as it gets an interface at a TTL that is already in this set, because the remaining hops
+ * (i.e., the route from the vantage point to that interface) are most likely the same as in the
+ * trace that first observed this pair.
+ *
+ * To be able to fill these remaining hops, the set keeps a copy of the routes which brought new
+ * pairs to it, and each pair points to the route which first observed it. Routes which bring no
+ * new pair are not kept. The structure is shared by all traceroute threads, hence the mutex.
+ */
+
+#ifndef LOCALSTOPSET_H_
+#define LOCALSTOPSET_H_
+
+#include <inttypes.h>
+#include <list>
+using std::list;
+#include <vector>
+using std::vector;
+#include <map>
+using std::map;
+
+#include "../../common/inet/InetAddress.h"
+#include "../../common/thread/Mutex.h"
+
+class LocalStopSet
+{
+public:
+
+    // Constructor, destructor
+    LocalStopSet();
+    ~LocalStopSet();
+
+    /*
+     * Records the (interface, TTL) pairs of a route (first hop being at TTL 1) along with the
+     * reply TTLs of each hop (needed to infer initial TTLs when the route is used to fill another
+     * one). Anonymous hops are not recorded.
+     */
+
+    void record(list<InetAddress> &routeHops, list<unsigned char> &replyTTLs);
+
+    /*
+     * Returns true if the pair (interface, TTL) is in the set. In that case, the hops at TTL 1 to
+     * TTL - 1 of the route which first observed this pair (and their reply TTLs) are appended to
+     * the given lists.
+     */
+
+    bool lookUp(InetAddress interface,
+                unsigned char TTL,
+                list<InetAddress> &prefixHops,
+                list<unsigned char> &prefixReplyTTLs);
+
+    inline unsigned int getNbPairs() { return (unsigned int) pairs.size(); }
+
+private:
+
+    // A route kept to fill the traces which stop on one of its pairs
+    struct KnownRoute
+    {
+        vector<InetAddress> hops;
+        vector<unsigned char> replyTTLs;
+    };
+
+    // Key of a pair: interface (as an integer) and TTL
+    static inline uint64_t pairKey(InetAddress &interface, unsigned char TTL)
+    {
+        return ((uint64_t) interface.getULongAddress() << 8) | (uint64_t) TTL;
+    }
+
+    map<uint64_t, unsigned int> pairs; // Pair -> index of the route in "routes"
+    vector<KnownRoute*> routes;
+    Mutex setMutex;
+};
+
+#endif /* LOCALSTOPSET_H_ */
@@ -0,0 +1,201 @@
+/*
+ * PreviousCampaign.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in PreviousCampaign.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <cstdlib>
+#include <sstream>
+#include <fstream>
+
+#include "PreviousCampaign.h"
+#include "../../common/inet/InetAddressException.h"
+
+PreviousCampaign::PreviousCampaign()
+{
+}
+
+PreviousCampaign::~PreviousCampaign()
+{
+    for(map<unsigned long, PreviousRoute*>::iterator it = routes.begin(); it != routes.end(); ++it)
+        delete it->second;
+    routes.clear();
+    distances.clear();
+}
+
+bool PreviousCampaign::load(string label)
+{
+    std::ifstream tracesFile;
+    tracesFile.open((label + ".traces").c_str());
+    if(!tracesFile.is_open())
+        return false;
+
+    string content = "";
+    content.assign((std::istreambuf_iterator<char>(tracesFile)), (std::istreambuf_iterator<char>()));
+    tracesFile.close();
+    parseTraces(content);
+
+    std::ifstream IPFile;
+    IPFile.open((label + ".ip").c_str());
+    if(IPFile.is_open())
+    {
+        content.assign((std::istreambuf_iterator<char>(IPFile)), (std::istreambuf_iterator<char>()));
+        IPFile.close();
+        parseDictionnary(content);
+    }
+
+    hitlist.load(label);
+    return true;
+}
+
+PreviousCampaign::PreviousRoute *PreviousCampaign::getRoute(InetAddress target)
+{
+    map<unsigned long, PreviousRoute*>::iterator it = routes.find(target.getULongAddress());
+    if(it == routes.end())
+        return NULL;
+    return it->second;
+}
+
+unsigned char PreviousCampaign::getDistance(InetAddress target)
+{
+    map<unsigned long, unsigned char>::iterator it = distances.find(target.getULongAddress());
+    if(it != distances.end())
+        return it->second;
+
+    // Reachable target which was not in the dictionnary
+    PreviousRoute *route = this->getRoute(target);
+    if(route != NULL && route->reachable)
+        return (unsigned char) (route->hops.size() + 1);
+    return 0;
+}
+
+TimeVal PreviousCampaign::getTimeout(InetAddress target)
+{
+    return hitlist.getTimeout(target);
+}
+
+void PreviousCampaign::parseTraces(string &content)
+{
+    /*
+     * Format (see Trace::toStringMeasured()):
+     * #
+     * Target: [IP] (+ " (opinion n°[X])" for bis traces)
+     * Unreachable | TTL: [distance]
+     * [TTL] - [IP | Anonymous | Skipped] (+ optional tag, e.g. " [Repaired-1]")
+     */
+
+    std::stringstream ss(content);
+    string line;
+    PreviousRoute *current = NULL;
+    while(std::getline(ss, line))
+    {
+        if(line.size() == 0)
+            continue;
+
+        if(line[0] == '#')
+        {
+            current = NULL;
+            continue;
+        }
+
+        if(line.compare(0, 8, "Target: ") == 0)
+        {
+            // Bis traces are ignored
+            if(line.find("(opinion") != string::npos)
+                continue;
+
+            string targetStr = line.substr(8);
+            size_t end = targetStr.find(' ');
+            if(end != string::npos)
+                targetStr = targetStr.substr(0, end);
+
+            try
+            {
+                InetAddress target(targetStr);
+                current = new PreviousRoute();
+                current->reachable = false;
+                map<unsigned long, PreviousRoute*>::iterator it = routes.find(target.getULongAddress());
+                if(it != routes.end())
+                {
+                    delete it->second;
+                    it->second = current;
+                }
+                else
+                {
+                    routes.insert(std::pair<unsigned long, PreviousRoute*>(target.getULongAddress(), current));
+                }
+            }
+            catch(InetAddressException &e)
+            {
+                current = NULL;
+            }
+            continue;
+        }
+
+        if(current == NULL)
+            continue;
+
+        if(line.compare(0, 5, "TTL: ") == 0)
+        {
+            current->reachable = true;
+            continue;
+        }
+
+        size_t separator = line.find(" - ");
+        if(separator == string::npos)
+            continue;
+
+        string hopStr = line.substr(separator + 3);
+        size_t end = hopStr.find(' ');
+        if(end != string::npos)
+            hopStr = hopStr.substr(0, end);
+
+        InetAddress hop(0);
+        if(hopStr != "Anonymous" && hopStr != "Skipped")
+        {
+            try
+            {
+                hop.setInetAddress(hopStr);
+            }
+            catch(InetAddressException &e)
+            {
+                hop = InetAddress(0);
+            }
+        }
+        current->hops.push_back(hop);
+    }
+}
+
+void PreviousCampaign::parseDictionnary(string &content)
+{
+    // Format (see IPTableEntry::toString()): [IP] - [TTL] - <[iTTLs]> (+ other details)
+    std::stringstream ss(content);
+    string line;
+    while(std::getline(ss, line))
+    {
+        size_t first = line.find(" - ");
+        if(first == string::npos)
+            continue;
+        size_t second = line.find(" - ", first + 3);
+        if(second == string::npos)
+            continue;
+
+        int TTL = std::atoi(line.substr(first + 3, second - first - 3).c_str());
+        if(TTL <= 0 || TTL >= 255)
+            continue;
+
+        try
+        {
+            InetAddress IP(line.substr(0, first));
+            distances[IP.getULongAddress()] = (unsigned char) TTL;
+        }
+        catch(InetAddressException &e)
+        {
+            continue;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * PreviousCampaign.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * PreviousCampaign holds what a previous run of RTrack (typically, the day before, towards the
+ * same targets) learnt about the targets, as found in its output files:
+ * -the measured routes (.traces file; bis traces are ignored), i.e., the hops expected at each
+ *  TTL for each target,
+ * -the distance of each IP (.ip file), which gives the distance of the targets that replied,
+ * -the timeout of each responsive target (.hitlist.bin or .hitlist file, see Hitlist), if the
+ *  previous campaign exported its hitlist.
+ *
+ * It is used for a "warm start" of the traceroute phase: a route is first checked with a probe at
+ * its last hop and, if the target was reached, another at its distance; if both match, the other
+ * hops are copied (see ParisTracerouteTask). Otherwise, the route is probed as usual, the expected
+ * hops only saving the retry of the hops which were already anonymous, until a hop differs. The
+ * distance of a target can also be used as start TTL with Doubletree, and its timeout as preferred
+ * timeout. The structure is read-only once loaded, so it can be used by all threads without a
+ * mutex.
+ */
+
+#ifndef PREVIOUSCAMPAIGN_H_
+#define PREVIOUSCAMPAIGN_H_
+
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+#include <map>
+using std::map;
+
+#include "../../common/inet/InetAddress.h"
+#include "Hitlist.h"
+
+class PreviousCampaign
+{
+public:
+
+    // Route towards a target in the previous campaign (0.0.0.0 for anonymous hops)
+    struct PreviousRoute
+    {
+        vector<InetAddress> hops;
+        bool reachable;
+    };
+
+    // Constructor, destructor
+    PreviousCampaign();
+    ~PreviousCampaign();
+
+    /*
+     * Loads [label].traces, [label].ip and [label].hitlist(.bin). Returns false if the .traces
+     * file could not be read (the other files are optional).
+     */
+
+    bool load(string label);
+
+    // Look-up methods (NULL or 0 if nothing is known)
+    PreviousRoute *getRoute(InetAddress target);
+    unsigned char getDistance(InetAddress target);
+    TimeVal getTimeout(InetAddress target);
+
+    inline unsigned int getNbRoutes() { return (unsigned int) routes.size(); }
+    inline unsigned int getNbDistances() { return (unsigned int) distances.size(); }
+    inline unsigned int getNbTimeouts() { return hitlist.getNbTargets(); }
+
+private:
+
+    map<unsigned long, PreviousRoute*> routes;
+    map<unsigned long, unsigned char> distances;
+    Hitlist hitlist;
+
+    void parseTraces(string &content);
+    void parseDictionnary(string &content);
+};
+
+#endif /* PREVIOUSCAMPAIGN_H_ */
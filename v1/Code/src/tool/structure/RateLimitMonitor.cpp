@@ -0,0 +1,112 @@
+/*
+ * RateLimitMonitor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in RateLimitMonitor.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include "RateLimitMonitor.h"
+
+RateLimitMonitor::RateLimitMonitor():
+monitorMutex(Mutex::ERROR_CHECKING_MUTEX)
+{
+    nbThrottlings = 0;
+    nbDeferredProbes = 0;
+}
+
+RateLimitMonitor::~RateLimitMonitor()
+{
+    successors.clear();
+    pairs.clear();
+}
+
+TimeVal RateLimitMonitor::reserve(InetAddress previousHop, unsigned char TTL)
+{
+    TimeVal wait(0, 0);
+    if(previousHop == InetAddress(0))
+        return wait;
+
+    monitorMutex.lock();
+    map<uint64_t, InetAddress>::iterator expected = successors.find(pairKey(previousHop, TTL));
+    if(expected != successors.end())
+    {
+        map<uint64_t, PairState>::iterator pair = pairs.find(pairKey(expected->second, TTL));
+        if(pair != pairs.end() && pair->second.spacing.isPositive())
+        {
+            PairState &state = pair->second;
+            TimeVal now = *(TimeVal::getCurrentSystemTime());
+            TimeVal slot = now;
+            if(state.nextSlot > now)
+            {
+                slot = state.nextSlot;
+                wait = slot - now;
+                nbDeferredProbes++;
+            }
+            state.nextSlot = slot + state.spacing;
+        }
+    }
+    monitorMutex.unlock();
+    return wait;
+}
+
+void RateLimitMonitor::record(InetAddress previousHop, unsigned char TTL, InetAddress rplyAddress)
+{
+    if(previousHop == InetAddress(0))
+        return;
+
+    monitorMutex.lock();
+    uint64_t successorKey = pairKey(previousHop, TTL);
+    if(rplyAddress != InetAddress(0))
+    {
+        successors[successorKey] = rplyAddress;
+        this->push(pairs[pairKey(rplyAddress, TTL)], true);
+    }
+    else
+    {
+        // The timeout is charged to the hop which followed the previous hop the last time
+        map<uint64_t, InetAddress>::iterator expected = successors.find(successorKey);
+        if(expected != successors.end())
+            this->push(pairs[pairKey(expected->second, TTL)], false);
+    }
+    monitorMutex.unlock();
+}
+
+void RateLimitMonitor::push(PairState &state, bool replied)
+{
+    state.outcomes = (state.outcomes << 1) | (replied ? 1 : 0);
+    if(state.nbOutcomes < WINDOW)
+        state.nbOutcomes++;
+    if(state.nbOutcomes < MIN_OUTCOMES)
+        return;
+
+    unsigned short nbReplies = 0;
+    for(unsigned short i = 0; i < state.nbOutcomes; i++)
+        if((state.outcomes >> i) & 1)
+            nbReplies++;
+    unsigned short percentage = (unsigned short) ((nbReplies * 100) / state.nbOutcomes);
+
+    if(percentage < COLLAPSE_PERCENTAGE)
+    {
+        TimeVal base(0, BASE_SPACING), max(0, MAX_SPACING);
+        if(!state.spacing.isPositive())
+            state.spacing = base;
+        else if(state.spacing * 2 < max)
+            state.spacing = state.spacing * 2;
+        else
+            state.spacing = max;
+        nbThrottlings++;
+
+        // The next decision is taken on the outcomes obtained with the new spacing
+        state.outcomes = 0;
+        state.nbOutcomes = 0;
+    }
+    else if(state.spacing.isPositive() && percentage >= RECOVERY_PERCENTAGE)
+    {
+        state.spacing.resetToZero();
+        state.outcomes = 0;
+        state.nbOutcomes = 0;
+    }
+}
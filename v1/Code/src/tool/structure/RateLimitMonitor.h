@@ -0,0 +1,86 @@
+/*
+ * RateLimitMonitor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * RateLimitMonitor follows, while the traceroute runs, the ratio of probes answered with a "Time
+ * exceeded" message for each (interface, TTL) pair, in order to slow down the probing of the
+ * routers which start rate-limiting ICMP (see RouteRepairer and RoundScheduler, which deal with
+ * the consequences after the traceroute, with long pauses). The expected hop of a probe is
+ * predicted from the previous hop of the trace: the monitor learns which interface follows each
+ * (previous hop, TTL) pair, so that a timeout can be charged to the interface which should have
+ * replied.
+ *
+ * When the ratio of a pair gets below COLLAPSE_PERCENTAGE (over at least MIN_OUTCOMES outcomes),
+ * the probes expected to hit it are spaced by a delay which starts at BASE_SPACING and doubles at
+ * each new collapse (up to MAX_SPACING), the traces waiting for their turn. The spacing is removed
+ * once the ratio gets back above RECOVERY_PERCENTAGE. Hops which are anonymous because of rate-
+ * limiting are therefore less frequent in the first place.
+ */
+
+#ifndef RATELIMITMONITOR_H_
+#define RATELIMITMONITOR_H_
+
+#include <inttypes.h>
+#include <map>
+using std::map;
+
+#include "../../common/inet/InetAddress.h"
+#include "../../common/date/TimeVal.h"
+#include "../../common/thread/Mutex.h"
+
+class RateLimitMonitor
+{
+public:
+
+    static const unsigned short WINDOW = 16; // Last outcomes kept per (interface, TTL) pair
+    static const unsigned short MIN_OUTCOMES = 8;
+    static const unsigned short COLLAPSE_PERCENTAGE = 50;
+    static const unsigned short RECOVERY_PERCENTAGE = 90;
+    static const long BASE_SPACING = 100000; // In microseconds
+    static const long MAX_SPACING = 2000000; // Idem
+
+    // Constructor, destructor
+    RateLimitMonitor();
+    ~RateLimitMonitor();
+
+    /*
+     * Returns the time to wait before probing at this TTL after the given previous hop (zero if
+     * the expected hop is not throttled or unknown) and reserves the corresponding slot.
+     */
+
+    TimeVal reserve(InetAddress previousHop, unsigned char TTL);
+
+    // Records the outcome of a probe (the reply address is 0.0.0.0 for a timeout)
+    void record(InetAddress previousHop, unsigned char TTL, InetAddress rplyAddress);
+
+    inline unsigned int getNbThrottlings() { return this->nbThrottlings; }
+    inline unsigned int getNbDeferredProbes() { return this->nbDeferredProbes; }
+
+private:
+
+    // Outcomes of the probes expected to hit an (interface, TTL) pair and current spacing
+    struct PairState
+    {
+        uint32_t outcomes; // Bit i = 1 if the i-th last probe got a reply
+        unsigned short nbOutcomes;
+        TimeVal spacing, nextSlot;
+
+        PairState(): outcomes(0), nbOutcomes(0), spacing(0, 0), nextSlot(0, 0) {}
+    };
+
+    static inline uint64_t pairKey(InetAddress &interface, unsigned char TTL)
+    {
+        return ((uint64_t) interface.getULongAddress() << 8) | (uint64_t) TTL;
+    }
+
+    map<uint64_t, InetAddress> successors; // (previous hop, TTL) -> expected hop
+    map<uint64_t, PairState> pairs;
+    unsigned int nbThrottlings, nbDeferredProbes;
+    Mutex monitorMutex;
+
+    void push(PairState &state, bool replied); // Mutex must be locked
+};
+
+#endif /* RATELIMITMONITOR_H_ */
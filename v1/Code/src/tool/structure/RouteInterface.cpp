@@ -81,6 +81,12 @@ void RouteInterface::predict(InetAddress ip)
     this->state = PREDICTED;
 }
 
+void RouteInterface::infer(InetAddress ip)
+{
+    this->ip = ip;
+    this->state = INFERRED;
+}
+
 RouteInterface &RouteInterface::operator=(const RouteInterface &other)
 {
     this->ip = other.ip;
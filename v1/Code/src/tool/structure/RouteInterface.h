@@ -35,7 +35,8 @@ public:
         VIA_TRACEROUTE, // Obtained through traceroute
         PREDICTED, // Predicted after using a grafting process
         STRETCHED, // This IP turned out to have been reachable with less hops
-        CYCLE // This IP is a duplicate in the route
+        CYCLE, // This IP is a duplicate in the route
+        INFERRED // Not probed, copied from another route through the global stop set
     };
 
     RouteInterface(); // Creates a "NOT_MEASURED" interface
@@ -50,6 +51,7 @@ public:
     void repairBis(InetAddress ip); // Always sets state to "REPAIRED_2"
     void deanonymize(InetAddress ip); // Always sets state to "LIMITED"
     void predict(InetAddress ip); // Always sets state to "PREDICTED"
+    void infer(InetAddress ip); // Always sets state to "INFERRED"
     
     // Overriden equality operator
     RouteInterface &operator=(const RouteInterface &other);
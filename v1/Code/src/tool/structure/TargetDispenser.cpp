@@ -0,0 +1,99 @@
+/*
+ * TargetDispenser.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in TargetDispenser.h (see this file to learn further about the 
+ * goals of such class).
+ */
+
+#include "TargetDispenser.h"
+
+TargetDispenser::TargetDispenser(list<InetAddress> &targets, unsigned short nbThreads):
+cursorMutex(Mutex::ERROR_CHECKING_MUTEX)
+{
+    this->targets.assign(targets.begin(), targets.end());
+    this->generator = NULL;
+    if(nbThreads == 0)
+        nbThreads = 1;
+    this->nbThreads = nbThreads;
+    this->cursor = 0;
+    this->nbChunks = 0;
+    this->nbProbed = 0;
+    this->nbTimeouts = 0;
+}
+
+TargetDispenser::TargetDispenser(TargetGenerator *generator, unsigned short nbThreads):
+cursorMutex(Mutex::ERROR_CHECKING_MUTEX)
+{
+    this->generator = generator;
+    if(nbThreads == 0)
+        nbThreads = 1;
+    this->nbThreads = nbThreads;
+    this->cursor = 0;
+    this->nbChunks = 0;
+    this->nbProbed = 0;
+    this->nbTimeouts = 0;
+}
+
+TargetDispenser::~TargetDispenser()
+{
+}
+
+bool TargetDispenser::nextChunk(list<InetAddress> &chunk)
+{
+    chunk.clear();
+    cursorMutex.lock();
+    size_t remaining = targets.size() - cursor;
+    if(generator != NULL)
+        remaining = (size_t) generator->getNbRemaining();
+    if(remaining == 0)
+    {
+        cursorMutex.unlock();
+        return false;
+    }
+    
+    // Guided self-scheduling, reduced by the ratio of timeouts (up to a tenth of the size)
+    size_t chunkSize = remaining / (2 * (size_t) nbThreads);
+    if(nbProbed > 0)
+    {
+        unsigned long timeoutPercentage = (nbTimeouts * 100) / nbProbed;
+        chunkSize = (chunkSize * (100 - (timeoutPercentage * 9) / 10)) / 100;
+    }
+    if(chunkSize < (size_t) MIN_CHUNK_SIZE)
+        chunkSize = (size_t) MIN_CHUNK_SIZE;
+    else if(chunkSize > (size_t) MAX_CHUNK_SIZE)
+        chunkSize = (size_t) MAX_CHUNK_SIZE;
+    if(chunkSize > remaining)
+        chunkSize = remaining;
+    
+    if(generator != NULL)
+    {
+        InetAddress target;
+        while(chunk.size() < chunkSize && generator->next(&target))
+            chunk.push_back(target);
+    }
+    else
+    {
+        chunk.insert(chunk.end(), targets.begin() + cursor, targets.begin() + cursor + chunkSize);
+        cursor += chunkSize;
+    }
+    
+    if(chunk.size() == 0)
+    {
+        cursorMutex.unlock();
+        return false;
+    }
+    nbChunks++;
+    cursorMutex.unlock();
+    return true;
+}
+
+void TargetDispenser::recordOutcomes(unsigned int nbProbed, unsigned int nbTimeouts)
+{
+    cursorMutex.lock();
+    this->nbProbed += nbProbed;
+    this->nbTimeouts += nbTimeouts;
+    cursorMutex.unlock();
+}
@@ -0,0 +1,68 @@
+/*
+ * TargetDispenser.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * TargetDispenser distributes the targets of a phase (pre-scanning, fingerprinting) among its 
+ * threads in small chunks, each thread taking a new chunk from a shared cursor once it is done 
+ * with the previous one, instead of receiving a fixed share of the targets before starting. A 
+ * thread which gets many unresponsive targets (each of them costing a full timeout) therefore 
+ * takes fewer chunks, and the phase ends shortly after the last chunk is taken rather than when 
+ * the slowest share is done.
+ *
+ * The size of a chunk follows guided self-scheduling (the remaining targets divided by twice the 
+ * amount of threads, so chunks shrink as the phase ends) and is reduced further with the ratio 
+ * of timeouts reported by the threads so far, since the cost of a chunk grows with this ratio. It 
+ * stays between MIN_CHUNK_SIZE and MAX_CHUNK_SIZE.
+ *
+ * The targets are either copied from a list, or drawn from a TargetGenerator as the chunks are
+ * taken, so that the pre-scanning never lists its targets. In the latter case, the amount of
+ * remaining targets is an upper bound given by the generator (it cannot know in advance how many
+ * IPs it will skip), which only makes the first chunks larger.
+ */
+
+#ifndef TARGETDISPENSER_H_
+#define TARGETDISPENSER_H_
+
+#include <list>
+using std::list;
+#include <vector>
+using std::vector;
+
+#include "../../common/inet/InetAddress.h"
+#include "../../common/thread/Mutex.h"
+#include "../utils/TargetGenerator.h"
+
+class TargetDispenser
+{
+public:
+
+    static const unsigned int MIN_CHUNK_SIZE = 1;
+    static const unsigned int MAX_CHUNK_SIZE = 64;
+
+    // Constructors (the targets are copied in an array, or drawn from the generator), destructor
+    TargetDispenser(list<InetAddress> &targets, unsigned short nbThreads);
+    TargetDispenser(TargetGenerator *generator, unsigned short nbThreads);
+    ~TargetDispenser();
+
+    // Replaces the content of "chunk" with the next chunk; returns false once all were given
+    bool nextChunk(list<InetAddress> &chunk);
+
+    // Reports the outcome of a chunk (probed targets and timeouts among them)
+    void recordOutcomes(unsigned int nbProbed, unsigned int nbTimeouts);
+
+    inline unsigned int getNbChunks() { return this->nbChunks; }
+
+private:
+
+    vector<InetAddress> targets;
+    TargetGenerator *generator; // NULL if the targets were given as a list (not owned)
+    unsigned short nbThreads;
+    size_t cursor;
+    unsigned int nbChunks;
+    unsigned long nbProbed, nbTimeouts;
+    Mutex cursorMutex;
+};
+
+#endif /* TARGETDISPENSER_H_ */
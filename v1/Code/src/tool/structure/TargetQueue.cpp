@@ -0,0 +1,87 @@
+/*
+ * TargetQueue.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in TargetQueue.h (see this file to learn further about the goals
+ * of such class).
+ */
+
+#include "TargetQueue.h"
+
+TargetQueue::TargetQueue(unsigned int capacity):
+queueMutex(Mutex::ERROR_CHECKING_MUTEX),
+notFull(&queueMutex),
+notEmpty(&queueMutex)
+{
+    if(capacity == 0)
+        capacity = 1;
+    this->capacity = capacity;
+    this->closed = false;
+    this->nbPushed = 0;
+    this->nbFullQueueWaits = 0;
+}
+
+TargetQueue::~TargetQueue()
+{
+    targets.clear();
+}
+
+bool TargetQueue::push(InetAddress target)
+{
+    queueMutex.lock();
+    if(!closed && targets.size() >= (size_t) capacity)
+        nbFullQueueWaits++;
+    while(!closed && targets.size() >= (size_t) capacity)
+        notFull.wait();
+
+    if(closed)
+    {
+        queueMutex.unlock();
+        return false;
+    }
+
+    targets.push_back(target);
+    nbPushed++;
+    notEmpty.signal();
+    queueMutex.unlock();
+    return true;
+}
+
+bool TargetQueue::pop(InetAddress *target)
+{
+    queueMutex.lock();
+    while(!closed && targets.size() == 0)
+        notEmpty.wait();
+
+    if(targets.size() == 0)
+    {
+        queueMutex.unlock();
+        return false;
+    }
+
+    *target = targets.front();
+    targets.pop_front();
+    notFull.signal();
+    queueMutex.unlock();
+    return true;
+}
+
+void TargetQueue::close()
+{
+    queueMutex.lock();
+    closed = true;
+    notFull.broadcast();
+    notEmpty.broadcast();
+    queueMutex.unlock();
+}
+
+bool TargetQueue::isClosed()
+{
+    bool res = false;
+    queueMutex.lock();
+    res = closed;
+    queueMutex.unlock();
+    return res;
+}
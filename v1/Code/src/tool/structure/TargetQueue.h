@@ -0,0 +1,64 @@
+/*
+ * TargetQueue.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * TargetQueue is a bounded queue of targets shared by a producer (the pre-scanning, which pushes
+ * the targets as soon as they are found responsive) and consumers (the traceroute workers), so
+ * that both phases overlap instead of running one after the other. A producer which finds the
+ * queue full waits until a consumer takes a target (back-pressure), therefore the amount of
+ * targets waiting in memory never exceeds the capacity of the queue. A consumer which finds the
+ * queue empty waits until a new target is pushed or until the queue is closed.
+ *
+ * The queue is closed by the producer once it has no more targets to give, and by the consumers
+ * once they stopped (e.g. emergency stop) so that a waiting producer is not stuck forever; the
+ * targets pushed after the closure are discarded.
+ */
+
+#ifndef TARGETQUEUE_H_
+#define TARGETQUEUE_H_
+
+#include <list>
+using std::list;
+
+#include "../../common/inet/InetAddress.h"
+#include "../../common/thread/Mutex.h"
+#include "../../common/thread/ConditionVariable.h"
+
+class TargetQueue
+{
+public:
+
+    // Constructor (capacity is the maximum amount of waiting targets), destructor
+    TargetQueue(unsigned int capacity);
+    ~TargetQueue();
+
+    inline unsigned int getCapacity() { return this->capacity; }
+
+    // Adds a target, waiting while the queue is full; returns false if the queue is closed
+    bool push(InetAddress target);
+
+    // Writes the next target, waiting while the queue is empty; returns false once closed and empty
+    bool pop(InetAddress *target);
+
+    // Closes the queue and wakes up every waiting thread
+    void close();
+    bool isClosed();
+
+    inline unsigned int getNbPushedTargets() { return this->nbPushed; }
+    inline unsigned int getNbFullQueueWaits() { return this->nbFullQueueWaits; }
+
+private:
+
+    unsigned int capacity;
+    list<InetAddress> targets;
+    bool closed;
+    unsigned int nbPushed, nbFullQueueWaits;
+
+    // Both conditions share the mutex protecting the queue
+    Mutex queueMutex;
+    ConditionVariable notFull, notEmpty;
+};
+
+#endif /* TARGETQUEUE_H_ */
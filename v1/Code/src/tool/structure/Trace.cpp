@@ -96,11 +96,15 @@ string Trace::toStringMeasured()
                 ss << " [Stretched]";
             else if(curState == RouteInterface::CYCLE)
                 ss << " [Cycle]";
+            else if(curState == RouteInterface::INFERRED)
+                ss << " [Inferred]";
         }
         else
         {
             if(curState == RouteInterface::ANONYMOUS || curState == RouteInterface::MISSING)
                 ss << "Anonymous";
+            else if(curState == RouteInterface::INFERRED)
+                ss << "Anonymous [Inferred]";
             else
                 ss << "Skipped";
         }
@@ -0,0 +1,58 @@
+/*
+ * UnreachablePrefixCache.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in UnreachablePrefixCache.h (see this file to learn further about
+ * the goals of such class).
+ */
+
+#include "UnreachablePrefixCache.h"
+
+UnreachablePrefixCache::UnreachablePrefixCache(unsigned short budget):
+cacheMutex(Mutex::ERROR_CHECKING_MUTEX)
+{
+    this->budget = budget;
+    this->nbShortenedTraces = 0;
+}
+
+UnreachablePrefixCache::~UnreachablePrefixCache()
+{
+    lastHops.clear();
+}
+
+bool UnreachablePrefixCache::isLastHop(InetAddress target, InetAddress hop, unsigned char TTL)
+{
+    if(hop == InetAddress(0))
+        return false;
+
+    bool found = false;
+    cacheMutex.lock();
+    map<uint32_t, LastHop>::iterator it = lastHops.find((uint32_t) (target.getULongAddress() >> 8));
+    if(it != lastHops.end())
+        found = (it->second.hop == hop && it->second.TTL == TTL);
+    cacheMutex.unlock();
+    return found;
+}
+
+void UnreachablePrefixCache::record(InetAddress target, InetAddress lastHop, unsigned char TTL)
+{
+    if(lastHop == InetAddress(0))
+        return;
+
+    LastHop newLastHop;
+    newLastHop.hop = lastHop;
+    newLastHop.TTL = TTL;
+
+    cacheMutex.lock();
+    lastHops[(uint32_t) (target.getULongAddress() >> 8)] = newLastHop;
+    cacheMutex.unlock();
+}
+
+void UnreachablePrefixCache::countShortenedTrace()
+{
+    cacheMutex.lock();
+    nbShortenedTraces++;
+    cacheMutex.unlock();
+}
@@ -0,0 +1,67 @@
+/*
+ * UnreachablePrefixCache.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * UnreachablePrefixCache remembers, for each destination prefix (the /24 of the target), the last
+ * hop which replied on the route towards a target that could not be reached, i.e., the last hop
+ * before the silence which stopped the trace (more consecutive anonymous hops than allowed).
+ * Unreachable targets are usually clustered in the same prefixes (dark address space), and the
+ * traces towards them spend most of their time waiting for the timeouts of the anonymous hops
+ * which end them, each anonymous hop being probed a second time with twice the timeout.
+ *
+ * A trace towards another target of the same prefix which gets the same last hop at the same
+ * TTL then only has a reduced budget of consecutive anonymous hops (0 means a single confirmation
+ * probe beyond the known last hop). If a hop replies in the meantime, the trace goes on with the
+ * usual budget, and the cache is updated by the traces which still end in silence.
+ */
+
+#ifndef UNREACHABLEPREFIXCACHE_H_
+#define UNREACHABLEPREFIXCACHE_H_
+
+#include <inttypes.h>
+#include <map>
+using std::map;
+
+#include "../../common/inet/InetAddress.h"
+#include "../../common/thread/Mutex.h"
+
+class UnreachablePrefixCache
+{
+public:
+
+    // Constructor (budget of consecutive anonymous hops after a known last hop), destructor
+    UnreachablePrefixCache(unsigned short budget);
+    ~UnreachablePrefixCache();
+
+    inline unsigned short getBudget() { return this->budget; }
+
+    // Returns true if the hop at this TTL is the known last hop for the prefix of the target
+    bool isLastHop(InetAddress target, InetAddress hop, unsigned char TTL);
+
+    // Records the last hop which replied on the route towards a target that was not reached
+    void record(InetAddress target, InetAddress lastHop, unsigned char TTL);
+
+    // Counts the traces which were stopped with the reduced budget
+    void countShortenedTrace();
+    inline unsigned int getNbShortenedTraces() { return this->nbShortenedTraces; }
+    inline unsigned int getNbPrefixes() { return (unsigned int) this->lastHops.size(); }
+
+private:
+
+    struct LastHop
+    {
+        InetAddress hop;
+        unsigned char TTL;
+
+        LastHop(): hop(0), TTL(0) {}
+    };
+
+    unsigned short budget;
+    map<uint32_t, LastHop> lastHops; // Key is the /24 of the target
+    unsigned int nbShortenedTraces;
+    Mutex cacheMutex;
+};
+
+#endif /* UNREACHABLEPREFIXCACHE_H_ */
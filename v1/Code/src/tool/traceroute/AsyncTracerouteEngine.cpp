@@ -0,0 +1,766 @@
+/*
+ * AsyncTracerouteEngine.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in AsyncTracerouteEngine.h (see this file to learn further about
+ * the goals of such class).
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/tcp.h>
+
+#include "AsyncTracerouteEngine.h"
+#include "ParisTracerouteTask.h"
+#include "../../prober/pipeline/ProbePipeline.h"
+
+AsyncTracerouteEngine::AsyncTracerouteEngine(ToolEnvironment *env,
+                                             unsigned int maxTargets,
+                                             unsigned short window) throw(SocketException)
+{
+    this->env = env;
+    this->protocol = env->getProbingProtocol();
+    this->maxTargets = maxTargets > 0 ? maxTargets : 1;
+    this->window = window;
+    if(this->window < 1)
+        this->window = 1;
+    else if(this->window > MAX_TTL)
+        this->window = MAX_TTL;
+    localAddress = htonl((uint32_t) env->getLocalIPAddress().getULongAddress());
+
+    // Same flow identifiers as a prober (with fixed flow) would use
+    unsigned short range = DirectProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID - DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID;
+    ICMPidentifier = DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + (rand() % range);
+    srcPort = DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + (rand() % range);
+    dstPort = DirectProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ;
+    dstPort += (DirectProber::DEFAULT_UPPER_DST_PORT_ICMP_SEQ - DirectProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ) / 2;
+
+    // Overall probing rate of the thread pool (one probe per regulating period per thread)
+    sendInterval = env->getProbeRegulatingPeriod() / (float) env->getMaxThreads();
+    
+    // Global stop set, except for bis traces (as in ParisTracerouteTask)
+    globalStopSet = env->getGlobalStopSet();
+    if(env->collectingBisTraces())
+        globalStopSet = NULL;
+
+    nbProbes = 0;
+    nbSuccessfulProbes = 0;
+    ICMPSocket = -1;
+    TCPSocket = -1;
+
+    int IPProtocol = IPPROTO_ICMP;
+    if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
+        IPProtocol = IPPROTO_UDP;
+    else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+        IPProtocol = IPPROTO_TCP;
+
+    if((sendSocket = socket(PF_INET, SOCK_RAW, IPProtocol)) == -1)
+        throw SocketException("Can NOT create sending socket.");
+
+    const int on = 1;
+    if(setsockopt(sendSocket, IPPROTO_IP, IP_HDRINCL, &on, sizeof(on)) < 0)
+    {
+        close(sendSocket);
+        throw SocketException("Can NOT set sending socket IP_HDRINCL");
+    }
+
+    const int receiveBufferSize = RECEIVE_BUFFER_SIZE;
+    if((ICMPSocket = socket(PF_INET, SOCK_RAW, IPPROTO_ICMP)) == -1 ||
+       fcntl(ICMPSocket, F_SETFL, O_NONBLOCK) == -1)
+    {
+        if(ICMPSocket != -1)
+            close(ICMPSocket);
+        close(sendSocket);
+        throw SocketException("Can NOT create receiving ICMP raw socket.");
+    }
+    setsockopt(ICMPSocket, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+
+    if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+    {
+        if((TCPSocket = socket(PF_INET, SOCK_RAW, IPPROTO_TCP)) == -1 ||
+           fcntl(TCPSocket, F_SETFL, O_NONBLOCK) == -1)
+        {
+            if(TCPSocket != -1)
+                close(TCPSocket);
+            close(ICMPSocket);
+            close(sendSocket);
+            throw SocketException("Can NOT create receiving TCP raw socket.");
+        }
+        setsockopt(TCPSocket, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+    }
+}
+
+AsyncTracerouteEngine::~AsyncTracerouteEngine()
+{
+    if(TCPSocket != -1)
+        close(TCPSocket);
+    close(ICMPSocket);
+    close(sendSocket);
+}
+
+void AsyncTracerouteEngine::trace(list<InetAddress> targets)
+{
+    this->queue = targets;
+    nbProbes = 0;
+    nbSuccessfulProbes = 0;
+    nextSendTime = *(TimeVal::getCurrentSystemTime());
+
+    struct pollfd fds[2];
+    nfds_t nbFds = 1;
+    fds[0].fd = ICMPSocket;
+    fds[0].events = POLLIN;
+    if(TCPSocket != -1)
+    {
+        fds[1].fd = TCPSocket;
+        fds[1].events = POLLIN;
+        nbFds = 2;
+    }
+
+    activateTargets();
+    while((this->targets.size() > 0 || queue.size() > 0) && !env->isStopping())
+    {
+        sendProbes();
+
+        // Waits until a reply arrives, the next deadline or the next probe to send
+        auto_ptr<TimeVal> now = TimeVal::getCurrentSystemTime();
+        int waitPeriod = MAX_POLLING_PERIOD;
+        TimeVal nextEvent = (*now) + TimeVal(0, MAX_POLLING_PERIOD * 1000);
+        if(deadlines.size() > 0 && deadlines.begin()->first < nextEvent)
+            nextEvent = deadlines.begin()->first;
+        if(toSend.size() > 0 && nextSendTime < nextEvent)
+            nextEvent = nextSendTime;
+        if(nextEvent <= (*now))
+        {
+            waitPeriod = 0;
+        }
+        else
+        {
+            TimeVal diff = nextEvent - (*now);
+            waitPeriod = (int) (diff.getSecondsPart() * 1000 + diff.getMicroSecondsPart() / 1000) + 1;
+        }
+
+        int pollResult = poll(fds, nbFds, waitPeriod);
+        if(pollResult < 0 && errno != EINTR)
+        {
+            perror("poll(...)");
+            this->stop();
+            break;
+        }
+        else if(pollResult > 0)
+        {
+            for(nfds_t i = 0; i < nbFds; i++)
+                if(fds[i].revents & POLLIN)
+                    receive(fds[i].fd);
+        }
+
+        handleTimeouts();
+        activateTargets();
+    }
+
+    // Cleans what remains (emergency stop)
+    for(deque<Probe*>::iterator it = toSend.begin(); it != toSend.end(); ++it)
+        if((*it)->target == NULL)
+            delete (*it);
+    toSend.clear();
+    for(map<uint64_t, Probe*>::iterator it = probes.begin(); it != probes.end(); ++it)
+        delete it->second;
+    probes.clear();
+    deadlines.clear();
+    for(map<uint32_t, Target*>::iterator it = this->targets.begin(); it != this->targets.end(); ++it)
+        delete it->second;
+    this->targets.clear();
+    queue.clear();
+
+    env->updateProbeAmounts(nbProbes, nbSuccessfulProbes);
+}
+
+void AsyncTracerouteEngine::activateTargets()
+{
+    IPLookUpTable *table = env->getIPTable();
+    size_t toCheck = queue.size();
+    while(targets.size() < (size_t) maxTargets && toCheck > 0)
+    {
+        InetAddress address = queue.front();
+        queue.pop_front();
+        toCheck--;
+
+        if(address == InetAddress(0))
+            continue;
+
+        // Same target twice in a row: it is traced again once the first trace is complete
+        uint32_t key = htonl((uint32_t) address.getULongAddress());
+        if(targets.find(key) != targets.end())
+        {
+            queue.push_back(address);
+            continue;
+        }
+
+        // Gets target IP in the dictionnary, creates it if missing
+        IPTableEntry *entry = table->lookUp(address);
+        if(entry == NULL)
+        {
+            entry = table->create(address);
+            entry->setPreferredTimeout(env->getTimeoutPeriod());
+        }
+
+        Target *t = new Target();
+        t->entry = entry;
+        t->address = address;
+        t->key = key;
+        t->nonce = (uint8_t) (rand() % 256);
+        t->timeout = env->getTimeoutPeriod();
+        if(entry->getPreferredTimeout() > t->timeout)
+            t->timeout = entry->getPreferredTimeout();
+        t->nextTTLToSend = 1;
+        t->nextTTLToEvaluate = 1;
+        for(unsigned short i = 0; i <= MAX_TTL; i++)
+            t->hops[i].done = false;
+        t->anonymous = 0;
+        t->cycles = 0;
+        t->verification = (globalStopSet != NULL) ? globalStopSet->drawVerification() : false;
+        t->nbInferredHops = 0;
+        t->confirmTTL = 0;
+        t->inferring = true;
+
+        if(env->debugMode())
+        {
+            stringstream ss;
+            ss << "Computing route to " << address << "...\n";
+            t->log += ss.str();
+        }
+
+        // If the distance was estimated at pre-scanning, all TTLs up to it are probed at once
+        unsigned short firstWindow = (unsigned short) entry->getEstimatedTTL();
+        if(firstWindow < window)
+            firstWindow = window;
+        
+        targets.insert(std::pair<uint32_t, Target*>(key, t));
+        while(t->nextTTLToSend <= MAX_TTL && t->nextTTLToSend < t->nextTTLToEvaluate + firstWindow)
+        {
+            schedule(t, t->nextTTLToSend, 0);
+            t->nextTTLToSend++;
+        }
+    }
+}
+
+void AsyncTracerouteEngine::schedule(Target *t, unsigned char TTL, unsigned char attempt)
+{
+    Probe *p = new Probe();
+    p->target = t;
+    p->TTL = TTL;
+    p->attempt = attempt;
+    p->tag = makeTag(t->nonce, attempt, TTL);
+    p->TCPSequence = 0;
+    p->TCPAck = 0;
+    p->sent = false;
+    probes.insert(std::pair<uint64_t, Probe*>(probeKey(t->key, p->tag), p));
+
+    // A retry is sent before the other probes, as ParisTracerouteTask would do
+    if(attempt > 0)
+        toSend.push_front(p);
+    else
+        toSend.push_back(p);
+}
+
+void AsyncTracerouteEngine::sendProbes()
+{
+    auto_ptr<TimeVal> now = TimeVal::getCurrentSystemTime();
+    if(nextSendTime < (*now))
+        nextSendTime = (*now);
+    while(toSend.size() > 0 && nextSendTime <= (*now) && !env->isStopping())
+    {
+        Probe *p = toSend.front();
+        toSend.pop_front();
+
+        // Probe of a trace which has been completed in the meantime
+        if(p->target == NULL)
+        {
+            delete p;
+            continue;
+        }
+
+        send(p);
+        nextSendTime += sendInterval;
+    }
+}
+
+void AsyncTracerouteEngine::send(Probe *p)
+{
+    Target *t = p->target;
+
+    uint8_t randomData[DEFAULT_RANDOM_DATA_BUFFER_LENGH];
+    for(unsigned short i = 0; i < DEFAULT_RANDOM_DATA_BUFFER_LENGH; i++)
+        randomData[i] = (uint8_t) (rand() % 256);
+
+    ProbeContext c;
+    c.src = &(env->getLocalIPAddress());
+    c.dst = &(t->address);
+    c.IPIdentifier = p->tag;
+    c.TTL = p->TTL;
+    c.usingFixedFlowID = true;
+    c.attentionMessage = &(env->getAttentionMessage());
+    c.randomData = randomData;
+    c.timestampRequest = false;
+    c.fixedFlowChecksum = (uint16_t) ((DirectProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ + DirectProber::DEFAULT_UPPER_DST_PORT_ICMP_SEQ) / 2);
+    c.originateTs = 0;
+    c.TCPSequence = 0;
+
+    uint16_t length = 0;
+    if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
+    {
+        c.srcPortICMPid = srcPort;
+        c.dstPortICMPseq = dstPort;
+        length = ProbePipeline<UDPWrappedICMPPolicy>::build(buffer, pseudoBuffer, c);
+    }
+    else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+    {
+        // The tag is also in the upper half of the sequence number, to recognize resets
+        c.srcPortICMPid = srcPort;
+        c.dstPortICMPseq = dstPort;
+        c.TCPSequence = ((uint32_t) p->tag << 16) | (uint32_t) (rand() % 65536);
+        length = ProbePipeline<TCPWrappedICMPPolicy>::build(buffer, pseudoBuffer, c);
+
+        struct tcphdr *tcp = (struct tcphdr*) (buffer + DirectProber::MINIMUM_IP_HEADER_LENGTH);
+        p->TCPSequence = c.TCPSequence;
+        p->TCPAck = ntohl(tcp->ack_seq);
+    }
+    else
+    {
+        // The tag is also the ICMP sequence number, as an echo reply quotes nothing
+        c.srcPortICMPid = ICMPidentifier;
+        c.dstPortICMPseq = p->tag;
+        length = ProbePipeline<ICMPProbePolicy>::build(buffer, pseudoBuffer, c);
+    }
+
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = t->key;
+
+    ssize_t bytesSent = 0;
+    ssize_t totalBytesSent = 0;
+    do
+    {
+        bytesSent = sendto(sendSocket,
+                           buffer + totalBytesSent,
+                           length - totalBytesSent,
+                           0,
+                           (struct sockaddr*) &to,
+                           sizeof(struct sockaddr));
+        if(bytesSent == -1)
+        {
+            perror("Socket Send Exception Error Message");
+            this->stop();
+            return;
+        }
+
+        totalBytesSent += bytesSent;
+    }
+    while(totalBytesSent < length);
+    nbProbes++;
+
+    p->sent = true;
+    TimeVal deadline = *(TimeVal::getCurrentSystemTime());
+    deadline += t->timeout * (float) (p->attempt + 1);
+    p->deadline = deadlines.insert(std::pair<TimeVal, Probe*>(deadline, p));
+}
+
+void AsyncTracerouteEngine::receive(int socket)
+{
+    // Bounded, such that timeouts are still handled on time under heavy load
+    for(unsigned short i = 0; i < 1024; i++)
+    {
+        ssize_t receivedBytes = recvfrom(socket, buffer, BUFFER_SIZE, 0, NULL, NULL);
+        if(receivedBytes <= 0)
+            break;
+        handleReply(receivedBytes);
+    }
+}
+
+void AsyncTracerouteEngine::handleReply(ssize_t length)
+{
+    struct ip *ip = (struct ip*) buffer;
+    if(length < DirectProber::MINIMUM_IP_HEADER_LENGTH || ip->ip_v != DirectProber::DEFAULT_IP_VERSION)
+        return;
+    ssize_t IPHeaderLength = ((ssize_t) ip->ip_hl) * 4;
+
+    // Finds the probe this packet might reply to
+    Probe *p = NULL;
+    if(ip->ip_p == IPPROTO_ICMP)
+    {
+        if(length < IPHeaderLength + DirectProber::DEFAULT_ICMP_HEADER_LENGTH)
+            return;
+
+        struct icmphdr *icmp = (struct icmphdr*) (buffer + IPHeaderLength);
+        uint32_t target = 0;
+        uint16_t tag = 0;
+        if(icmp->type == DirectProber::ICMP_TYPE_TIME_EXCEEDED || icmp->type == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
+        {
+            ssize_t quotedOffset = IPHeaderLength + DirectProber::DEFAULT_ICMP_HEADER_LENGTH;
+            if(length < quotedOffset + DirectProber::MINIMUM_IP_HEADER_LENGTH + 8)
+                return;
+
+            struct ip *quoted = (struct ip*) (buffer + quotedOffset);
+            if(length < quotedOffset + ((ssize_t) quoted->ip_hl) * 4 + 8 || quoted->ip_src.s_addr != localAddress)
+                return;
+
+            target = quoted->ip_dst.s_addr;
+            tag = ntohs(quoted->ip_id);
+        }
+        else if(icmp->type == DirectProber::ICMP_TYPE_ECHO_REPLY && protocol == ToolEnvironment::PROBING_PROTOCOL_ICMP)
+        {
+            if(ntohs((icmp->un).echo.id) != ICMPidentifier)
+                return;
+
+            target = ip->ip_src.s_addr;
+            tag = ntohs((icmp->un).echo.sequence);
+        }
+        else
+        {
+            return;
+        }
+
+        map<uint64_t, Probe*>::iterator it = probes.find(probeKey(target, tag));
+        if(it == probes.end())
+            return;
+        p = it->second;
+    }
+    else if(ip->ip_p == IPPROTO_TCP && protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+    {
+        if(length < IPHeaderLength + DirectProber::MINIMUM_TCP_HEADER_LENGTH)
+            return;
+
+        struct tcphdr *tcp = (struct tcphdr*) (buffer + IPHeaderLength);
+        map<uint32_t, Target*>::iterator itTarget = targets.find(ip->ip_src.s_addr);
+        if(itTarget == targets.end() || ntohs(tcp->dest) != srcPort)
+            return;
+
+        /*
+         * A reset acknowledges the sequence number of the probe (+ its length), or has the
+         * acknowledgement number of the probe as sequence number.
+         */
+
+        Target *t = itTarget->second;
+        uint32_t seq = ntohl(tcp->seq), ack = ntohl(tcp->ack_seq);
+        uint32_t probeLength = 1 + DirectProber::DEFAULT_TCP_RANDOM_DATA_LENGTH + (uint32_t) env->getAttentionMessage().length();
+        unsigned short lastTTL = (unsigned short) t->nextTTLToSend;
+        if((unsigned short) t->confirmTTL >= lastTTL)
+            lastTTL = (unsigned short) t->confirmTTL + 1; // Probe sent beyond the window
+        for(unsigned short TTL = t->nextTTLToEvaluate; TTL < lastTTL && p == NULL; TTL++)
+        {
+            for(unsigned char attempt = 0; attempt < 2 && p == NULL; attempt++)
+            {
+                map<uint64_t, Probe*>::iterator it = probes.find(probeKey(t->key, makeTag(t->nonce, attempt, TTL)));
+                if(it == probes.end() || !it->second->sent)
+                    continue;
+                if(it->second->TCPAck == seq || it->second->TCPSequence + probeLength == ack)
+                    p = it->second;
+            }
+        }
+        if(p == NULL)
+            return;
+    }
+    else
+    {
+        return;
+    }
+
+    if(!p->sent)
+        return;
+
+    // Checks the packet and classifies the reply exactly as a prober would
+    ProbeContext c;
+    c.src = &(env->getLocalIPAddress());
+    c.dst = &(p->target->address);
+    c.IPIdentifier = p->tag;
+    c.TTL = p->TTL;
+    c.usingFixedFlowID = true;
+    c.attentionMessage = &(env->getAttentionMessage());
+    c.randomData = NULL;
+    c.timestampRequest = false;
+    c.fixedFlowChecksum = 0;
+    c.originateTs = 0;
+    c.TCPSequence = p->TCPSequence;
+    c.replyType = 0;
+    c.replyCode = 0;
+    c.payloadTTL = 0;
+    c.receiveTs = 0;
+    c.transmitTs = 0;
+
+    unsigned short payloadLength = 0, replyIPIdentifier = 0;
+    uint8_t replyTTL = 0;
+    InetAddress replyAddress;
+    const char *rejection = NULL;
+    if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
+    {
+        c.srcPortICMPid = srcPort;
+        c.dstPortICMPseq = dstPort;
+        rejection = ProbePipeline<UDPWrappedICMPPolicy>::classify(buffer, length, c, &payloadLength, &replyTTL, &replyIPIdentifier, &replyAddress);
+    }
+    else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+    {
+        c.srcPortICMPid = srcPort;
+        c.dstPortICMPseq = dstPort;
+        rejection = ProbePipeline<TCPWrappedICMPPolicy>::classify(buffer, length, c, &payloadLength, &replyTTL, &replyIPIdentifier, &replyAddress);
+    }
+    else
+    {
+        c.srcPortICMPid = ICMPidentifier;
+        c.dstPortICMPseq = p->tag;
+        rejection = ProbePipeline<ICMPProbePolicy>::classify(buffer, length, c, &payloadLength, &replyTTL, &replyIPIdentifier, &replyAddress);
+    }
+    if(rejection != NULL)
+        return;
+
+    nbSuccessfulProbes++;
+
+    /*
+     * N.B.: like in ParisTracerouteTask, the reply TTL of a hop is the one of the first probe,
+     * hence 0 if the hop only replied to the retry.
+     */
+
+    Hop result;
+    result.done = true;
+    result.address = replyAddress;
+    result.replyTTL = (p->attempt == 0) ? replyTTL : 0;
+    result.replyType = c.replyType;
+    complete(p, result);
+}
+
+void AsyncTracerouteEngine::handleTimeouts()
+{
+    auto_ptr<TimeVal> now = TimeVal::getCurrentSystemTime();
+    while(deadlines.size() > 0 && deadlines.begin()->first <= (*now))
+    {
+        Probe *p = deadlines.begin()->second;
+        deadlines.erase(deadlines.begin());
+        probes.erase(probeKey(p->target->key, p->tag));
+
+        Target *t = p->target;
+        unsigned char TTL = p->TTL, attempt = p->attempt;
+        delete p;
+
+        // New probe with twice the timeout period
+        if(attempt == 0)
+        {
+            if(env->debugMode())
+            {
+                stringstream ss;
+                ss << "No reply at TTL " << (unsigned short) TTL << ", retrying with twice the initial timeout...\n";
+                t->log += ss.str();
+            }
+
+            schedule(t, TTL, 1);
+            continue;
+        }
+
+        t->hops[TTL].done = true;
+        t->hops[TTL].address = InetAddress(0);
+        t->hops[TTL].replyTTL = 0;
+        t->hops[TTL].replyType = 255;
+        evaluate(t);
+    }
+}
+
+void AsyncTracerouteEngine::complete(Probe *p, Hop &result)
+{
+    Target *t = p->target;
+    deadlines.erase(p->deadline);
+    probes.erase(probeKey(t->key, p->tag));
+    t->hops[p->TTL] = result;
+    delete p;
+
+    evaluate(t);
+}
+
+void AsyncTracerouteEngine::evaluate(Target *t)
+{
+    unsigned short maxAnonymous = env->getMaxConsecutiveAnonHops();
+    unsigned short maxCycles = env->getMaxCycles();
+    
+    // Hops copied from the global stop set: waits for the target to reply right after them
+    if(t->confirmTTL > 0)
+    {
+        Hop &confirmation = t->hops[t->confirmTTL];
+        if(!confirmation.done)
+            return;
+        
+        if(confirmation.replyType == DirectProber::ICMP_TYPE_ECHO_REPLY)
+        {
+            finish(t, true, t->confirmTTL);
+            return;
+        }
+        
+        if(env->debugMode())
+        {
+            stringstream ss;
+            ss << "The target did not reply at TTL " << (unsigned short) t->confirmTTL << " (after ";
+            ss << "the copied hops): probing as usual from now on.\n";
+            t->log += ss.str();
+        }
+        for(unsigned short i = 0; i < t->nbInferredHops; i++)
+        {
+            t->routeHops.pop_back();
+            t->replyTTLs.pop_back();
+        }
+        t->nbInferredHops = 0;
+        t->confirmTTL = 0;
+        t->inferring = false;
+    }
+
+    // Same rules as in ParisTracerouteTask, applied in increasing TTL order
+    while(t->nextTTLToEvaluate <= MAX_TTL && t->hops[t->nextTTLToEvaluate].done)
+    {
+        unsigned char TTL = t->nextTTLToEvaluate;
+        Hop &hop = t->hops[TTL];
+
+        // Counting consecutive anonymous hops and cycles
+        if(hop.address == InetAddress(0))
+        {
+            t->anonymous++;
+        }
+        else
+        {
+            t->anonymous = 0;
+            for(list<InetAddress>::iterator it = t->routeHops.begin(); it != t->routeHops.end(); ++it)
+            {
+                if((*it) == hop.address)
+                {
+                    t->cycles++;
+                    break;
+                }
+            }
+        }
+
+        // Scenarii where we should stop
+        if(t->anonymous > maxAnonymous || t->cycles > maxCycles)
+        {
+            finish(t, false, TTL);
+            return;
+        }
+
+        if(hop.replyType == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
+        {
+            finish(t, false, TTL);
+            return;
+        }
+
+        if(hop.replyType == DirectProber::ICMP_TYPE_ECHO_REPLY)
+        {
+            finish(t, true, TTL);
+            return;
+        }
+
+        t->routeHops.push_back(hop.address);
+        t->replyTTLs.push_back(hop.replyTTL);
+        t->nextTTLToEvaluate++;
+        
+        // Rest of the route already known for this /24: it is copied rather than probed
+        list<InetAddress> suffixHops;
+        list<unsigned char> suffixReplyTTLs;
+        bool suffixReachesDst = false;
+        if(globalStopSet != NULL && !t->verification && t->inferring && 
+           globalStopSet->lookUp(hop.address, t->address, suffixHops, suffixReplyTTLs, suffixReachesDst))
+        {
+            t->nbInferredHops = (unsigned short) suffixHops.size();
+            t->routeHops.splice(t->routeHops.end(), suffixHops);
+            t->replyTTLs.splice(t->replyTTLs.end(), suffixReplyTTLs);
+            
+            // If the other target was reached, this one must reply right after the copied hops
+            unsigned short dstTTL = (unsigned short) TTL + 1 + t->nbInferredHops;
+            if(!suffixReachesDst || dstTTL > (unsigned short) MAX_TTL)
+            {
+                finish(t, false, TTL);
+                return;
+            }
+            
+            // The probe at this TTL may already be in flight or answered (sliding window)
+            t->confirmTTL = (unsigned char) dstTTL;
+            if(t->confirmTTL >= t->nextTTLToSend)
+                schedule(t, t->confirmTTL, 0);
+            evaluate(t);
+            return;
+        }
+    }
+
+    if(t->nextTTLToEvaluate > MAX_TTL)
+    {
+        finish(t, false, t->nextTTLToEvaluate);
+        return;
+    }
+
+    // Slides the window (a TTL already probed to confirm an inferred distance is skipped)
+    while(t->nextTTLToSend <= MAX_TTL && t->nextTTLToSend < t->nextTTLToEvaluate + window)
+    {
+        if(!t->hops[t->nextTTLToSend].done)
+            schedule(t, t->nextTTLToSend, 0);
+        t->nextTTLToSend++;
+    }
+}
+
+void AsyncTracerouteEngine::finish(Target *t, bool reachedDst, unsigned char probeTTL)
+{
+    // Cancels the probes still in flight (or waiting to be sent) for this target
+    unsigned short lastTTL = (unsigned short) t->nextTTLToSend;
+    if((unsigned short) t->confirmTTL >= lastTTL)
+        lastTTL = (unsigned short) t->confirmTTL + 1;
+    for(unsigned short TTL = t->nextTTLToEvaluate; TTL < lastTTL; TTL++)
+    {
+        for(unsigned char attempt = 0; attempt < 2; attempt++)
+        {
+            map<uint64_t, Probe*>::iterator it = probes.find(probeKey(t->key, makeTag(t->nonce, attempt, TTL)));
+            if(it == probes.end())
+                continue;
+
+            Probe *p = it->second;
+            probes.erase(it);
+            if(p->sent)
+            {
+                deadlines.erase(p->deadline);
+                delete p;
+            }
+            else
+            {
+                p->target = NULL; // Deleted by sendProbes()
+            }
+        }
+    }
+
+    // Only measured routes are recorded in the global stop set
+    if(globalStopSet != NULL && t->nbInferredHops == 0)
+        globalStopSet->record(t->address, t->routeHops, t->replyTTLs, reachedDst, t->verification);
+    
+    t->log += ParisTracerouteTask::saveRoute(env, 
+                                             t->entry, 
+                                             t->routeHops, 
+                                             t->replyTTLs, 
+                                             reachedDst, 
+                                             probeTTL, 
+                                             t->nbInferredHops);
+
+    ToolEnvironment::consoleMessagesMutex.lock();
+    ostream *out = env->getOutputStream();
+    (*out) << t->log << endl;
+    ToolEnvironment::consoleMessagesMutex.unlock();
+
+    targets.erase(t->key);
+    delete t;
+}
+
+void AsyncTracerouteEngine::stop()
+{
+    ToolEnvironment::emergencyStopMutex.lock();
+    env->triggerStop();
+    ToolEnvironment::emergencyStopMutex.unlock();
+}
@@ -0,0 +1,152 @@
+/*
+ * AsyncTracerouteEngine.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * AsyncTracerouteEngine computes the routes towards a list of targets in an event-driven way,
+ * rather than with one thread per target probing one TTL at a time and waiting for each reply
+ * (see ParisTracerouteTask). Each target being traced is a small state machine (TTLs in flight,
+ * consecutive anonymous hops, cycles, whether the target was reached), and a single thread keeps
+ * up to "maxTargets" targets in flight, with up to "window" TTLs in flight for each of them. All
+ * probes are sent through one raw socket and all replies are read from one or two raw sockets
+ * (ICMP, plus TCP when probing with TCP).
+ *
+ * A reply is matched with its probe thanks to a tag, written in the IP identifier of the probe
+ * (quoted in time exceeded and destination unreachable messages) and, depending on the protocol,
+ * in the ICMP sequence number (echo replies) or recovered from the TCP sequence numbers (resets).
+ * The tag gives the TTL of the probe, the attempt (first probe or retry with twice the timeout)
+ * and a random byte proper to the target. The flow identifier stays fixed for all probes towards
+ * a target, as with Paris traceroute (ICMP probes keep the same checksum).
+ *
+ * Replies are evaluated in increasing TTL order with exactly the same rules as ParisTracerouteTask
+ * (maximum consecutive anonymous hops, maximum cycles, destination unreachable, echo reply), so
+ * the resulting traces are the same: the probes sent beyond the TTL where a trace stops are simply
+ * ignored. With a window of 1, the probing itself is the same as with ParisTracerouteTask. The
+ * global stop set (see GlobalStopSet) is used in the same way as well.
+ *
+ * When the distance of a target was estimated at pre-scanning (see NetworkPrescanner), the first
+ * window covers all the TTLs up to that distance, so the whole expected route is probed at once.
+ *
+ * Probes are paced such that the overall probing rate never exceeds the one of the thread pool
+ * (i.e., one probe per regulating period for each of the maxThreads threads).
+ */
+
+#ifndef ASYNCTRACEROUTEENGINE_H_
+#define ASYNCTRACEROUTEENGINE_H_
+
+#include <inttypes.h>
+#include <list>
+using std::list;
+#include <map>
+using std::map;
+using std::multimap;
+#include <deque>
+using std::deque;
+
+#include "../ToolEnvironment.h"
+#include "../../prober/exception/SocketException.h"
+
+class AsyncTracerouteEngine
+{
+public:
+
+    static const unsigned char MAX_TTL = 64; // Same as in ParisTracerouteTask
+    static const size_t BUFFER_SIZE = 2048;
+    static const int RECEIVE_BUFFER_SIZE = 4 * 1024 * 1024; // Requested size of the socket buffers
+    static const int MAX_POLLING_PERIOD = 100; // In ms (to check the emergency stop)
+
+    AsyncTracerouteEngine(ToolEnvironment *env,
+                          unsigned int maxTargets,
+                          unsigned short window) throw(SocketException);
+    ~AsyncTracerouteEngine();
+
+    // Computes the routes towards all targets; returns when done or upon emergency stop
+    void trace(list<InetAddress> targets);
+
+private:
+
+    // Result for a TTL of a target
+    struct Hop
+    {
+        bool done;
+        InetAddress address;
+        unsigned char replyTTL, replyType;
+    };
+
+    // Target being traced
+    struct Target
+    {
+        IPTableEntry *entry;
+        InetAddress address;
+        uint32_t key; // Address as an integer, in network order
+        uint8_t nonce;
+        TimeVal timeout;
+        unsigned char nextTTLToSend, nextTTLToEvaluate;
+        Hop hops[MAX_TTL + 1];
+        list<InetAddress> routeHops;
+        list<unsigned char> replyTTLs;
+        unsigned short anonymous, cycles;
+        bool verification; // True if the global stop set is ignored (to verify it)
+        unsigned short nbInferredHops;
+        unsigned char confirmTTL; // TTL where the target should reply (global stop set), 0 if none
+        bool inferring; // False once a distance inferred from the global stop set was wrong
+        string log;
+    };
+
+    // Probe which was sent (or is waiting to be sent) and has not been answered yet
+    struct Probe
+    {
+        Target *target;
+        unsigned char TTL, attempt;
+        uint16_t tag;
+        uint32_t TCPSequence, TCPAck;
+        bool sent;
+        multimap<TimeVal, Probe*>::iterator deadline;
+    };
+
+    // Environment and parameters
+    ToolEnvironment *env;
+    unsigned short protocol; // As in ToolEnvironment
+    unsigned int maxTargets;
+    unsigned short window;
+    uint32_t localAddress; // Network order
+    uint16_t ICMPidentifier, srcPort, dstPort;
+    TimeVal sendInterval, nextSendTime;
+    GlobalStopSet *globalStopSet; // NULL if not used
+
+    // Sockets
+    int sendSocket, ICMPSocket, TCPSocket;
+
+    // Targets in flight (by address) and probes (by target and tag), deadlines, probes to send
+    list<InetAddress> queue;
+    map<uint32_t, Target*> targets;
+    map<uint64_t, Probe*> probes;
+    multimap<TimeVal, Probe*> deadlines;
+    deque<Probe*> toSend;
+
+    // Buffers and amounts of probes
+    uint8_t buffer[BUFFER_SIZE], pseudoBuffer[BUFFER_SIZE];
+    unsigned int nbProbes, nbSuccessfulProbes;
+
+    // Private methods
+    void activateTargets();
+    void schedule(Target *t, unsigned char TTL, unsigned char attempt);
+    void sendProbes();
+    void send(Probe *p);
+    void receive(int socket);
+    void handleReply(ssize_t length);
+    void handleTimeouts();
+    void complete(Probe *p, Hop &result);
+    void evaluate(Target *t);
+    void finish(Target *t, bool reachedDst, unsigned char probeTTL);
+    void stop();
+
+    static inline uint64_t probeKey(uint32_t target, uint16_t tag) { return ((uint64_t) target << 16) | tag; }
+    static inline uint16_t makeTag(uint8_t nonce, unsigned char attempt, unsigned char TTL)
+    {
+        return (uint16_t) (((uint16_t) nonce << 8) | ((uint16_t) attempt << 7) | (uint16_t) TTL);
+    }
+};
+
+#endif /* ASYNCTRACEROUTEENGINE_H_ */
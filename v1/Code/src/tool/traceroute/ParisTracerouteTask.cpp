@@ -8,8 +8,15 @@
  * goals of such class).
  */
 
+#include <vector>
+using std::vector;
+#include <map>
+using std::map;
+
 #include "ParisTracerouteTask.h"
 #include "../structure/RouteInterface.h"
+#include "../structure/LocalStopSet.h"
+#include "../../common/thread/Thread.h"
 
 ParisTracerouteTask::ParisTracerouteTask(ToolEnvironment *e, 
                                          InetAddress t, 
@@ -17,51 +24,28 @@ ParisTracerouteTask::ParisTracerouteTask(ToolEnvironment *e,
                                          unsigned short ubii, 
                                          unsigned short lbis, 
                                          unsigned short ubis) throw (SocketException):
-env(e)
+env(e), 
+reference(NULL), 
+firstOpinion(NULL), 
+maxProbeTTL(MAX_TTL), 
+singleAttempts(false), 
+globalStopSet(NULL), 
+verification(false), 
+monitor(NULL), 
+expected(NULL)
 {
+    controller = env->getConcurrencyController();
+    failed = false;
+    
     try
     {
-        unsigned short protocol = env->getProbingProtocol();
-    
-        if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
-        {
-            int roundRobinSocketCount = 1;
-            
-            prober = new DirectUDPWrappedICMPProber(env->getAttentionMessage(), 
-                                                    roundRobinSocketCount, 
-                                                    env->getTimeoutPeriod(), 
-                                                    env->getProbeRegulatingPeriod(), 
-                                                    lbii, 
-                                                    ubii, 
-                                                    lbis, 
-                                                    ubis, 
-                                                    env->debugMode());
-        }
-        else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
-        {
-            int roundRobinSocketCount = 1;
-            
-            prober = new DirectTCPWrappedICMPProber(env->getAttentionMessage(), 
-                                                    roundRobinSocketCount, 
-                                                    env->getTimeoutPeriod(), 
-                                                    env->getProbeRegulatingPeriod(), 
-                                                    lbii, 
-                                                    ubii, 
-                                                    lbis, 
-                                                    ubis, 
-                                                    env->debugMode());
-        }
-        else
-        {
-            prober = new DirectICMPProber(env->getAttentionMessage(), 
-                                          env->getTimeoutPeriod(), 
-                                          env->getProbeRegulatingPeriod(), 
-                                          lbii, 
-                                          ubii, 
-                                          lbis, 
-                                          ubis, 
-                                          env->debugMode());
-        }
+        prober = env->getProberPool()->acquire(env->getTimeoutPeriod(), 
+                                               env->getProbeRegulatingPeriod(), 
+                                               lbii, 
+                                               ubii, 
+                                               lbis, 
+                                               ubis, 
+                                               env->debugMode());
     }
     catch(SocketException &se)
     {
@@ -79,15 +63,20 @@ env(e)
     {
         targetIP = env->getIPTable()->create(t);
         targetIP->setPreferredTimeout(env->getTimeoutPeriod());
+        
+        // Warm start: the timeout of the previous campaign, if longer
+        PreviousCampaign *previous = env->getPreviousCampaign();
+        if(previous != NULL)
+        {
+            TimeVal previousTimeout = previous->getTimeout(t);
+            if(previousTimeout > env->getTimeoutPeriod())
+                targetIP->setPreferredTimeout(previousTimeout);
+        }
     }
     
     // Verbosity/debug stuff
-    displayFinalRoute = false; // Default
     debugMode = false; // Default
-    unsigned short displayMode = env->getDisplayMode();
-    if(displayMode >= ToolEnvironment::DISPLAY_MODE_SLIGHTLY_VERBOSE)
-        displayFinalRoute = true;
-    if(displayMode >= ToolEnvironment::DISPLAY_MODE_DEBUG)
+    if(env->getDisplayMode() >= ToolEnvironment::DISPLAY_MODE_DEBUG)
         debugMode = true;
     
     // Start of the new log with first probing details (debug mode only)
@@ -105,8 +94,10 @@ ParisTracerouteTask::~ParisTracerouteTask()
 {
     if(prober != NULL)
     {
+        if(controller != NULL)
+            controller->recordProbes(prober->getNbProbes(), prober->getNbSuccessfulProbes());
         env->updateProbeAmounts(prober);
-        delete prober;
+        env->getProberPool()->release(prober);
     }
 }
 
@@ -140,97 +131,554 @@ ProbeRecord *ParisTracerouteTask::probe(const InetAddress &dst, unsigned char TT
 
 void ParisTracerouteTask::stop()
 {
+    if(controller != NULL)
+    {
+        failed = true;
+        controller->signalFailure();
+        return;
+    }
+    
     ToolEnvironment::emergencyStopMutex.lock();
     env->triggerStop();
     ToolEnvironment::emergencyStopMutex.unlock();
 }
 
-void ParisTracerouteTask::run()
+unsigned char ParisTracerouteTask::estimateStartTTL()
 {
-    InetAddress probeDst((InetAddress) (*targetIP));
-
-    // probeTTL or probeDst could not be properly found: quits
-    if(probeDst == InetAddress(0))
+    unsigned char startTTL = env->getDoubletreeStartTTL();
+    
+    // Bis traces are meant to re-measure the whole route (hence no Doubletree)
+    if(startTTL <= 1 || env->getLocalStopSet() == NULL || env->collectingBisTraces())
+        return 1;
+    
+    // If the distance of the target is already known, starts there
+    unsigned char knownTTL = targetIP->getTTL();
+    if(knownTTL == IPTableEntry::NO_KNOWN_TTL || knownTTL == 0)
     {
-        return;
+        // Otherwise, the distance estimated at pre-scanning or observed by the previous campaign
+        knownTTL = targetIP->getEstimatedTTL();
+        PreviousCampaign *previous = env->getPreviousCampaign();
+        if(knownTTL == 0 && previous != NULL)
+            knownTTL = previous->getDistance((InetAddress) (*targetIP));
     }
+    if(knownTTL != IPTableEntry::NO_KNOWN_TTL && knownTTL > 0 && knownTTL < startTTL)
+        startTTL = knownTTL;
     
-    // Changes timeout if necessary for this IP
+    if(startTTL > MAX_TTL)
+        startTTL = MAX_TTL;
+    return startTTL;
+}
+
+unsigned char ParisTracerouteTask::inheritedStartTTL()
+{
+    if(reference == NULL || !reference->hasValidRoute())
+        return 1;
+    
+    unsigned short routeSize = reference->getRouteSize();
+    if(routeSize <= (unsigned short) SIBLING_MARGIN + 2)
+        return 1;
+    return (unsigned char) (routeSize - 1 - SIBLING_MARGIN);
+}
+
+bool ParisTracerouteTask::anomalyWindow(unsigned char &firstTTL, unsigned char &lastTTL)
+{
+    if(firstOpinion == NULL || !firstOpinion->hasValidRoute())
+        return false;
+    
+    // Hops with the same IPs as listed by ToolEnvironment::listProblematicTargets()
     IPLookUpTable *table = env->getIPTable();
-    IPTableEntry *probeDstEntry = table->lookUp(probeDst);
-    TimeVal usedTimeout = prober->getTimeout();
-    if(probeDstEntry != NULL)
+    RouteInterface *route = firstOpinion->getRoute();
+    unsigned short routeSize = firstOpinion->getRouteSize();
+    unsigned short first = 0, last = 0; // As TTLs (0 = none)
+    for(unsigned short i = 0; i < routeSize; i++)
     {
-        TimeVal preferredTimeout = probeDstEntry->getPreferredTimeout();
-        if(preferredTimeout > usedTimeout)
+        if(route[i].ip == InetAddress(0))
+            continue;
+        
+        IPTableEntry *entry = table->lookUp(route[i].ip);
+        if(entry == NULL || (!entry->isStretched() && !entry->isCycling()))
+            continue;
+        
+        if(first == 0)
+            first = i + 1;
+        last = i + 1;
+    }
+    
+    if(first == 0)
+        return false;
+    
+    firstTTL = 1;
+    if(first > (unsigned short) ANOMALY_MARGIN + 1)
+        firstTTL = (unsigned char) (first - ANOMALY_MARGIN);
+    
+    lastTTL = MAX_TTL;
+    if(last + (unsigned short) ANOMALY_MARGIN < routeSize)
+        lastTTL = (unsigned char) (last + ANOMALY_MARGIN);
+    
+    return firstTTL > 1 || lastTTL < MAX_TTL;
+}
+
+bool ParisTracerouteTask::probeWindow(const InetAddress &dst, 
+                                      TimeVal usedTimeout, 
+                                      unsigned char firstTTL, 
+                                      unsigned char lastTTL, 
+                                      list<InetAddress> &routeHops, 
+                                      list<unsigned char> &replyTTLs, 
+                                      bool &reachedDst, 
+                                      unsigned char &probeTTL, 
+                                      unsigned short &nbInferredHops, 
+                                      unsigned short &nbInheritedHops)
+{
+    // First hops are the ones of the first opinion
+    RouteInterface *firstRoute = firstOpinion->getRoute();
+    unsigned short firstRouteSize = firstOpinion->getRouteSize();
+    for(unsigned short i = 0; i < (unsigned short) firstTTL - 1; i++)
+    {
+        routeHops.push_back(firstRoute[i].ip);
+        replyTTLs.push_back(firstRoute[i].iTTL); // Unchanged by saveRoute()
+    }
+    nbInheritedHops = firstTTL - 1;
+    
+    probeTTL = firstTTL;
+    maxProbeTTL = lastTTL;
+    bool success = this->probeForward(dst, usedTimeout, routeHops, replyTTLs, reachedDst, probeTTL, nbInferredHops);
+    maxProbeTTL = MAX_TTL;
+    if(!success)
+        return false;
+    
+    // Window probed without the trace stopping: the rest is copied from the first opinion
+    if(probeTTL > lastTTL)
+    {
+        for(unsigned short i = lastTTL; i < firstRouteSize; i++)
         {
-            prober->setTimeout(preferredTimeout);
-            usedTimeout = preferredTimeout;
+            routeHops.push_back(firstRoute[i].ip);
+            replyTTLs.push_back(firstRoute[i].iTTL);
         }
+        nbInferredHops = firstRouteSize - lastTTL;
+        reachedDst = firstOpinion->isTargetReachable();
+        probeTTL = (unsigned char) (firstRouteSize + 1);
+    }
+    return true;
+}
+
+void ParisTracerouteTask::probeFlows(const InetAddress &dst, 
+                                     TimeVal usedTimeout, 
+                                     unsigned char firstTTL, 
+                                     unsigned char lastTTL)
+{
+    unsigned short nbFlows = env->getBisTraceFlows();
+    if(debugMode)
+    {
+        stringstream ss;
+        ss << "Re-probing TTLs " << (unsigned short) firstTTL << " to ";
+        if(lastTTL < MAX_TTL)
+            ss << (unsigned short) lastTTL;
+        else
+            ss << "the end of the route";
+        ss << " with " << nbFlows << " flow" << (nbFlows > 1 ? "s" : "") << " (flow-varied bis ";
+        ss << "traces).\n";
+        this->log += ss.str();
     }
     
-    bool reachedDst = false;
-    unsigned char probeTTL = 1;
-    list<InetAddress> routeHops;
-    list<unsigned char> replyTTLs;
-    unsigned short anonymous = 0, cycles = 0;
-    while(probeTTL <= MAX_TTL)
+    vector<list<InetAddress> > flowHops(nbFlows);
+    vector<list<unsigned char> > flowReplyTTLs(nbFlows);
+    vector<bool> flowReachedDst(nbFlows, false);
+    vector<unsigned char> flowProbeTTLs(nbFlows, 1);
+    vector<unsigned short> flowInferredHops(nbFlows, 0), flowInheritedHops(nbFlows, 0);
+    
+    // The successors learnt by the live rate-limit pacing depend on the flow
+    monitor = NULL;
+    singleAttempts = true;
+    for(unsigned short i = 0; i < nbFlows; i++)
+    {
+        if(debugMode)
+        {
+            stringstream ss;
+            ss << "Flow n°" << (i + 1) << ":\n";
+            this->log += ss.str();
+        }
+        
+        prober->setFlowID(i + 1);
+        bool reachedDst = false;
+        bool success = this->probeWindow(dst, 
+                                         usedTimeout, 
+                                         firstTTL, 
+                                         lastTTL, 
+                                         flowHops[i], 
+                                         flowReplyTTLs[i], 
+                                         reachedDst, 
+                                         flowProbeTTLs[i], 
+                                         flowInferredHops[i], 
+                                         flowInheritedHops[i]);
+        flowReachedDst[i] = reachedDst;
+        if(!success)
+            break;
+    }
+    prober->setFlowID(0);
+    singleAttempts = false;
+    if(env->isStopping() || failed)
+        return;
+    
+    // First interface seen at each measured TTL of the window (first opinion, then each flow)
+    map<unsigned short, InetAddress> seenHops;
+    RouteInterface *firstRoute = firstOpinion->getRoute();
+    unsigned short firstRouteSize = firstOpinion->getRouteSize();
+    for(unsigned short TTL = firstTTL; TTL <= lastTTL && TTL <= firstRouteSize; TTL++)
+        if(firstRoute[TTL - 1].ip != InetAddress(0))
+            seenHops[TTL] = firstRoute[TTL - 1].ip;
+    
+    bool loadBalanced = false;
+    for(unsigned short i = 0; i < nbFlows && !loadBalanced; i++)
+    {
+        unsigned short TTL = 1, lastMeasuredTTL = (unsigned short) (flowHops[i].size() - flowInferredHops[i]);
+        for(list<InetAddress>::iterator it = flowHops[i].begin(); it != flowHops[i].end(); ++it, TTL++)
+        {
+            if(TTL <= flowInheritedHops[i] || TTL > lastMeasuredTTL || (*it) == InetAddress(0))
+                continue;
+            
+            map<unsigned short, InetAddress>::iterator seen = seenHops.find(TTL);
+            if(seen == seenHops.end())
+            {
+                seenHops[TTL] = (*it);
+            }
+            else if(seen->second != (*it))
+            {
+                loadBalanced = true;
+                break;
+            }
+        }
+    }
+    
+    if(debugMode)
+    {
+        stringstream ss;
+        ss << "The hops around the anomalies ";
+        if(loadBalanced)
+            ss << "depend on the flow (load balancing).\n";
+        else
+            ss << "are the same for all flows (persistent anomalies).\n";
+        this->log += ss.str();
+    }
+    
+    // One trace per flow
+    for(unsigned short i = 0; i < nbFlows; i++)
+    {
+        if(i > 0)
+            this->log += "\n";
+        this->log += saveRoute(env, 
+                               targetIP, 
+                               flowHops[i], 
+                               flowReplyTTLs[i], 
+                               flowReachedDst[i], 
+                               flowProbeTTLs[i], 
+                               flowInferredHops[i], 
+                               flowInheritedHops[i], 
+                               i + 2);
+    }
+    
+    ToolEnvironment::tracesListMutex.lock();
+    env->countFlowVariedTarget(loadBalanced);
+    ToolEnvironment::tracesListMutex.unlock();
+}
+
+bool ParisTracerouteTask::probeHop(const InetAddress &dst, 
+                                   unsigned char TTL, 
+                                   TimeVal usedTimeout, 
+                                   InetAddress &rplyAddress, 
+                                   unsigned char &remainingTTL, 
+                                   unsigned char &rplyType, 
+                                   bool noRetry)
+{
+    ProbeRecord *record = NULL;
+    try
+    {
+        record = this->probe(dst, TTL);
+    }
+    catch(SocketException &se)
     {
-        ProbeRecord *record = NULL;
+        this->stop();
+        return false;
+    }
+    
+    rplyAddress = record->getRplyAddress();
+    remainingTTL = record->getRplyTTL();
+    if(rplyAddress == InetAddress(0) && noRetry)
+    {
+        // Debug message
+        if(debugMode && singleAttempts)
+        {
+            this->log += "Not retrying at this TTL (flow-varied bis trace).\n";
+        }
+        else if(debugMode)
+        {
+            this->log += "Not retrying at this TTL (hop was anonymous in the previous campaign).\n";
+        }
+    }
+    else if(rplyAddress == InetAddress(0))
+    {
+        delete record;
+        
+        // Debug message
+        if(debugMode)
+        {
+            this->log += "Retrying at this TTL with twice the initial timeout...\n";
+        }
+        
+        // New probe with twice the timeout period
+        prober->setTimeout(usedTimeout * 2);
+        
         try
         {
-            record = this->probe(probeDst, probeTTL);
+            record = this->probe(dst, TTL);
         }
         catch(SocketException &se)
         {
+            prober->setTimeout(usedTimeout);
             this->stop();
-            return;
+            return false;
         }
         
-        InetAddress rplyAddress = record->getRplyAddress();
-        unsigned char remainingTTL = record->getRplyTTL();
-        if(rplyAddress == InetAddress(0))
+        rplyAddress = record->getRplyAddress();
+        
+        // Restores default timeout
+        prober->setTimeout(usedTimeout);
+        
+        /*
+         * N.B.: because this program is supposed to run traceroute more intensively than 
+         * TreeNET, there is no 3rd attempt with 4 times the initial timeout.
+         */
+    }
+    
+    rplyType = record->getRplyICMPtype();
+    delete record;
+    return true;
+}
+
+bool ParisTracerouteTask::expectsAnonymous(unsigned char TTL)
+{
+    if(expected == NULL)
+        return false;
+    
+    // Beyond the previous route of an unreachable target, only timeouts were seen
+    if((size_t) TTL > expected->hops.size())
+        return !expected->reachable;
+    return expected->hops[TTL - 1] == InetAddress(0);
+}
+
+void ParisTracerouteTask::checkExpected(unsigned char TTL, const InetAddress &rplyAddress)
+{
+    if(expected == NULL)
+        return;
+    
+    InetAddress expectedHop(0);
+    if((size_t) TTL <= expected->hops.size())
+        expectedHop = expected->hops[TTL - 1];
+    else if(expected->reachable)
+        return; // Target (or a longer route, which does not change the probing)
+    
+    if(rplyAddress == expectedHop)
+        return;
+    
+    if(debugMode)
+    {
+        stringstream ss;
+        ss << "Got " << rplyAddress << " at TTL " << (unsigned short) TTL << " instead of ";
+        ss << expectedHop << " (previous campaign): probing as usual from now on.\n";
+        this->log += ss.str();
+    }
+    expected = NULL;
+}
+
+bool ParisTracerouteTask::checkPreviousRoute(const InetAddress &dst, 
+                                             TimeVal usedTimeout, 
+                                             list<InetAddress> &routeHops, 
+                                             list<unsigned char> &replyTTLs, 
+                                             bool &reachedDst, 
+                                             unsigned char &probeTTL, 
+                                             unsigned short &nbInheritedHops, 
+                                             bool &stable)
+{
+    stable = false;
+    if(expected == NULL)
+        return true;
+    
+    // Last responsive hop of the previous route
+    vector<InetAddress> &hops = expected->hops;
+    unsigned short lastTTL = 0;
+    for(size_t i = hops.size(); i > 0; i--)
+    {
+        if(hops[i - 1] != InetAddress(0))
+        {
+            lastTTL = (unsigned short) i;
+            break;
+        }
+    }
+    unsigned short dstTTL = (unsigned short) hops.size() + 1;
+    if(lastTTL == 0 || lastTTL > (unsigned short) MAX_TTL || (expected->reachable && dstTTL > (unsigned short) MAX_TTL))
+        return true;
+    
+    InetAddress rplyAddress(0);
+    unsigned char remainingTTL = 0, rplyType = 0;
+    if(!this->probeHop(dst, (unsigned char) lastTTL, usedTimeout, rplyAddress, remainingTTL, rplyType))
+        return false;
+    
+    if(rplyAddress != hops[lastTTL - 1] || rplyType != DirectProber::ICMP_TYPE_TIME_EXCEEDED)
+    {
+        if(debugMode)
+        {
+            stringstream ss;
+            ss << "Got " << rplyAddress << " at TTL " << lastTTL << " instead of " << hops[lastTTL - 1];
+            ss << " (last hop in the previous campaign): probing the full route.\n";
+            this->log += ss.str();
+        }
+        return true;
+    }
+    unsigned char lastReplyTTL = remainingTTL;
+    
+    // The target should still reply at the same distance
+    if(expected->reachable)
+    {
+        if(!this->probeHop(dst, (unsigned char) dstTTL, usedTimeout, rplyAddress, remainingTTL, rplyType))
+            return false;
+        
+        if(rplyType != DirectProber::ICMP_TYPE_ECHO_REPLY)
         {
-            delete record;
-            
-            // Debug message
             if(debugMode)
             {
-                this->log += "Retrying at this TTL with twice the initial timeout...\n";
-            }
-            
-            // New probe with twice the timeout period
-            prober->setTimeout(usedTimeout * 2);
-            
-            try
-            {
-                record = this->probe(probeDst, probeTTL);
+                stringstream ss;
+                ss << "The target did not reply at TTL " << dstTTL << " (distance in the previous ";
+                ss << "campaign): probing the full route.\n";
+                this->log += ss.str();
             }
-            catch(SocketException &se)
+            return true;
+        }
+    }
+    
+    if(debugMode)
+    {
+        stringstream ss;
+        ss << "Same last hop";
+        if(expected->reachable)
+            ss << " and distance";
+        ss << " as in the previous campaign: the other hops are copied from it.\n";
+        this->log += ss.str();
+    }
+    
+    /*
+     * The hops before the last hop are copied (their reply TTLs are unknown, hence 0), and so 
+     * are the anonymous hops between the last hop and the target.
+     */
+    
+    stable = true;
+    for(unsigned short i = 0; i < lastTTL - 1; i++)
+    {
+        routeHops.push_back(hops[i]);
+        replyTTLs.push_back(0);
+    }
+    nbInheritedHops = lastTTL - 1;
+    routeHops.push_back(hops[lastTTL - 1]);
+    replyTTLs.push_back(lastReplyTTL);
+    if(expected->reachable)
+    {
+        for(unsigned short i = lastTTL; i < dstTTL - 1; i++)
+        {
+            routeHops.push_back(InetAddress(0));
+            replyTTLs.push_back(0);
+        }
+        reachedDst = true;
+        probeTTL = (unsigned char) dstTTL;
+    }
+    else
+    {
+        probeTTL = (unsigned char) lastTTL + 1;
+    }
+    return true;
+}
+
+bool ParisTracerouteTask::probeForward(const InetAddress &dst, 
+                                       TimeVal usedTimeout, 
+                                       list<InetAddress> &routeHops, 
+                                       list<unsigned char> &replyTTLs, 
+                                       bool &reachedDst, 
+                                       unsigned char &probeTTL, 
+                                       unsigned short &nbInferredHops, 
+                                       bool *diverged)
+{
+    unsigned short anonymous = 0, cycles = 0;
+    
+    // Last responsive hop so far and budget of consecutive anonymous hops after it
+    InetAddress lastResponsive(0);
+    unsigned char lastResponsiveTTL = 0, TTL = 1;
+    for(list<InetAddress>::iterator it = routeHops.begin(); it != routeHops.end(); ++it, TTL++)
+    {
+        if((*it) != InetAddress(0))
+        {
+            lastResponsive = (*it);
+            lastResponsiveTTL = TTL;
+        }
+    }
+    unsigned short maxAnonymous = env->getMaxConsecutiveAnonHops();
+    unsigned short budget = maxAnonymous;
+    bool inferring = true; // False once a distance inferred from the global stop set is wrong
+    
+    while(probeTTL <= MAX_TTL && probeTTL <= maxProbeTTL)
+    {
+        InetAddress rplyAddress(0);
+        unsigned char remainingTTL = 0, rplyType = 0;
+        bool noRetry = singleAttempts || this->expectsAnonymous(probeTTL);
+        
+        // Live rate-limit pacing: waits for its turn if the expected hop is throttled
+        InetAddress previousHop(0);
+        if(monitor != NULL && routeHops.size() > 0 && routeHops.size() == (size_t) probeTTL - 1)
+        {
+            previousHop = routeHops.back();
+            TimeVal wait = monitor->reserve(previousHop, probeTTL);
+            if(wait.isPositive())
             {
-                this->stop();
-                return;
+                if(debugMode)
+                {
+                    stringstream ss;
+                    ss << "Waiting " << wait << " before probing at TTL " << (unsigned short) probeTTL;
+                    ss << " (the expected hop seems to be rate-limited).\n";
+                    this->log += ss.str();
+                }
+                Thread::invokeSleep(wait);
             }
-            
-            rplyAddress = record->getRplyAddress();
-            
-            // Restores default timeout
-            prober->setTimeout(usedTimeout);
-            
-            /*
-             * N.B.: because this program is supposed to run traceroute more intensively than 
-             * TreeNET, there is no 3rd attempt with 4 times the initial timeout.
-             */
         }
         
+        if(!this->probeHop(dst, probeTTL, usedTimeout, rplyAddress, remainingTTL, rplyType, noRetry))
+            return false;
+        this->checkExpected(probeTTL, rplyAddress);
+        
+        if(monitor != NULL && (rplyAddress == InetAddress(0) || rplyType == DirectProber::ICMP_TYPE_TIME_EXCEEDED))
+            monitor->record(previousHop, probeTTL, rplyAddress);
+        
         // Counting consecutive anonymous hops and cycles
         if(rplyAddress == InetAddress(0))
         {
             anonymous++;
+            
+            // Silence after the known last hop of an unreachable target of the same prefix
+            if(anonymous == 1 && unreachables != NULL && 
+               unreachables->isLastHop(dst, lastResponsive, lastResponsiveTTL))
+            {
+                budget = unreachables->getBudget();
+                if(debugMode)
+                {
+                    stringstream ss;
+                    ss << lastResponsive << " is the last hop towards another unreachable target ";
+                    ss << "of the same prefix: only " << budget << " more anonymous hop";
+                    ss << (budget != 1 ? "s are" : " is") << " allowed.\n";
+                    this->log += ss.str();
+                }
+            }
         }
         else
         {
             anonymous = 0;
+            budget = maxAnonymous;
+            lastResponsive = rplyAddress;
+            lastResponsiveTTL = probeTTL;
             for(list<InetAddress>::iterator it = routeHops.begin(); it != routeHops.end(); ++it)
             {
                 if((*it) == rplyAddress)
@@ -241,32 +689,367 @@ void ParisTracerouteTask::run()
             }
         }
         
+        // Sibling target: hops before the last hop of the representative should be the same
+        if(diverged != NULL && rplyAddress != InetAddress(0) && probeTTL < reference->getRouteSize())
+        {
+            InetAddress refHop = reference->getRoute()[probeTTL - 1].ip;
+            if(refHop != InetAddress(0) && refHop != rplyAddress)
+            {
+                (*diverged) = true;
+                return true;
+            }
+        }
+        
         // Scenarii where we should stop
-        if(anonymous > env->getMaxConsecutiveAnonHops() || cycles > env->getMaxCycles())
+        if(anonymous > budget)
         {
-            delete record;
+            if(unreachables != NULL)
+            {
+                if(anonymous <= maxAnonymous)
+                    unreachables->countShortenedTrace();
+                unreachables->record(dst, lastResponsive, lastResponsiveTTL);
+            }
             break;
         }
         
-        if(record->getRplyICMPtype() == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
+        if(cycles > env->getMaxCycles())
         {
-            delete record;
             break;
         }
         
-        if(record->getRplyICMPtype() == DirectProber::ICMP_TYPE_ECHO_REPLY)
+        if(rplyType == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
+        {
+            break;
+        }
+        
+        if(rplyType == DirectProber::ICMP_TYPE_ECHO_REPLY)
         {
             reachedDst = true;
-            delete record;
             break;
         }
         
         routeHops.push_back(rplyAddress);
         replyTTLs.push_back(remainingTTL);
-        delete record;
         probeTTL++;
+        
+        // Rest of the route already known for this /24: it is copied rather than probed
+        list<InetAddress> suffixHops;
+        list<unsigned char> suffixReplyTTLs;
+        bool suffixReachesDst = false;
+        if(globalStopSet != NULL && !verification && inferring && 
+           globalStopSet->lookUp(rplyAddress, dst, suffixHops, suffixReplyTTLs, suffixReachesDst))
+        {
+            if(debugMode)
+            {
+                stringstream ss;
+                ss << rplyAddress << " is in the global stop set: the next hops are taken from ";
+                ss << "the route where it was seen.\n";
+                this->log += ss.str();
+            }
+            
+            /*
+             * If the other target was reached, this one is only considered as reached if it 
+             * replies right after the copied hops, which is checked with a probe. Otherwise, the 
+             * copied hops are dropped and the probing goes on as usual.
+             */
+            
+            unsigned short dstTTL = (unsigned short) probeTTL + suffixHops.size();
+            if(suffixReachesDst && dstTTL <= (unsigned short) MAX_TTL)
+            {
+                if(!this->probeHop(dst, (unsigned char) dstTTL, usedTimeout, rplyAddress, remainingTTL, rplyType))
+                    return false;
+                
+                if(rplyType != DirectProber::ICMP_TYPE_ECHO_REPLY)
+                {
+                    if(debugMode)
+                    {
+                        stringstream ss;
+                        ss << "The target did not reply at TTL " << dstTTL << " (after the copied ";
+                        ss << "hops): probing as usual from now on.\n";
+                        this->log += ss.str();
+                    }
+                    inferring = false;
+                    continue;
+                }
+                
+                reachedDst = true;
+                probeTTL = (unsigned char) dstTTL;
+            }
+            
+            nbInferredHops = (unsigned short) suffixHops.size();
+            routeHops.splice(routeHops.end(), suffixHops);
+            replyTTLs.splice(replyTTLs.end(), suffixReplyTTLs);
+            break;
+        }
+    }
+    
+    return true;
+}
+
+bool ParisTracerouteTask::probeBackward(const InetAddress &dst, 
+                                        unsigned char startTTL, 
+                                        TimeVal usedTimeout, 
+                                        list<InetAddress> &routeHops, 
+                                        list<unsigned char> &replyTTLs, 
+                                        bool reachedDst, 
+                                        unsigned char &probeTTL)
+{
+    LocalStopSet *stopSet = env->getLocalStopSet();
+    list<InetAddress> prefixHops;
+    list<unsigned char> prefixReplyTTLs;
+    
+    /*
+     * If the target replied at the start TTL, it can be closer than expected: as long as it keeps 
+     * replying while probing backward, the distance is updated and nothing is recorded.
+     */
+    
+    bool shrinking = reachedDst && probeTTL == startTTL;
+    for(unsigned char TTL = startTTL - 1; TTL > 0; TTL--)
+    {
+        InetAddress rplyAddress(0);
+        unsigned char remainingTTL = 0, rplyType = 0;
+        bool noRetry = this->expectsAnonymous(TTL);
+        if(!this->probeHop(dst, TTL, usedTimeout, rplyAddress, remainingTTL, rplyType, noRetry))
+            return false;
+        if(!shrinking || rplyType != DirectProber::ICMP_TYPE_ECHO_REPLY)
+            this->checkExpected(TTL, rplyAddress);
+        
+        if(shrinking && rplyType == DirectProber::ICMP_TYPE_ECHO_REPLY)
+        {
+            probeTTL = TTL;
+            continue;
+        }
+        shrinking = false;
+        
+        prefixHops.push_front(rplyAddress);
+        prefixReplyTTLs.push_front(remainingTTL);
+        
+        // Stops as soon as this (interface, TTL) pair was already seen in another trace
+        list<InetAddress> knownHops;
+        list<unsigned char> knownReplyTTLs;
+        if(stopSet != NULL && stopSet->lookUp(rplyAddress, TTL, knownHops, knownReplyTTLs))
+        {
+            if(debugMode)
+            {
+                stringstream ss;
+                ss << rplyAddress << " at TTL " << (unsigned short) TTL << " is in the local ";
+                ss << "stop set: the previous hops are taken from the route where it was seen.\n";
+                this->log += ss.str();
+            }
+            
+            prefixHops.splice(prefixHops.begin(), knownHops);
+            prefixReplyTTLs.splice(prefixReplyTTLs.begin(), knownReplyTTLs);
+            break;
+        }
     }
     
+    routeHops.splice(routeHops.begin(), prefixHops);
+    replyTTLs.splice(replyTTLs.begin(), prefixReplyTTLs);
+    return true;
+}
+
+void ParisTracerouteTask::run()
+{
+    InetAddress probeDst((InetAddress) (*targetIP));
+
+    // probeTTL or probeDst could not be properly found: quits
+    if(probeDst == InetAddress(0))
+    {
+        return;
+    }
+    
+    // Changes timeout if necessary for this IP
+    IPLookUpTable *table = env->getIPTable();
+    IPTableEntry *probeDstEntry = table->lookUp(probeDst);
+    TimeVal usedTimeout = prober->getTimeout();
+    if(probeDstEntry != NULL)
+    {
+        TimeVal preferredTimeout = probeDstEntry->getPreferredTimeout();
+        if(preferredTimeout > usedTimeout)
+        {
+            prober->setTimeout(preferredTimeout);
+            usedTimeout = preferredTimeout;
+        }
+    }
+    
+    // Global stop set (not used for bis traces, and ignored by some traces to verify it)
+    globalStopSet = env->getGlobalStopSet();
+    monitor = env->getRateLimitMonitor();
+    unreachables = env->getUnreachablePrefixCache();
+    if(env->collectingBisTraces())
+        unreachables = NULL;
+    verification = false;
+    if(globalStopSet != NULL)
+    {
+        if(env->collectingBisTraces())
+            globalStopSet = NULL;
+        else
+            verification = globalStopSet->drawVerification();
+    }
+    
+    // Warm start: route measured by the previous campaign (bis traces re-measure everything)
+    expected = NULL;
+    PreviousCampaign *previous = env->getPreviousCampaign();
+    if(previous != NULL && !env->collectingBisTraces())
+        expected = previous->getRoute(probeDst);
+    
+    bool reachedDst = false, diverged = false;
+    unsigned char probeTTL = 1;
+    list<InetAddress> routeHops;
+    list<unsigned char> replyTTLs;
+    unsigned short nbInferredHops = 0, nbInheritedHops = 0;
+    
+    // Differential bis trace: only the TTLs around the anomalies of the first opinion are probed
+    unsigned char firstTTL = 1, lastTTL = MAX_TTL;
+    bool differential = this->anomalyWindow(firstTTL, lastTTL);
+    
+    // Flow-varied bis traces: the same window is probed with each flow in a single pass
+    if(env->getBisTraceFlows() > 0 && firstOpinion != NULL && firstOpinion->hasValidRoute())
+    {
+        this->probeFlows(probeDst, usedTimeout, firstTTL, lastTTL);
+        
+        ToolEnvironment::consoleMessagesMutex.lock();
+        ostream *out = env->getOutputStream();
+        (*out) << this->log << endl;
+        ToolEnvironment::consoleMessagesMutex.unlock();
+        return;
+    }
+    
+    if(differential)
+    {
+        if(debugMode)
+        {
+            stringstream ss;
+            ss << "Re-probing TTLs " << (unsigned short) firstTTL << " to ";
+            if(lastTTL < MAX_TTL)
+                ss << (unsigned short) lastTTL;
+            else
+                ss << "the end of the route";
+            ss << " (differential bis trace).\n";
+            this->log += ss.str();
+        }
+        
+        if(!this->probeWindow(probeDst, usedTimeout, firstTTL, lastTTL, routeHops, replyTTLs, reachedDst, probeTTL, nbInferredHops, nbInheritedHops))
+            return;
+    }
+    
+    // Sibling of a representative target: starts a few hops before the end of its route
+    unsigned char startTTL = this->inheritedStartTTL();
+    if(startTTL > 1)
+    {
+        if(debugMode)
+        {
+            stringstream ss;
+            ss << "Starting at TTL " << (unsigned short) startTTL << " (sibling of ";
+            ss << reference->getTargetIP() << ").\n";
+            this->log += ss.str();
+        }
+        
+        probeTTL = startTTL;
+        if(!this->probeForward(probeDst, usedTimeout, routeHops, replyTTLs, reachedDst, probeTTL, nbInferredHops, &diverged))
+            return;
+        
+        if(diverged)
+        {
+            if(debugMode)
+            {
+                this->log += "The route diverges from the route of the representative target. ";
+                this->log += "Computing the full route...\n";
+            }
+            
+            routeHops.clear();
+            replyTTLs.clear();
+            reachedDst = false;
+            nbInferredHops = 0;
+        }
+        else
+        {
+            // First hops are the ones of the representative
+            RouteInterface *refRoute = reference->getRoute();
+            list<InetAddress> inheritedHops;
+            list<unsigned char> inheritedITTLs;
+            for(unsigned short i = 0; i < (unsigned short) startTTL - 1; i++)
+            {
+                inheritedHops.push_back(refRoute[i].ip);
+                inheritedITTLs.push_back(refRoute[i].iTTL); // Unchanged by saveRoute()
+            }
+            nbInheritedHops = startTTL - 1;
+            routeHops.splice(routeHops.begin(), inheritedHops);
+            replyTTLs.splice(replyTTLs.begin(), inheritedITTLs);
+        }
+    }
+    
+    // Warm start: a route identical to the previous one is confirmed with a few probes
+    bool stable = false;
+    if(!differential && startTTL <= 1)
+    {
+        if(!this->checkPreviousRoute(probeDst, usedTimeout, routeHops, replyTTLs, reachedDst, probeTTL, nbInheritedHops, stable))
+            return;
+        
+        // Unreachable target: the probing resumes after the last hop
+        if(stable && !reachedDst)
+        {
+            if(!this->probeForward(probeDst, usedTimeout, routeHops, replyTTLs, reachedDst, probeTTL, nbInferredHops))
+                return;
+        }
+    }
+    
+    if(!differential && !stable && (startTTL <= 1 || diverged))
+    {
+        // With Doubletree, the trace starts at the estimated distance (1 otherwise)
+        startTTL = this->estimateStartTTL();
+        if(debugMode && startTTL > 1)
+        {
+            stringstream ss;
+            ss << "Starting at TTL " << (unsigned short) startTTL << " (Doubletree).\n";
+            this->log += ss.str();
+        }
+        
+        probeTTL = startTTL;
+        if(!this->probeForward(probeDst, usedTimeout, routeHops, replyTTLs, reachedDst, probeTTL, nbInferredHops))
+            return;
+        
+        // Doubletree: hops before the start TTL are obtained by probing backward
+        if(startTTL > 1)
+        {
+            if(!this->probeBackward(probeDst, startTTL, usedTimeout, routeHops, replyTTLs, reachedDst, probeTTL))
+                return;
+        }
+    }
+    
+    LocalStopSet *stopSet = env->getLocalStopSet();
+    if(stopSet != NULL)
+        stopSet->record(routeHops, replyTTLs);
+    
+    // Only measured routes (and siblings which matched their representative) are recorded
+    if(globalStopSet != NULL && nbInferredHops == 0)
+    {
+        bool routeChange = globalStopSet->record(probeDst, routeHops, replyTTLs, reachedDst, verification);
+        if(debugMode && routeChange)
+            this->log += "This route differs from the routes of the global stop set, which is updated.\n";
+    }
+    
+    this->log += saveRoute(env, targetIP, routeHops, replyTTLs, reachedDst, probeTTL, nbInferredHops, nbInheritedHops);
+    
+    // Displays the log, which can be a complete sequence of probe as well as a single line
+    ToolEnvironment::consoleMessagesMutex.lock();
+    ostream *out = env->getOutputStream();
+    (*out) << this->log << endl;
+    ToolEnvironment::consoleMessagesMutex.unlock();
+}
+
+string ParisTracerouteTask::saveRoute(ToolEnvironment *env, 
+                                      IPTableEntry *targetIP, 
+                                      list<InetAddress> &routeHops, 
+                                      list<unsigned char> &replyTTLs, 
+                                      bool reachedDst, 
+                                      unsigned char probeTTL, 
+                                      unsigned short nbInferredHops, 
+                                      unsigned short nbInheritedHops, 
+                                      unsigned short opinionNumber)
+{
+    InetAddress probeDst((InetAddress) (*targetIP));
+    
     // Route array
     unsigned short sizeRoute = (unsigned short) routeHops.size();
     RouteInterface *route = new RouteInterface[sizeRoute];
@@ -274,7 +1057,9 @@ void ParisTracerouteTask::run()
     for(list<InetAddress>::iterator it = routeHops.begin(); it != routeHops.end(); ++it)
     {
         route[i].ip = (*it);
-        if((*it) != InetAddress(0))
+        if(i < nbInheritedHops || i + nbInferredHops >= sizeRoute)
+            route[i].state = RouteInterface::INFERRED;
+        else if((*it) != InetAddress(0))
             route[i].state = RouteInterface::VIA_TRACEROUTE;
         else
             route[i].state = RouteInterface::MISSING;
@@ -310,44 +1095,38 @@ void ParisTracerouteTask::run()
     }
     newTrace->setRouteSize(sizeRoute);
     newTrace->setRoute(route);
+    newTrace->setOpinionNumber(opinionNumber);
     
     ToolEnvironment::tracesListMutex.lock();
     env->addTrace(newTrace);
     ToolEnvironment::tracesListMutex.unlock();
     
-    // Appends the log with a single line (laconic mode) or the route that was obtained
-    if(displayFinalRoute)
+    // Log with a single line (laconic mode) or the route that was obtained
+    stringstream routeLog;
+    unsigned short displayMode = env->getDisplayMode();
+    if(displayMode >= ToolEnvironment::DISPLAY_MODE_SLIGHTLY_VERBOSE)
     {
-        stringstream routeLog;
-        
         // Adding a line break after probe logs to separate from the complete route
-        if(debugMode)
+        if(displayMode >= ToolEnvironment::DISPLAY_MODE_DEBUG)
         {
             routeLog << "\n";
         }
         
-        routeLog << "Got the route to " << (InetAddress) (*targetIP) << ":\n";
+        routeLog << "Got the route to " << probeDst << ":\n";
         for(unsigned short i = 0; i < sizeRoute; i++)
         {
-            if(route[i].state == RouteInterface::MISSING)
-                routeLog << "Missing\n";
+            if(route[i].ip == InetAddress(0))
+                routeLog << "Missing";
             else
-                routeLog << route[i].ip << "\n";
+                routeLog << route[i].ip;
+            if(route[i].state == RouteInterface::INFERRED)
+                routeLog << " [Inferred]";
+            routeLog << "\n";
         }
-
-        this->log += routeLog.str();
     }
     else
     {
-        stringstream routeLog;
-        routeLog << "Got the route to " << (InetAddress) (*targetIP) << ".";
-        
-        this->log += routeLog.str();
+        routeLog << "Got the route to " << probeDst << ".";
     }
-    
-    // Displays the log, which can be a complete sequence of probe as well as a single line
-    ToolEnvironment::consoleMessagesMutex.lock();
-    ostream *out = env->getOutputStream();
-    (*out) << this->log << endl;
-    ToolEnvironment::consoleMessagesMutex.unlock();
+    return routeLog.str();
 }
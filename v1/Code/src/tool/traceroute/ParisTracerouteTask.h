@@ -25,6 +25,21 @@
  *  also moved to a different folder to keep a coherent file architecture.
  *
  * May 2, 2017: re-used and slightly modified for the needs of WIP Traceroute.
+ *
+ * Oct 19, 2026: added the Doubletree mode, where the trace starts at an estimated distance and 
+ * probes backward until it reaches an interface already seen at the same TTL (see LocalStopSet). 
+ * Also added the warm start, where the hops of a previous campaign are used as expectations (see 
+ * PreviousCampaign), and differential bis traces, which only re-probe the TTLs around the 
+ * stretched or cycling hops of the first opinion and copy the rest of the route from it, and 
+ * flow-varied bis traces, which re-probe the same hops once per flow (one probe per TTL and per 
+ * flow) and record one trace per flow.
+ *
+ * Oct 19, 2026: the warm start first checks whether the route is stable with a probe at its last 
+ * hop and another at the distance of the target; if so, the rest of the previous route is copied.
+ *
+ * Oct 19, 2026: with the adaptive concurrency (see ConcurrencyController), a lack of resources 
+ * (no socket, sending failure) no longer triggers the emergency stop: the task is marked as 
+ * failed, nothing is recorded and the worker retries the target later.
  */
 
 #ifndef PARISTRACEROUTETASK_H_
@@ -39,12 +54,20 @@
 #include "../../prober/tcp/DirectTCPWrappedICMPProber.h"
 #include "../../prober/exception/SocketException.h"
 #include "../../prober/structure/ProbeRecord.h"
+#include "../structure/GlobalStopSet.h"
+#include "../structure/PreviousCampaign.h"
 
 class ParisTracerouteTask : public Runnable
 {
 public:
 
     static const unsigned char MAX_TTL = 64; // It is extremely rare to observe a TTL above this value
+    
+    // Amount of hops probed before the penultimate hop of the representative (sibling targets)
+    static const unsigned char SIBLING_MARGIN = 2;
+    
+    // Amount of hops re-probed before/after the anomalies of the first opinion (differential bis traces)
+    static const unsigned char ANOMALY_MARGIN = 2;
 
     // Constructor
     ParisTracerouteTask(ToolEnvironment *env, 
@@ -58,6 +81,33 @@ public:
     ~ParisTracerouteTask();
     void run();
     
+    // Makes this target a sibling of the target of the given (complete) trace
+    inline void setReference(Trace *reference) { this->reference = reference; }
+    
+    // Gives the first opinion of the target (differential bis traces)
+    inline void setFirstOpinion(Trace *firstOpinion) { this->firstOpinion = firstOpinion; }
+    
+    // True if the task could not be carried out because of a lack of resources (to retry)
+    inline bool hasFailed() { return this->failed; }
+    
+    /*
+     * Records the route obtained towards a target (as a new trace) and returns the log line(s) 
+     * describing it, depending on the display mode. It is also used by AsyncTracerouteEngine, 
+     * such that both ways of tracing produce the same output. The last "nbInferredHops" hops 
+     * were copied from the global stop set rather than measured, as were the first 
+     * "nbInheritedHops" hops (copied from the representative of a sibling target).
+     */
+    
+    static string saveRoute(ToolEnvironment *env, 
+                            IPTableEntry *targetIP, 
+                            list<InetAddress> &routeHops, 
+                            list<unsigned char> &replyTTLs, 
+                            bool reachedDst, 
+                            unsigned char probeTTL, 
+                            unsigned short nbInferredHops = 0, 
+                            unsigned short nbInheritedHops = 0, 
+                            unsigned short opinionNumber = 1);
+    
 private:
 
     // Pointer to the environment variable
@@ -70,11 +120,159 @@ private:
     DirectProber *prober;
     ProbeRecord *probe(const InetAddress &dst, unsigned char TTL);
     
-    // "Stop" method (when resources are lacking)
+    // Trace of the representative target (sibling targets only, NULL otherwise)
+    Trace *reference;
+    
+    // First opinion of the target (differential bis traces only, NULL otherwise)
+    Trace *firstOpinion;
+    
+    // Last TTL probeForward() can probe (MAX_TTL, except for differential bis traces)
+    unsigned char maxProbeTTL;
+    
+    /*
+     * Differential bis traces: gives the TTLs to probe again, i.e., the TTLs of the stretched or 
+     * cycling hops of the first opinion plus ANOMALY_MARGIN hops on each side (lastTTL is MAX_TTL 
+     * if the window reaches the end of the route). Returns false if there is nothing to do 
+     * differently from a complete trace.
+     */
+    
+    bool anomalyWindow(unsigned char &firstTTL, unsigned char &lastTTL);
+    
+    /*
+     * Probes the TTLs from firstTTL to lastTTL (see anomalyWindow()), the hops before and, if 
+     * the trace does not stop within the window, the hops after being copied from the first 
+     * opinion. Returns false if the probing failed.
+     */
+    
+    bool probeWindow(const InetAddress &dst, 
+                     TimeVal usedTimeout, 
+                     unsigned char firstTTL, 
+                     unsigned char lastTTL, 
+                     list<InetAddress> &routeHops, 
+                     list<unsigned char> &replyTTLs, 
+                     bool &reachedDst, 
+                     unsigned char &probeTTL, 
+                     unsigned short &nbInferredHops, 
+                     unsigned short &nbInheritedHops);
+    
+    /*
+     * Flow-varied bis traces: probes the window with each flow ID from 1 to the amount of flows 
+     * (the first opinion used flow 0), each TTL being probed once, then records one trace per 
+     * flow (flow i gives the opinion n°i+1). The target is counted as load balanced if two flows 
+     * (first opinion included) got distinct interfaces at a same measured TTL, and as having 
+     * persistent anomalies otherwise.
+     */
+    
+    void probeFlows(const InetAddress &dst, 
+                    TimeVal usedTimeout, 
+                    unsigned char firstTTL, 
+                    unsigned char lastTTL);
+    
+    // True while each TTL is probed without retry (flow-varied bis traces)
+    bool singleAttempts;
+    
+    // Global stop set (NULL if not used) and whether this trace ignores it to verify it
+    GlobalStopSet *globalStopSet;
+    bool verification;
+    
+    // Live rate-limit pacing (NULL if not used)
+    RateLimitMonitor *monitor;
+    
+    // Cache of the prefixes of unreachable targets (NULL if not used, e.g. for bis traces)
+    UnreachablePrefixCache *unreachables;
+    
+    // Route measured by the previous campaign (warm start; NULL if none or once it differs)
+    PreviousCampaign::PreviousRoute *expected;
+    
+    /*
+     * Probes a TTL (retrying once with twice the timeout, unless "noRetry" is true); false if the 
+     * probing failed.
+     */
+    
+    bool probeHop(const InetAddress &dst, 
+                  unsigned char TTL, 
+                  TimeVal usedTimeout, 
+                  InetAddress &rplyAddress, 
+                  unsigned char &remainingTTL, 
+                  unsigned char &rplyType, 
+                  bool noRetry = false);
+    
+    /*
+     * Warm start: expectsAnonymous() tells whether the hop at a given TTL was anonymous in the 
+     * previous campaign (then, a timeout is not retried), while checkExpected() compares a reply 
+     * with the expected hop and drops the expectations as soon as they differ.
+     */
+    
+    bool expectsAnonymous(unsigned char TTL);
+    void checkExpected(unsigned char TTL, const InetAddress &rplyAddress);
+    
+    /*
+     * Warm start: probes the last responsive hop of the previous route and, if the target was 
+     * reached, the previous distance of the target. If both match, the route is considered as 
+     * stable ("stable" set to true): the hops before the last hop are copied from the previous 
+     * route (as inherited hops) and, if the target was reached, so are the anonymous hops after 
+     * it. Otherwise, nothing is recorded. Returns false if the probing failed.
+     */
+    
+    bool checkPreviousRoute(const InetAddress &dst, 
+                            TimeVal usedTimeout, 
+                            list<InetAddress> &routeHops, 
+                            list<unsigned char> &replyTTLs, 
+                            bool &reachedDst, 
+                            unsigned char &probeTTL, 
+                            unsigned short &nbInheritedHops, 
+                            bool &stable);
+    
+    /*
+     * Doubletree: the trace starts at an estimated distance (estimateStartTTL() returns 1 when 
+     * Doubletree is not used), goes forward as usual, then probeBackward() probes the TTLs below 
+     * the start TTL until reaching an (interface, TTL) pair of the local stop set, in which case 
+     * the first hops are copied from the route which first observed that pair.
+     */
+    
+    unsigned char estimateStartTTL();
+    
+    /*
+     * Probes forward from probeTTL until the target, a stop condition (anonymous hops, cycles) 
+     * or a hop in the global stop set. If "diverged" is not NULL, the hops are compared with the 
+     * route of the representative target (reference) and the probing stops as soon as they 
+     * differ, setting "diverged" to true. Returns false if the probing failed.
+     */
+    
+    bool probeForward(const InetAddress &dst, 
+                      TimeVal usedTimeout, 
+                      list<InetAddress> &routeHops, 
+                      list<unsigned char> &replyTTLs, 
+                      bool &reachedDst, 
+                      unsigned char &probeTTL, 
+                      unsigned short &nbInferredHops, 
+                      bool *diverged = NULL);
+    
+    // Sibling targets start a few hops before the end of the route of their representative
+    unsigned char inheritedStartTTL();
+    
+    /*
+     * Doubletree: probes backward from startTTL - 1 and prepends the hops to the route, until TTL 
+     * 1 or a pair of the local stop set (see above). If the target replied at the start TTL, its 
+     * distance (probeTTL) is first lowered as long as it keeps replying. Returns false if the 
+     * probing failed.
+     */
+    
+    bool probeBackward(const InetAddress &dst, 
+                       unsigned char startTTL, 
+                       TimeVal usedTimeout, 
+                       list<InetAddress> &routeHops, 
+                       list<unsigned char> &replyTTLs, 
+                       bool reachedDst, 
+                       unsigned char &probeTTL);
+    
+    // "Stop" method (when resources are lacking); only marks the task as failed if adaptive
     void stop();
+    ConcurrencyController *controller;
+    bool failed;
     
     // Verbosity/debug stuff
-    bool displayFinalRoute, debugMode;
+    bool debugMode;
     string log;
 };
 
@@ -0,0 +1,570 @@
+/*
+ * StatelessTracerouteEngine.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in StatelessTracerouteEngine.h (see this file to learn further
+ * about the goals of such class).
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/tcp.h>
+
+#include "StatelessTracerouteEngine.h"
+#include "ParisTracerouteTask.h"
+#include "../../common/random/CyclicPermutation.h"
+#include "../../prober/pipeline/ProbePipeline.h"
+
+StatelessTracerouteEngine::StatelessTracerouteEngine(ToolEnvironment *env,
+                                                     unsigned char maxTTL,
+                                                     unsigned short gapLimit) throw(SocketException)
+{
+    this->env = env;
+    this->protocol = env->getProbingProtocol();
+    this->maxTTL = maxTTL;
+    if(this->maxTTL < 1)
+        this->maxTTL = 1;
+    else if(this->maxTTL > MAX_TTL)
+        this->maxTTL = MAX_TTL;
+    this->gapLimit = gapLimit;
+    localAddress = htonl((uint32_t) env->getLocalIPAddress().getULongAddress());
+
+    // Same flow identifiers as AsyncTracerouteEngine
+    unsigned short range = DirectProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID - DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID;
+    ICMPidentifier = DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + (rand() % range);
+    srcPort = DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID + (rand() % range);
+    dstPort = DirectProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ;
+    dstPort += (DirectProber::DEFAULT_UPPER_DST_PORT_ICMP_SEQ - DirectProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ) / 2;
+
+    // Overall probing rate of the thread pool (one probe per regulating period per thread)
+    sendInterval = env->getProbeRegulatingPeriod() / (float) env->getMaxThreads();
+
+    nbProbes = 0;
+    nbSuccessfulProbes = 0;
+    ICMPSocket = -1;
+    TCPSocket = -1;
+
+    int IPProtocol = IPPROTO_ICMP;
+    if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
+        IPProtocol = IPPROTO_UDP;
+    else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+        IPProtocol = IPPROTO_TCP;
+
+    if((sendSocket = socket(PF_INET, SOCK_RAW, IPProtocol)) == -1)
+        throw SocketException("Can NOT create sending socket.");
+
+    const int on = 1;
+    if(setsockopt(sendSocket, IPPROTO_IP, IP_HDRINCL, &on, sizeof(on)) < 0)
+    {
+        close(sendSocket);
+        throw SocketException("Can NOT set sending socket IP_HDRINCL");
+    }
+
+    const int receiveBufferSize = RECEIVE_BUFFER_SIZE;
+    if((ICMPSocket = socket(PF_INET, SOCK_RAW, IPPROTO_ICMP)) == -1 ||
+       fcntl(ICMPSocket, F_SETFL, O_NONBLOCK) == -1)
+    {
+        if(ICMPSocket != -1)
+            close(ICMPSocket);
+        close(sendSocket);
+        throw SocketException("Can NOT create receiving ICMP raw socket.");
+    }
+    setsockopt(ICMPSocket, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+
+    if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+    {
+        if((TCPSocket = socket(PF_INET, SOCK_RAW, IPPROTO_TCP)) == -1 ||
+           fcntl(TCPSocket, F_SETFL, O_NONBLOCK) == -1)
+        {
+            if(TCPSocket != -1)
+                close(TCPSocket);
+            close(ICMPSocket);
+            close(sendSocket);
+            throw SocketException("Can NOT create receiving TCP raw socket.");
+        }
+        setsockopt(TCPSocket, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+    }
+}
+
+StatelessTracerouteEngine::~StatelessTracerouteEngine()
+{
+    if(TCPSocket != -1)
+        close(TCPSocket);
+    close(ICMPSocket);
+    close(sendSocket);
+}
+
+void StatelessTracerouteEngine::trace(list<InetAddress> targets)
+{
+    IPLookUpTable *table = env->getIPTable();
+    TimeVal maxTimeout = env->getTimeoutPeriod();
+    for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+    {
+        // Duplicates are traced once (every TTL is probed anyway)
+        uint32_t key = htonl((uint32_t) (*it).getULongAddress());
+        if((*it) == InetAddress(0) || indexes.find(key) != indexes.end())
+            continue;
+
+        // Gets target IP in the dictionnary, creates it if missing
+        IPTableEntry *entry = table->lookUp((*it));
+        if(entry == NULL)
+        {
+            entry = table->create((*it));
+            entry->setPreferredTimeout(env->getTimeoutPeriod());
+        }
+
+        Target t;
+        t.entry = entry;
+        t.address = (*it);
+        t.timeout = env->getTimeoutPeriod();
+        if(entry->getPreferredTimeout() > t.timeout)
+            t.timeout = entry->getPreferredTimeout();
+        if(t.timeout > maxTimeout)
+            maxTimeout = t.timeout;
+
+        indexes.insert(std::pair<uint32_t, unsigned int>(key, (unsigned int) this->targets.size()));
+        this->targets.push_back(t);
+    }
+
+    nbProbes = 0;
+    nbSuccessfulProbes = 0;
+    startTime = *(TimeVal::getCurrentSystemTime());
+
+    // Every (target, TTL) pair, in a pseudo-random order
+    uint32_t nbTargets = (uint32_t) this->targets.size();
+    uint64_t nbPairs = (uint64_t) nbTargets * (uint64_t) maxTTL;
+    if(nbPairs > (uint64_t) CyclicPermutation::MAX_SIZE)
+    {
+        nbPairs = (uint64_t) CyclicPermutation::MAX_SIZE;
+        ostream *out = env->getOutputStream();
+        ToolEnvironment::consoleMessagesMutex.lock();
+        (*out) << "Too many (target, TTL) pairs for a single permutation: only the first ";
+        (*out) << nbPairs << " will be probed." << endl;
+        ToolEnvironment::consoleMessagesMutex.unlock();
+    }
+    CyclicPermutation permutation((uint32_t) nbPairs);
+
+    TimeVal nextSendTime = startTime;
+    uint32_t pair = 0;
+    while(permutation.next(&pair) && !env->isStopping())
+    {
+        receiveUntil(nextSendTime);
+        if(env->isStopping())
+            break;
+
+        // Consecutive pairs mostly differ by their target, so TTLs are mixed as well
+        send((unsigned int) (pair % nbTargets), (unsigned char) (pair / nbTargets + 1));
+
+        nextSendTime += sendInterval;
+        auto_ptr<TimeVal> now = TimeVal::getCurrentSystemTime();
+        if(nextSendTime < (*now))
+            nextSendTime = (*now);
+    }
+
+    // Waits for the replies to the last probes
+    if(!env->isStopping())
+    {
+        TimeVal endTime = *(TimeVal::getCurrentSystemTime());
+        endTime += maxTimeout * 2.0f;
+        receiveUntil(endTime);
+    }
+
+    env->updateProbeAmounts(nbProbes, nbSuccessfulProbes);
+    if(!env->isStopping())
+        reassemble();
+
+    this->targets.clear();
+    indexes.clear();
+    replies.clear();
+}
+
+uint16_t StatelessTracerouteEngine::elapsedUnits()
+{
+    TimeVal elapsed = *(TimeVal::getCurrentSystemTime()) - startTime;
+    uint64_t microSeconds = (uint64_t) elapsed.getSecondsPart() * 1000000 + (uint64_t) elapsed.getMicroSecondsPart();
+    return (uint16_t) (microSeconds / TIMESTAMP_UNIT);
+}
+
+void StatelessTracerouteEngine::send(unsigned int target, unsigned char TTL)
+{
+    Target &t = targets[target];
+    uint32_t key = htonl((uint32_t) t.address.getULongAddress());
+    uint16_t tag = makeTag(TTL);
+
+    uint8_t randomData[DEFAULT_RANDOM_DATA_BUFFER_LENGH];
+    for(unsigned short i = 0; i < DEFAULT_RANDOM_DATA_BUFFER_LENGH; i++)
+        randomData[i] = (uint8_t) (rand() % 256);
+
+    ProbeContext c;
+    c.src = &(env->getLocalIPAddress());
+    c.dst = &(t.address);
+    c.IPIdentifier = tag;
+    c.TTL = TTL;
+    c.usingFixedFlowID = true;
+    c.attentionMessage = &(env->getAttentionMessage());
+    c.randomData = randomData;
+    c.timestampRequest = false;
+    c.fixedFlowChecksum = (uint16_t) ((DirectProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ + DirectProber::DEFAULT_UPPER_DST_PORT_ICMP_SEQ) / 2);
+    c.originateTs = 0;
+    c.TCPSequence = 0;
+
+    uint16_t length = 0;
+    if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
+    {
+        c.srcPortICMPid = srcPort;
+        c.dstPortICMPseq = dstPort;
+        length = ProbePipeline<UDPWrappedICMPPolicy>::build(buffer, pseudoBuffer, c);
+    }
+    else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+    {
+        // The tag is also in the upper half of the sequence number, to recognize resets
+        c.srcPortICMPid = srcPort;
+        c.dstPortICMPseq = dstPort;
+        c.TCPSequence = TCPSequence(tag, key);
+        length = ProbePipeline<TCPWrappedICMPPolicy>::build(buffer, pseudoBuffer, c);
+    }
+    else
+    {
+        // The tag is also the ICMP sequence number, as an echo reply quotes nothing
+        c.srcPortICMPid = ICMPidentifier;
+        c.dstPortICMPseq = tag;
+        length = ProbePipeline<ICMPProbePolicy>::build(buffer, pseudoBuffer, c);
+    }
+
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = key;
+
+    ssize_t bytesSent = 0;
+    ssize_t totalBytesSent = 0;
+    do
+    {
+        bytesSent = sendto(sendSocket,
+                           buffer + totalBytesSent,
+                           length - totalBytesSent,
+                           0,
+                           (struct sockaddr*) &to,
+                           sizeof(struct sockaddr));
+        if(bytesSent == -1)
+        {
+            perror("Socket Send Exception Error Message");
+            this->stop();
+            return;
+        }
+
+        totalBytesSent += bytesSent;
+    }
+    while(totalBytesSent < length);
+    nbProbes++;
+}
+
+void StatelessTracerouteEngine::receiveUntil(TimeVal limit)
+{
+    struct pollfd fds[2];
+    nfds_t nbFds = 1;
+    fds[0].fd = ICMPSocket;
+    fds[0].events = POLLIN;
+    if(TCPSocket != -1)
+    {
+        fds[1].fd = TCPSocket;
+        fds[1].events = POLLIN;
+        nbFds = 2;
+    }
+
+    while(!env->isStopping())
+    {
+        auto_ptr<TimeVal> now = TimeVal::getCurrentSystemTime();
+        int waitPeriod = 0;
+        if(limit > (*now))
+        {
+            TimeVal diff = limit - (*now);
+            waitPeriod = (int) (diff.getSecondsPart() * 1000 + diff.getMicroSecondsPart() / 1000);
+            if(waitPeriod > MAX_POLLING_PERIOD)
+                waitPeriod = MAX_POLLING_PERIOD;
+        }
+
+        int pollResult = poll(fds, nbFds, waitPeriod);
+        if(pollResult < 0 && errno != EINTR)
+        {
+            perror("poll(...)");
+            this->stop();
+            return;
+        }
+        else if(pollResult > 0)
+        {
+            for(nfds_t i = 0; i < nbFds; i++)
+                if(fds[i].revents & POLLIN)
+                    receive(fds[i].fd);
+        }
+
+        // Sub-millisecond remainders are not waited for (the next poll() would not block)
+        if(waitPeriod == 0)
+            return;
+    }
+}
+
+void StatelessTracerouteEngine::receive(int socket)
+{
+    // Bounded, such that probes are still sent on time under heavy load
+    for(unsigned short i = 0; i < 1024; i++)
+    {
+        ssize_t receivedBytes = recvfrom(socket, buffer, BUFFER_SIZE, 0, NULL, NULL);
+        if(receivedBytes <= 0)
+            break;
+        handleReply(receivedBytes);
+    }
+}
+
+void StatelessTracerouteEngine::handleReply(ssize_t length)
+{
+    struct ip *ip = (struct ip*) buffer;
+    if(length < DirectProber::MINIMUM_IP_HEADER_LENGTH || ip->ip_v != DirectProber::DEFAULT_IP_VERSION)
+        return;
+    ssize_t IPHeaderLength = ((ssize_t) ip->ip_hl) * 4;
+
+    // Decodes the target and the tag of the probe this packet might reply to
+    uint32_t target = 0;
+    uint16_t tag = 0;
+    uint32_t sequence = 0;
+    if(ip->ip_p == IPPROTO_ICMP)
+    {
+        if(length < IPHeaderLength + DirectProber::DEFAULT_ICMP_HEADER_LENGTH)
+            return;
+
+        struct icmphdr *icmp = (struct icmphdr*) (buffer + IPHeaderLength);
+        if(icmp->type == DirectProber::ICMP_TYPE_TIME_EXCEEDED || icmp->type == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
+        {
+            ssize_t quotedOffset = IPHeaderLength + DirectProber::DEFAULT_ICMP_HEADER_LENGTH;
+            if(length < quotedOffset + DirectProber::MINIMUM_IP_HEADER_LENGTH + 8)
+                return;
+
+            struct ip *quoted = (struct ip*) (buffer + quotedOffset);
+            if(length < quotedOffset + ((ssize_t) quoted->ip_hl) * 4 + 8 || quoted->ip_src.s_addr != localAddress)
+                return;
+
+            target = quoted->ip_dst.s_addr;
+            tag = ntohs(quoted->ip_id);
+        }
+        else if(icmp->type == DirectProber::ICMP_TYPE_ECHO_REPLY && protocol == ToolEnvironment::PROBING_PROTOCOL_ICMP)
+        {
+            if(ntohs((icmp->un).echo.id) != ICMPidentifier)
+                return;
+
+            target = ip->ip_src.s_addr;
+            tag = ntohs((icmp->un).echo.sequence);
+        }
+        else
+        {
+            return;
+        }
+        sequence = TCPSequence(tag, target);
+    }
+    else if(ip->ip_p == IPPROTO_TCP && protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+    {
+        if(length < IPHeaderLength + DirectProber::MINIMUM_TCP_HEADER_LENGTH)
+            return;
+
+        // A reset acknowledges the sequence number of the probe (+ its length)
+        struct tcphdr *tcp = (struct tcphdr*) (buffer + IPHeaderLength);
+        uint32_t probeLength = 1 + DirectProber::DEFAULT_TCP_RANDOM_DATA_LENGTH + (uint32_t) env->getAttentionMessage().length();
+        target = ip->ip_src.s_addr;
+        sequence = ntohl(tcp->ack_seq) - probeLength;
+        tag = (uint16_t) (sequence >> 16);
+        if(sequence != TCPSequence(tag, target))
+            return;
+    }
+    else
+    {
+        return;
+    }
+
+    map<uint32_t, unsigned int>::iterator it = indexes.find(target);
+    unsigned char TTL = tagTTL(tag);
+    if(it == indexes.end() || TTL > maxTTL)
+        return;
+    Target &t = targets[it->second];
+
+    // Checks the packet and classifies the reply exactly as a prober would
+    ProbeContext c;
+    c.src = &(env->getLocalIPAddress());
+    c.dst = &(t.address);
+    c.IPIdentifier = tag;
+    c.TTL = TTL;
+    c.usingFixedFlowID = true;
+    c.attentionMessage = &(env->getAttentionMessage());
+    c.randomData = NULL;
+    c.timestampRequest = false;
+    c.fixedFlowChecksum = 0;
+    c.originateTs = 0;
+    c.TCPSequence = sequence;
+    c.replyType = 0;
+    c.replyCode = 0;
+    c.payloadTTL = 0;
+    c.receiveTs = 0;
+    c.transmitTs = 0;
+
+    unsigned short payloadLength = 0, replyIPIdentifier = 0;
+    uint8_t replyTTL = 0;
+    InetAddress replyAddress;
+    const char *rejection = NULL;
+    if(protocol == ToolEnvironment::PROBING_PROTOCOL_UDP)
+    {
+        c.srcPortICMPid = srcPort;
+        c.dstPortICMPseq = dstPort;
+        rejection = ProbePipeline<UDPWrappedICMPPolicy>::classify(buffer, length, c, &payloadLength, &replyTTL, &replyIPIdentifier, &replyAddress);
+    }
+    else if(protocol == ToolEnvironment::PROBING_PROTOCOL_TCP)
+    {
+        c.srcPortICMPid = srcPort;
+        c.dstPortICMPseq = dstPort;
+        rejection = ProbePipeline<TCPWrappedICMPPolicy>::classify(buffer, length, c, &payloadLength, &replyTTL, &replyIPIdentifier, &replyAddress);
+    }
+    else
+    {
+        c.srcPortICMPid = ICMPidentifier;
+        c.dstPortICMPseq = tag;
+        rejection = ProbePipeline<ICMPProbePolicy>::classify(buffer, length, c, &payloadLength, &replyTTL, &replyIPIdentifier, &replyAddress);
+    }
+    if(rejection != NULL)
+        return;
+
+    // Late replies (after what would be the second attempt of ParisTracerouteTask) are discarded
+    uint16_t mask = (uint16_t) ((1 << TIMESTAMP_BITS) - 1);
+    uint16_t units = (uint16_t) ((elapsedUnits() - tag) & mask);
+    TimeVal RTT(0, (unsigned long) units * TIMESTAMP_UNIT);
+    if(RTT > t.timeout * 2.0f)
+        return;
+
+    nbSuccessfulProbes++;
+
+    Reply r;
+    r.target = it->second;
+    r.TTL = TTL;
+    r.replyTTL = replyTTL;
+    r.replyType = c.replyType;
+    r.address = replyAddress;
+    replies.push_back(r);
+}
+
+bool StatelessTracerouteEngine::replyOrder(const Reply &r1, const Reply &r2)
+{
+    if(r1.target != r2.target)
+        return r1.target < r2.target;
+    return r1.TTL < r2.TTL;
+}
+
+void StatelessTracerouteEngine::reassemble()
+{
+    // Replies by target then by TTL (the first reply to a given probe is kept)
+    std::stable_sort(replies.begin(), replies.end(), replyOrder);
+
+    unsigned short maxCycles = env->getMaxCycles();
+    bool debugMode = env->debugMode();
+    ostream *out = env->getOutputStream();
+    size_t nextReply = 0;
+    for(unsigned int i = 0; i < (unsigned int) targets.size(); i++)
+    {
+        // Hops of this target (NULL if no reply)
+        Reply *hops[MAX_TTL + 1];
+        for(unsigned short j = 0; j <= MAX_TTL; j++)
+            hops[j] = NULL;
+        for(; nextReply < replies.size() && replies[nextReply].target == i; nextReply++)
+            if(hops[replies[nextReply].TTL] == NULL)
+                hops[replies[nextReply].TTL] = &(replies[nextReply]);
+
+        // Same rules as in ParisTracerouteTask, the gap limit replacing the anonymous hops limit
+        list<InetAddress> routeHops;
+        list<unsigned char> replyTTLs;
+        unsigned short anonymous = 0, cycles = 0;
+        bool reachedDst = false;
+        unsigned char probeTTL = 1;
+        for(; probeTTL <= maxTTL; probeTTL++)
+        {
+            InetAddress rplyAddress(0);
+            unsigned char remainingTTL = 0, rplyType = 255;
+            if(hops[probeTTL] != NULL)
+            {
+                rplyAddress = hops[probeTTL]->address;
+                remainingTTL = hops[probeTTL]->replyTTL;
+                rplyType = hops[probeTTL]->replyType;
+            }
+
+            // Counting consecutive anonymous hops and cycles
+            if(rplyAddress == InetAddress(0))
+            {
+                anonymous++;
+            }
+            else
+            {
+                anonymous = 0;
+                for(list<InetAddress>::iterator it = routeHops.begin(); it != routeHops.end(); ++it)
+                {
+                    if((*it) == rplyAddress)
+                    {
+                        cycles++;
+                        break;
+                    }
+                }
+            }
+
+            // Scenarii where we should stop
+            if(anonymous > gapLimit || cycles > maxCycles)
+                break;
+
+            if(rplyType == DirectProber::ICMP_TYPE_DESTINATION_UNREACHABLE)
+                break;
+
+            if(rplyType == DirectProber::ICMP_TYPE_ECHO_REPLY)
+            {
+                reachedDst = true;
+                break;
+            }
+
+            routeHops.push_back(rplyAddress);
+            replyTTLs.push_back(remainingTTL);
+        }
+
+        string log = "";
+        if(debugMode)
+        {
+            stringstream ss;
+            ss << "Reassembling route to " << targets[i].address << " from ";
+            unsigned short nbReplies = 0;
+            for(unsigned short j = 1; j <= maxTTL; j++)
+                if(hops[j] != NULL)
+                    nbReplies++;
+            ss << nbReplies << " repl" << (nbReplies != 1 ? "ies" : "y") << ".\n";
+            log += ss.str();
+        }
+        log += ParisTracerouteTask::saveRoute(env,
+                                              targets[i].entry,
+                                              routeHops,
+                                              replyTTLs,
+                                              reachedDst,
+                                              probeTTL);
+
+        ToolEnvironment::consoleMessagesMutex.lock();
+        (*out) << log << endl;
+        ToolEnvironment::consoleMessagesMutex.unlock();
+    }
+}
+
+void StatelessTracerouteEngine::stop()
+{
+    ToolEnvironment::emergencyStopMutex.lock();
+    env->triggerStop();
+    ToolEnvironment::emergencyStopMutex.unlock();
+}
@@ -0,0 +1,121 @@
+/*
+ * StatelessTracerouteEngine.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * StatelessTracerouteEngine computes the routes towards a list of targets in the same spirit as
+ * Yarrp (Beverly, "Yarrp'ing the Internet: Randomized High-Speed Active Topology Discovery", IMC
+ * 2016): rather than tracing each target hop after hop (see ParisTracerouteTask), every (target,
+ * TTL) pair up to a maximum TTL is probed exactly once, in a pseudo-random order generated on the
+ * fly (see CyclicPermutation), at the overall rate of the thread pool. Consecutive probes thus go
+ * to different targets and TTLs, which spreads the load over the routers (and therefore reduces
+ * the anomalies caused by ICMP rate-limiting), and no state is kept per probe.
+ *
+ * Replies are self-describing: the target is the destination of the quoted packet (or the source
+ * of the reply when the target replies itself), while the TTL and the send time (in units of
+ * TIMESTAMP_UNIT microseconds, modulo 2^TIMESTAMP_BITS) are encoded in a tag written in the IP
+ * identifier of the probe and, depending on the protocol, in the ICMP sequence number (echo
+ * replies) or in the upper half of the TCP sequence number (resets). The flow identifier stays
+ * fixed for all probes towards a target, as with Paris traceroute. A reply arriving after twice
+ * the timeout (i.e., after the second attempt ParisTracerouteTask would make) is discarded.
+ *
+ * Replies are only logged while probing. Once the last probes had time to be answered, the routes
+ * are reassembled offline with the same rules as ParisTracerouteTask, the maximum amount of
+ * consecutive anonymous hops being replaced by a gap limit applied post hoc. Unlike the other
+ * ways of tracing, probes are sent beyond the end of the routes; this is the price of not keeping
+ * any state while probing.
+ */
+
+#ifndef STATELESSTRACEROUTEENGINE_H_
+#define STATELESSTRACEROUTEENGINE_H_
+
+#include <inttypes.h>
+#include <list>
+using std::list;
+#include <vector>
+using std::vector;
+#include <map>
+using std::map;
+
+#include "../ToolEnvironment.h"
+#include "../../prober/exception/SocketException.h"
+
+class StatelessTracerouteEngine
+{
+public:
+
+    static const unsigned char MAX_TTL = 64; // Same as in ParisTracerouteTask
+    static const unsigned short TIMESTAMP_BITS = 10; // Remaining bits of the tag (TTL - 1 takes 6)
+    static const unsigned int TIMESTAMP_UNIT = 8000; // In microseconds (i.e., wraps after 8.192s)
+    static const size_t BUFFER_SIZE = 2048;
+    static const int RECEIVE_BUFFER_SIZE = 4 * 1024 * 1024; // Requested size of the socket buffers
+    static const int MAX_POLLING_PERIOD = 100; // In ms (to check the emergency stop)
+
+    StatelessTracerouteEngine(ToolEnvironment *env,
+                              unsigned char maxTTL,
+                              unsigned short gapLimit) throw(SocketException);
+    ~StatelessTracerouteEngine();
+
+    // Probes all (target, TTL) pairs then reassembles the routes; returns early upon emergency stop
+    void trace(list<InetAddress> targets);
+
+private:
+
+    // Target (the whole list is kept until the routes are reassembled)
+    struct Target
+    {
+        IPTableEntry *entry;
+        InetAddress address;
+        TimeVal timeout;
+    };
+
+    // Reply logged while probing
+    struct Reply
+    {
+        unsigned int target; // Index in the list of targets
+        unsigned char TTL, replyTTL, replyType;
+        InetAddress address;
+    };
+
+    // Environment and parameters
+    ToolEnvironment *env;
+    unsigned short protocol; // As in ToolEnvironment
+    unsigned char maxTTL;
+    unsigned short gapLimit;
+    uint32_t localAddress; // Network order
+    uint16_t ICMPidentifier, srcPort, dstPort;
+    TimeVal sendInterval, startTime;
+
+    // Sockets
+    int sendSocket, ICMPSocket, TCPSocket;
+
+    // Targets (by index, and indexes by address in network order) and logged replies
+    vector<Target> targets;
+    map<uint32_t, unsigned int> indexes;
+    vector<Reply> replies;
+
+    // Buffers and amounts of probes
+    uint8_t buffer[BUFFER_SIZE], pseudoBuffer[BUFFER_SIZE];
+    unsigned int nbProbes, nbSuccessfulProbes;
+
+    // Private methods
+    void send(unsigned int target, unsigned char TTL);
+    void receiveUntil(TimeVal limit);
+    void receive(int socket);
+    void handleReply(ssize_t length);
+    void reassemble();
+    void stop();
+
+    uint16_t elapsedUnits();
+    inline uint16_t makeTag(unsigned char TTL)
+    {
+        uint16_t mask = (uint16_t) ((1 << TIMESTAMP_BITS) - 1);
+        return (uint16_t) (((uint16_t) (TTL - 1) << TIMESTAMP_BITS) | (elapsedUnits() & mask));
+    }
+    static inline unsigned char tagTTL(uint16_t tag) { return (unsigned char) ((tag >> TIMESTAMP_BITS) + 1); }
+    static inline uint32_t TCPSequence(uint16_t tag, uint32_t target) { return ((uint32_t) tag << 16) | (target & 0xFFFF); }
+    static bool replyOrder(const Reply &r1, const Reply &r2);
+};
+
+#endif /* STATELESSTRACEROUTEENGINE_H_ */
@@ -0,0 +1,100 @@
+/*
+ * TracerouteWorker.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in TracerouteWorker.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include "TracerouteWorker.h"
+#include "ParisTracerouteTask.h"
+#include "../../common/thread/Thread.h"
+
+TracerouteWorker::TracerouteWorker(ToolEnvironment *env,
+                                   Tracerouter *parent,
+                                   unsigned short lowerBoundICMPid,
+                                   unsigned short upperBoundICMPid,
+                                   unsigned short lowerBoundICMPseq,
+                                   unsigned short upperBoundICMPseq)
+{
+    this->env = env;
+    this->parent = parent;
+    this->lowerBoundICMPid = lowerBoundICMPid;
+    this->upperBoundICMPid = upperBoundICMPid;
+    this->lowerBoundICMPseq = lowerBoundICMPseq;
+    this->upperBoundICMPseq = upperBoundICMPseq;
+}
+
+TracerouteWorker::~TracerouteWorker()
+{
+}
+
+void TracerouteWorker::retry(ConcurrencyController *controller, InetAddress target)
+{
+    // Failures go on without any success: resources are most likely not coming back
+    if(controller->givesUp())
+    {
+        ToolEnvironment::emergencyStopMutex.lock();
+        env->triggerStop();
+        ToolEnvironment::emergencyStopMutex.unlock();
+        return;
+    }
+    
+    parent->retryTarget(target);
+    Thread::invokeSleep(controller->getRetryDelay());
+}
+
+void TracerouteWorker::run()
+{
+    ConcurrencyController *controller = env->getConcurrencyController();
+    InetAddress target;
+    while(!env->isStopping() && parent->nextTarget(&target))
+    {
+        if(controller != NULL)
+        {
+            controller->acquire();
+            if(env->isStopping())
+            {
+                controller->release(false);
+                return;
+            }
+        }
+        
+        ParisTracerouteTask *task = NULL;
+        try
+        {
+            task = new ParisTracerouteTask(env,
+                                           target,
+                                           lowerBoundICMPid,
+                                           upperBoundICMPid,
+                                           lowerBoundICMPseq,
+                                           upperBoundICMPseq);
+        }
+        catch(SocketException &se)
+        {
+            // ParisTracerouteTask already triggered the emergency stop, unless adaptive
+            if(controller == NULL)
+                return;
+            
+            controller->release(true);
+            this->retry(controller, target);
+            continue;
+        }
+        
+        task->setReference(parent->getReference(target));
+        task->setFirstOpinion(parent->getFirstOpinion(target));
+
+        task->run();
+        bool failed = task->hasFailed();
+        delete task;
+        
+        if(controller != NULL)
+        {
+            controller->release(failed);
+            if(failed)
+                this->retry(controller, target);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+/*
+ * TracerouteWorker.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * TracerouteWorker is a long-lived thread of the traceroute phase (see Tracerouter). It pulls
+ * targets from the shared queue of its parent and computes the route towards each of them with
+ * a ParisTracerouteTask, until the queue is empty or an emergency stop is triggered. Each worker
+ * keeps its own range of ICMP identifiers/source ports for its whole life, such that concurrent
+ * workers never overlap.
+ *
+ * With the adaptive concurrency, a worker waits for its turn (see ConcurrencyController) before
+ * each target, and gives back a target it could not trace (lack of resources) to its parent, to
+ * be traced again after a delay.
+ */
+
+#ifndef TRACEROUTEWORKER_H_
+#define TRACEROUTEWORKER_H_
+
+#include "Tracerouter.h"
+#include "../../common/thread/Runnable.h"
+
+class TracerouteWorker : public Runnable
+{
+public:
+
+    // Constructor, destructor and run method
+    TracerouteWorker(ToolEnvironment *env,
+                     Tracerouter *parent,
+                     unsigned short lowerBoundICMPid,
+                     unsigned short upperBoundICMPid,
+                     unsigned short lowerBoundICMPseq,
+                     unsigned short upperBoundICMPseq);
+    ~TracerouteWorker();
+    void run();
+
+private:
+
+    // Pointers to the environment and parent
+    ToolEnvironment *env;
+    Tracerouter *parent;
+
+    // Probing parameters
+    unsigned short lowerBoundICMPid, upperBoundICMPid;
+    unsigned short lowerBoundICMPseq, upperBoundICMPseq;
+    
+    // Gives back a target which could not be traced, or triggers the emergency stop
+    void retry(ConcurrencyController *controller, InetAddress target);
+};
+
+#endif /* TRACEROUTEWORKER_H_ */
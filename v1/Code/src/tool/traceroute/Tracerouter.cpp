@@ -0,0 +1,371 @@
+/*
+ * Tracerouter.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in Tracerouter.h (see this file to learn further about the goals
+ * of such class).
+ */
+
+#include <ostream>
+using std::ostream;
+
+#include "Tracerouter.h"
+#include "TracerouteWorker.h"
+#include "AsyncTracerouteEngine.h"
+#include "StatelessTracerouteEngine.h"
+#include "../../common/thread/Thread.h"
+#include "../utils/StopException.h"
+
+Tracerouter::Tracerouter(ToolEnvironment *env):
+targetsMutex(Mutex::ERROR_CHECKING_MUTEX)
+{
+    this->env = env;
+    this->queue = NULL;
+    this->generator = NULL;
+    this->generatorEnded = false;
+    this->lowerBoundICMPid = DirectProber::DEFAULT_LOWER_SRC_PORT_ICMP_ID;
+    this->upperBoundICMPid = DirectProber::DEFAULT_UPPER_SRC_PORT_ICMP_ID;
+}
+
+Tracerouter::~Tracerouter()
+{
+}
+
+void Tracerouter::setICMPidRange(unsigned short lowerBound, unsigned short upperBound)
+{
+    this->lowerBoundICMPid = lowerBound;
+    this->upperBoundICMPid = upperBound;
+}
+
+bool Tracerouter::nextTarget(InetAddress *target)
+{
+    bool retry = false;
+    targetsMutex.lock();
+    if(retries.size() > 0)
+    {
+        *target = retries.front();
+        retries.pop_front();
+        retry = true;
+    }
+    targetsMutex.unlock();
+    if(retry)
+        return true;
+    
+    if(queue != NULL)
+        return queue->pop(target);
+    
+    bool found = false;
+    targetsMutex.lock();
+    if(generator != NULL)
+    {
+        found = generator->next(target);
+        if(!found)
+            generatorEnded = true;
+    }
+    else if(targets.size() > 0)
+    {
+        *target = targets.front();
+        targets.pop_front();
+        found = true;
+    }
+    targetsMutex.unlock();
+    return found;
+}
+
+void Tracerouter::retryTarget(InetAddress target)
+{
+    targetsMutex.lock();
+    retries.push_back(target);
+    targetsMutex.unlock();
+}
+
+Trace *Tracerouter::getReference(InetAddress target)
+{
+    unsigned short prefixLength = env->getSiblingPrefixLength();
+    if(references.size() == 0 || prefixLength == 0)
+        return NULL;
+    
+    map<unsigned long, Trace*>::iterator it = references.find(target.getULongAddress() >> (32 - prefixLength));
+    if(it == references.end())
+        return NULL;
+    return it->second;
+}
+
+Trace *Tracerouter::getFirstOpinion(InetAddress target)
+{
+    map<unsigned long, Trace*>::iterator it = firstOpinions.find(target.getULongAddress());
+    if(it == firstOpinions.end())
+        return NULL;
+    return it->second;
+}
+
+void Tracerouter::probe()
+{
+    // Differential/flow-varied bis traces: first opinions are listed (before any new trace)
+    if(env->collectingBisTraces() && (env->usingDifferentialBisTraces() || env->getBisTraceFlows() > 0))
+    {
+        list<Trace*> *traces = env->getTraces();
+        for(list<Trace*>::iterator it = traces->begin(); it != traces->end(); ++it)
+            if((*it)->getOpinionNumber() == 1)
+                firstOpinions[(*it)->getTargetIP().getULongAddress()] = (*it);
+        
+        try
+        {
+            this->traceQueue();
+        }
+        catch(StopException &e)
+        {
+            firstOpinions.clear();
+            throw;
+        }
+        firstOpinions.clear();
+        return;
+    }
+    
+    unsigned short prefixLength = env->getSiblingPrefixLength();
+    if(prefixLength == 0 || env->collectingBisTraces() || queue != NULL || generator != NULL)
+    {
+        this->traceQueue();
+        return;
+    }
+    
+    // Representatives (first target of each prefix) are traced first
+    map<unsigned long, InetAddress> representatives;
+    list<InetAddress> siblings;
+    list<InetAddress> allTargets = targets;
+    targets.clear();
+    for(list<InetAddress>::iterator it = allTargets.begin(); it != allTargets.end(); ++it)
+    {
+        unsigned long prefix = (*it).getULongAddress() >> (32 - prefixLength);
+        if(representatives.find(prefix) == representatives.end())
+        {
+            representatives.insert(std::pair<unsigned long, InetAddress>(prefix, (*it)));
+            targets.push_back((*it));
+        }
+        else
+        {
+            siblings.push_back((*it));
+        }
+    }
+    
+    this->traceQueue();
+    if(siblings.size() == 0)
+        return;
+    
+    // Gets the traces of the representatives (no trace is being added at this point)
+    list<Trace*> *traces = env->getTraces();
+    for(list<Trace*>::iterator it = traces->begin(); it != traces->end(); ++it)
+    {
+        if((*it)->getOpinionNumber() > 1)
+            continue;
+        
+        InetAddress target = (*it)->getTargetIP();
+        unsigned long prefix = target.getULongAddress() >> (32 - prefixLength);
+        map<unsigned long, InetAddress>::iterator rep = representatives.find(prefix);
+        if(rep != representatives.end() && rep->second == target)
+            references[prefix] = (*it);
+    }
+    
+    ostream *out = env->getOutputStream();
+    (*out) << "Traced " << representatives.size() << " representative target";
+    if(representatives.size() > 1)
+        (*out) << "s";
+    (*out) << ", now tracing their siblings..." << endl;
+    
+    targets = siblings;
+    try
+    {
+        this->traceQueue();
+    }
+    catch(StopException &e)
+    {
+        references.clear();
+        throw;
+    }
+    references.clear();
+}
+
+void Tracerouter::traceQueue()
+{
+    unsigned short maxThreads = env->getMaxThreads();
+    unsigned long nbTargets = (unsigned long) targets.size();
+    if(queue != NULL || generator != NULL)
+        nbTargets = (unsigned long) maxThreads; // Unknown amount, the whole pool is started
+    if(nbTargets == 0)
+    {
+        return;
+    }
+
+    // Stateless engine (every TTL of every target, in a random order) if requested
+    if(env->getStatelessTracerouteMaxTTL() > 0 && queue == NULL && generator == NULL)
+    {
+        StatelessTracerouteEngine *engine = NULL;
+        try
+        {
+            engine = new StatelessTracerouteEngine(env, 
+                                                   env->getStatelessTracerouteMaxTTL(), 
+                                                   env->getStatelessTracerouteGapLimit());
+        }
+        catch(SocketException &se)
+        {
+            ostream *out = env->getOutputStream();
+            (*out) << "Unable to set up the stateless traceroute (" << se.what() << "). ";
+            (*out) << "Routes will be computed with threads." << endl;
+        }
+        
+        if(engine != NULL)
+        {
+            list<InetAddress> toTrace = targets;
+            targets.clear();
+            engine->trace(toTrace);
+            delete engine;
+            
+            if(env->isStopping())
+            {
+                throw StopException();
+            }
+            return;
+        }
+    }
+    
+    // Asynchronous engine (single thread, many targets and TTLs in flight) if requested
+    if(env->getAsyncTracerouteTargets() > 0 && queue == NULL && generator == NULL)
+    {
+        AsyncTracerouteEngine *engine = NULL;
+        try
+        {
+            engine = new AsyncTracerouteEngine(env, 
+                                               env->getAsyncTracerouteTargets(), 
+                                               env->getAsyncTracerouteWindow());
+        }
+        catch(SocketException &se)
+        {
+            ostream *out = env->getOutputStream();
+            (*out) << "Unable to set up the asynchronous traceroute (" << se.what() << "). ";
+            (*out) << "Routes will be computed with threads." << endl;
+        }
+        
+        if(engine != NULL)
+        {
+            list<InetAddress> toTrace = targets;
+            targets.clear();
+            engine->trace(toTrace);
+            delete engine;
+            
+            if(env->isStopping())
+            {
+                throw StopException();
+            }
+            return;
+        }
+    }
+
+    unsigned short nbWorkers = maxThreads;
+    if(nbTargets < (unsigned long) maxThreads)
+        nbWorkers = (unsigned short) nbTargets;
+
+    // Prepares the workers, each with its own range of ICMP identifiers/source ports
+    unsigned short range = (upperBoundICMPid - lowerBoundICMPid) / nbWorkers;
+
+    Thread **th = new Thread*[nbWorkers];
+    for(unsigned short i = 0; i < nbWorkers; i++)
+        th[i] = NULL;
+
+    for(unsigned short i = 0; i < nbWorkers; i++)
+    {
+        unsigned short lowBound = (i * range);
+        unsigned short upBound = lowBound + range - 1;
+
+        Runnable *task = NULL;
+        try
+        {
+            task = new TracerouteWorker(env,
+                                        this,
+                                        lowerBoundICMPid + lowBound,
+                                        lowerBoundICMPid + upBound,
+                                        DirectProber::DEFAULT_LOWER_DST_PORT_ICMP_SEQ,
+                                        DirectProber::DEFAULT_UPPER_DST_PORT_ICMP_SEQ);
+
+            th[i] = new Thread(task);
+        }
+        catch(ThreadException &te)
+        {
+            ostream *out = env->getOutputStream();
+            (*out) << "Unable to create more threads." << endl;
+
+            delete task;
+            
+            // Adaptive concurrency: the workers already created carry out the traceroute
+            ConcurrencyController *controller = env->getConcurrencyController();
+            if(controller != NULL && i > 0)
+            {
+                (*out) << "Going on with " << i << " thread" << (i > 1 ? "s" : "") << "." << endl;
+                controller->capConcurrency(i);
+                nbWorkers = i;
+                break;
+            }
+
+            for(unsigned short k = 0; k < nbWorkers; k++)
+                delete th[k];
+            delete[] th;
+            
+            if(queue != NULL)
+                queue->close();
+
+            throw StopException();
+        }
+    }
+
+    // Bounded ramp-up: the delay between two workers shrinks if the pool is large
+    TimeVal rampUpDelay = env->getProbeThreadDelay();
+    TimeVal maxRampUpDelay = TimeVal(MAX_RAMP_UP_PERIOD, 0) / (float) nbWorkers;
+    if(rampUpDelay > maxRampUpDelay)
+        rampUpDelay = maxRampUpDelay;
+
+    /*
+     * Workers are started in order, stopping early if the queue is already empty (e.g. many
+     * workers for few targets which are quickly traced).
+     */
+
+    unsigned short nbStarted = 0;
+    for(unsigned short i = 0; i < nbWorkers; i++)
+    {
+        th[i]->start();
+        nbStarted++;
+
+        if(i < nbWorkers - 1)
+        {
+            Thread::invokeSleep(rampUpDelay);
+
+            bool emptyQueue = false;
+            targetsMutex.lock();
+            if(generator != NULL)
+                emptyQueue = generatorEnded;
+            else
+                emptyQueue = (targets.size() == 0 && queue == NULL);
+            targetsMutex.unlock();
+            if(emptyQueue || env->isStopping())
+                break;
+        }
+    }
+
+    for(unsigned short i = 0; i < nbWorkers; i++)
+    {
+        if(i < nbStarted)
+            th[i]->join();
+        delete th[i];
+    }
+    delete[] th;
+    
+    // No consumer any more: a pre-scanning waiting for room in the queue must not be stuck
+    if(queue != NULL)
+        queue->close();
+
+    // Might happen because of SocketSendException thrown within a worker
+    if(env->isStopping())
+    {
+        throw StopException();
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * Tracerouter.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Tracerouter schedules the traceroute phase (and each opinion of the second opinion traceroute)
+ * over a fixed pool of long-lived workers (see TracerouteWorker) which pull their next target
+ * from a shared queue until it is empty. This replaces the former scheme where RTrack created
+ * one thread per target in waves of up to maxThreads threads and joined all of them before
+ * starting the next wave: a single target with many anonymous hops no longer keeps the other
+ * slots idle, since each worker moves to the next target as soon as it is done with the current
+ * one.
+ *
+ * Workers are started progressively (the ramp-up), with the probe thread delay between each of
+ * them, as the waves were. However, the whole ramp-up is bounded (see MAX_RAMP_UP_PERIOD) so a
+ * large pool starts in a reasonable amount of time. Once started, workers stay desynchronized on
+ * their own, because targets take different amounts of time to trace.
+ *
+ * If the asynchronous traceroute is enabled, the whole list of targets is rather given to an
+ * AsyncTracerouteEngine, which traces them from the calling thread (workers are only used if the
+ * engine cannot be set up). The same goes for the stateless traceroute (see
+ * StatelessTracerouteEngine), which takes precedence.
+ *
+ * If sibling targets are used (see the prefix length in ToolEnvironment), the targets are first
+ * grouped by prefix. The first target of each prefix (its representative) is traced as usual,
+ * then the other targets (its siblings) are traced starting a few hops before the end of the
+ * route of their representative (see ParisTracerouteTask).
+ *
+ * With differential bis traces, the first opinion of each target is kept aside while collecting
+ * the bis traces, such that each bis trace only re-probes the hops around its anomalies. The same
+ * goes for flow-varied bis traces, where these hops are re-probed with several flows.
+ *
+ * Finally, the workers can consume a bounded TargetQueue fed by a pre-scanning running at the
+ * same time (see PrescanningPipeline) instead of a list known in advance. The whole pool is then
+ * started, and each worker waits for a new target until the queue is closed. The workers use
+ * their own range of ICMP identifiers, apart from the one of the pre-scanning.
+ *
+ * The targets can also be drawn one at a time from a TargetGenerator (e.g. with a filter keeping
+ * the responsive targets), which replaces the list of targets: the amount of targets is then not
+ * known in advance, so the whole pool is started, as with a queue. The asynchronous and stateless
+ * engines and the sibling targets need the list of targets, hence they are not used with it.
+ *
+ * With the adaptive concurrency (see ConcurrencyController), the pool is started as usual but the
+ * amount of workers tracing at the same time follows the controller, and the targets which could
+ * not be traced for a lack of resources come back in a separate list, which is emptied first. A
+ * thread which cannot be created only caps the concurrency to the workers already created.
+ */
+
+#ifndef TRACEROUTER_H_
+#define TRACEROUTER_H_
+
+#include <list>
+using std::list;
+#include <map>
+using std::map;
+
+#include "../ToolEnvironment.h"
+#include "../structure/TargetQueue.h"
+#include "../utils/TargetGenerator.h"
+#include "../../common/thread/Mutex.h"
+
+class Tracerouter
+{
+public:
+
+    // Upper bound (in seconds) on the time spent starting all the workers
+    const static unsigned short MAX_RAMP_UP_PERIOD = 5;
+
+    // Constructor, destructor
+    Tracerouter(ToolEnvironment *env);
+    ~Tracerouter();
+
+    // Sets the targets to trace (the queue is consumed by probe())
+    inline void setTargets(list<InetAddress> targets) { this->targets = targets; }
+    
+    // Sets a queue fed while the workers run (pipelining), which replaces the list of targets
+    inline void setTargetQueue(TargetQueue *queue) { this->queue = queue; }
+    void setICMPidRange(unsigned short lowerBound, unsigned short upperBound);
+    
+    // Sets a generator giving the targets to trace, which replaces the list (not owned)
+    inline void setTargetGenerator(TargetGenerator *generator) { this->generator = generator; }
+
+    // Method used by the workers to get their next target; returns false once the queue is empty
+    bool nextTarget(InetAddress *target);
+    
+    // Gives back a target which could not be traced (adaptive concurrency), traced before the others
+    void retryTarget(InetAddress target);
+    
+    // Trace of the representative of a sibling target (NULL if none)
+    Trace *getReference(InetAddress target);
+    
+    // First opinion of a target (differential/flow-varied bis traces only, NULL otherwise)
+    Trace *getFirstOpinion(InetAddress target);
+
+    // Computes the routes towards all targets; throws StopException upon emergency stop
+    void probe();
+
+private:
+
+    // Pointer to the environment
+    ToolEnvironment *env;
+
+    // Shared queue of targets and its mutex
+    list<InetAddress> targets;
+    Mutex targetsMutex;
+    
+    // Targets to trace again, given back by the workers (lack of resources)
+    list<InetAddress> retries;
+    
+    // Queue fed by a pre-scanning running at the same time (NULL otherwise)
+    TargetQueue *queue;
+    
+    // Generator giving the targets (NULL otherwise), protected by targetsMutex
+    TargetGenerator *generator;
+    bool generatorEnded;
+    
+    // Range of ICMP identifiers/source ports shared by the workers
+    unsigned short lowerBoundICMPid, upperBoundICMPid;
+    
+    // Traces of the representative targets, by prefix (read-only while siblings are traced)
+    map<unsigned long, Trace*> references;
+    
+    // First opinions, by target (differential/flow-varied bis traces only)
+    map<unsigned long, Trace*> firstOpinions;
+    
+    // Computes the routes towards the targets of the queue
+    void traceQueue();
+};
+
+#endif /* TRACEROUTER_H_ */
@@ -0,0 +1,317 @@
+/*
+ * CheckpointJournal.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in CheckpointJournal.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <cstdlib>
+#include <sstream>
+using std::stringstream;
+#include <fstream>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "CheckpointJournal.h"
+#include "../../common/inet/InetAddressException.h"
+
+CheckpointJournal::CheckpointJournal(string filename):
+journalMutex(Mutex::ERROR_CHECKING_MUTEX)
+{
+    this->filename = filename;
+    this->fd = -1;
+    this->synchronized = true;
+    this->missingLineBreak = false;
+    this->nbPending = 0;
+    this->lastSync = *(TimeVal::getCurrentSystemTime());
+    this->nbLoadedTargets = 0;
+    this->nbLoadedTraces = 0;
+}
+
+CheckpointJournal::CheckpointJournal(int descriptor):
+journalMutex(Mutex::ERROR_CHECKING_MUTEX)
+{
+    this->filename = "";
+    this->fd = descriptor;
+    this->synchronized = false;
+    this->missingLineBreak = false;
+    this->nbPending = 0;
+    this->lastSync = *(TimeVal::getCurrentSystemTime());
+    this->nbLoadedTargets = 0;
+    this->nbLoadedTraces = 0;
+}
+
+CheckpointJournal::~CheckpointJournal()
+{
+    this->sync();
+    if(fd >= 0)
+        close(fd);
+}
+
+bool CheckpointJournal::load(IPLookUpTable *table, list<Trace*> *traces)
+{
+    std::ifstream journalFile;
+    journalFile.open(filename.c_str());
+    if(!journalFile.is_open())
+        return false;
+
+    string content = "";
+    content.assign((std::istreambuf_iterator<char>(journalFile)), (std::istreambuf_iterator<char>()));
+    journalFile.close();
+
+    // Drops a last record which was not fully written
+    if(content.size() > 0 && content[content.size() - 1] != '\n')
+    {
+        missingLineBreak = true;
+        size_t lastBreak = content.rfind('\n');
+        if(lastBreak == string::npos)
+            content = "";
+        else
+            content = content.substr(0, lastBreak + 1);
+    }
+
+    stringstream ss(content);
+    string line;
+    while(std::getline(ss, line))
+        this->parseRecord(line, table, traces);
+    return true;
+}
+
+bool CheckpointJournal::parseRecord(string &line, IPLookUpTable *table, list<Trace*> *traces)
+{
+    if(line.size() < 3 || line[1] != ' ')
+        return false;
+
+    switch(line[0])
+    {
+        case 'P':
+            if(!this->parseTarget(line, table))
+                return false;
+            nbLoadedTargets++;
+            return true;
+        case 'T':
+            if(!this->parseTrace(line, table, traces))
+                return false;
+            nbLoadedTraces++;
+            return true;
+        case 'E':
+            endedPhases.insert(line.substr(2));
+            return false;
+        default:
+            return false;
+    }
+}
+
+bool CheckpointJournal::open(bool truncate)
+{
+    int flags = O_WRONLY | O_CREAT | O_APPEND;
+    if(truncate)
+    {
+        flags |= O_TRUNC;
+        missingLineBreak = false;
+    }
+    fd = ::open(filename.c_str(), flags, 0644);
+    if(fd < 0)
+        return false;
+
+    // Terminates a partially written record, so that it does not corrupt the next one
+    if(missingLineBreak)
+    {
+        journalMutex.lock();
+        this->append("");
+        journalMutex.unlock();
+    }
+    return true;
+}
+
+void CheckpointJournal::recordResponsiveTarget(IPTableEntry *target)
+{
+    TimeVal timeout = target->getPreferredTimeout();
+    stringstream record;
+    record << "P " << (InetAddress) (*target) << " " << timeout.getSecondsPart() << " ";
+    record << timeout.getMicroSecondsPart() << " " << (unsigned short) target->getEstimatedTTL();
+
+    journalMutex.lock();
+    this->append(record.str());
+    journalMutex.unlock();
+}
+
+void CheckpointJournal::recordTrace(Trace *trace, unsigned char targetTTL)
+{
+    unsigned short routeSize = trace->getRouteSize();
+    RouteInterface *route = trace->getRoute();
+    if(route == NULL)
+        routeSize = 0;
+
+    stringstream record;
+    record << "T " << trace->getTargetIP() << " " << trace->getOpinionNumber() << " ";
+    record << (trace->isTargetReachable() ? (unsigned short) targetTTL : 0) << " " << routeSize;
+    for(unsigned short i = 0; i < routeSize; i++)
+    {
+        record << " " << route[i].ip << "," << route[i].state << ",";
+        record << (unsigned short) route[i].iTTL;
+    }
+
+    journalMutex.lock();
+    this->append(record.str());
+    journalMutex.unlock();
+}
+
+void CheckpointJournal::recordPhaseEnd(string phase)
+{
+    journalMutex.lock();
+    this->append("E " + phase);
+    this->flush();
+    journalMutex.unlock();
+}
+
+void CheckpointJournal::record(string line)
+{
+    journalMutex.lock();
+    this->append(line);
+    journalMutex.unlock();
+}
+
+void CheckpointJournal::sync()
+{
+    journalMutex.lock();
+    this->flush();
+    journalMutex.unlock();
+}
+
+bool CheckpointJournal::hasEnded(string phase)
+{
+    return endedPhases.find(phase) != endedPhases.end();
+}
+
+list<InetAddress> CheckpointJournal::filterTraced(list<InetAddress> targets, unsigned short opinion)
+{
+    map<unsigned short, set<unsigned long> >::iterator found = traced.find(opinion);
+    if(found == traced.end())
+        return targets;
+
+    list<InetAddress> remaining;
+    for(list<InetAddress>::iterator it = targets.begin(); it != targets.end(); ++it)
+        if(found->second.find(it->getULongAddress()) == found->second.end())
+            remaining.push_back((*it));
+    return remaining;
+}
+
+void CheckpointJournal::append(string record)
+{
+    if(fd < 0)
+        return;
+
+    pending += record + "\n";
+    nbPending++;
+
+    TimeVal now = *(TimeVal::getCurrentSystemTime());
+    if(nbPending >= SYNC_BATCH || now - lastSync >= TimeVal(SYNC_PERIOD, 0))
+        this->flush();
+}
+
+void CheckpointJournal::flush()
+{
+    lastSync = *(TimeVal::getCurrentSystemTime());
+    if(fd < 0 || pending.size() == 0)
+        return;
+
+    const char *data = pending.c_str();
+    size_t toWrite = pending.size();
+    while(toWrite > 0)
+    {
+        ssize_t written = write(fd, data, toWrite);
+        if(written < 0)
+            break; // Records are lost, but probing goes on
+        data += written;
+        toWrite -= (size_t) written;
+    }
+    if(synchronized)
+        fsync(fd);
+
+    pending.clear();
+    nbPending = 0;
+}
+
+bool CheckpointJournal::parseTarget(string &line, IPLookUpTable *table)
+{
+    stringstream ss(line.substr(2));
+    string IPStr;
+    long seconds = 0, microSeconds = 0;
+    unsigned short estimatedTTL = 0;
+    if(!(ss >> IPStr >> seconds >> microSeconds >> estimatedTTL))
+        return false;
+
+    try
+    {
+        InetAddress IP(IPStr);
+        IPTableEntry *entry = table->lookUp(IP);
+        if(entry == NULL)
+            entry = table->create(IP);
+        entry->setPreferredTimeout(TimeVal(seconds, microSeconds));
+        entry->setEstimatedTTL((unsigned char) estimatedTTL);
+    }
+    catch(InetAddressException &e)
+    {
+        return false;
+    }
+    return true;
+}
+
+bool CheckpointJournal::parseTrace(string &line, IPLookUpTable *table, list<Trace*> *traces)
+{
+    stringstream ss(line.substr(2));
+    string targetStr;
+    unsigned short opinion = 0, targetTTL = 0, routeSize = 0;
+    if(!(ss >> targetStr >> opinion >> targetTTL >> routeSize))
+        return false;
+
+    RouteInterface *route = NULL;
+    if(routeSize > 0)
+        route = new RouteInterface[routeSize];
+    try
+    {
+        InetAddress target(targetStr);
+        for(unsigned short i = 0; i < routeSize; i++)
+        {
+            string hopStr;
+            if(!(ss >> hopStr))
+                throw InetAddressException("Truncated route");
+
+            size_t first = hopStr.find(','), second = hopStr.rfind(',');
+            if(first == string::npos || second == first)
+                throw InetAddressException("Malformed hop");
+
+            route[i].ip.setInetAddress(hopStr.substr(0, first));
+            route[i].state = (unsigned short) std::atoi(hopStr.substr(first + 1, second - first - 1).c_str());
+            route[i].iTTL = (unsigned char) std::atoi(hopStr.substr(second + 1).c_str());
+        }
+
+        // The target entry is created as the traceroute would (with its distance if reached)
+        IPTableEntry *entry = table->lookUp(target);
+        if(entry == NULL)
+            entry = table->create(target);
+
+        Trace *trace = new Trace(target);
+        trace->setOpinionNumber(opinion);
+        if(targetTTL > 0)
+        {
+            trace->setTargetAsReachable();
+            entry->setTTL((unsigned char) targetTTL);
+        }
+        trace->setRouteSize(routeSize);
+        trace->setRoute(route);
+        traces->push_back(trace);
+        traced[opinion].insert(target.getULongAddress());
+    }
+    catch(InetAddressException &e)
+    {
+        if(route != NULL)
+            delete[] route;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,113 @@
+/*
+ * CheckpointJournal.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * CheckpointJournal is an append-only journal of the results of a campaign, written as they are
+ * obtained, so that a campaign which was interrupted (crash, emergency stop, reboot...) can be
+ * resumed instead of being restarted from scratch. It records, one line per record:
+ * -each responsive target found during pre-scanning ("P [IP] [timeout s] [timeout us] [distance]"),
+ * -each trace, with its opinion number, the distance of its target (0 if it was not reached) and
+ *  each hop as [IP],[state],[initial TTL] ("T [target] [opinion] [TTL] [route size] [hops]"),
+ * -the end of each probing phase ("E [phase]").
+ *
+ * Records are buffered and the buffer is written then synchronized to disk (fsync()) every
+ * SYNC_BATCH records, every SYNC_PERIOD seconds and at the end of each phase, so that the cost of
+ * the journal remains negligible while losing at most a few seconds of work upon a crash. A last
+ * record which was only partially written is ignored when the journal is loaded.
+ *
+ * Upon resuming, load() re-creates the entries of the IP dictionnary and the traces, then the
+ * completed phases are skipped and the other phases only probe the targets which are missing from
+ * the journal. Phases which do not probe targets one by one (route analysis, fingerprinting,
+ * rate-limit analysis) are not journaled and are simply run again.
+ *
+ * The same records are used by the workers of a sharded campaign to stream their results to the
+ * coordinator (see ShardConnection); in this case, the journal writes to the connection and is
+ * not synchronized to disk.
+ */
+
+#ifndef CHECKPOINTJOURNAL_H_
+#define CHECKPOINTJOURNAL_H_
+
+#include <string>
+using std::string;
+#include <list>
+using std::list;
+#include <set>
+using std::set;
+#include <map>
+using std::map;
+
+#include "../../common/thread/Mutex.h"
+#include "../../common/date/TimeVal.h"
+#include "../structure/IPLookUpTable.h"
+#include "../structure/Trace.h"
+
+class CheckpointJournal
+{
+public:
+
+    static const unsigned int SYNC_BATCH = 512; // Records
+    static const long SYNC_PERIOD = 2; // Seconds
+
+    // Constructors (nothing is read or written yet), destructor (synchronizes pending records)
+    CheckpointJournal(string filename);
+    CheckpointJournal(int descriptor); // Streams to an open descriptor, which it then owns
+    ~CheckpointJournal();
+
+    /*
+     * Reads the journal (if it exists) to re-create the responsive targets in the IP dictionnary
+     * and the traces (appended to the list); returns false if the file could not be read.
+     */
+
+    bool load(IPLookUpTable *table, list<Trace*> *traces);
+
+    // Opens the journal in append mode (emptied first if truncate is true); false upon failure
+    bool open(bool truncate);
+
+    // Methods to record results (thread-safe)
+    void recordResponsiveTarget(IPTableEntry *target);
+    void recordTrace(Trace *trace, unsigned char targetTTL);
+    void recordPhaseEnd(string phase); // Also synchronizes the journal
+    void record(string line); // Any record, already formatted
+
+    // Writes and synchronizes pending records
+    void sync();
+
+    // Parses a single record (as load() does); returns false if it is not a target or a trace
+    bool parseRecord(string &line, IPLookUpTable *table, list<Trace*> *traces);
+
+    // Methods to use the loaded records
+    bool hasEnded(string phase);
+    list<InetAddress> filterTraced(list<InetAddress> targets, unsigned short opinion);
+    inline string getFilename() { return this->filename; }
+    inline unsigned int getNbLoadedTargets() { return this->nbLoadedTargets; }
+    inline unsigned int getNbLoadedTraces() { return this->nbLoadedTraces; }
+
+private:
+
+    string filename;
+    int fd; // -1 if not opened
+    bool synchronized; // False when streaming to a connection
+    bool missingLineBreak; // True if the journal ends with a partially written record
+
+    // Pending records
+    Mutex journalMutex;
+    string pending;
+    unsigned int nbPending;
+    TimeVal lastSync;
+
+    // Loaded records
+    set<string> endedPhases;
+    map<unsigned short, set<unsigned long> > traced; // Traced targets, by opinion number
+    unsigned int nbLoadedTargets, nbLoadedTraces;
+
+    // Private methods
+    void append(string record); // Mutex must be locked
+    void flush(); // Mutex must be locked
+    bool parseTarget(string &line, IPLookUpTable *table);
+    bool parseTrace(string &line, IPLookUpTable *table, list<Trace*> *traces);
+};
+
+#endif /* CHECKPOINTJOURNAL_H_ */
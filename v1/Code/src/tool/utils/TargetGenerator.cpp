@@ -0,0 +1,119 @@
+/*
+ * TargetGenerator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * Implements the class defined in TargetGenerator.h (see this file to learn further about the
+ * goals of such class).
+ */
+
+#include <algorithm>
+#include <sstream>
+
+#include "TargetGenerator.h"
+
+TargetGenerator::TargetGenerator(list<InetAddress> &IPs,
+                                 list<NetworkAddress> &blocks,
+                                 NetworkAddress &LAN,
+                                 uint32_t seed) throw (InetAddressException)
+{
+    uint64_t spaceSize = getSpaceSize(IPs, blocks);
+    if(spaceSize > (uint64_t) CyclicPermutation::MAX_SIZE)
+    {
+        std::stringstream ss;
+        ss << "Target space of " << spaceSize << " IPs exceeds the maximum of ";
+        ss << CyclicPermutation::MAX_SIZE << " IPs";
+        throw InetAddressException(ss.str());
+    }
+
+    this->IPs.assign(IPs.begin(), IPs.end());
+
+    // Blocks are given by their prefix and their size (not with their upper border)
+    uint64_t blockEnd = (uint64_t) this->IPs.size();
+    for(list<NetworkAddress>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+    {
+        unsigned char prefixLength = it->getPrefixLength();
+        if(prefixLength > 32)
+            continue;
+
+        uint64_t blockSize = (uint64_t) 1 << (32 - prefixLength);
+        uint32_t prefix = (uint32_t) it->getLowerBorderAddress().getULongAddress();
+        prefix &= ~((uint32_t) (blockSize - 1));
+
+        blockEnd += blockSize;
+        blockPrefixes.push_back(prefix);
+        blockEnds.push_back(blockEnd);
+    }
+
+    unsigned char LANPrefixLength = LAN.getPrefixLength();
+    if(LANPrefixLength > 32)
+        LANPrefixLength = 32;
+    uint64_t LANSize = (uint64_t) 1 << (32 - LANPrefixLength);
+    LANLowerBorder = (uint32_t) LAN.getLowerBorderAddress().getULongAddress();
+    LANLowerBorder &= ~((uint32_t) (LANSize - 1));
+    LANUpperBorder = (uint32_t) (LANLowerBorder + LANSize - 1);
+
+    permutation = new CyclicPermutation((uint32_t) spaceSize, seed);
+    filter = FILTER_NONE;
+    table = NULL;
+}
+
+TargetGenerator::~TargetGenerator()
+{
+    delete permutation;
+}
+
+uint64_t TargetGenerator::getSpaceSize(list<InetAddress> &IPs, list<NetworkAddress> &blocks)
+{
+    uint64_t spaceSize = (uint64_t) IPs.size();
+    for(list<NetworkAddress>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+    {
+        unsigned char prefixLength = it->getPrefixLength();
+        if(prefixLength <= 32)
+            spaceSize += (uint64_t) 1 << (32 - prefixLength);
+    }
+    return spaceSize;
+}
+
+void TargetGenerator::setFilter(unsigned short filter, IPLookUpTable *table)
+{
+    this->filter = filter;
+    this->table = table;
+    if(table == NULL)
+        this->filter = FILTER_NONE;
+}
+
+bool TargetGenerator::next(InetAddress *target)
+{
+    uint32_t index = 0;
+    while(permutation->next(&index))
+    {
+        uint32_t IP = 0;
+        if((size_t) index < IPs.size())
+        {
+            IP = (uint32_t) IPs[index].getULongAddress();
+        }
+        else
+        {
+            // First block ending after this index
+            vector<uint64_t>::iterator end = std::upper_bound(blockEnds.begin(), blockEnds.end(), (uint64_t) index);
+            size_t block = (size_t) (end - blockEnds.begin());
+            uint64_t blockStart = (block == 0) ? (uint64_t) IPs.size() : blockEnds[block - 1];
+            IP = blockPrefixes[block] + (uint32_t) ((uint64_t) index - blockStart);
+        }
+
+        if(IP >= LANLowerBorder && IP <= LANUpperBorder)
+            continue;
+
+        *target = InetAddress((unsigned long int) IP);
+        if(filter != FILTER_NONE)
+        {
+            bool responsive = (table->lookUp(*target) != NULL);
+            if(responsive != (filter == FILTER_RESPONSIVE))
+                continue;
+        }
+        return true;
+    }
+    return false;
+}
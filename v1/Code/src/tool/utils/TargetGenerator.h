@@ -0,0 +1,88 @@
+/*
+ * TargetGenerator.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jefgrailet
+ *
+ * TargetGenerator gives the targets parsed by TargetParser (single IPs and IP blocks) one at a
+ * time, in a pseudo-random order, without listing them first. The target space is seen as the
+ * single IPs followed by the IPs of each block, and a CyclicPermutation over the indexes of this
+ * space decides the order: an index is turned into an IP by finding the block it falls in, so the
+ * memory used does not depend on the amount of targets. IPs of the LAN of the vantage point are
+ * skipped, and so are, if asked, the targets which are (or are not) in the IP dictionnary, i.e.,
+ * which were (or were not) found responsive by the pre-scanning.
+ *
+ * The pre-scanning (through a TargetDispenser) and the traceroute (see Tracerouter) take their
+ * targets directly from a generator when no other step needs the complete list of targets (see
+ * Main.cpp); otherwise, TargetParser lists the targets in the order of a generator.
+ *
+ * Consecutive targets are therefore spread across prefixes (consecutive IPs are rarely probed at
+ * the same time), which replaces the former re-ordering of a fully built list of targets. The
+ * order only depends on the seed, so a campaign can be run again with the same order.
+ *
+ * The target space cannot exceed CyclicPermutation::MAX_SIZE IPs: TargetParser reports a larger
+ * space (see getSpaceSize()) before any generator is created, and the constructor throws an
+ * InetAddressException if it is given such a space anyway.
+ */
+
+#ifndef TARGETGENERATOR_H_
+#define TARGETGENERATOR_H_
+
+#include <inttypes.h>
+#include <list>
+using std::list;
+#include <vector>
+using std::vector;
+
+#include "../../common/inet/InetAddress.h"
+#include "../../common/inet/NetworkAddress.h"
+#include "../../common/inet/InetAddressException.h"
+#include "../../common/random/CyclicPermutation.h"
+#include "../structure/IPLookUpTable.h"
+
+class TargetGenerator
+{
+public:
+
+    // Filters (targets in the IP dictionnary are the ones found responsive by the pre-scanning)
+    const static unsigned short FILTER_NONE = 0; // Default
+    const static unsigned short FILTER_RESPONSIVE = 1;
+    const static unsigned short FILTER_UNRESPONSIVE = 2;
+
+    // Constructor (throws an InetAddressException if the space exceeds MAX_SIZE), destructor
+    TargetGenerator(list<InetAddress> &IPs,
+                    list<NetworkAddress> &blocks,
+                    NetworkAddress &LAN,
+                    uint32_t seed) throw (InetAddressException);
+    ~TargetGenerator();
+
+    // Size of the target space (LAN included), which may exceed CyclicPermutation::MAX_SIZE
+    static uint64_t getSpaceSize(list<InetAddress> &IPs, list<NetworkAddress> &blocks);
+
+    // Skips the targets which are (not) in the given IP dictionnary (see above)
+    void setFilter(unsigned short filter, IPLookUpTable *table);
+
+    // Writes the next target and returns true, or returns false once all targets were given
+    bool next(InetAddress *target);
+
+    // Starts the same order again
+    inline void rewind() { this->permutation->rewind(); }
+
+    inline uint32_t getSpaceSize() { return this->permutation->getSize(); }
+
+    // Upper bound on the amount of targets left (the skipped IPs are not known in advance)
+    inline uint32_t getNbRemaining() { return this->permutation->getSize() - this->permutation->getNbGiven(); }
+
+private:
+
+    vector<InetAddress> IPs;
+    vector<uint32_t> blockPrefixes;
+    vector<uint64_t> blockEnds; // Index (in the target space) following the last IP of each block
+    uint32_t LANLowerBorder, LANUpperBorder;
+    CyclicPermutation *permutation;
+
+    unsigned short filter;
+    IPLookUpTable *table;
+};
+
+#endif /* TARGETGENERATOR_H_ */
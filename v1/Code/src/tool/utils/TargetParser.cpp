@@ -8,16 +8,17 @@
  */
 
 #include <cstdlib>
-#include <algorithm>
+#include <ctime>
 #include <sstream>
-#include <vector>
 #include <fstream>
+#include <unistd.h>
 
 #include "TargetParser.h"
 
 TargetParser::TargetParser(ToolEnvironment *env)
 {
     this->env = env;
+    this->seed = (uint32_t) time(NULL) ^ ((uint32_t) getpid() << 16);
 }
 
 TargetParser::~TargetParser()
@@ -113,107 +114,45 @@ void TargetParser::parseCommandLine(string targetListStr)
     parse(plainTargetsStr, ',');
 }
 
-list<InetAddress> TargetParser::reorder(list<InetAddress> toReorder)
+void TargetParser::parseShard(string shard)
 {
-    unsigned long nbTargets = (unsigned long) toReorder.size();
-    unsigned short maxThreads = env->getMaxThreads();
-    list<InetAddress> reordered;
-    
-    // If there are more targets than the amount of threads which will be used
-    if(nbTargets > (unsigned long) maxThreads)
-    {
-        /*
-         * TARGET REORDERING
-         *
-         * As targets are usually given in order, probing consecutive targets may be 
-         * inefficient as targetted interfaces may not be as responsive if multiple 
-         * threads probe them at the same time (because of the traffic generated at a 
-         * time), making inference results less complete and accurate. To avoid this, the 
-         * list of targets is re-organized to avoid consecutive IPs as much as possible.
-         */
-        
-        list<InetAddress>::iterator it = toReorder.begin();
-        for(unsigned long i = 0; i < nbTargets; i++)
-        {
-            reordered.push_back((*it));
-            toReorder.erase(it--);
+    parse(shard, '\n');
+}
 
-            for(unsigned short j = 0; j < maxThreads; j++)
-            {
-                it++;
-                if(it == toReorder.end())
-                    it = toReorder.begin();
-            }
-        }
-    }
-    else
-    {
-        // In this case, we will just shuffle the list.
-        std::vector<InetAddress> targetsV(toReorder.size());
-        std::copy(toReorder.begin(), toReorder.end(), targetsV.begin());
-        std::random_shuffle(targetsV.begin(), targetsV.end());
-        std::list<InetAddress> shuffledTargets(targetsV.begin(), targetsV.end());
-        reordered = shuffledTargets;
-    }
-    
-    return reordered;
+uint64_t TargetParser::getSpaceSize()
+{
+    return TargetGenerator::getSpaceSize(parsedIPs, parsedIPBlocks);
 }
 
-list<InetAddress> TargetParser::getInitialTargets()
+TargetGenerator *TargetParser::createGenerator()
 {
     NetworkAddress LAN = env->getLAN();
-    InetAddress LANLowerBorder = LAN.getLowerBorderAddress();
-    InetAddress LANUpperBorder = LAN.getUpperBorderAddress();
+    return new TargetGenerator(parsedIPs, parsedIPBlocks, LAN, seed);
+}
+
+list<InetAddress> TargetParser::getInitialTargets()
+{
     list<InetAddress> targets;
-    
-    for(std::list<InetAddress>::iterator it = parsedIPs.begin(); it != parsedIPs.end(); ++it)
-    {
-        InetAddress target((*it));
-        
-        if(target >= LANLowerBorder && target <= LANUpperBorder)
-            continue;
-        
+    TargetGenerator *generator = this->createGenerator();
+    InetAddress target;
+    while(generator->next(&target))
         targets.push_back(target);
-    }
-    
-    for(std::list<NetworkAddress>::iterator it = parsedIPBlocks.begin(); it != parsedIPBlocks.end(); ++it)
-    {
-        NetworkAddress cur = (*it);
-        
-        InetAddress lowerBorder = cur.getLowerBorderAddress();
-        InetAddress upperBorder = cur.getUpperBorderAddress();
-
-        for(InetAddress cur2 = lowerBorder; cur2 <= upperBorder; cur2++)
-        {
-            if(cur2 >= LANLowerBorder && cur2 <= LANUpperBorder)
-                continue;
-            
-            targets.push_back(cur2);
-        }
-    }
-
-    return reorder(targets);
+    delete generator;
+    return targets;
 }
 
 list<InetAddress> TargetParser::getResponsiveTargets()
 {
-    // Starting with all the initial targets, all unresponsive targets are filtered out
-    list<InetAddress> initial = this->getInitialTargets();
+    // Initial targets (in the same order), without the unresponsive ones
     list<InetAddress> targets;
-    
     IPLookUpTable *table = env->getIPTable();
-    
-    for(std::list<InetAddress>::iterator it = initial.begin(); it != initial.end(); ++it)
-    {
-        InetAddress cur = (*it);
-        
-        if(table->lookUp(cur) != NULL)
-        {
-            targets.push_back(cur);
-        }
-    }
-    
-    return reorder(targets);
+    TargetGenerator *generator = this->createGenerator();
+    generator->setFilter(TargetGenerator::FILTER_RESPONSIVE, table);
+    InetAddress target;
+    while(generator->next(&target))
+        targets.push_back(target);
+    delete generator;
+    return targets;
 }
 
 bool TargetParser::targetsEncompassLAN()
@@ -228,16 +167,8 @@ bool TargetParser::targetsEncompassLAN()
     
     for(std::list<NetworkAddress>::iterator it = parsedIPBlocks.begin(); it != parsedIPBlocks.end(); ++it)
     {
-        NetworkAddress cur = (*it);
-        
-        InetAddress lowerBorder = cur.getLowerBorderAddress();
-        InetAddress upperBorder = cur.getUpperBorderAddress();
-
-        for(InetAddress cur = lowerBorder; cur <= upperBorder; cur++)
-        {
-            if(cur == localIP)
-                return true;
-        }
+        if(it->subsumes(localIP))
+            return true;
     }
     
     return false;
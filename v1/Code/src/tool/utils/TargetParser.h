@@ -9,6 +9,12 @@
  * the listing of pre-scan targets in addition to the usual targets led to the creation of this 
  * class. In addition to parsing, this class also handles the target re-ordering.
  *
+ * Oct 19, 2026: the targets are now given in the order of a TargetGenerator (a seeded cyclic 
+ * permutation of the target space), rather than by re-ordering the complete list of targets, 
+ * which took a time proportional to the amount of targets times the amount of threads. The 
+ * pre-scanning and the traceroute can also take the targets directly from a generator, without 
+ * listing them (see createGenerator()).
+ *
  * This class, in WIP Traceroute, is re-used almost in the same way as in TreeNET, except that a 
  * few things have been simplified because unneeded for WIP Traceroute, or renamed to fit better.
  */
@@ -25,6 +31,7 @@ using std::list;
 
 #include "../ToolEnvironment.h"
 #include "../../common/inet/NetworkAddress.h"
+#include "TargetGenerator.h"
 
 class TargetParser
 {
@@ -42,11 +49,16 @@ public:
      */
     
     void parseCommandLine(string targetListStr);
+    void parseShard(string shard); // Targets dispatched by a coordinator, one per line
     
     // Accessers to parsed elements
     inline list<InetAddress> getParsedIPs() { return this->parsedIPs; }
     inline list<NetworkAddress> getParsedIPBlocks() { return this->parsedIPBlocks; }
     
+    // Seed of the order of the targets (drawn at construction, unless set)
+    inline void setSeed(uint32_t seed) { this->seed = seed; }
+    inline uint32_t getSeed() { return this->seed; }
+    
     /*
      * Methods to obtain targets. First one returns the (re-ordered) initial target IPs, either 
      * directly fed to the traceroute part, either fed to a pre-scanning phase (much like 
@@ -59,6 +71,15 @@ public:
     list<InetAddress> getInitialTargets();
     list<InetAddress> getResponsiveTargets();
     
+    /*
+     * Gives the initial targets one at a time, in the same order as the lists above, without 
+     * listing them (the caller must delete the generator). getSpaceSize() should be checked 
+     * first, as a generator cannot cover more than CyclicPermutation::MAX_SIZE IPs.
+     */
+    
+    TargetGenerator *createGenerator();
+    uint64_t getSpaceSize();
+    
     // Boolean method telling if the LAN of the VP is encompassed by the targets
     bool targetsEncompassLAN();
 
@@ -70,10 +91,10 @@ private:
     // Private fields
     list<InetAddress> parsedIPs;
     list<NetworkAddress> parsedIPBlocks;
+    uint32_t seed;
     
     // Private methods
     void parse(string input, char separator);
-    list<InetAddress> reorder(list<InetAddress> toReorder);
     
 };
 